@@ -43,6 +43,7 @@ CONFIG = {
     "example_name": "bgemm",
     "target_platform": "ascend_a2a3_sim",
     "enable_binary_expansion": True,
+    "enable_kernel_fusion": False,
     "enable_task_dump": True,
     "enable_task_graph_pdf": False,
     "benchmark_orchestration": True,  # tasks/ms without executing
@@ -65,6 +66,7 @@ try:
         PTOFunctionBuilder, PTOModule, MultiBackendCodeGenerator,
         generate_arm64_code, generate_cuda_code, generate_ascend_code,
     )
+    from compile.pto_build import BuildError, build_runner_executable
     from isa_definition.pto_isa_definition import ElementType, MemorySpace
 except ImportError as e:
     print(f"Error importing PTO modules: {e}")
@@ -164,14 +166,15 @@ def generate_code():
             gen = MultiBackendCodeGenerator(
                 enable_fusion=True,
                 analyze_buffers=True,
-                module=module
+                module=module,
+                kernel_fusion=CONFIG['enable_kernel_fusion']
             )
             
             # Create PTO assembly compiler for generating .pto files
             from compile.pto_compile import PTOModuleCompiler
             pto_compiler = PTOModuleCompiler()
             
-            for func_name, prog in module.functions.items():
+            for func_name, prog in gen.module.functions.items():
                 # Determine function type
                 is_incore = getattr(prog, 'is_in_core', True)
                 is_cube = getattr(prog, 'is_cube', False)
@@ -302,43 +305,25 @@ def compile_code():
     
     print(f"  Compiling: {os.path.basename(orch_file)}")
     
-    # Build compile command - output executable to platform_dir (not code_dir)
+    # Output executable to platform_dir (not code_dir)
     exe_basename = os.path.basename(orch_file).replace('.c', '')
     exe_path = os.path.join(platform_dir, exe_basename)
     
-    compile_flags = ["-O2", "-std=c11", "-D_POSIX_C_SOURCE=199309L"]
-    if CONFIG['enable_binary_expansion']:
-        compile_flags.append("-DPTO_BINARY_EXPANSION")
-    if CONFIG['enable_task_dump']:
-        compile_flags.append("-DPTO_TASK_DUMP")
-    
-    # Add platform-specific flags for A2A3 simulation
-    if platform == "ascend_a2a3_sim":
-        compile_flags.append("-DA2A3_TARGET_SIMULATOR")
-    
-    # Add include paths
-    include_paths = [f"-I{RUNTIME_DIR}"]
-    if is_a2a3_platform:
-        # Add InCore directories to include path for InCore function headers
-        aic_dir = os.path.join(code_dir, "incore_aic")
-        aiv_dir = os.path.join(code_dir, "incore_aiv")
-        if os.path.exists(aic_dir):
-            include_paths.append(f"-I{aic_dir}")
-        if os.path.exists(aiv_dir):
-            include_paths.append(f"-I{aiv_dir}")
-        include_paths.append(f"-I{code_dir}")
-    
-    cmd = f"gcc {' '.join(compile_flags)} {' '.join(include_paths)} -o {exe_path} {orch_file} -lpthread"
-    
-    print(f"  Command: {cmd}")
-    success, stdout, stderr = run_command(cmd, cwd=platform_dir)
+    # Objects are cached by content hash: only changed sources are recompiled
+    try:
+        builder = build_runner_executable(platform, code_dir, orch_file, exe_path,
+                                          binary_expansion=CONFIG['enable_binary_expansion'],
+                                          task_dump=CONFIG['enable_task_dump'])
+    except BuildError as e:
+        print(f"  Compilation failed: {e}")
+        return False
     
-    if success:
-        print(f"  Compiled successfully: {exe_path}")
-        return True
+    print(builder.report.format())
+    if builder.built == 0:
+        print(f"  Build cache hit, relinked from cached objects: {exe_path}")
     else:
-        print(f"  Compilation failed: {stderr}")
-        return False
+        print(f"  Compiled successfully: {exe_path}")
+    return True
 
 
 def generate_test_program_template(code_dir, example_name):
@@ -43,6 +43,7 @@ CONFIG = {
     "example_name": "bgemm",
     "target_platform": "cuda",
     "enable_binary_expansion": True,
+    "enable_kernel_fusion": False,
     "enable_task_dump": True,
     "enable_task_graph_pdf": True,
     "benchmark_orchestration": True,  # tasks/ms without executing
@@ -164,14 +165,15 @@ def generate_code():
             gen = MultiBackendCodeGenerator(
                 enable_fusion=True,
                 analyze_buffers=True,
-                module=module
+                module=module,
+                kernel_fusion=CONFIG['enable_kernel_fusion']
             )
             
             # Create PTO assembly compiler for generating .pto files
             from compile.pto_compile import PTOModuleCompiler
             pto_compiler = PTOModuleCompiler()
             
-            for func_name, prog in module.functions.items():
+            for func_name, prog in gen.module.functions.items():
                 # Determine function type
                 is_incore = getattr(prog, 'is_in_core', True)
                 is_cube = getattr(prog, 'is_cube', False)
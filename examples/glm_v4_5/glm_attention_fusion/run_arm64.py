@@ -50,6 +50,7 @@ CONFIG = {
     "example_name": "glm_v4_5_attention_fusion",
     "target_platform": "arm64",
     "enable_binary_expansion": True,
+    "enable_kernel_fusion": False,
     "enable_task_dump": True,
     "enable_task_graph_pdf": False,
     "enable_perf_benchmark": False,
@@ -75,6 +76,7 @@ try:
         PTOFunctionBuilder, PTOModule, MultiBackendCodeGenerator,
         generate_arm64_code,
     )
+    from compile.pto_build import BuildError, build_runner_executable
     from isa_definition.pto_isa_definition import ElementType, MemorySpace
 except ImportError as e:
     print(f"Error importing PTO modules: {e}")
@@ -430,10 +432,11 @@ def generate_code():
         gen = MultiBackendCodeGenerator(
             enable_fusion=True,
             analyze_buffers=True,
-            module=module
+            module=module,
+            kernel_fusion=CONFIG['enable_kernel_fusion']
         )
         
-        for func_name, prog in module.functions.items():
+        for func_name, prog in gen.module.functions.items():
             print(f"  Generating arm64 code for: {func_name}")
             
             code = gen.generate_arm64(prog)
@@ -496,21 +499,22 @@ def compile_code():
     
     print(f"  Found orchestration file: {os.path.basename(orch_file)}")
     
-    # Compile orchestration function
+    # Compile orchestration function against the prebuilt runtime library
     exe_name = os.path.join(platform_dir, os.path.basename(orch_file).replace('.c', ''))
-    compile_cmd = (
-        f"gcc -O2 -std=c11 -lm -I{RUNTIME_DIR} "
-        f"-o {exe_name} {orch_file} "
-        f"{os.path.join(RUNTIME_DIR, 'pto_runtime.c')} -lpthread"
-    )
-    
     print(f"  Compiling {os.path.basename(orch_file)}...")
-    success, stdout, stderr = run_command(compile_cmd)
-    if not success:
-        print(f"  ✗ Compilation failed: {stderr}")
+    try:
+        builder = build_runner_executable("arm64", code_dir, orch_file, exe_name,
+                                          binary_expansion=CONFIG['enable_binary_expansion'],
+                                          task_dump=CONFIG['enable_task_dump'])
+    except BuildError as e:
+        print(f"  ✗ Compilation failed: {e}")
         return False
     
-    print(f"  ✓ Compilation successful: {exe_name}")
+    print(builder.report.format())
+    if builder.built == 0:
+        print(f"  ✓ Build cache hit, relinked from cached objects: {exe_name}")
+    else:
+        print(f"  ✓ Compilation successful: {exe_name}")
     return True
 
 
@@ -933,7 +937,7 @@ int main(int argc, char** argv) {{
     
     // Set function pointers for all tasks
     for (int32_t task_id = 0; task_id < rt->next_task_id; task_id++) {{
-        int32_t slot = PTO_TASK_SLOT(task_id);
+        int32_t slot = PTO_TASK_SLOT(rt, task_id);
         PendingTask* task = &rt->pend_task[slot];
         if (!task->is_active) continue;
         
@@ -988,7 +992,7 @@ int main(int argc, char** argv) {{
             break;
         }}
         
-        int32_t slot = PTO_TASK_SLOT(task_id);
+        int32_t slot = PTO_TASK_SLOT(rt, task_id);
         PendingTask* task = &rt->pend_task[slot];
         
         // Build argument array
@@ -1187,7 +1191,7 @@ int main(int argc, char** argv) {{
     // Note: rowexpanddiv uses state_o and state_l which were just updated
     int32_t t13 = -1;
     for (int32_t task_id = 0; task_id < rt->next_task_id; task_id++) {{
-        int32_t slot = PTO_TASK_SLOT(task_id);
+        int32_t slot = PTO_TASK_SLOT(rt, task_id);
         PendingTask* task = &rt->pend_task[slot];
         if (task->is_active && strcmp(task->func_name, "rowexpanddiv") == 0) {{
             t13 = task_id;
@@ -1197,7 +1201,7 @@ int main(int argc, char** argv) {{
     
     if (t13 >= 0) {{
         // Set function pointer
-        int32_t slot = PTO_TASK_SLOT(t13);
+        int32_t slot = PTO_TASK_SLOT(rt, t13);
         PendingTask* task = &rt->pend_task[slot];
         task->func_ptr = (void*)rowexpanddiv_wrapper;
         
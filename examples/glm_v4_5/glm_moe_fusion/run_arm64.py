@@ -50,6 +50,7 @@ CONFIG = {
     "example_name": "glm_v4_5_moe_fusion",
     "target_platform": "arm64",
     "enable_binary_expansion": True,
+    "enable_kernel_fusion": False,
     "enable_task_dump": True,
     "enable_task_graph_pdf": False,
     "enable_perf_benchmark": False,
@@ -73,6 +74,7 @@ try:
         PTOFunctionBuilder, PTOModule, MultiBackendCodeGenerator,
         generate_arm64_code,
     )
+    from compile.pto_build import BuildError, build_runner_executable
     from isa_definition.pto_isa_definition import ElementType, MemorySpace
 except ImportError as e:
     print(f"Error importing PTO modules: {e}")
@@ -382,10 +384,11 @@ def generate_code():
         gen = MultiBackendCodeGenerator(
             enable_fusion=True,
             analyze_buffers=True,
-            module=module
+            module=module,
+            kernel_fusion=CONFIG['enable_kernel_fusion']
         )
         
-        for func_name, prog in module.functions.items():
+        for func_name, prog in gen.module.functions.items():
             print(f"  Generating arm64 code for: {func_name}")
             
             code = gen.generate_arm64(prog)
@@ -447,21 +450,22 @@ def compile_code():
     
     print(f"  Found orchestration file: {os.path.basename(orch_file)}")
     
-    # Compile orchestration function
+    # Compile orchestration function against the prebuilt runtime library
     exe_name = os.path.join(platform_dir, os.path.basename(orch_file).replace('.c', ''))
-    compile_cmd = (
-        f"gcc -O2 -std=c11 -lm -I{RUNTIME_DIR} "
-        f"-o {exe_name} {orch_file} "
-        f"{os.path.join(RUNTIME_DIR, 'pto_runtime.c')} -lpthread"
-    )
-    
     print(f"  Compiling {os.path.basename(orch_file)}...")
-    success, stdout, stderr = run_command(compile_cmd)
-    if not success:
-        print(f"  ✗ Compilation failed: {stderr}")
+    try:
+        builder = build_runner_executable("arm64", code_dir, orch_file, exe_name,
+                                          binary_expansion=CONFIG['enable_binary_expansion'],
+                                          task_dump=CONFIG['enable_task_dump'])
+    except BuildError as e:
+        print(f"  ✗ Compilation failed: {e}")
         return False
     
-    print(f"  ✓ Compilation successful: {exe_name}")
+    print(builder.report.format())
+    if builder.built == 0:
+        print(f"  ✓ Build cache hit, relinked from cached objects: {exe_name}")
+    else:
+        print(f"  ✓ Compilation successful: {exe_name}")
     return True
 
 
@@ -42,6 +42,7 @@ CONFIG = {
     "example_name": "llama",
     "target_platform": "arm64",
     "enable_binary_expansion": True,
+    "enable_kernel_fusion": False,
     "enable_task_dump": True,
     "enable_task_graph_pdf": True,
     "benchmark_orchestration": True,  # tasks/ms without executing
@@ -64,6 +65,7 @@ try:
         PTOFunctionBuilder, PTOModule, MultiBackendCodeGenerator,
         generate_arm64_code, generate_cuda_code, generate_ascend_code,
     )
+    from compile.pto_build import BuildError, build_runner_executable
     from isa_definition.pto_isa_definition import ElementType, MemorySpace
 except ImportError as e:
     print(f"Error importing PTO modules: {e}")
@@ -150,10 +152,11 @@ def generate_code():
             gen = MultiBackendCodeGenerator(
                 enable_fusion=True,
                 analyze_buffers=True,
-                module=module
+                module=module,
+                kernel_fusion=CONFIG['enable_kernel_fusion']
             )
             
-            for func_name, prog in module.functions.items():
+            for func_name, prog in gen.module.functions.items():
                 print(f"  Generating {platform} code for: {func_name}")
                 
                 if platform == "arm64":
@@ -234,27 +237,25 @@ def compile_code():
     
     print(f"  Compiling: {os.path.basename(orch_file)}")
     
-    # Build compile command - output executable to platform_dir (not code_dir)
+    # Output executable to platform_dir (not code_dir)
     exe_basename = os.path.basename(orch_file).replace('.c', '')
     exe_path = os.path.join(platform_dir, exe_basename)
     
-    compile_flags = ["-O2", "-std=c11"]
-    if CONFIG['enable_binary_expansion']:
-        compile_flags.append("-DPTO_BINARY_EXPANSION")
-    if CONFIG['enable_task_dump']:
-        compile_flags.append("-DPTO_TASK_DUMP")
-    
-    cmd = f"gcc {' '.join(compile_flags)} -I{RUNTIME_DIR} -o {exe_path} {orch_file} -lpthread"
-    
-    print(f"  Command: {cmd}")
-    success, stdout, stderr = run_command(cmd, cwd=platform_dir)
+    # Objects are cached by content hash: only changed sources are recompiled
+    try:
+        builder = build_runner_executable(platform, code_dir, orch_file, exe_path,
+                                          binary_expansion=CONFIG['enable_binary_expansion'],
+                                          task_dump=CONFIG['enable_task_dump'])
+    except BuildError as e:
+        print(f"  Compilation failed: {e}")
+        return False
     
-    if success:
-        print(f"  Compiled successfully: {exe_path}")
-        return True
+    print(builder.report.format())
+    if builder.built == 0:
+        print(f"  Build cache hit, relinked from cached objects: {exe_path}")
     else:
-        print(f"  Compilation failed: {stderr}")
-        return False
+        print(f"  Compiled successfully: {exe_path}")
+    return True
 
 
 # =============================================================================
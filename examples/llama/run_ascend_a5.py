@@ -42,6 +42,7 @@ CONFIG = {
     "example_name": "llama",
     "target_platform": "ascend_a5",
     "enable_binary_expansion": True,
+    "enable_kernel_fusion": False,
     "enable_task_dump": True,
     "enable_task_graph_pdf": True,
     "benchmark_orchestration": True,  # tasks/ms without executing
@@ -150,10 +151,11 @@ def generate_code():
             gen = MultiBackendCodeGenerator(
                 enable_fusion=True,
                 analyze_buffers=True,
-                module=module
+                module=module,
+                kernel_fusion=CONFIG['enable_kernel_fusion']
             )
             
-            for func_name, prog in module.functions.items():
+            for func_name, prog in gen.module.functions.items():
                 print(f"  Generating {platform} code for: {func_name}")
                 
                 if platform == "arm64":
@@ -51,10 +51,27 @@ const pipe_t PIPE_MTE2 = 3;
 const pipe_t PIPE_MTE3 = 4;
 const pipe_t PIPE_M = 5;
 const pipe_t PIPE_ALL = 6;
+const pipe_t PIPE_FIX = 7;
+
+#ifdef PTO_CPU_ASYNC_TLOAD
+// Asynchronous TLOAD: flags and barriers synchronize with the copy thread
+// (see pto/cpu/async_copy.hpp).
+namespace pto::cpu {
+inline void AsyncSetFlag(int srcPipe, int dstPipe, int eventId);
+inline void AsyncWaitFlag(int srcPipe, int dstPipe, int eventId);
+inline void AsyncPipeBarrier(int pipe);
+} // namespace pto::cpu
+
+inline void pipe_barrier(pipe_t pipe)
+{
+    pto::cpu::AsyncPipeBarrier(pipe);
+}
+#else
 inline void pipe_barrier(pipe_t pipe)
 {
     (void)pipe;
 }
+#endif
 
 constexpr pipe_t opPipeList[] = {
 };
@@ -80,12 +97,24 @@ static inline void aclrtMallocHost(void**p, size_t sz){
 #define aclrtDestroyStream(x)
 #define aclrtResetDevice(x)
 #define aclFinalize(x)
+#ifdef PTO_CPU_ASYNC_TLOAD
+#define set_flag(a,b,c) pto::cpu::AsyncSetFlag((a), (b), (c))
+#define wait_flag(a,b,c) pto::cpu::AsyncWaitFlag((a), (b), (c))
+#else
 #define set_flag(a,b,c)
 #define wait_flag(a,b,c)
+#endif
 #define __cce_get_tile_ptr(x) x
 
 typedef int event_t;
 #define EVENT_ID0 0
+#define EVENT_ID1 1
+#define EVENT_ID2 2
+#define EVENT_ID3 3
+#define EVENT_ID4 4
+#define EVENT_ID5 5
+#define EVENT_ID6 6
+#define EVENT_ID7 7
 
 // --- SPMD helpers for CPU simulator ---
 //
@@ -125,7 +125,7 @@ namespace pto {
 #else
     // Some toolchains compile host-side stubs in addition to AICORE code paths.
     // Guard intrinsic calls so non-AICORE compilation units don't fail to build.
-#if defined(__CCE_IS_AICORE__) || defined(__CCE_AICORE__)
+#if defined(__CCE_IS_AICORE__) || defined(__CCE_AICORE__) || (defined(__CPU_SIM) && defined(PTO_CPU_ASYNC_TLOAD))
     set_flag(SrcPipe, DstPipe, EVENT_ID0);
     wait_flag(SrcPipe, DstPipe, EVENT_ID0);
 #else
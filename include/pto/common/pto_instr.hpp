@@ -172,9 +172,10 @@ PTO_INST RecordEvent TSTORE_FP(GlobalData &dst, TileData &src, FpTileData &fp, W
 // Push/Pop: GM tile FIFO helpers (prototype).
 //
 // These are intended as explicit producer/consumer operations around GM-backed tile FIFOs
-// (e.g. Cube producer -> Vec consumer). The `token` operand is reserved for future
-// cross-core synchronization and/or FIFO slot selection; today the default backends treat
-// it as a no-op hint.
+// (e.g. Cube producer -> Vec consumer). The `token` operand identifies the FIFO: the NPU
+// backends use it as the MTE3 -> MTE2 event id guarding the GM buffer. The CPU backend
+// goes through GM as well; with PTO_CPU_TPUSH_FIFO it instead hands tiles over through an
+// in-memory FIFO per (block, token) without touching GM.
 template <typename GlobalData, typename TileData, typename... WaitEvents>
 PTO_INST RecordEvent TPUSH(GlobalData &dst, TileData &src, uint16_t token, WaitEvents &...events)
 {
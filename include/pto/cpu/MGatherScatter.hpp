@@ -12,6 +12,7 @@ See LICENSE in the root of the software repository for the full text of the Lice
 #define MGATHER_SCATTER_HPP
 
 #include "pto/cpu/tile_offsets.hpp"
+#include "pto/cpu/gather.hpp"
 #include "pto/cpu/parallel.hpp"
 #include <pto/common/pto_tile.hpp>
 #include <type_traits>
@@ -33,6 +34,14 @@ PTO_INTERNAL void MGATHER_IMPL(TileDst &dst, GlobalData &src, TileInd &indexes)
     }
 
     auto *base = src.data();
+    if constexpr (TileDst::isRowMajor && TileDst::SFractal == SLayout::NoneBox && TileInd::isRowMajor &&
+                  TileInd::SFractal == SLayout::NoneBox) {
+        cpu::parallel_for_rows(validRow, validCol, [&](std::size_t i) {
+            cpu::GatherRun<false>(dst.data() + GetTileElementOffset<TileDst>(i, 0), base,
+                indexes.data() + GetTileElementOffset<TileInd>(i, 0), validCol);
+        });
+        return;
+    }
     cpu::parallel_for_rows(validRow, validCol, [&](std::size_t i) {
         for (std::size_t j = 0; j < validCol; ++j) {
             const size_t dstOff = GetTileElementOffset<TileDst>(i, j);
@@ -58,14 +67,14 @@ PTO_INTERNAL void MSCATTER_IMPL(GlobalData &dst, TileSrc &src, TileInd &indexes)
     }
 
     auto *base = dst.data();
-    for (unsigned i = 0; i < validRow; ++i) {
-        for (unsigned j = 0; j < validCol; ++j) {
-            const size_t srcOff = GetTileElementOffset<TileSrc>(i, j);
-            const size_t idxOff = GetTileElementOffset<TileInd>(i, j);
-            const auto idx = static_cast<size_t>(indexes.data()[idxOff]);
-            base[idx] = src.data()[srcOff];
-        }
-    }
+    cpu::ScatterByDestination(
+        static_cast<std::size_t>(validRow) * validCol,
+        [&](std::size_t k) {
+            return static_cast<size_t>(indexes.data()[GetTileElementOffset<TileInd>(k / validCol, k % validCol)]);
+        },
+        [&](std::size_t k, std::size_t idx) {
+            base[idx] = src.data()[GetTileElementOffset<TileSrc>(k / validCol, k % validCol)];
+        });
 }
 
 } // namespace pto
@@ -13,29 +13,36 @@ See LICENSE in the root of the software repository for the full text of the Lice
 
 #include <pto/common/pto_tile.hpp>
 #include <cmath>
+#include "pto/cpu/tile_offsets.hpp"
+#include "pto/cpu/parallel.hpp"
+#include "pto/cpu/reduce.hpp"
 
 namespace pto {
     template <typename TileDst, typename TileSrc>
     void TColMax(typename TileDst::TileDType dst, typename TileSrc::TileDType src, uint16_t M, uint16_t N)
     {
-        for (uint16_t j = 0; j < N; j++) {
-            typename TileDst::DType max = src[GetTileElementOffset<TileSrc>(0,j)];
-
-            for (uint16_t i = 1; i < M; i++) {
-                size_t idx = GetTileElementOffset<TileSrc>(i, j);
-                if (src[idx] > max) {
-                    max = src[idx];
+        if constexpr (TileSrc::SFractal == SLayout::NoneBox && TileSrc::isRowMajor &&
+                      TileDst::SFractal == SLayout::NoneBox && cpu::is_simd_f32_source_v<typename TileSrc::DType>) {
+            cpu::ReduceColumnsF32<cpu::ReduceKind::Max>(dst, TileDst::ColStride, src, TileSrc::Cols, M, N);
+        } else {
+            cpu::parallel_for_1d(0, N, static_cast<std::size_t>(M) * N, [&](std::size_t j) {
+                typename TileDst::DType max = src[GetTileElementOffset<TileSrc>(0, j)];
+                for (uint16_t i = 1; i < M; i++) {
+                    size_t idx = GetTileElementOffset<TileSrc>(i, j);
+                    if (src[idx] > max) {
+                        max = src[idx];
+                    }
                 }
-            }
-            dst[GetTileElementOffset<TileDst>(0,j)] = max;
+                dst[GetTileElementOffset<TileDst>(0, j)] = max;
+            });
         }
     }
 
     template <typename TileDst, typename TileSrc>
     PTO_INTERNAL void CheckCMValid()
     {
-        using SrcType = TileSrc::DType;
-        using DstType = TileDst::DType;
+        using SrcType = typename TileSrc::DType;
+        using DstType = typename TileDst::DType;
         static_assert(
             (std::is_same_v<SrcType, half> && std::is_same_v<DstType, half>) ||  // f162f16
                 (std::is_same_v<SrcType, half> && std::is_same_v<DstType, float>) ||  // f162f32
@@ -13,6 +13,7 @@ See LICENSE in the root of the software repository for the full text of the Lice
 
 #include "pto/cpu/tile_offsets.hpp"
 #include "pto/cpu/parallel.hpp"
+#include "pto/cpu/reduce.hpp"
 #include <pto/common/pto_tile.hpp>
 
 namespace pto {
@@ -24,6 +25,12 @@ PTO_INTERNAL void TColmin_Impl(typename TileOut::TileDType dst, typename TileIn:
     if (validRow == 0 || validCol == 0) {
         return;
     }
+    if constexpr (TileIn::SFractal == SLayout::NoneBox && TileIn::isRowMajor &&
+                  TileOut::SFractal == SLayout::NoneBox && cpu::is_simd_f32_source_v<typename TileIn::DType> &&
+                  cpu::is_simd_f32_source_v<typename TileOut::DType>) {
+        cpu::ReduceColumnsF32<cpu::ReduceKind::Min>(dst, TileOut::ColStride, src, TileIn::Cols, validRow, validCol);
+        return;
+    }
     cpu::parallel_for_1d(0, validCol, static_cast<std::size_t>(validRow) * validCol, [&](std::size_t j) {
         size_t idx = GetTileElementOffset<TileIn>(0, j);
         typename TileOut::DType minVal = src[idx];
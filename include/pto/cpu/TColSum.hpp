@@ -13,26 +13,33 @@ See LICENSE in the root of the software repository for the full text of the Lice
 
 #include <pto/common/pto_tile.hpp>
 #include <cmath>
+#include "pto/cpu/tile_offsets.hpp"
+#include "pto/cpu/parallel.hpp"
+#include "pto/cpu/reduce.hpp"
 
 namespace pto {
     template <typename TileDst, typename TileSrc>
     void TColSum(typename TileDst::TileDType dst, typename TileSrc::TileDType src, uint16_t M, uint16_t N)
     {
-        for (uint16_t j = 0; j < N; j++) {
-            typename TileDst::DType sum = 0;
-
-            for (uint16_t i = 0; i < M; i++) {
-               sum += src[GetTileElementOffset<TileSrc>(i,j)];
-            }
-            dst[GetTileElementOffset<TileDst>(0,j)] = sum;
+        if constexpr (TileSrc::SFractal == SLayout::NoneBox && TileSrc::isRowMajor &&
+                      TileDst::SFractal == SLayout::NoneBox && cpu::is_simd_f32_source_v<typename TileSrc::DType>) {
+            cpu::ReduceColumnsF32<cpu::ReduceKind::Sum>(dst, TileDst::ColStride, src, TileSrc::Cols, M, N);
+        } else {
+            cpu::parallel_for_1d(0, N, static_cast<std::size_t>(M) * N, [&](std::size_t j) {
+                TypeSum<TileDst> sum = 0;
+                for (uint16_t i = 0; i < M; i++) {
+                    sum += src[GetTileElementOffset<TileSrc>(i, j)];
+                }
+                dst[GetTileElementOffset<TileDst>(0, j)] = static_cast<typename TileDst::DType>(sum);
+            });
         }
     }
 
     template <typename TileDst, typename TileSrc>
     PTO_INTERNAL void CheckCSValid()
     {
-        using SrcNonDuplicateType = TileSrc::DType;
-        using DstNonDuplicateType = TileDst::DType;
+        using SrcNonDuplicateType = typename TileSrc::DType;
+        using DstNonDuplicateType = typename TileDst::DType;
         static_assert(
             (std::is_same_v<SrcNonDuplicateType, half> && std::is_same_v<DstNonDuplicateType, half>) ||  // f162f16
                 (std::is_same_v<SrcNonDuplicateType, half> && std::is_same_v<DstNonDuplicateType, float>) ||  // f162f32
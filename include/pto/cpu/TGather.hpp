@@ -16,6 +16,7 @@ See LICENSE in the root of the software repository for the full text of the Lice
 #include <type_traits>
 #include <pto/common/pto_tile.hpp>
 #include <pto/common/type.hpp>
+#include "pto/cpu/gather.hpp"
 #include "pto/cpu/tile_offsets.hpp"
 
 namespace pto {
@@ -62,6 +63,16 @@ PTO_INTERNAL void TGather(typename TileDataD::TileDType dst, typename TileDataS0
     typename TileDataS1::TileDType src1, unsigned validCol, unsigned validRow)
 {
     const std::size_t numel0 = static_cast<std::size_t>(TileDataS0::Rows) * static_cast<std::size_t>(TileDataS0::Cols);
+    if constexpr (TileDataS0::isRowMajor && TileDataS0::SFractal == SLayout::NoneBox && TileDataS1::isRowMajor &&
+                  TileDataS1::SFractal == SLayout::NoneBox && TileDataD::isRowMajor &&
+                  TileDataD::SFractal == SLayout::NoneBox) {
+        // Flat index == element offset in a plain row-major src0.
+        for (unsigned r = 0; r < validRow; r++) {
+            cpu::GatherRun<true>(dst + GetTileElementOffset<TileDataD>(r, 0), src0,
+                src1 + GetTileElementOffset<TileDataS1>(r, 0), validCol, numel0);
+        }
+        return;
+    }
     for (unsigned r = 0; r < validRow; r++) {
         for (unsigned c = 0; c < validCol; c++) {
             const size_t idx1 = GetTileElementOffset<TileDataS1>(r, c);
@@ -13,7 +13,11 @@ See LICENSE in the root of the software repository for the full text of the Lice
 
 #include <unistd.h>
 #include <cassert>
+#include "pto/cpu/copy.hpp"
 #include "pto/cpu/parallel.hpp"
+#ifdef PTO_CPU_ASYNC_TLOAD
+#include "pto/cpu/async_copy.hpp"
+#endif
 
 namespace pto {
     template <typename TileData>
@@ -39,10 +43,35 @@ namespace pto {
         return 0;
     }
 
+    // Pads only what the plain copy leaves untouched: the tail of each valid
+    // row (column) and the rows (columns) past the valid region.
+    template <typename TileData>
+    PTO_INLINE void FillPlainPadding(typename TileData::DType *dst, int validRow, int validCol)
+    {
+        const auto pad = getPadValue<TileData>();
+        constexpr std::size_t kInner = TileData::isRowMajor ? TileData::Cols : TileData::Rows;
+        constexpr std::size_t kOuter = TileData::isRowMajor ? TileData::Rows : TileData::Cols;
+        const std::size_t validInner = static_cast<std::size_t>(TileData::isRowMajor ? validCol : validRow);
+        const std::size_t validOuter = static_cast<std::size_t>(TileData::isRowMajor ? validRow : validCol);
+        if (validInner < kInner) {
+            for (std::size_t i = 0; i < validOuter; i++) {
+                std::fill(dst + i * kInner + validInner, dst + (i + 1) * kInner, pad);
+            }
+        }
+        if (validOuter < kOuter) {
+            std::fill(dst + validOuter * kInner, dst + kOuter * kInner, pad);
+        }
+    }
+
     template <typename GlobalData, typename TileData, std::enable_if_t<TileData::isRowMajor, int> = 0>
     __tf__  PTO_INLINE void LoadPlainMatrix(typename GlobalData::DType __out__ *dst, typename TileData::TileDType __in__ src,
         int gShape3, int gShape4, int gStride3, int gStride4, int validRow, int validCol, size_t idx3) {
         size_t offsetDstBase =  idx3*gShape3*TileData::Cols;
+        if (cpu::IsUnitStride<GlobalData, GlobalTensorDim::DIM_4>(gStride4)) {
+            cpu::CopyRuns(dst + offsetDstBase, TileData::Cols, src, static_cast<std::size_t>(gStride3),
+                static_cast<std::size_t>(gShape3), static_cast<std::size_t>(gShape4));
+            return;
+        }
         cpu::parallel_for_1d(0, static_cast<std::size_t>(gShape3), static_cast<std::size_t>(gShape3) * gShape4, [&](std::size_t r) {
             const std::size_t dstBase = offsetDstBase + r * TileData::Cols;
             const std::size_t srcBase = r * static_cast<std::size_t>(gStride3);
@@ -56,6 +85,11 @@ namespace pto {
     __tf__  PTO_INLINE void LoadPlainMatrix(typename GlobalData::DType __out__ *dst, typename TileData::TileDType __in__ src,
         int gShape3, int gShape4, int gStride3, int gStride4, int validRow, int validCol, size_t idx3) {
         size_t offsetDstBase =  idx3*gShape4*TileData::Rows;
+        if (cpu::IsUnitStride<GlobalData, GlobalTensorDim::DIM_3>(gStride3)) {
+            cpu::CopyRuns(dst + offsetDstBase, TileData::Rows, src, static_cast<std::size_t>(gStride4),
+                static_cast<std::size_t>(gShape4), static_cast<std::size_t>(gShape3));
+            return;
+        }
         cpu::parallel_for_1d(0, static_cast<std::size_t>(gShape4), static_cast<std::size_t>(gShape3) * gShape4, [&](std::size_t c) {
             const std::size_t dstBase = offsetDstBase + c * TileData::Rows;
             const std::size_t srcStride4 = static_cast<std::size_t>(gStride4);
@@ -134,15 +168,15 @@ namespace pto {
         assert((gShape0*gShape1*gShape2*gShape3 == validRow && gShape4==validCol && TileData::isRowMajor) ||
             (gShape0*gShape1*gShape2*gShape4 == validCol && gShape3==validRow && !TileData::isRowMajor));
 
-        // Filling padding
-        std::fill(dst,dst+(TileData::Cols*TileData::Rows),getPadValue<TileData>());
-
         //Filling data
         if(TileData::SFractal == SLayout::NoneBox) {
+            FillPlainPadding<TileData>(dst, validRow, validCol);
             LoadPlain<GlobalData, TileData>(dst, src, gShape0, gShape1, gShape2, gShape3, gShape4, gStride0, gStride1, gStride2,
                 gStride3, gStride4, validRow, validCol);
         } else {
             assert(gShape0==1 && gShape1==1 && gShape2==1 && "ND,DN -> Nz,Zn convertion does support only 2D GMs");
+            // Fractal padding is scattered across the boxes; fill the whole tile.
+            std::fill(dst,dst+(TileData::Cols*TileData::Rows),getPadValue<TileData>());
             LoadSubfractalMatrix<GlobalData, TileData>(dst, src, gShape3, gShape4, gStride3, gStride4, validRow, validCol);
         }
     }
@@ -153,20 +187,30 @@ namespace pto {
         static_assert(sizeof(typename TileData::DType) == sizeof(typename GlobalData::DType),
                       "Source dtype must be same with dst dtype");
         static_assert(GlobalData::layout == pto::Layout::ND || GlobalData::layout == pto::Layout::DN , "Only ND and DN GLobal Tensors are currently supported");
-        TLoad<TileData, GlobalData>(dst.data(),
-            src.data(),
-            src.GetShape(pto::GlobalTensorDim::DIM_0),
-            src.GetShape(pto::GlobalTensorDim::DIM_1),
-            src.GetShape(pto::GlobalTensorDim::DIM_2),
-            src.GetShape(pto::GlobalTensorDim::DIM_3),
-            src.GetShape(pto::GlobalTensorDim::DIM_4),
-            src.GetStride(pto::GlobalTensorDim::DIM_0),
-            src.GetStride(pto::GlobalTensorDim::DIM_1),
-            src.GetStride(pto::GlobalTensorDim::DIM_2),
-            src.GetStride(pto::GlobalTensorDim::DIM_3),
-            src.GetStride(pto::GlobalTensorDim::DIM_4),
-            dst.GetValidRow(),
-            dst.GetValidCol());
+        const int gShape0 = src.GetShape(pto::GlobalTensorDim::DIM_0);
+        const int gShape1 = src.GetShape(pto::GlobalTensorDim::DIM_1);
+        const int gShape2 = src.GetShape(pto::GlobalTensorDim::DIM_2);
+        const int gShape3 = src.GetShape(pto::GlobalTensorDim::DIM_3);
+        const int gShape4 = src.GetShape(pto::GlobalTensorDim::DIM_4);
+        const int gStride0 = src.GetStride(pto::GlobalTensorDim::DIM_0);
+        const int gStride1 = src.GetStride(pto::GlobalTensorDim::DIM_1);
+        const int gStride2 = src.GetStride(pto::GlobalTensorDim::DIM_2);
+        const int gStride3 = src.GetStride(pto::GlobalTensorDim::DIM_3);
+        const int gStride4 = src.GetStride(pto::GlobalTensorDim::DIM_4);
+        const int validRow = dst.GetValidRow();
+        const int validCol = dst.GetValidCol();
+#ifdef PTO_CPU_ASYNC_TLOAD
+        // The tile must stay alive (and untouched) until the matching wait_flag.
+        typename TileData::DType *dstPtr = dst.data();
+        typename GlobalData::DType *srcPtr = src.data();
+        cpu::AsyncCopyEngine::Instance().Submit([=]() {
+            TLoad<TileData, GlobalData>(dstPtr, srcPtr, gShape0, gShape1, gShape2, gShape3, gShape4, gStride0,
+                gStride1, gStride2, gStride3, gStride4, validRow, validCol);
+        });
+#else
+        TLoad<TileData, GlobalData>(dst.data(), src.data(), gShape0, gShape1, gShape2, gShape3, gShape4, gStride0,
+            gStride1, gStride2, gStride3, gStride4, validRow, validCol);
+#endif
     }
 }
 #endif
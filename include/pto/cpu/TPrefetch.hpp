@@ -11,17 +11,92 @@ See LICENSE in the root of the software repository for the full text of the Lice
 #ifndef TPREFETCH_HPP
 #define TPREFETCH_HPP
 
+#include <cstddef>
+#include <cstdint>
+
+// Cache-line size assumed by the software prefetcher.
+#ifndef PTO_CPU_CACHE_LINE_BYTES
+#define PTO_CPU_CACHE_LINE_BYTES 64u
+#endif
+
+// Regions larger than this are prefetched with a non-temporal hint so that a
+// big stream does not evict the working set of the current tile.
+#ifndef PTO_CPU_PREFETCH_NT_BYTES
+#define PTO_CPU_PREFETCH_NT_BYTES (1u << 20)
+#endif
+
 namespace pto {
 
+namespace cpu {
+template <int Locality>
+PTO_INTERNAL void PrefetchRange(const void *begin, std::size_t bytes)
+{
+    const char *p = static_cast<const char *>(begin);
+    const uintptr_t first = reinterpret_cast<uintptr_t>(p) & ~static_cast<uintptr_t>(PTO_CPU_CACHE_LINE_BYTES - 1);
+    const uintptr_t last = reinterpret_cast<uintptr_t>(p + bytes);
+    for (uintptr_t line = first; line < last; line += PTO_CPU_CACHE_LINE_BYTES) {
+        __builtin_prefetch(reinterpret_cast<const void *>(line), 0, Locality);
+    }
+}
+
+// Walks the GM region row by row (dims 0..3) and prefetches each row, stopping
+// once `budget` bytes of data have been covered.
+template <int Locality, typename T>
+PTO_INTERNAL void PrefetchRegion(const T *base, const int (&shape)[5], const int (&stride)[5], std::size_t budget)
+{
+    const std::size_t rowBytes = static_cast<std::size_t>(shape[4]) * sizeof(T);
+    for (int n0 = 0; n0 < shape[0]; ++n0) {
+        for (int n1 = 0; n1 < shape[1]; ++n1) {
+            for (int n2 = 0; n2 < shape[2]; ++n2) {
+                for (int r = 0; r < shape[3]; ++r) {
+                    if (budget == 0) {
+                        return;
+                    }
+                    const T *row = base + static_cast<std::ptrdiff_t>(n0) * stride[0] +
+                                   static_cast<std::ptrdiff_t>(n1) * stride[1] +
+                                   static_cast<std::ptrdiff_t>(n2) * stride[2] +
+                                   static_cast<std::ptrdiff_t>(r) * stride[3];
+                    const std::size_t bytes = rowBytes < budget ? rowBytes : budget;
+                    if (stride[4] == 1) {
+                        PrefetchRange<Locality>(row, bytes);
+                    } else {
+                        for (std::size_t c = 0; c < bytes / sizeof(T); ++c) {
+                            __builtin_prefetch(row + static_cast<std::ptrdiff_t>(c) * stride[4], 0, Locality);
+                        }
+                    }
+                    budget -= bytes;
+                }
+            }
+        }
+    }
+}
+} // namespace cpu
+
+// CPU simulator: TPREFETCH streams the GlobalTensor region into the cache with
+// software prefetches. As on the NPU the dst tile is only a staging buffer; its
+// size bounds how much of the region is fetched.
 template <typename TileData, typename GlobalData>
 PTO_INTERNAL void TPREFETCH_IMPL(TileData &dst, GlobalData &src)
 {
-    // CPU simulator: prefetch is non-semantic. Keep it as a no-op.
     (void)dst;
-    (void)src;
+    using T = typename GlobalData::RawDType;
+    const int shape[5] = {src.GetShape(pto::GlobalTensorDim::DIM_0), src.GetShape(pto::GlobalTensorDim::DIM_1),
+        src.GetShape(pto::GlobalTensorDim::DIM_2), src.GetShape(pto::GlobalTensorDim::DIM_3),
+        src.GetShape(pto::GlobalTensorDim::DIM_4)};
+    const int stride[5] = {src.GetStride(pto::GlobalTensorDim::DIM_0), src.GetStride(pto::GlobalTensorDim::DIM_1),
+        src.GetStride(pto::GlobalTensorDim::DIM_2), src.GetStride(pto::GlobalTensorDim::DIM_3),
+        src.GetStride(pto::GlobalTensorDim::DIM_4)};
+    const std::size_t tileBytes = static_cast<std::size_t>(TileData::Numel) * sizeof(typename TileData::DType);
+    const std::size_t regionBytes = static_cast<std::size_t>(shape[0]) * shape[1] * shape[2] * shape[3] *
+                                    shape[4] * sizeof(T);
+    const std::size_t budget = regionBytes < tileBytes ? regionBytes : tileBytes;
+    if (budget > PTO_CPU_PREFETCH_NT_BYTES) {
+        cpu::PrefetchRegion<0>(src.data(), shape, stride, budget);
+    } else {
+        cpu::PrefetchRegion<3>(src.data(), shape, stride, budget);
+    }
 }
 
 } // namespace pto
 
 #endif
-
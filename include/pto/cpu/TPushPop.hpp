@@ -13,25 +13,72 @@ See LICENSE in the root of the software repository for the full text of the Lice
 
 #include <pto/common/type.hpp>
 
+#include "pto/common/cpu_stub.hpp"
 #include "pto/cpu/TLoad.hpp"
 #include "pto/cpu/TStore.hpp"
+#include "pto/cpu/tile_fifo.hpp"
 
 namespace pto {
 
+// By default TPUSH/TPOP go through the GM tensor with TSTORE/TLOAD, as on the
+// NPU, and the token is only a synchronization hint. Define PTO_CPU_TPUSH_FIFO
+// to hand tiles over through the in-memory FIFO of (get_block_idx(), token)
+// instead (see tile_fifo.hpp); the GM tensor is then left untouched.
 template <typename GlobalData, typename TileData>
 PTO_INTERNAL void TPUSH_IMPL(GlobalData &dst, TileData &src, uint16_t token)
 {
+#ifdef PTO_CPU_TPUSH_FIFO
+    (void)dst;
+    cpu::TileFifoFor(get_block_idx(), token).Push(src.data(), sizeof(typename TileData::TileDType));
+#else
     (void)token;
     TSTORE_IMPL(dst, src);
+#endif
 }
 
 template <typename TileData, typename GlobalData>
 PTO_INTERNAL void TPOP_IMPL(TileData &dst, GlobalData &src, uint16_t token)
 {
+#ifdef PTO_CPU_TPUSH_FIFO
+    (void)src;
+    cpu::TileFifoFor(get_block_idx(), token).Pop(dst.data(), sizeof(typename TileData::TileDType));
+#else
     (void)token;
     TLOAD_IMPL(dst, src);
+#endif
 }
 
+namespace cpu {
+
+// FIFO access by explicit block for threaded CPU-side schedulers and tests.
+// PushTile/PopTile wait like TPUSH/TPOP; the Try variants return false when
+// the FIFO is full (push) or empty (pop).
+template <typename TileData>
+inline void PushTile(TileData &src, uint32_t block, uint16_t token)
+{
+    TileFifoFor(block, token).Push(src.data(), sizeof(typename TileData::TileDType));
+}
+
+template <typename TileData>
+inline void PopTile(TileData &dst, uint32_t block, uint16_t token)
+{
+    TileFifoFor(block, token).Pop(dst.data(), sizeof(typename TileData::TileDType));
+}
+
+template <typename TileData>
+inline bool TryPushTile(TileData &src, uint32_t block, uint16_t token)
+{
+    return TileFifoFor(block, token).TryPush(src.data(), sizeof(typename TileData::TileDType));
+}
+
+template <typename TileData>
+inline bool TryPopTile(TileData &dst, uint32_t block, uint16_t token)
+{
+    return TileFifoFor(block, token).TryPop(dst.data(), sizeof(typename TileData::TileDType));
+}
+
+} // namespace cpu
+
 } // namespace pto
 
 #endif // PTO_CPU_TPUSH_POP_HPP
@@ -13,7 +13,9 @@ See LICENSE in the root of the software repository for the full text of the Lice
 
 #include <pto/common/pto_tile.hpp>
 #include <cmath>
+#include "pto/cpu/tile_offsets.hpp"
 #include "pto/cpu/parallel.hpp"
+#include "pto/cpu/reduce.hpp"
 
 namespace pto{
 
@@ -26,10 +28,16 @@ namespace pto{
             typename tile_shape_out::DType max_val;
             if constexpr (tile_shape_in::SFractal == SLayout::NoneBox && tile_shape_in::isRowMajor) {
                 const std::size_t base = i * tile_shape_in::Cols;
-                max_val = src[base];
-                PTO_CPU_VECTORIZE_LOOP
-                for (std::size_t j = 1; j < validCol; ++j) {
-                    max_val = std::max(max_val, static_cast<typename tile_shape_out::DType>(src[base + j]));
+                if constexpr (cpu::is_simd_f32_source_v<typename tile_shape_in::DType> &&
+                              cpu::is_simd_f32_source_v<typename tile_shape_out::DType>) {
+                    max_val = static_cast<typename tile_shape_out::DType>(
+                        cpu::ReduceContiguousF32<cpu::ReduceKind::Max>(src + base, validCol));
+                } else {
+                    max_val = src[base];
+                    PTO_CPU_VECTORIZE_LOOP
+                    for (std::size_t j = 1; j < validCol; ++j) {
+                        max_val = std::max(max_val, static_cast<typename tile_shape_out::DType>(src[base + j]));
+                    }
                 }
             } else {
                 size_t idx = GetTileElementOffset<tile_shape_in>(i, 0);
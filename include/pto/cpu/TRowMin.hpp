@@ -13,6 +13,7 @@ See LICENSE in the root of the software repository for the full text of the Lice
 
 #include "pto/cpu/tile_offsets.hpp"
 #include "pto/cpu/parallel.hpp"
+#include "pto/cpu/reduce.hpp"
 #include <pto/common/pto_tile.hpp>
 
 namespace pto {
@@ -28,10 +29,16 @@ PTO_INTERNAL void TRowmin_Impl(typename TileOut::TileDType dst, typename TileIn:
         typename TileOut::DType minVal;
         if constexpr (TileIn::SFractal == SLayout::NoneBox && TileIn::isRowMajor) {
             const std::size_t base = i * TileIn::Cols;
-            minVal = src[base];
-            PTO_CPU_VECTORIZE_LOOP
-            for (std::size_t j = 1; j < validCol; ++j) {
-                minVal = std::min(minVal, static_cast<typename TileOut::DType>(src[base + j]));
+            if constexpr (cpu::is_simd_f32_source_v<typename TileIn::DType> &&
+                          cpu::is_simd_f32_source_v<typename TileOut::DType>) {
+                minVal = static_cast<typename TileOut::DType>(
+                    cpu::ReduceContiguousF32<cpu::ReduceKind::Min>(src + base, validCol));
+            } else {
+                minVal = src[base];
+                PTO_CPU_VECTORIZE_LOOP
+                for (std::size_t j = 1; j < validCol; ++j) {
+                    minVal = std::min(minVal, static_cast<typename TileOut::DType>(src[base + j]));
+                }
             }
         } else {
             size_t idx = GetTileElementOffset<TileIn>(i, 0);
@@ -12,6 +12,7 @@ See LICENSE in the root of the software repository for the full text of the Lice
 #define TROWSUM_HPP
 #include "pto/cpu/tile_offsets.hpp"
 #include "pto/cpu/parallel.hpp"
+#include "pto/cpu/reduce.hpp"
 
 namespace pto {
     template <typename TileDst, typename TileSrc>
@@ -21,9 +22,14 @@ namespace pto {
             TypeSum<TileDst> sum = 0;
             if constexpr (TileSrc::SFractal == SLayout::NoneBox && TileSrc::isRowMajor) {
                 const std::size_t base = i * TileSrc::Cols;
-                PTO_CPU_VECTORIZE_LOOP
-                for (std::size_t j = 0; j < N; ++j) {
-                    sum += src[base + j];
+                if constexpr (cpu::is_simd_f32_source_v<typename TileSrc::DType> &&
+                              std::is_same_v<TypeSum<TileDst>, float>) {
+                    sum = cpu::ReduceContiguousF32<cpu::ReduceKind::Sum>(src + base, N);
+                } else {
+                    PTO_CPU_VECTORIZE_LOOP
+                    for (std::size_t j = 0; j < N; ++j) {
+                        sum += src[base + j];
+                    }
                 }
             } else {
                 for (std::size_t j = 0; j < N; ++j) {
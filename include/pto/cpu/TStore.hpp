@@ -13,6 +13,7 @@ See LICENSE in the root of the software repository for the full text of the Lice
 
 #include <pto/common/constants.hpp>
 #include <cassert>
+#include "pto/cpu/copy.hpp"
 #include "pto/cpu/parallel.hpp"
 
 namespace pto {
@@ -21,6 +22,17 @@ namespace pto {
     __tf__  PTO_INLINE void StorePlainMatrix(typename GlobalData::DType __out__ *dst, typename TileData::TileDType __in__ src,
         int gShape3, int gShape4, int gStride3, int gStride4, int validRow, int validCol, size_t idx3) {
         size_t offsetSrcBase =  idx3*gShape3*TileData::Cols;
+        if (cpu::IsUnitStride<GlobalData, GlobalTensorDim::DIM_4>(gStride4)) {
+            const std::size_t bytes = static_cast<std::size_t>(validRow) * validCol * sizeof(typename GlobalData::DType);
+            if (cpu::UseStreamingStore(bytes)) {
+                cpu::StreamRuns(dst, static_cast<std::size_t>(gStride3), src + offsetSrcBase, TileData::Cols,
+                    static_cast<std::size_t>(gShape3), static_cast<std::size_t>(gShape4));
+            } else {
+                cpu::CopyRuns(dst, static_cast<std::size_t>(gStride3), src + offsetSrcBase, TileData::Cols,
+                    static_cast<std::size_t>(gShape3), static_cast<std::size_t>(gShape4));
+            }
+            return;
+        }
         cpu::parallel_for_1d(0, static_cast<std::size_t>(gShape3), static_cast<std::size_t>(gShape3) * gShape4, [&](std::size_t r) {
             const std::size_t srcBase = offsetSrcBase + r * TileData::Cols;
             const std::size_t dstBase = r * static_cast<std::size_t>(gStride3);
@@ -34,6 +46,17 @@ namespace pto {
     __tf__  PTO_INLINE void StorePlainMatrix(typename GlobalData::DType __out__ *dst, typename TileData::TileDType __in__ src,
         int gShape3, int gShape4, int gStride3, int gStride4, int validRow, int validCol, size_t idx3) {
         size_t offsetSrcBase =  idx3*gShape4*TileData::Rows;
+        if (cpu::IsUnitStride<GlobalData, GlobalTensorDim::DIM_3>(gStride3)) {
+            const std::size_t bytes = static_cast<std::size_t>(validRow) * validCol * sizeof(typename GlobalData::DType);
+            if (cpu::UseStreamingStore(bytes)) {
+                cpu::StreamRuns(dst, static_cast<std::size_t>(gStride4), src + offsetSrcBase, TileData::Rows,
+                    static_cast<std::size_t>(gShape4), static_cast<std::size_t>(gShape3));
+            } else {
+                cpu::CopyRuns(dst, static_cast<std::size_t>(gStride4), src + offsetSrcBase, TileData::Rows,
+                    static_cast<std::size_t>(gShape4), static_cast<std::size_t>(gShape3));
+            }
+            return;
+        }
         cpu::parallel_for_1d(0, static_cast<std::size_t>(gShape4), static_cast<std::size_t>(gShape3) * gShape4, [&](std::size_t c) {
             const std::size_t srcBase = offsetSrcBase + c * TileData::Rows;
             const std::size_t dstStride4 = static_cast<std::size_t>(gStride4);
@@ -32,7 +32,7 @@ namespace pto
                 else {
                     size_t subTileR = r / SrcTileData::InnerRows;
                     size_t innerR = r % SrcTileData::InnerRows;
-                    srcTileIdx = GetElementOffsetSubfractals<SrcTileData>(subTileSrcC,innerSrcC,subTileR,innerR);
+                    srcTileIdx = GetTileElementOffsetSubfractals<SrcTileData>(subTileSrcC,innerSrcC,subTileR,innerR);
                 }
 
                 if constexpr (DstTileData::SFractal == SLayout::NoneBox)
@@ -40,7 +40,7 @@ namespace pto
                 else {
                     size_t subTileR = r / DstTileData::InnerRows;
                     size_t innerR = r % DstTileData::InnerRows;
-                    dstTileIdx = GetElementOffsetSubfractals<DstTileData>(subTileR,innerR, subTileDstC,innerDstC);
+                    dstTileIdx = GetTileElementOffsetSubfractals<DstTileData>(subTileR,innerR, subTileDstC,innerDstC);
                 }
                 dst[dstTileIdx] = src[srcTileIdx];
             }
@@ -0,0 +1,169 @@
+/**
+Copyright (c) 2025 Huawei Technologies Co., Ltd.
+This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+CANN Open Software License Agreement Version 2.0 (the "License").
+Please refer to the License for details. You may not use this file except in compliance with the License.
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+See LICENSE in the root of the software repository for the full text of the License.
+*/
+
+#ifndef PTO_CPU_ASYNC_COPY_HPP
+#define PTO_CPU_ASYNC_COPY_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <pto/common/event.hpp>
+
+// CPU model of the MTE2 (GM -> tile) pipe.
+//
+// With PTO_CPU_ASYNC_TLOAD defined, TLOAD hands its copy to a background copy
+// thread and returns immediately, like the NPU MTE2 queue. Kernels then rely on
+// the same synchronization they use on the NPU:
+//   set_flag(PIPE_MTE2, PIPE_V, id)   -> remembers the last TLOAD issued so far
+//   wait_flag(PIPE_MTE2, PIPE_V, id)  -> blocks until that TLOAD has landed
+//   pipe_barrier(PIPE_ALL / PIPE_MTE2) and PtoSetWaitFlag<PIPE_MTE2, X>() drain the queue.
+// Without the macro TLOAD stays synchronous and the flags stay no-ops.
+//
+// Each core has its own MTE2 queue: every thread that issues TLOADs gets its own
+// engine and copy thread, so a wait on one core never waits for another core's copies.
+
+namespace pto::cpu {
+
+class AsyncCopyEngine {
+public:
+    // The calling thread's engine; its copy thread is joined when the caller exits.
+    static AsyncCopyEngine &Instance()
+    {
+        static thread_local AsyncCopyEngine engine;
+        return engine;
+    }
+
+    // Queues a copy and returns its ticket (tickets start at 1).
+    uint64_t Submit(std::function<void()> copy)
+    {
+        uint64_t ticket;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!worker_.joinable()) {
+                worker_ = std::thread([this]() { Run(); });
+            }
+            ticket = ++submitted_;
+            queue_.emplace_back(std::move(copy));
+        }
+        pending_.notify_one();
+        return ticket;
+    }
+
+    uint64_t LastSubmitted()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return submitted_;
+    }
+
+    // Copies complete in submission order, so one counter covers every ticket.
+    void WaitFor(uint64_t ticket)
+    {
+        if (completed_.load(std::memory_order_acquire) >= ticket) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&]() { return completed_.load(std::memory_order_acquire) >= ticket; });
+    }
+
+    void Drain()
+    {
+        WaitFor(LastSubmitted());
+    }
+
+    ~AsyncCopyEngine()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        pending_.notify_one();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+private:
+    AsyncCopyEngine() = default;
+    AsyncCopyEngine(const AsyncCopyEngine &) = delete;
+    AsyncCopyEngine &operator=(const AsyncCopyEngine &) = delete;
+
+    void Run()
+    {
+        for (;;) {
+            std::function<void()> copy;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                pending_.wait(lock, [&]() { return stop_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+                copy = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            copy();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                completed_.fetch_add(1, std::memory_order_release);
+            }
+            done_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable pending_;
+    std::condition_variable done_;
+    std::deque<std::function<void()>> queue_;
+    std::thread worker_;
+    uint64_t submitted_ = 0;
+    std::atomic<uint64_t> completed_{0};
+    bool stop_ = false;
+};
+
+constexpr int kAsyncFlagPipes = 8;
+
+inline uint64_t &AsyncFlagSlot(int srcPipe, int dstPipe, int eventId)
+{
+    static thread_local uint64_t flags[kAsyncFlagPipes][kAsyncFlagPipes][EVENT_ID_MAX] = {};
+    return flags[static_cast<unsigned>(srcPipe) % kAsyncFlagPipes][static_cast<unsigned>(dstPipe) % kAsyncFlagPipes]
+                [static_cast<unsigned>(eventId) % EVENT_ID_MAX];
+}
+
+// Only MTE2 runs asynchronously on the CPU; every other pipe is already in
+// program order on the calling thread, so its flags need no state.
+inline void AsyncSetFlag(int srcPipe, int dstPipe, int eventId)
+{
+    if (srcPipe == PIPE_MTE2) {
+        AsyncFlagSlot(srcPipe, dstPipe, eventId) = AsyncCopyEngine::Instance().LastSubmitted();
+    }
+}
+
+inline void AsyncWaitFlag(int srcPipe, int dstPipe, int eventId)
+{
+    if (srcPipe == PIPE_MTE2) {
+        AsyncCopyEngine::Instance().WaitFor(AsyncFlagSlot(srcPipe, dstPipe, eventId));
+    }
+}
+
+inline void AsyncPipeBarrier(int pipe)
+{
+    if (pipe == PIPE_MTE2 || pipe == PIPE_ALL) {
+        AsyncCopyEngine::Instance().Drain();
+    }
+}
+
+} // namespace pto::cpu
+
+#endif
@@ -0,0 +1,132 @@
+/**
+Copyright (c) 2025 Huawei Technologies Co., Ltd.
+This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+CANN Open Software License Agreement Version 2.0 (the "License").
+Please refer to the License for details. You may not use this file except in compliance with the License.
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+See LICENSE in the root of the software repository for the full text of the License.
+*/
+
+#ifndef PTO_CPU_COPY_HPP
+#define PTO_CPU_COPY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// TSTOREs writing at least this many bytes through unit-stride rows use
+// non-temporal stores, so a large output does not evict the working set of the
+// next kernel. Set to 0 to disable streaming stores.
+#ifndef PTO_CPU_STREAM_STORE_BYTES
+#define PTO_CPU_STREAM_STORE_BYTES (1u << 20)
+#endif
+
+namespace pto::cpu {
+
+// True when the GM stride along Dim is 1. A static Stride makes this
+// a constant, so the strided fallback at the call site compiles away.
+template <typename GlobalData, int Dim>
+inline bool IsUnitStride(int runtimeStride) noexcept
+{
+    constexpr int staticStride = GlobalData::staticStride[Dim];
+    if constexpr (staticStride == 1) {
+        return true;
+    } else if constexpr (staticStride > 0) {
+        return false;
+    } else {
+        return runtimeStride == 1;
+    }
+}
+
+// Copies `runs` runs of `len` contiguous elements; one memcpy when both sides
+// are dense.
+template <typename DstT, typename SrcT>
+inline void CopyRuns(DstT *dst, std::size_t dstStride, const SrcT *src, std::size_t srcStride, std::size_t runs,
+    std::size_t len) noexcept
+{
+    static_assert(sizeof(DstT) == sizeof(SrcT), "CopyRuns copies bit patterns between same-sized types");
+    if (runs == 0 || len == 0) {
+        return;
+    }
+    if (dstStride == len && srcStride == len) {
+        std::memcpy(dst, src, runs * len * sizeof(DstT));
+        return;
+    }
+    for (std::size_t i = 0; i < runs; ++i) {
+        std::memcpy(dst + i * dstStride, src + i * srcStride, len * sizeof(DstT));
+    }
+}
+
+inline void StreamCopyBytes(void *dst, const void *src, std::size_t bytes) noexcept
+{
+#if defined(__SSE2__)
+    auto *d = static_cast<char *>(dst);
+    auto *s = static_cast<const char *>(src);
+    std::size_t head = (16u - (reinterpret_cast<std::uintptr_t>(d) & 15u)) & 15u;
+    if (head > bytes) {
+        head = bytes;
+    }
+    std::memcpy(d, s, head);
+    d += head;
+    s += head;
+    bytes -= head;
+    for (; bytes >= 64; d += 64, s += 64, bytes -= 64) {
+        const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 16));
+        const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 32));
+        const __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i *>(d), v0);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(d + 16), v1);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(d + 32), v2);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(d + 48), v3);
+    }
+    for (; bytes >= 16; d += 16, s += 16, bytes -= 16) {
+        _mm_stream_si128(reinterpret_cast<__m128i *>(d), _mm_loadu_si128(reinterpret_cast<const __m128i *>(s)));
+    }
+    std::memcpy(d, s, bytes);
+#else
+    // No portable non-temporal store here; a plain copy is still correct.
+    std::memcpy(dst, src, bytes);
+#endif
+}
+
+// Orders the streaming stores before any later store (e.g. a completion flag).
+inline void StreamFence() noexcept
+{
+#if defined(__SSE2__)
+    _mm_sfence();
+#endif
+}
+
+// CopyRuns with non-temporal stores to dst.
+template <typename DstT, typename SrcT>
+inline void StreamRuns(DstT *dst, std::size_t dstStride, const SrcT *src, std::size_t srcStride, std::size_t runs,
+    std::size_t len) noexcept
+{
+    static_assert(sizeof(DstT) == sizeof(SrcT), "StreamRuns copies bit patterns between same-sized types");
+    if (runs == 0 || len == 0) {
+        return;
+    }
+    if (dstStride == len && srcStride == len) {
+        StreamCopyBytes(dst, src, runs * len * sizeof(DstT));
+    } else {
+        for (std::size_t i = 0; i < runs; ++i) {
+            StreamCopyBytes(dst + i * dstStride, src + i * srcStride, len * sizeof(DstT));
+        }
+    }
+    StreamFence();
+}
+
+inline bool UseStreamingStore(std::size_t bytes) noexcept
+{
+    return PTO_CPU_STREAM_STORE_BYTES != 0 && bytes >= static_cast<std::size_t>(PTO_CPU_STREAM_STORE_BYTES);
+}
+
+} // namespace pto::cpu
+
+#endif
@@ -0,0 +1,211 @@
+/**
+Copyright (c) 2025 Huawei Technologies Co., Ltd.
+This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+CANN Open Software License Agreement Version 2.0 (the "License").
+Please refer to the License for details. You may not use this file except in compliance with the License.
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+See LICENSE in the root of the software repository for the full text of the License.
+*/
+
+#ifndef PTO_CPU_GATHER_HPP
+#define PTO_CPU_GATHER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "pto/cpu/parallel.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// How many elements ahead MGATHER prefetches base[idx]; 0 disables prefetching.
+// A bare gather loop already keeps many independent misses in flight, so the
+// prefetches only pay off when the surrounding kernel is compute-heavy (try 16-32).
+#ifndef PTO_CPU_GATHER_PREFETCH_DISTANCE
+#define PTO_CPU_GATHER_PREFETCH_DISTANCE 0u
+#endif
+
+// Destination-range buckets per thread used by the parallel MSCATTER.
+#ifndef PTO_CPU_SCATTER_BUCKETS_PER_THREAD
+#define PTO_CPU_SCATTER_BUCKETS_PER_THREAD 4u
+#endif
+
+namespace pto::cpu {
+
+template <typename IndexT>
+inline bool GatherIndexInBounds(IndexT raw, std::size_t limit) noexcept
+{
+    if constexpr (std::is_signed_v<IndexT>) {
+        if (raw < 0) {
+            return false;
+        }
+    }
+    return static_cast<std::size_t>(raw) < limit;
+}
+
+#if defined(__AVX2__)
+// Hardware gather of 32-bit elements through 32-bit indices. Returns how many
+// leading elements were produced; the caller finishes the tail. Unsigned
+// indices with the top bit set do not fit the signed gather offset and are left
+// to the scalar path (unbounded) or treated as out of range (bounded).
+template <bool Bounded, bool SignedIndex>
+inline std::size_t GatherRun32Simd(int32_t *dst, const int32_t *base, const int32_t *idx, std::size_t n,
+    std::size_t limit) noexcept
+{
+    const int32_t limit32 = static_cast<int32_t>(std::min<std::size_t>(limit, std::numeric_limits<int32_t>::max()));
+    std::size_t j = 0;
+#if defined(__AVX512F__)
+    constexpr std::size_t kLanes = 16;
+    const __m512i limitV = _mm512_set1_epi32(limit32);
+    for (; j + kLanes <= n; j += kLanes) {
+        const __m512i vi = _mm512_loadu_si512(idx + j);
+        __m512i v;
+        if constexpr (Bounded) {
+            const __mmask16 ok = _mm512_cmplt_epi32_mask(vi, limitV) & _mm512_cmpge_epi32_mask(vi, _mm512_setzero_si512());
+            v = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), ok, vi, base, 4);
+        } else {
+            if constexpr (!SignedIndex) {
+                if (_mm512_cmplt_epi32_mask(vi, _mm512_setzero_si512()) != 0) {
+                    break;
+                }
+            }
+            v = _mm512_i32gather_epi32(vi, base, 4);
+        }
+        _mm512_storeu_si512(dst + j, v);
+    }
+#else
+    constexpr std::size_t kLanes = 8;
+    const __m256i limitV = _mm256_set1_epi32(limit32);
+    for (; j + kLanes <= n; j += kLanes) {
+        const __m256i vi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(idx + j));
+        __m256i v;
+        if constexpr (Bounded) {
+            const __m256i ok = _mm256_and_si256(_mm256_cmpgt_epi32(limitV, vi),
+                _mm256_cmpgt_epi32(vi, _mm256_set1_epi32(-1)));
+            v = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), base, vi, ok, 4);
+        } else {
+            if constexpr (!SignedIndex) {
+                if (_mm256_movemask_ps(_mm256_castsi256_ps(vi)) != 0) {
+                    break;
+                }
+            }
+            v = _mm256_i32gather_epi32(base, vi, 4);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + j), v);
+    }
+#endif
+    return j;
+}
+#endif
+
+// dst[j] = base[idx[j]] for j in [0, n). With Bounded, indices outside
+// [0, limit) produce zero instead of being read.
+//
+// 32-bit data with 32-bit indices uses AVX2/AVX-512 gathers. x86 has no 16-bit
+// gather and NEON has no gather at all, so the remaining cases (and the tail)
+// run a scalar loop that the compiler packs into vector lanes where it can.
+// Unbounded gathers (GM) prefetch PTO_CPU_GATHER_PREFETCH_DISTANCE elements ahead.
+template <bool Bounded, typename DstT, typename SrcT, typename IndexT>
+inline void GatherRun(DstT *dst, const SrcT *base, const IndexT *idx, std::size_t n, std::size_t limit = 0) noexcept
+{
+    static_assert(sizeof(DstT) == sizeof(SrcT), "GatherRun copies same-sized elements");
+    std::size_t j = 0;
+#if defined(__AVX2__)
+    if constexpr (sizeof(DstT) == 4 && sizeof(IndexT) == 4 && std::is_integral_v<IndexT> &&
+                  (Bounded || PTO_CPU_GATHER_PREFETCH_DISTANCE == 0)) {
+        const std::size_t done = GatherRun32Simd<Bounded, std::is_signed_v<IndexT>>(reinterpret_cast<int32_t *>(dst),
+            reinterpret_cast<const int32_t *>(base), reinterpret_cast<const int32_t *>(idx), n, limit);
+        dst += done;
+        idx += done;
+        n -= done;
+    } else if constexpr (sizeof(DstT) == 4 && sizeof(IndexT) == 4 && std::is_integral_v<IndexT>) {
+        // Interleave prefetching with the vector gather one block at a time.
+        constexpr std::size_t kBlock = 64;
+        constexpr std::size_t kDist = PTO_CPU_GATHER_PREFETCH_DISTANCE;
+        while (j < n) {
+            const std::size_t e = std::min(n, j + kBlock);
+            for (std::size_t p = j + kDist; p < std::min(n, e + kDist); ++p) {
+                __builtin_prefetch(base + static_cast<std::size_t>(idx[p]), 0, 3);
+            }
+            const std::size_t done = GatherRun32Simd<false, std::is_signed_v<IndexT>>(
+                reinterpret_cast<int32_t *>(dst + j), reinterpret_cast<const int32_t *>(base),
+                reinterpret_cast<const int32_t *>(idx + j), e - j, limit);
+            for (std::size_t k = j + done; k < e; ++k) {
+                dst[k] = base[static_cast<std::size_t>(idx[k])];
+            }
+            j = e;
+        }
+        return;
+    }
+#endif
+    for (; j < n; ++j) {
+        if constexpr (Bounded) {
+            dst[j] = GatherIndexInBounds(idx[j], limit) ? base[static_cast<std::size_t>(idx[j])] : DstT(0);
+        } else {
+            if constexpr (PTO_CPU_GATHER_PREFETCH_DISTANCE != 0) {
+                if (j + PTO_CPU_GATHER_PREFETCH_DISTANCE < n) {
+                    __builtin_prefetch(base + static_cast<std::size_t>(idx[j + PTO_CPU_GATHER_PREFETCH_DISTANCE]), 0, 3);
+                }
+            }
+            dst[j] = base[static_cast<std::size_t>(idx[j])];
+        }
+    }
+}
+
+// Scatters n elements with a store that must observe source order for repeated
+// indices. Above the parallel threshold the elements are bucketed by
+// destination range (a stable counting sort on idx), and whole buckets are
+// written by different threads: no two threads touch the same address and
+// duplicates inside a bucket keep their original order (last writer wins).
+// index(k) returns the destination element of element k; store(k, dst) writes it.
+template <typename IndexFn, typename StoreFn>
+inline void ScatterByDestination(std::size_t n, IndexFn index, StoreFn store)
+{
+    const unsigned threads = get_thread_count();
+    if (n < static_cast<std::size_t>(PTO_CPU_PARALLEL_THRESHOLD_ELEMS) || threads <= 1 ||
+        n > std::numeric_limits<uint32_t>::max()) {
+        for (std::size_t k = 0; k < n; ++k) {
+            store(k, index(k));
+        }
+        return;
+    }
+
+    std::size_t lo = std::numeric_limits<std::size_t>::max();
+    std::size_t hi = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+        const std::size_t d = index(k);
+        lo = std::min(lo, d);
+        hi = std::max(hi, d);
+    }
+    const std::size_t buckets = static_cast<std::size_t>(threads) * PTO_CPU_SCATTER_BUCKETS_PER_THREAD;
+    const std::size_t width = (hi - lo) / buckets + 1;
+
+    std::vector<uint32_t> start(buckets + 1, 0);
+    for (std::size_t k = 0; k < n; ++k) {
+        ++start[(index(k) - lo) / width + 1];
+    }
+    for (std::size_t b = 0; b < buckets; ++b) {
+        start[b + 1] += start[b];
+    }
+    std::vector<uint32_t> order(n);
+    std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+    for (std::size_t k = 0; k < n; ++k) {
+        order[fill[(index(k) - lo) / width]++] = static_cast<uint32_t>(k);
+    }
+
+    parallel_for_1d(0, buckets, n, [&](std::size_t b) {
+        for (uint32_t p = start[b]; p < start[b + 1]; ++p) {
+            store(order[p], index(order[p]));
+        }
+    });
+}
+
+} // namespace pto::cpu
+
+#endif
@@ -40,14 +40,18 @@ namespace pto::cpu {
 
 inline unsigned get_thread_count() noexcept
 {
-    unsigned hw = std::thread::hardware_concurrency();
-    if (hw == 0) {
-        hw = 1;
-    }
-    if constexpr (PTO_CPU_MAX_THREADS != 0u) {
-        hw = std::min<unsigned>(hw, PTO_CPU_MAX_THREADS);
-    }
-    return std::max<unsigned>(1, hw);
+    // hardware_concurrency() reads sysfs on every call; query it once.
+    static const unsigned count = []() noexcept {
+        unsigned hw = std::thread::hardware_concurrency();
+        if (hw == 0) {
+            hw = 1;
+        }
+        if constexpr (PTO_CPU_MAX_THREADS != 0u) {
+            hw = std::min<unsigned>(hw, PTO_CPU_MAX_THREADS);
+        }
+        return std::max<unsigned>(1, hw);
+    }();
+    return count;
 }
 
 template <typename Fn>
@@ -0,0 +1,181 @@
+/**
+Copyright (c) 2025 Huawei Technologies Co., Ltd.
+This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+CANN Open Software License Agreement Version 2.0 (the "License").
+Please refer to the License for details. You may not use this file except in compliance with the License.
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+See LICENSE in the root of the software repository for the full text of the License.
+*/
+
+#ifndef PTO_CPU_REDUCE_HPP
+#define PTO_CPU_REDUCE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+#include "pto/cpu/parallel.hpp"
+#include "pto/cpu/simd.hpp"
+
+// Number of independent SIMD accumulators used by row reductions (and column
+// vectors per strip in column reductions). More accumulators hide the add/max
+// latency; 4..8 saturates current cores.
+#ifndef PTO_CPU_REDUCE_ACCUMULATORS
+#define PTO_CPU_REDUCE_ACCUMULATORS 8u
+#endif
+
+// Define PTO_CPU_DETERMINISTIC_REDUCE to make row sums accumulate strictly left
+// to right, bit-identical to a scalar reference. The multi-accumulator path is
+// reproducible run to run, but associates differently. Max/min and column
+// reductions are order-exact either way.
+
+// Columns per parallel task in column reductions.
+#ifndef PTO_CPU_COL_REDUCE_BLOCK
+#define PTO_CPU_COL_REDUCE_BLOCK 256u
+#endif
+
+namespace pto::cpu {
+
+enum class ReduceKind { Sum, Max, Min };
+
+template <ReduceKind Kind>
+inline float ReduceIdentityF32() noexcept
+{
+    if constexpr (Kind == ReduceKind::Sum) {
+        return 0.0f;
+    } else if constexpr (Kind == ReduceKind::Max) {
+        return -std::numeric_limits<float>::infinity();
+    } else {
+        return std::numeric_limits<float>::infinity();
+    }
+}
+
+template <ReduceKind Kind, typename T>
+inline T ReduceCombine(T a, T b) noexcept
+{
+    if constexpr (Kind == ReduceKind::Sum) {
+        return a + b;
+    } else if constexpr (Kind == ReduceKind::Max) {
+        return a < b ? b : a;
+    } else {
+        return b < a ? b : a;
+    }
+}
+
+template <ReduceKind Kind>
+inline float ReduceLanes(VecF32 v) noexcept
+{
+    float r = v[0];
+    for (std::size_t l = 1; l < kVecF32Lanes; ++l) {
+        r = ReduceCombine<Kind>(r, v[l]);
+    }
+    return r;
+}
+
+// Reduces n contiguous elements to one float32 value.
+template <ReduceKind Kind, typename SrcT>
+inline float ReduceContiguousF32(const SrcT *p, std::size_t n) noexcept
+{
+    static_assert(is_simd_f32_source_v<SrcT>, "ReduceContiguousF32 expects float or half input");
+    constexpr std::size_t kAcc = PTO_CPU_REDUCE_ACCUMULATORS;
+    static_assert(kAcc >= 1 && kAcc <= 16 && (kAcc & (kAcc - 1)) == 0,
+        "PTO_CPU_REDUCE_ACCUMULATORS must be a power of two in [1, 16]");
+#ifdef PTO_CPU_DETERMINISTIC_REDUCE
+    if constexpr (Kind == ReduceKind::Sum) {
+        float r = 0.0f;
+        for (std::size_t j = 0; j < n; ++j) {
+            r += static_cast<float>(p[j]);
+        }
+        return r;
+    }
+#endif
+    constexpr std::size_t kStep = kAcc * kVecF32Lanes;
+    const VecF32 identity = BroadcastF32(ReduceIdentityF32<Kind>());
+    VecF32 acc[kAcc];
+    for (std::size_t k = 0; k < kAcc; ++k) {
+        acc[k] = identity;
+    }
+
+    std::size_t j = 0;
+    for (; j + kStep <= n; j += kStep) {
+        for (std::size_t k = 0; k < kAcc; ++k) {
+            acc[k] = ReduceCombine<Kind>(acc[k], LoadAsF32(p + j + k * kVecF32Lanes));
+        }
+    }
+    for (; j + kVecF32Lanes <= n; j += kVecF32Lanes) {
+        acc[0] = ReduceCombine<Kind>(acc[0], LoadAsF32(p + j));
+    }
+    // Fixed pairwise tree keeps the association independent of n and threads.
+    for (std::size_t width = kAcc / 2; width > 0; width /= 2) {
+        for (std::size_t k = 0; k < width; ++k) {
+            acc[k] = ReduceCombine<Kind>(acc[k], acc[k + width]);
+        }
+    }
+    float r = ReduceLanes<Kind>(acc[0]);
+    for (; j < n; ++j) {
+        r = ReduceCombine<Kind>(r, static_cast<float>(p[j]));
+    }
+    return r;
+}
+
+// Sweeps all rows of a strip of Vecs column vectors; the accumulators stay in
+// registers and every column accumulates in row order (order-exact).
+template <ReduceKind Kind, std::size_t Vecs, typename SrcT, typename DstT>
+inline void ReduceColumnStripF32(DstT *out, std::size_t outStride, const SrcT *src, std::size_t srcRowStride,
+    std::size_t rows) noexcept
+{
+    VecF32 acc[Vecs];
+    for (std::size_t k = 0; k < Vecs; ++k) {
+        acc[k] = LoadAsF32(src + k * kVecF32Lanes);
+    }
+    for (std::size_t i = 1; i < rows; ++i) {
+        const SrcT *row = src + i * srcRowStride;
+        for (std::size_t k = 0; k < Vecs; ++k) {
+            acc[k] = ReduceCombine<Kind>(acc[k], LoadAsF32(row + k * kVecF32Lanes));
+        }
+    }
+    for (std::size_t c = 0; c < Vecs * kVecF32Lanes; ++c) {
+        out[c * outStride] = static_cast<DstT>(acc[c / kVecF32Lanes][c % kVecF32Lanes]);
+    }
+}
+
+// Reduces rows [0, rows) of a row-major matrix column-wise into out[0, cols).
+// Column blocks are distributed over threads; inside a block the rows are swept
+// with register-resident column vectors instead of walking down each column.
+template <ReduceKind Kind, typename SrcT, typename DstT>
+inline void ReduceColumnsF32(DstT *out, std::size_t outStride, const SrcT *src, std::size_t srcRowStride,
+    std::size_t rows, std::size_t cols)
+{
+    static_assert(is_simd_f32_source_v<SrcT>, "ReduceColumnsF32 expects float or half input");
+    constexpr std::size_t kBlock = PTO_CPU_COL_REDUCE_BLOCK;
+    constexpr std::size_t kStripVecs = PTO_CPU_REDUCE_ACCUMULATORS;
+    constexpr std::size_t kStrip = kStripVecs * kVecF32Lanes;
+    static_assert(kBlock % kVecF32Lanes == 0, "PTO_CPU_COL_REDUCE_BLOCK must be a multiple of the SIMD width");
+    if (rows == 0 || cols == 0) {
+        return;
+    }
+    const std::size_t blocks = (cols + kBlock - 1) / kBlock;
+    parallel_for_1d(0, blocks, rows * cols, [&](std::size_t b) {
+        const std::size_t c0 = b * kBlock;
+        const std::size_t c1 = std::min(cols, c0 + kBlock);
+        std::size_t c = c0;
+        for (; c + kStrip <= c1; c += kStrip) {
+            ReduceColumnStripF32<Kind, kStripVecs>(out + c * outStride, outStride, src + c, srcRowStride, rows);
+        }
+        for (; c + kVecF32Lanes <= c1; c += kVecF32Lanes) {
+            ReduceColumnStripF32<Kind, 1>(out + c * outStride, outStride, src + c, srcRowStride, rows);
+        }
+        for (; c < c1; ++c) {
+            float r = static_cast<float>(src[c]);
+            for (std::size_t i = 1; i < rows; ++i) {
+                r = ReduceCombine<Kind>(r, static_cast<float>(src[i * srcRowStride + c]));
+            }
+            out[c * outStride] = static_cast<DstT>(r);
+        }
+    });
+}
+
+} // namespace pto::cpu
+
+#endif
@@ -0,0 +1,84 @@
+/**
+Copyright (c) 2025 Huawei Technologies Co., Ltd.
+This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+CANN Open Software License Agreement Version 2.0 (the "License").
+Please refer to the License for details. You may not use this file except in compliance with the License.
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+See LICENSE in the root of the software repository for the full text of the License.
+*/
+
+#ifndef PTO_CPU_SIMD_HPP
+#define PTO_CPU_SIMD_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <pto/common/type.hpp>
+
+// Width (in bytes) of the portable SIMD vectors used by the CPU kernels.
+// Defaults to the widest register the target enables (AVX-512/AVX/SSE/NEON),
+// so vector arguments never cross an ABI boundary the target cannot hold.
+#ifndef PTO_CPU_SIMD_BYTES
+#if defined(__AVX512F__)
+#define PTO_CPU_SIMD_BYTES 64u
+#elif defined(__AVX__)
+#define PTO_CPU_SIMD_BYTES 32u
+#else
+#define PTO_CPU_SIMD_BYTES 16u
+#endif
+#endif
+
+namespace pto::cpu {
+
+// GCC/Clang vector extensions: lowered to SSE/AVX/NEON/SVE by the compiler, so
+// the kernels stay free of target-specific intrinsics.
+typedef float VecF32 __attribute__((vector_size(PTO_CPU_SIMD_BYTES)));
+
+constexpr std::size_t kVecF32Lanes = PTO_CPU_SIMD_BYTES / sizeof(float);
+
+// Element types that the float32 SIMD kernels can widen from without loss.
+template <typename T>
+constexpr bool is_simd_f32_source_v =
+    std::is_same_v<std::remove_cv_t<T>, float> || std::is_same_v<std::remove_cv_t<T>, half>;
+
+inline VecF32 BroadcastF32(float v) noexcept
+{
+    VecF32 r;
+    for (std::size_t l = 0; l < kVecF32Lanes; ++l) {
+        r[l] = v;
+    }
+    return r;
+}
+
+// Unaligned load of kVecF32Lanes elements, widened to float32.
+template <typename T>
+inline VecF32 LoadAsF32(const T *p) noexcept
+{
+    VecF32 r;
+    if constexpr (std::is_same_v<std::remove_cv_t<T>, float>) {
+        std::memcpy(&r, p, sizeof(r));
+    } else {
+        for (std::size_t l = 0; l < kVecF32Lanes; ++l) {
+            r[l] = static_cast<float>(p[l]);
+        }
+    }
+    return r;
+}
+
+// Unaligned store of kVecF32Lanes elements, narrowed from float32.
+template <typename T>
+inline void StoreFromF32(T *p, VecF32 v) noexcept
+{
+    if constexpr (std::is_same_v<std::remove_cv_t<T>, float>) {
+        std::memcpy(p, &v, sizeof(v));
+    } else {
+        for (std::size_t l = 0; l < kVecF32Lanes; ++l) {
+            p[l] = static_cast<T>(v[l]);
+        }
+    }
+}
+
+} // namespace pto::cpu
+
+#endif
@@ -0,0 +1,164 @@
+/**
+Copyright (c) 2025 Huawei Technologies Co., Ltd.
+This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+CANN Open Software License Agreement Version 2.0 (the "License").
+Please refer to the License for details. You may not use this file except in compliance with the License.
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+See LICENSE in the root of the software repository for the full text of the License.
+*/
+
+#ifndef PTO_CPU_TILE_FIFO_HPP
+#define PTO_CPU_TILE_FIFO_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// CPU model of the cross-core tile FIFO behind TPUSH/TPOP, used when
+// PTO_CPU_TPUSH_FIFO is defined (see TPushPop.hpp).
+//
+// Each (block, token) pair names one lock-free single-producer/single-consumer
+// ring of tile payloads. Keying by block keeps the cube/vector pair of one
+// block from sharing a ring with another block that uses the same event id.
+//
+// Push() waits while the ring is full and Pop() while it is empty, yielding
+// to the other side, as TPUSH/TPOP do when cube and vector cores run
+// concurrently. TryPush()/TryPop() never wait.
+//
+// When the simulator runs blocks one after another on a single thread, a full
+// ring at TPUSH or an empty one at TPOP can never make progress. Define
+// PTO_CPU_TILE_FIFO_NO_WAIT to have Push()/Pop() throw std::runtime_error in
+// that case instead of hanging.
+
+// Slots per ring; a producer can run at most this many tiles ahead of its consumer.
+#ifndef PTO_CPU_TILE_FIFO_DEPTH
+#define PTO_CPU_TILE_FIFO_DEPTH 4u
+#endif
+
+namespace pto::cpu {
+
+class TileFifo {
+public:
+    static constexpr std::size_t kDepth = PTO_CPU_TILE_FIFO_DEPTH;
+    static_assert(kDepth >= 1, "PTO_CPU_TILE_FIFO_DEPTH must be at least 1");
+
+    TileFifo(uint32_t block, uint16_t token) : block_(block), token_(token) {}
+
+    // Producer side. A slot is owned by the producer until tail_ publishes it,
+    // so it can be (re)sized without synchronizing with the consumer.
+    bool TryPush(const void *data, std::size_t bytes)
+    {
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == kDepth) {
+            return false;
+        }
+        Slot &slot = slots_[tail % kDepth];
+        if (slot.capacity < bytes) {
+            slot.data.reset(new unsigned char[bytes]);
+            slot.capacity = bytes;
+        }
+        std::memcpy(slot.data.get(), data, bytes);
+        slot.bytes = bytes;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    void Push(const void *data, std::size_t bytes)
+    {
+        while (!TryPush(data, bytes)) {
+#ifdef PTO_CPU_TILE_FIFO_NO_WAIT
+            Fail("TPUSH", "full: more than " + std::to_string(kDepth) + " tiles pushed before a TPOP");
+#else
+            std::this_thread::yield();
+#endif
+        }
+    }
+
+    // Consumer side.
+    bool TryPop(void *data, std::size_t bytes)
+    {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        const Slot &slot = slots_[head % kDepth];
+        if (slot.bytes != bytes) {
+            Fail("TPOP", "holding a " + std::to_string(slot.bytes) + "-byte tile, popped as " +
+                             std::to_string(bytes) + " bytes");
+        }
+        std::memcpy(data, slot.data.get(), bytes);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    void Pop(void *data, std::size_t bytes)
+    {
+        while (!TryPop(data, bytes)) {
+#ifdef PTO_CPU_TILE_FIFO_NO_WAIT
+            Fail("TPOP", "empty: no tile was pushed with this token");
+#else
+            std::this_thread::yield();
+#endif
+        }
+    }
+
+    std::size_t Size() const noexcept
+    {
+        return static_cast<std::size_t>(tail_.load(std::memory_order_acquire) -
+                                        head_.load(std::memory_order_acquire));
+    }
+
+private:
+    struct Slot {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t capacity = 0;
+        std::size_t bytes = 0;
+    };
+
+    [[noreturn]] void Fail(const char *op, const std::string &what) const
+    {
+        throw std::runtime_error(std::string("[PTO][CPU] ") + op + ": tile FIFO of block " +
+                                 std::to_string(block_) + " token " + std::to_string(token_) + " is " + what);
+    }
+
+    const uint32_t block_;
+    const uint16_t token_;
+    // Separate cache lines so producer and consumer do not false-share.
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    Slot slots_[kDepth];
+};
+
+// Rings are created on first use and live for the whole process, so a
+// (block, token) pair can be used from any thread without registration.
+// Only a thread's first use of a pair takes the registry lock; after that
+// the ring comes from the thread's own cache.
+inline TileFifo &TileFifoFor(uint32_t block, uint16_t token)
+{
+    const uint64_t key = (static_cast<uint64_t>(block) << 16) | token;
+    thread_local std::unordered_map<uint64_t, TileFifo *> cache;
+    TileFifo *&cached = cache[key];
+    if (cached == nullptr) {
+        static std::mutex mutex;
+        static std::unordered_map<uint64_t, std::unique_ptr<TileFifo>> fifos;
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unique_ptr<TileFifo> &fifo = fifos[key];
+        if (!fifo) {
+            fifo = std::make_unique<TileFifo>(block, token);
+        }
+        cached = fifo.get();
+    }
+    return *cached;
+}
+
+} // namespace pto::cpu
+
+#endif
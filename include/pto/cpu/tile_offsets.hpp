@@ -31,7 +31,7 @@ namespace pto {
             return subTileR*TileData::Cols*TileData::InnerRows +
                 subTileC*TileData::InnerNumel + innerR*TileData::InnerCols + innerC;
         } else {
-            static_assert(false, "Invalid layout");
+            static_assert(sizeof(TileData) == 0, "Invalid layout");
         }
     }
 
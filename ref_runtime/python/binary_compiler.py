@@ -3,6 +3,7 @@ import subprocess
 import tempfile
 from pathlib import Path
 from typing import List, Optional, Union
+from kernel_cache import KernelCache
 from toolchain import AICoreToolchain, AICPUToolchain, HostToolchain
 
 
@@ -15,6 +16,10 @@ class BinaryCompiler:
     1. aicore - AICore accelerator kernels (Bisheng CCE)
     2. aicpu - AICPU device task scheduler (aarch64 cross-compiler)
     3. host - Host executables (standard C/C++ compiler)
+
+    Builds are cached on disk (see kernel_cache.py): a build whose sources,
+    include trees, CMake arguments and compiler versions match an earlier one
+    returns the stored binary without running CMake.
     """
     _instance = None
     _initialized = False
@@ -190,17 +195,52 @@ class BinaryCompiler:
             RuntimeError: If CMake or Make fails
             FileNotFoundError: If output binary not found
         """
-        if target_platform == "aicore":
-            return self._compile_aicore(include_dirs, source_dirs)
-        elif target_platform == "aicpu":
-            return self._compile_aicpu(include_dirs, source_dirs)
-        elif target_platform == "host":
-            return self._compile_host(include_dirs, source_dirs)
-        else:
+        toolchains = {
+            "aicore": (self.aicore_toolchain, self._compile_aicore),
+            "aicpu": (self.aicpu_toolchain, self._compile_aicpu),
+            "host": (self.host_toolchain, self._compile_host),
+        }
+        if target_platform not in toolchains:
             raise ValueError(
                 f"Invalid target platform: {target_platform}. "
                 "Must be 'aicore', 'aicpu', or 'host'."
             )
+        toolchain, build = toolchains[target_platform]
+
+        cache = KernelCache.default()
+        key = self._cache_key(cache, target_platform, toolchain, include_dirs, source_dirs)
+        hits = cache.hits
+        binary_data = cache.get_or_build(key, lambda: build(include_dirs, source_dirs))
+        if cache.enabled and cache.hits > hits:
+            print(f"[{target_platform}] Binary cache hit ({key[:16]}), skipping CMake build")
+        return binary_data
+
+    @staticmethod
+    def _cache_key(
+        cache: KernelCache,
+        target_platform: str,
+        toolchain: Union[AICoreToolchain, AICPUToolchain, HostToolchain],
+        include_dirs: List[str],
+        source_dirs: List[str],
+    ) -> str:
+        """
+        Cache key of one build: CMake arguments, compiler versions and the
+        contents of the platform tree (all of src/platform/a2a3, since the
+        per-target CMakeLists pull in ../common), include and source dirs.
+        """
+        if not cache.enabled:
+            return ""
+        tools = [getattr(toolchain, name) for name in ("cc", "cxx", "ld") if getattr(toolchain, name, None)]
+        tools.append("cmake")
+        trees = [str(Path(toolchain.get_root_dir()).parent)]
+        trees += [os.path.abspath(d) for d in include_dirs]
+        trees += [os.path.abspath(d) for d in source_dirs]
+        parts = [
+            target_platform,
+            toolchain.get_binary_name(),
+            toolchain.gen_cmake_args(include_dirs, source_dirs),
+        ]
+        return cache.make_key(parts, trees, tools)
 
     def _compile_aicore(self, include_dirs: List[str], source_dirs: List[str]) -> bytes:
         """Compile AICore kernel."""
@@ -0,0 +1,364 @@
+"""
+On-disk cache for compiled binaries.
+
+Python counterpart of src/platform/a2a3/host/kernel_cache.h. Both use the same
+directory, layout and environment variables, so one size limit and one LRU
+order cover runtime binaries and kernels:
+
+- layout: ``<dir>/<key[0:2]>/<key>.bin``, published with an atomic rename
+- a per-key ``.lock`` file (``fcntl.flock``) serializes builds of the same
+  key across processes; readers take no lock
+- lookups refresh the entry mtime; the least recently used entries are
+  evicted once the cache exceeds its size limit
+
+Environment:
+
+- ``PTO_KERNEL_CACHE=0``: disable the cache
+- ``PTO_KERNEL_CACHE_DIR``: cache directory (default
+  ``$XDG_CACHE_HOME/pto-isa/kernels`` or ``~/.cache/pto-isa/kernels``)
+- ``PTO_KERNEL_CACHE_MAX_MB``: size limit in MiB (default 2048)
+"""
+
+import fcntl
+import hashlib
+import os
+import subprocess
+import tempfile
+import time
+from pathlib import Path
+from typing import Callable, Dict, Iterable, List, Optional
+
+# Bump when the key derivation or entry format changes.
+KEY_VERSION = "pto-binary-cache-v1"
+
+_ENTRY_SUFFIX = ".bin"
+_LOCK_SUFFIX = ".lock"
+_TEMP_PREFIX = ".tmp."
+# Temp and lock files older than this are leftovers of killed processes.
+_STALE_SECONDS = 3600
+
+# Files whose contents feed a build. Everything else in a source tree
+# (docs, caches, build outputs) is ignored.
+_SOURCE_SUFFIXES = {".c", ".cc", ".cpp", ".cxx", ".h", ".hh", ".hpp", ".hxx", ".inc", ".cmake", ".txt", ".ld"}
+
+
+def _names_file(path: Path, fd: int) -> bool:
+    """True if path still names the open file fd (it was not unlinked or replaced)."""
+    try:
+        held = os.fstat(fd)
+        named = os.stat(path)
+    except OSError:
+        return False
+    return held.st_dev == named.st_dev and held.st_ino == named.st_ino
+
+
+def _lock_key_file(lock_path: Path):
+    """
+    Open and exclusively lock a key's lock file; None if that is not possible.
+
+    _evict() may unlink a stale lock file while we wait for it, so the lock
+    only counts if the path still names the locked file; otherwise retry on
+    the new one.
+    """
+    for _ in range(8):
+        try:
+            lock_file = open(lock_path, "a+b")
+        except OSError:
+            return None
+        try:
+            fcntl.flock(lock_file.fileno(), fcntl.LOCK_EX)
+        except OSError:
+            lock_file.close()
+            return None
+        if _names_file(lock_path, lock_file.fileno()):
+            return lock_file
+        fcntl.flock(lock_file.fileno(), fcntl.LOCK_UN)
+        lock_file.close()
+    return None
+
+
+def _remove_unheld_lock_file(lock_path: Path) -> None:
+    """
+    Remove a lock file nobody holds or waits for. Holding its lock keeps
+    _lock_key_file() callers from taking the file we are about to unlink.
+    """
+    try:
+        fd = os.open(lock_path, os.O_RDWR | os.O_CLOEXEC)
+    except OSError:
+        return
+    try:
+        fcntl.flock(fd, fcntl.LOCK_EX | fcntl.LOCK_NB)
+    except OSError:
+        os.close(fd)
+        return
+    try:
+        if _names_file(lock_path, fd):
+            os.unlink(lock_path)
+    except OSError:
+        pass
+    finally:
+        fcntl.flock(fd, fcntl.LOCK_UN)
+        os.close(fd)
+
+
+class KernelCache:
+    """
+    Content-addressed store for compiled binaries.
+
+    Usage:
+        cache = KernelCache.default()
+        key = cache.make_key(["aicpu", cmake_args], [src_dir], [cc_path])
+        data = cache.get_or_build(key, lambda: build())
+    """
+
+    _default: Optional["KernelCache"] = None
+
+    def __init__(self, cache_dir: Optional[str], max_bytes: int = 0):
+        """
+        Args:
+            cache_dir: Cache directory (created on demand); None disables the cache
+            max_bytes: Size limit for all entries; 0 means unlimited
+        """
+        self.cache_dir = Path(cache_dir) if cache_dir else None
+        self.max_bytes = max_bytes
+        self.hits = 0
+        self.misses = 0
+        self.stores = 0
+        self.evictions = 0
+        self._file_digests: Dict[str, tuple] = {}
+        self._tool_versions: Dict[str, str] = {}
+
+    @classmethod
+    def default(cls) -> "KernelCache":
+        """Process-wide cache configured from the environment."""
+        if cls._default is None:
+            if os.getenv("PTO_KERNEL_CACHE", "").strip().lower() in ("0", "off"):
+                cls._default = cls(None)
+            else:
+                cache_dir = os.getenv("PTO_KERNEL_CACHE_DIR", "").strip()
+                if not cache_dir:
+                    xdg = os.getenv("XDG_CACHE_HOME", "").strip()
+                    base = Path(xdg) if xdg else Path.home() / ".cache"
+                    cache_dir = str(base / "pto-isa" / "kernels")
+                max_mb = int(os.getenv("PTO_KERNEL_CACHE_MAX_MB", "2048") or "2048")
+                cls._default = cls(cache_dir, max_mb << 20)
+        return cls._default
+
+    @property
+    def enabled(self) -> bool:
+        return self.cache_dir is not None
+
+    def stats(self) -> Dict[str, int]:
+        """Hit/miss/store/eviction counters of this process."""
+        return {
+            "hits": self.hits,
+            "misses": self.misses,
+            "stores": self.stores,
+            "evictions": self.evictions,
+        }
+
+    # ------------------------------------------------------------------
+    # Keys
+    # ------------------------------------------------------------------
+
+    def _file_digest(self, path: Path) -> str:
+        st = path.stat()
+        memo = self._file_digests.get(str(path))
+        if memo is not None and memo[0] == st.st_mtime_ns and memo[1] == st.st_size:
+            return memo[2]
+        digest = hashlib.sha256(path.read_bytes()).hexdigest()
+        self._file_digests[str(path)] = (st.st_mtime_ns, st.st_size, digest)
+        return digest
+
+    def _tool_version(self, tool: str) -> str:
+        """`<tool> --version` output; a missing tool contributes its name only."""
+        if tool not in self._tool_versions:
+            try:
+                result = subprocess.run([tool, "--version"], capture_output=True, text=True, timeout=30)
+                self._tool_versions[tool] = result.stdout + result.stderr
+            except (OSError, subprocess.SubprocessError):
+                self._tool_versions[tool] = ""
+        return self._tool_versions[tool]
+
+    def make_key(self, parts: Iterable[str], trees: Iterable[str], tools: Iterable[str] = ()) -> str:
+        """
+        Build the cache key of one build.
+
+        Args:
+            parts: Strings that select the build (target, flags, ...)
+            trees: Files or directories whose source files are build inputs
+            tools: Compiler executables, identified by their --version output
+
+        Returns:
+            64-character hex key
+        """
+        h = hashlib.sha256()
+        h.update(KEY_VERSION.encode())
+        for part in parts:
+            h.update(b"\0part\0" + str(part).encode())
+        for tool in tools:
+            h.update(b"\0tool\0" + str(tool).encode() + b"\0" + self._tool_version(str(tool)).encode())
+        for tree in trees:
+            root = Path(tree)
+            if root.is_file():
+                files: List[Path] = [root]
+            elif root.is_dir():
+                files = sorted(
+                    p for p in root.rglob("*")
+                    if p.is_file()
+                    and p.suffix in _SOURCE_SUFFIXES
+                    and not any(part.startswith(".") or part == "__pycache__" for part in p.relative_to(root).parts)
+                )
+            else:
+                files = []
+            h.update(b"\0tree\0" + str(root).encode())
+            for f in files:
+                h.update(b"\0file\0" + str(f.relative_to(root) if f != root else f.name).encode())
+                h.update(self._file_digest(f).encode())
+        return h.hexdigest()
+
+    # ------------------------------------------------------------------
+    # Entries
+    # ------------------------------------------------------------------
+
+    def _entry_path(self, key: str) -> Path:
+        return self.cache_dir / key[:2] / (key + _ENTRY_SUFFIX)
+
+    def _read_entry(self, key: str) -> Optional[bytes]:
+        entry = self._entry_path(key)
+        try:
+            data = entry.read_bytes()
+        except OSError:
+            return None
+        # Zero-length entries can only come from a crash; treat as missing.
+        if not data:
+            return None
+        try:
+            os.utime(entry)  # LRU: a lookup counts as a use
+        except OSError:
+            pass
+        return data
+
+    def get(self, key: str) -> Optional[bytes]:
+        """Return the cached binary for key, or None (counted as a miss)."""
+        if not self.enabled:
+            return None
+        data = self._read_entry(key)
+        if data is None:
+            self.misses += 1
+        else:
+            self.hits += 1
+        return data
+
+    def put(self, key: str, data: bytes) -> bool:
+        """Publish data as the entry for key. Returns False if it could not be written."""
+        if not self.enabled:
+            return False
+        subdir = self.cache_dir / key[:2]
+        try:
+            subdir.mkdir(parents=True, exist_ok=True)
+            fd, tmp = tempfile.mkstemp(prefix=_TEMP_PREFIX, dir=str(subdir))
+            try:
+                with os.fdopen(fd, "wb") as f:
+                    f.write(data)
+                os.replace(tmp, self._entry_path(key))
+            except BaseException:
+                try:
+                    os.unlink(tmp)
+                except OSError:
+                    pass
+                raise
+        except OSError:
+            return False
+        self.stores += 1
+        if self.max_bytes > 0:
+            self._evict(key)
+        return True
+
+    def get_or_build(self, key: str, build: Callable[[], bytes]) -> bytes:
+        """
+        Return the binary for key, calling build() on a miss.
+
+        Processes missing on the same key wait for each other, so only one
+        of them builds.
+        """
+        if not self.enabled:
+            return build()
+        data = self._read_entry(key)
+        if data is not None:
+            self.hits += 1
+            return data
+
+        # Without the lock, build anyway: the atomic rename in put() keeps this safe.
+        lock_file = None
+        subdir = self.cache_dir / key[:2]
+        try:
+            subdir.mkdir(parents=True, exist_ok=True)
+        except OSError:
+            pass
+        else:
+            lock_file = _lock_key_file(subdir / (key + _LOCK_SUFFIX))
+
+        try:
+            data = self._read_entry(key)  # another process may have finished it
+            if data is not None:
+                self.hits += 1
+                return data
+            self.misses += 1
+            data = build()
+            self.put(key, data)
+            return data
+        finally:
+            if lock_file is not None:
+                fcntl.flock(lock_file.fileno(), fcntl.LOCK_UN)
+                lock_file.close()
+
+    def _evict(self, keep_key: str) -> None:
+        keep = self._entry_path(keep_key)
+        now = time.time()
+        entries = []
+        total = 0
+        try:
+            subdirs = [d for d in self.cache_dir.iterdir() if d.is_dir() and not d.name.startswith(".")]
+        except OSError:
+            return
+        for subdir in subdirs:
+            try:
+                names = list(subdir.iterdir())
+            except OSError:
+                continue
+            for path in names:
+                try:
+                    st = path.stat()
+                except OSError:
+                    continue
+                if path.name.startswith(_TEMP_PREFIX):
+                    if now - st.st_mtime > _STALE_SECONDS:
+                        try:
+                            path.unlink()
+                        except OSError:
+                            pass
+                    continue
+                if path.name.endswith(_LOCK_SUFFIX):
+                    # A running build may hold an old lock file; only drop unheld ones.
+                    if now - st.st_mtime > _STALE_SECONDS:
+                        _remove_unheld_lock_file(path)
+                    continue
+                if not path.name.endswith(_ENTRY_SUFFIX):
+                    continue
+                total += st.st_size
+                if path != keep:
+                    entries.append((st.st_mtime_ns, st.st_size, path))
+
+        if total <= self.max_bytes:
+            return
+        entries.sort()
+        for _, size, path in entries:
+            if total <= self.max_bytes:
+                break
+            try:
+                path.unlink()
+                self.evictions += 1  # only count what this process removed
+            except OSError:
+                pass
+            total -= size
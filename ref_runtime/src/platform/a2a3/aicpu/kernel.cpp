@@ -111,12 +111,12 @@ int ShutdownAiCore(void *arg) {
  *   - If task completed (idle + task != 0): update dependencies, clear task
  *   - If core idle and tasks available: dispatch next ready task
  *
- * @param g Task graph containing all tasks and dependencies
+ * @param g CSR task graph image; its scratch area holds the ready queue
  * @param hank Array of handshake buffers (one per core)
  * @param core_num Number of AICore instances available
  * @return Number of tasks completed
  */
-int execute_graph(Graph& g, Handshake* hank, int core_num, int nr_aic) {
+int execute_graph(CsrGraph& g, Handshake* hank, int core_num, int nr_aic) {
     if (nr_aic < 0) {
         nr_aic = 0;
     }
@@ -124,7 +124,7 @@ int execute_graph(Graph& g, Handshake* hank, int core_num, int nr_aic) {
         nr_aic = core_num;
     }
     // Get initially ready tasks from graph
-    int ready_queue[GRAPH_MAX_TASKS];
+    int* ready_queue = g.ready_queue(0);
     int ready_count = g.get_initial_ready_tasks(ready_queue);
 
     int completed = 0;
@@ -148,8 +148,9 @@ int execute_graph(Graph& g, Handshake* hank, int core_num, int nr_aic) {
                 DEV_INFO("  Core %d completed task %d", core_id, task_id);
 
                 // Update fanin of successors
+                const int* fanout = g.fanout(task);
                 for (int i = 0; i < task->fanout_count; i++) {
-                    int dep_id = task->fanout[i];
+                    int dep_id = fanout[i];
                     Task* dep = g.get_task(dep_id);
                     dep->fanin--;
 
@@ -293,7 +294,7 @@ extern "C" __attribute__((visibility("default"))) int DynTileFwkBackendKernelSer
 
     // Step 2: Execute task graph if provided
     if (rtargs->graphArgs != nullptr) {
-        Graph* g = rtargs->graphArgs;
+        CsrGraph* g = rtargs->graphArgs;
         Handshake* hank = reinterpret_cast<Handshake*>(rtargs->hankArgs);
         int core_num = static_cast<int>(rtargs->core_num);
         int nr_aic = static_cast<int>(devArgs->nrAic);
@@ -10,7 +10,7 @@
  * - `DeviceArgs.aicpuSoBin/aicpuSoLen` carries the in-device bytes of the backend server .so
  * - `DeviceArgs.opaque` carries a pointer to `PtoRuntimeArgs` (our own mailbox)
  * - `PtoRuntimeArgs` carries the runtime pointers for the simplified graph scheduler:
- *   handshake array + graph pointer.
+ *   handshake array + CSR graph image pointer.
  */
 
 #ifndef RUNTIME_COMMON_KERNEL_ARGS_H
@@ -18,7 +18,7 @@
 
 #include <cstdint>
 
-class Graph;
+struct CsrGraph;
 struct Handshake;
 
 // Keep these definitions ABI-compatible with the TileFwk layout used by the
@@ -104,7 +104,7 @@ struct DeviceKernelArgs {
 // PTO-ISA runtime mailbox (owned by this repo; stored in DeviceArgs.opaque).
 struct PtoRuntimeArgs {
     Handshake *hankArgs{nullptr};
-    Graph *graphArgs{nullptr};
+    CsrGraph *graphArgs{nullptr};
     int64_t core_num{0};
 };
 
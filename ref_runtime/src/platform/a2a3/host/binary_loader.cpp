@@ -6,10 +6,174 @@
  */
 
 #include "binary_loader.h"
+#include "function_cache.h"
+#include "kernel_cache.h"
 #include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <fstream>
+#include <functional>
 #include <iostream>
-#include <cstring>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+/**
+ * Read-only mapping of one ELF object and the location of its .text section
+ */
+struct MappedObject {
+    void* base{nullptr};
+    size_t length{0};
+    uint64_t textOffset{0};
+    uint64_t textSize{0};
+    std::string error;
+
+    MappedObject() = default;
+    MappedObject(const MappedObject&) = delete;
+    MappedObject& operator=(const MappedObject&) = delete;
+    ~MappedObject() {
+        if (base != nullptr) {
+            munmap(base, length);
+        }
+    }
+
+    const uint8_t* Text() const { return static_cast<const uint8_t*>(base) + textOffset; }
+};
+
+/**
+ * mmap an ELF64 object and locate .text, checking every offset against the file size
+ *
+ * @return true on success; otherwise obj.error describes the problem
+ */
+bool MapElfText(const std::string& binPath, MappedObject& obj) {
+    int fd = open(binPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        obj.error = "Cannot open file: " + binPath;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        obj.error = "File is empty or cannot be read: " + binPath;
+        return false;
+    }
+    obj.length = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, obj.length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // the mapping keeps the file referenced
+    if (base == MAP_FAILED) {
+        obj.error = "Cannot map file: " + binPath;
+        return false;
+    }
+    obj.base = base;
+
+    // Step 1: Parse ELF header
+    const uint8_t* buf = static_cast<const uint8_t*>(base);
+    if (obj.length < sizeof(Elf64_Ehdr)) {
+        obj.error = "File too small for ELF header: " + binPath;
+        return false;
+    }
+    auto elfHeader = reinterpret_cast<const Elf64_Ehdr*>(buf);
+    if (elfHeader->e_ident[EI_MAG0] != ELFMAG0 ||
+        elfHeader->e_ident[EI_MAG1] != ELFMAG1 ||
+        elfHeader->e_ident[EI_MAG2] != ELFMAG2 ||
+        elfHeader->e_ident[EI_MAG3] != ELFMAG3) {
+        obj.error = "Not a valid ELF file: " + binPath;
+        return false;
+    }
+    if (elfHeader->e_ident[EI_CLASS] != ELFCLASS64) {
+        obj.error = "Not a 64-bit ELF file: " + binPath;
+        return false;
+    }
+
+    // Step 2: Get section headers and the section name string table
+    const uint64_t shEnd = elfHeader->e_shoff + static_cast<uint64_t>(elfHeader->e_shnum) * sizeof(Elf64_Shdr);
+    if (elfHeader->e_shoff == 0 || elfHeader->e_shnum == 0 || shEnd > obj.length ||
+        elfHeader->e_shstrndx >= elfHeader->e_shnum) {
+        obj.error = "Invalid section headers in ELF file: " + binPath;
+        return false;
+    }
+    auto sectionHeaders = reinterpret_cast<const Elf64_Shdr*>(buf + elfHeader->e_shoff);
+    const Elf64_Shdr* shstrHeader = &sectionHeaders[elfHeader->e_shstrndx];
+    if (shstrHeader->sh_offset + shstrHeader->sh_size > obj.length) {
+        obj.error = "Invalid section name table in ELF file: " + binPath;
+        return false;
+    }
+    const char* strtbl = reinterpret_cast<const char*>(buf + shstrHeader->sh_offset);
+
+    // Step 3: Find .text
+    for (int i = 0; i < elfHeader->e_shnum; i++) {
+        const Elf64_Shdr* section = &sectionHeaders[i];
+        if (section->sh_name + sizeof(".text") > shstrHeader->sh_size ||
+            std::strcmp(strtbl + section->sh_name, ".text") != 0) {
+            continue;
+        }
+        if (section->sh_size == 0 || section->sh_offset + section->sh_size > obj.length) {
+            obj.error = "Invalid .text section in: " + binPath;
+            return false;
+        }
+        obj.textOffset = section->sh_offset;
+        obj.textSize = section->sh_size;
+        return true;
+    }
+    obj.error = ".text section not found in: " + binPath;
+    return false;
+}
+
+/**
+ * Run fn(0..n-1) on up to `threads` threads (the caller's included)
+ */
+void ParallelFor(size_t n, unsigned threads, const std::function<void(size_t)>& fn) {
+    if (threads <= 1 || n <= 1) {
+        for (size_t i = 0; i < n; i++) {
+            fn(i);
+        }
+        return;
+    }
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1)) {
+            fn(i);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& th : pool) {
+        th.join();
+    }
+}
+
+/**
+ * Check that an image is a well-formed CoreFunctionBinCache of numKernels entries
+ */
+bool ValidImage(std::vector<uint8_t>& image, size_t numKernels) {
+    if (image.size() < sizeof(CoreFunctionBinCache)) {
+        return false;
+    }
+    auto cache = reinterpret_cast<CoreFunctionBinCache*>(image.data());
+    if (cache->numKernels != numKernels || cache->GetTotalSize() != image.size()) {
+        return false;
+    }
+    for (uint64_t i = 0; i < cache->numKernels; i++) {
+        const uint64_t offset = cache->GetOffsets()[i];
+        if (offset + sizeof(uint64_t) > cache->dataSize ||
+            cache->GetKernel(i)->size > cache->dataSize - offset - sizeof(uint64_t)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
 
 uint32_t GetFileSize(const std::string& filePath) {
     std::ifstream file(filePath, std::ios::binary | std::ios::ate);
@@ -32,66 +196,104 @@ uint32_t GetFileSize(const std::string& filePath) {
 std::vector<uint8_t> LoadBinData(const std::string& binPath) {
     std::vector<uint8_t> text;
 
-    // Step 1: Read entire file
-    uint32_t fileSize = GetFileSize(binPath);
-    if (fileSize == 0) {
-        std::cerr << "Error: File is empty or cannot be read: " << binPath << '\n';
+    MappedObject obj;
+    if (!MapElfText(binPath, obj)) {
+        std::cerr << "Error: " << obj.error << '\n';
         return text;
     }
 
-    std::vector<char> buf(fileSize);
-    std::ifstream file(binPath, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot open file: " << binPath << '\n';
-        return text;
-    }
+    text.assign(obj.Text(), obj.Text() + obj.textSize);
+    std::cout << "Loaded .text section from " << binPath
+              << " (size: " << obj.textSize << " bytes)\n";
+    return text;
+}
 
-    file.read(buf.data(), fileSize);
-    if (!file) {
-        std::cerr << "Error: Failed to read file: " << binPath << '\n';
-        return text;
+int PackKernelBinaries(const std::vector<std::string>& binPaths, std::vector<uint8_t>& image, unsigned threads) {
+    const size_t numKernels = binPaths.size();
+    if (threads == 0) {
+        threads = std::max(1u, std::min({std::thread::hardware_concurrency(), 8u,
+                                         static_cast<unsigned>(std::max<size_t>(numKernels, 1))}));
     }
-    file.close();
-
-    // Step 2: Parse ELF header
-    auto elfHeader = reinterpret_cast<Elf64_Ehdr*>(buf.data());
 
-    // Verify ELF magic number (0x7F 'E' 'L' 'F')
-    if (elfHeader->e_ident[EI_MAG0] != ELFMAG0 ||
-        elfHeader->e_ident[EI_MAG1] != ELFMAG1 ||
-        elfHeader->e_ident[EI_MAG2] != ELFMAG2 ||
-        elfHeader->e_ident[EI_MAG3] != ELFMAG3) {
-        std::cerr << "Error: Not a valid ELF file: " << binPath << '\n';
-        return text;
+    // Step 1: Map every object and locate its .text section
+    std::unique_ptr<MappedObject[]> objs(new MappedObject[numKernels]);
+    ParallelFor(numKernels, threads, [&](size_t i) { MapElfText(binPaths[i], objs[i]); });
+    for (size_t i = 0; i < numKernels; i++) {
+        if (objs[i].base == nullptr || !objs[i].error.empty()) {
+            std::cerr << "Error: " << objs[i].error << '\n';
+            return -1;
+        }
     }
 
-    // Step 3: Get section headers
-    auto sectionHeaders = reinterpret_cast<Elf64_Shdr*>(
-        reinterpret_cast<uint64_t>(elfHeader) + elfHeader->e_shoff);
+    // Step 2: Size the image and assign offsets
+    const uint64_t headerSize = sizeof(CoreFunctionBinCache) + numKernels * sizeof(uint64_t);
+    std::vector<uint64_t> offsets(numKernels);
+    uint64_t binaryDataSize = 0;
+    for (size_t i = 0; i < numKernels; i++) {
+        offsets[i] = binaryDataSize;
+        binaryDataSize += sizeof(uint64_t) + objs[i].textSize;  // size field + data
+    }
+    image.resize(headerSize + binaryDataSize);
 
-    // Get string table for section names
-    auto shstrHeader = &sectionHeaders[elfHeader->e_shstrndx];
-    auto strtbl = buf.data() + shstrHeader->sh_offset;
+    auto cache = reinterpret_cast<CoreFunctionBinCache*>(image.data());
+    cache->dataSize = binaryDataSize;
+    cache->numKernels = numKernels;
+    if (numKernels > 0) {
+        std::memcpy(cache->GetOffsets(), offsets.data(), numKernels * sizeof(uint64_t));
+    }
 
-    // Step 4: Find and extract .text section
-    for (int i = 0; i < elfHeader->e_shnum; i++) {
-        auto section = &sectionHeaders[i];
-        auto sectionName = strtbl + section->sh_name;
+    // Step 3: Copy each .text directly from its mapping into place
+    uint8_t* dataPtr = cache->GetBinaryData();
+    ParallelFor(numKernels, threads, [&](size_t i) {
+        CoreFunctionBin* funcBin = reinterpret_cast<CoreFunctionBin*>(dataPtr + offsets[i]);
+        funcBin->size = objs[i].textSize;
+        std::memcpy(funcBin->data, objs[i].Text(), objs[i].textSize);
+    });
+    return 0;
+}
 
-        if (std::strcmp(sectionName, ".text") == 0) {
-            // Extract .text section binary data
-            text.resize(section->sh_size);
-            std::memcpy(text.data(), buf.data() + section->sh_offset, section->sh_size);
+int LoadPackedKernelImage(const std::vector<std::string>& binPaths, std::vector<uint8_t>& image, bool* fromCache) {
+    if (fromCache != nullptr) {
+        *fromCache = false;
+    }
 
-            std::cout << "Loaded .text section from " << binPath
-                      << " (size: " << section->sh_size << " bytes)\n";
-            break;
+    // Key on file identity, not contents: hashing every object would cost
+    // about as much as packing it.
+    KernelCache& cache = KernelCache::Default();
+    std::string key;
+    if (cache.Enabled()) {
+        std::ostringstream material;
+        material << "pto-packed-kernel-image-v1\n";
+        bool statOk = true;
+        for (const std::string& path : binPaths) {
+            struct stat st;
+            if (stat(path.c_str(), &st) != 0) {
+                statOk = false;
+                break;
+            }
+            material << path << ' ' << st.st_size << ' ' << st.st_mtim.tv_sec << '.' << st.st_mtim.tv_nsec
+                     << ' ' << st.st_ino << '\n';
+        }
+        if (statOk) {
+            key = KernelCache::Sha256Hex(material.str());
         }
     }
 
-    if (text.empty()) {
-        std::cerr << "Error: .text section not found in: " << binPath << '\n';
+    if (!key.empty() && cache.FetchBytes(key, image)) {
+        if (ValidImage(image, binPaths.size())) {
+            if (fromCache != nullptr) {
+                *fromCache = true;
+            }
+            return 0;
+        }
+        std::cerr << "Warning: ignoring malformed persisted kernel image\n";
     }
 
-    return text;
+    if (PackKernelBinaries(binPaths, image) != 0) {
+        return -1;
+    }
+    if (!key.empty()) {
+        cache.StoreBytes(key, image.data(), image.size());
+    }
+    return 0;
 }
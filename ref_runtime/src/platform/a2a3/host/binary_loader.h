@@ -11,6 +11,9 @@
  * 4. Return raw binary data
  *
  * Based on production code: src/interface/cache/function_cache.cpp:277-320
+ *
+ * For many kernels, PackKernelBinaries() builds the whole CoreFunctionBinCache
+ * image in one pass over memory-mapped objects instead.
  */
 
 #ifndef RUNTIME_BINARY_LOADER_H
@@ -45,4 +48,37 @@ uint32_t GetFileSize(const std::string& filePath);
  */
 std::vector<uint8_t> LoadBinData(const std::string& binPath);
 
+/**
+ * Pack the .text sections of several ELF .o files into one CoreFunctionBinCache image
+ *
+ * Single pass over the inputs:
+ * 1. mmaps every object and locates its .text section (in parallel)
+ * 2. sizes the image from the section headers
+ * 3. copies each .text straight from the mapping to its final offset (in parallel)
+ *
+ * Kernel i of the image is binPaths[i]. The layout matches the one built by
+ * DeviceRunner::LoadKernelsToDevice from LoadBinData() results.
+ *
+ * @param binPaths  Paths to the .o files, in image order
+ * @param image     Output - CoreFunctionBinCache header, offsets and CoreFunctionBin entries
+ * @param threads   Worker threads; 0 picks min(hardware threads, objects, 8)
+ * @return 0 on success, -1 on error (message names the failing file)
+ */
+int PackKernelBinaries(const std::vector<std::string>& binPaths, std::vector<uint8_t>& image, unsigned threads = 0);
+
+/**
+ * Get the packed kernel image, reusing the one persisted by an earlier run
+ *
+ * The image is stored in the kernel cache directory (kernel_cache.h) under a
+ * key derived from the path, size and mtime of every object, so a restart
+ * that loads the same objects reads one file instead of parsing each .o.
+ * Falls back to PackKernelBinaries() and persists its result.
+ *
+ * @param binPaths   Paths to the .o files, in image order
+ * @param image      Output - CoreFunctionBinCache image
+ * @param fromCache  Optional output - true if the persisted image was used
+ * @return 0 on success, -1 on error
+ */
+int LoadPackedKernelImage(const std::vector<std::string>& binPaths, std::vector<uint8_t>& image, bool* fromCache = nullptr);
+
 #endif  // RUNTIME_BINARY_LOADER_H
@@ -7,12 +7,16 @@
 
 #include "devicerunner.h"
 #include "binary_loader.h"
+#include "kernel_cache.h"
 #include "kernel_compiler.h"
 #include "graph.h"
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 // =============================================================================
@@ -283,29 +287,41 @@ int DeviceRunner::Run(Graph& graph, int numCores, int launchAicpuNum) {
         return rc;
     }
 
+    // Flatten the graph into a CSR image sized to the actual task/edge counts.
+    const size_t graphBytes = graph.csr_bytes();
+    std::unique_ptr<uint8_t, decltype(&std::free)> graphHost(
+        static_cast<uint8_t*>(std::aligned_alloc(64, graphBytes)), &std::free);
+    CsrGraph* csr = graphHost ? graph.build_csr(graphHost.get(), graphBytes) : nullptr;
+    if (csr == nullptr) {
+        std::cerr << "Error: Failed to build CSR graph image (" << graphBytes << " bytes)\n";
+        return -1;
+    }
+
     // Set functionBinAddr for all tasks (runtime function pointer dispatch).
-    Graph mutableGraph = graph;
     std::cout << "\n=== Setting functionBinAddr for Tasks ===" << std::endl;
-    for (int i = 0; i < mutableGraph.get_task_count(); i++) {
-        Task* task = mutableGraph.get_task(i);
-        if (task == nullptr) {
-            continue;
-        }
+    const bool verbose = csr->get_task_count() <= 64;
+    for (int i = 0; i < csr->get_task_count(); i++) {
+        Task* task = csr->get_task(i);
         uint64_t addr = GetFunctionBinAddr(task->func_id);
         task->functionBinAddr = addr;
-        std::cout << "  Task " << i << " (func_id=" << task->func_id
-                  << ") -> functionBinAddr=0x" << std::hex << addr << std::dec << std::endl;
+        if (verbose) {
+            std::cout << "  Task " << i << " (func_id=" << task->func_id
+                      << ") -> functionBinAddr=0x" << std::hex << addr << std::dec << std::endl;
+        }
     }
+    std::cout << "  " << csr->get_task_count() << " tasks, " << csr->edge_count << " edges, "
+              << csr->image_bytes << " bytes" << std::endl;
     std::cout << std::endl;
 
-    // Copy graph to device memory.
-    void* graphDevRaw = memAlloc_.Alloc(sizeof(Graph));
+    // Copy graph image to device memory. The executor scratch area at the
+    // end of the allocation is left uninitialized.
+    void* graphDevRaw = memAlloc_.Alloc(csr->total_bytes);
     if (graphDevRaw == nullptr) {
         std::cerr << "Error: Alloc for graphArgs failed\n";
         return -1;
     }
-    auto* graphDev = reinterpret_cast<Graph*>(graphDevRaw);
-    rc = rtMemcpy(graphDev, sizeof(Graph), &mutableGraph, sizeof(Graph), RT_MEMCPY_HOST_TO_DEVICE);
+    auto* graphDev = reinterpret_cast<CsrGraph*>(graphDevRaw);
+    rc = rtMemcpy(graphDev, csr->total_bytes, csr, csr->image_bytes, RT_MEMCPY_HOST_TO_DEVICE);
     if (rc != 0) {
         std::cerr << "Error: rtMemcpy for graph failed: " << rc << '\n';
         memAlloc_.Free(graphDev);
@@ -378,10 +394,14 @@ int DeviceRunner::Run(Graph& graph, int numCores, int launchAicpuNum) {
     }
     std::cout << "AICore stream done" << std::endl;
 
-    // Copy graph back for profiling (task start/end, core id, etc).
+    // Copy the task array back for profiling (task start/end, core id, etc).
     hasLastGraph_ = false;
     if (enableProfile_) {
-        rc = rtMemcpy(&lastGraph_, sizeof(Graph), graphDev, sizeof(Graph), RT_MEMCPY_DEVICE_TO_HOST);
+        lastTasks_.resize(static_cast<size_t>(csr->get_task_count()));
+        const size_t taskBytes = lastTasks_.size() * sizeof(Task);
+        rc = taskBytes == 0 ? 0 : rtMemcpy(lastTasks_.data(), taskBytes,
+                                           reinterpret_cast<uint8_t*>(graphDev) + csr->tasks_offset,
+                                           taskBytes, RT_MEMCPY_DEVICE_TO_HOST);
         if (rc != 0) {
             std::cerr << "Warning: rtMemcpy for graph (device->host) failed: " << rc << '\n';
         } else {
@@ -442,16 +462,12 @@ std::vector<TaskProfileRecord> DeviceRunner::GetLastProfile() const {
     if (!hasLastGraph_) {
         return out;
     }
-    const int taskCount = lastGraph_.get_task_count();
-    if (taskCount <= 0) {
+    if (lastTasks_.empty()) {
         return out;
     }
-    out.reserve(static_cast<size_t>(taskCount));
-    for (int i = 0; i < taskCount; i++) {
-        const Task* t = lastGraph_.get_task(i);
-        if (t == nullptr) {
-            continue;
-        }
+    out.reserve(lastTasks_.size());
+    for (const Task& task : lastTasks_) {
+        const Task* t = &task;
         TaskProfileRecord rec;
         rec.task_id = t->task_id;
         rec.func_id = t->func_id;
@@ -486,14 +502,19 @@ int DeviceRunner::Finalize() {
         return 0;
     }
 
+    // Report kernel cache effectiveness for this process
+    const KernelCache::Stats cacheStats = KernelCache::Default().GetStats();
+    if (cacheStats.hits + cacheStats.misses > 0) {
+        std::cout << "Kernel cache: " << cacheStats.hits << " hits, " << cacheStats.misses << " misses, "
+                  << cacheStats.evictions << " evictions (" << KernelCache::Default().Dir() << ")\n";
+    }
+
     // Cleanup AICPU SO
     soInfo_.Finalize();
 
     // Cleanup kernel binary cache (NEW)
-    if (binCache_ != nullptr) {
-        delete[] reinterpret_cast<uint8_t*>(binCache_);
-        binCache_ = nullptr;
-    }
+    binCache_ = nullptr;
+    std::vector<uint8_t>().swap(binImage_);
     funcIdToAddr_.clear();
     funcIdToBinPath_.clear();
     binGmAddr_ = nullptr;  // Will be freed by memAlloc_.Finalize()
@@ -616,70 +637,38 @@ int DeviceRunner::LoadKernelsToDevice() {
     std::cout << "\n=== Loading Kernels to Device ===" << '\n';
     std::cout << "Number of kernels: " << funcIdToBinPath_.size() << '\n';
 
-    // Step 1: Load all kernel binaries (extract .text sections)
-    std::map<int, std::vector<uint8_t>> binaries;
+    // Step 1: Build the CoreFunctionBinCache image (kernel i = i-th func_id in
+    // ascending order), reusing the image persisted by an earlier run if the
+    // objects are unchanged
+    std::vector<int> funcIds;
+    std::vector<std::string> binPaths;
     for (const auto& pair : funcIdToBinPath_) {
-        int funcId = pair.first;
-        const std::string& binPath = pair.second;
-
-        std::vector<uint8_t> binData = LoadBinData(binPath);
-        if (binData.empty()) {
-            std::cerr << "Error: Failed to load binary for func_id=" << funcId << '\n';
-            return -1;
-        }
-
-        binaries[funcId] = std::move(binData);
-        std::cout << "  func_id=" << funcId << " -> " << binaries[funcId].size() << " bytes\n";
+        funcIds.push_back(pair.first);
+        binPaths.push_back(pair.second);
     }
 
-    // Step 2: Calculate cache size
-    uint64_t numKernels = binaries.size();
-    uint64_t headerSize = sizeof(CoreFunctionBinCache) + numKernels * sizeof(uint64_t);
-    uint64_t binaryDataSize = 0;
-
-    for (const auto& pair : binaries) {
-        binaryDataSize += sizeof(uint64_t) + pair.second.size();  // size field + data
+    auto t0 = std::chrono::steady_clock::now();
+    bool fromCache = false;
+    if (LoadPackedKernelImage(binPaths, binImage_, &fromCache) != 0) {
+        std::cerr << "Error: Failed to pack kernel binaries\n";
+        binImage_.clear();
+        return -1;
     }
+    auto t1 = std::chrono::steady_clock::now();
 
-    uint64_t totalSize = headerSize + binaryDataSize;
+    binCache_ = reinterpret_cast<CoreFunctionBinCache*>(binImage_.data());
+    const uint64_t totalSize = binImage_.size();
+    const uint64_t headerSize = totalSize - binCache_->dataSize;
     std::cout << "Cache size: " << totalSize << " bytes (header: " << headerSize
-              << ", data: " << binaryDataSize << ")\n";
-
-    // Step 3: Build cache structure in host memory
-    uint8_t* hostBuf = new uint8_t[totalSize];
-    std::memset(hostBuf, 0, totalSize);
-
-    binCache_ = reinterpret_cast<CoreFunctionBinCache*>(hostBuf);
-    binCache_->dataSize = binaryDataSize;
-    binCache_->numKernels = numKernels;
-
-    // Fill offset array and copy binaries
-    uint64_t* offsets = binCache_->GetOffsets();
-    uint8_t* dataPtr = binCache_->GetBinaryData();
-    uint64_t currentOffset = 0;
+              << ", data: " << binCache_->dataSize << "), "
+              << (fromCache ? "persisted image" : "packed") << " in "
+              << std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() << " us\n";
 
-    size_t index = 0;
-    for (const auto& pair : binaries) {
-        // Store offset
-        offsets[index] = currentOffset;
-
-        // Write CoreFunctionBin at this offset
-        CoreFunctionBin* funcBin = reinterpret_cast<CoreFunctionBin*>(dataPtr + currentOffset);
-        funcBin->size = pair.second.size();
-        std::memcpy(funcBin->data, pair.second.data(), funcBin->size);
-
-        std::cout << "  Kernel " << index << " (func_id=" << pair.first
-                  << "): offset=" << currentOffset << ", size=" << funcBin->size << '\n';
-
-        currentOffset += sizeof(uint64_t) + funcBin->size;
-        index++;
-    }
-
-    // Step 4: Allocate device GM memory
+    // Step 2: Allocate device GM memory
     void* gmAddr = memAlloc_.Alloc(totalSize);
     if (gmAddr == nullptr) {
         std::cerr << "Error: Failed to allocate device GM memory for kernel cache\n";
-        delete[] hostBuf;
+        binImage_.clear();
         binCache_ = nullptr;
         return -1;
     }
@@ -687,40 +676,37 @@ int DeviceRunner::LoadKernelsToDevice() {
     binGmAddr_ = gmAddr;
     std::cout << "Allocated device GM memory: " << gmAddr << " (" << totalSize << " bytes)\n";
 
-    // Step 5: Copy cache to device
-    int rc = rtMemcpy(binGmAddr_, totalSize, hostBuf, totalSize, RT_MEMCPY_HOST_TO_DEVICE);
+    // Step 3: Copy the whole image to device in one transfer
+    int rc = rtMemcpy(binGmAddr_, totalSize, binImage_.data(), totalSize, RT_MEMCPY_HOST_TO_DEVICE);
     if (rc != 0) {
         std::cerr << "Error: rtMemcpy to device failed: " << rc << '\n';
         memAlloc_.Free(binGmAddr_);
         binGmAddr_ = nullptr;
-        delete[] hostBuf;
+        binImage_.clear();
         binCache_ = nullptr;
         return rc;
     }
 
-    // Step 6: Calculate functionBinAddr for each kernel
+    // Step 4: Calculate functionBinAddr for each kernel
     uint64_t gmBase = reinterpret_cast<uint64_t>(binGmAddr_);
-    uint64_t dataOffset = headerSize;  // Offset to start of binary data
+    const uint64_t* offsets = binCache_->GetOffsets();
 
-    index = 0;
-    for (const auto& pair : binaries) {
-        int funcId = pair.first;
-        uint64_t offset = offsets[index];
+    for (size_t index = 0; index < funcIds.size(); index++) {
+        int funcId = funcIds[index];
 
         // functionBinAddr = GM base + header + offset + sizeof(size field)
-        uint64_t functionBinAddr = gmBase + dataOffset + offset + sizeof(uint64_t);
+        uint64_t functionBinAddr = gmBase + headerSize + offsets[index] + sizeof(uint64_t);
 
         funcIdToAddr_[funcId] = functionBinAddr;
 
         std::cout << "  func_id=" << funcId << " -> functionBinAddr=0x"
-                  << std::hex << functionBinAddr << std::dec << '\n';
-
-        index++;
+                  << std::hex << functionBinAddr << std::dec
+                  << " (" << binCache_->GetKernel(index)->size << " bytes)\n";
     }
 
     std::cout << "=== Kernel Loading Complete ===\n\n";
 
-    // Keep hostBuf for now (will be freed in Finalize)
+    // Keep the host image (binImage_) until Finalize
     return 0;
 }
 
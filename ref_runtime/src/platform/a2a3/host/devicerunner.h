@@ -231,12 +231,13 @@ public:
      *
      * Called once after all RegisterKernel() calls during initialization.
      * This method:
-     * 1. Loads each .o file using LoadBinData() (extracts .text section)
-     * 2. Builds CoreFunctionBinCache with all kernel binaries
-     * 3. Allocates device GM memory for the cache
-     * 4. Copies cache to device
-     * 5. Calculates functionBinAddr[i] = gmBaseAddr + offset[i]
-     * 6. Stores addresses for later retrieval via GetFunctionBinAddr()
+     * 1. Builds the CoreFunctionBinCache image with LoadPackedKernelImage()
+     *    (mmaps the .o files and packs their .text sections in parallel, or
+     *    reuses the image persisted by an earlier run)
+     * 2. Allocates device GM memory for the cache
+     * 3. Copies the image to device in one transfer
+     * 4. Calculates functionBinAddr[i] = gmBaseAddr + header + offset[i] + 8
+     * 5. Stores addresses for later retrieval via GetFunctionBinAddr()
      *
      * @return 0 on success, error code on failure
      */
@@ -319,15 +320,16 @@ private:
     std::vector<Handshake> hankArgs_;
 
     // Kernel binary management (NEW - for runtime function pointer dispatch)
-    CoreFunctionBinCache* binCache_{nullptr};         // Host-side cache structure
+    std::vector<uint8_t> binImage_;                   // Host-side packed image
+    CoreFunctionBinCache* binCache_{nullptr};         // Host-side cache structure (in binImage_)
     void* binGmAddr_{nullptr};                        // Device GM base address
     std::map<int, uint64_t> funcIdToAddr_;           // func_id -> functionBinAddr
     std::map<int, std::string> funcIdToBinPath_;     // func_id -> .o file path
 
-    // Profiling: last executed graph snapshot (copied back from device).
+    // Profiling: task array of the last executed graph (copied back from device).
     bool enableProfile_{false};
     bool hasLastGraph_{false};
-    Graph lastGraph_{};
+    std::vector<Task> lastTasks_;
 };
 
 #endif  // RUNTIME_DEVICERUNNER_H
@@ -0,0 +1,655 @@
+/**
+ * On-disk Compiled Kernel Cache Implementation
+ */
+
+#include "kernel_cache.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Bump when the key derivation or entry format changes.
+const char* const kKeyVersion = "pto-kernel-cache-v1";
+const char* const kEntrySuffix = ".bin";
+const char* const kLockSuffix = ".lock";
+const char* const kTempPrefix = ".tmp.";
+// Temp and lock files older than this are leftovers of killed processes.
+const int64_t kStaleNs = 3600LL * 1000000000LL;
+
+bool ReadFile(const std::string& path, std::string& data) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.good()) {
+        return false;
+    }
+    std::ostringstream oss;
+    oss << in.rdbuf();
+    data = oss.str();
+    return true;
+}
+
+bool CopyFile(const std::string& from, const std::string& to) {
+    std::ifstream in(from, std::ios::binary);
+    if (!in.good()) {
+        return false;
+    }
+    std::ofstream out(to, std::ios::binary | std::ios::trunc);
+    if (!out.good()) {
+        return false;
+    }
+    out << in.rdbuf();
+    out.flush();
+    return out.good();
+}
+
+int64_t MtimeNs(const struct stat& st) {
+    return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+}
+
+// True if path still names the file open as fd.
+bool NamesFile(const std::string& path, int fd) {
+    struct stat held;
+    struct stat named;
+    return fstat(fd, &held) == 0 && stat(path.c_str(), &named) == 0 && held.st_dev == named.st_dev &&
+           held.st_ino == named.st_ino;
+}
+
+// Open and exclusively lock a key's lock file; -1 if that is not possible.
+// Evict() may unlink a stale lock file while we wait for it, so the lock only
+// counts if the path still names the locked file; otherwise retry on the new one.
+int LockKeyFile(const std::string& lockPath) {
+    for (int attempt = 0; attempt < 8; attempt++) {
+        const int fd = open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return -1;
+        }
+        if (flock(fd, LOCK_EX) != 0) {
+            close(fd);
+            return -1;
+        }
+        if (NamesFile(lockPath, fd)) {
+            return fd;
+        }
+        flock(fd, LOCK_UN);
+        close(fd);
+    }
+    return -1;
+}
+
+// Remove a lock file nobody holds or waits for. Holding its lock keeps
+// LockKeyFile() callers from taking the file we are about to unlink.
+void RemoveUnheldLockFile(const std::string& lockPath) {
+    const int fd = open(lockPath.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    if (flock(fd, LOCK_EX | LOCK_NB) == 0) {
+        if (NamesFile(lockPath, fd)) {
+            unlink(lockPath.c_str());
+        }
+        flock(fd, LOCK_UN);
+    }
+    close(fd);
+}
+
+int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string DirName(const std::string& path) {
+    size_t pos = path.find_last_of('/');
+    if (pos == std::string::npos) {
+        return ".";
+    }
+    return (pos == 0) ? "/" : path.substr(0, pos);
+}
+
+bool EndsWith(const std::string& s, const char* suffix) {
+    const size_t n = std::strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+bool MakeDirs(const std::string& path) {
+    if (path.empty()) {
+        return false;
+    }
+    size_t pos = 0;
+    while (pos != std::string::npos) {
+        pos = path.find('/', pos + 1);
+        const std::string prefix = path.substr(0, pos);
+        if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) {
+            return false;
+        }
+    }
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+/**
+ * Parse `#include "name"` / `#include <name>` directives
+ *
+ * Conditional compilation is ignored, so headers behind an #if are included
+ * in the key as well; that only makes the key more conservative.
+ */
+std::vector<std::pair<bool, std::string>> ParseIncludes(const std::string& text) {
+    std::vector<std::pair<bool, std::string>> includes;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t i = line.find_first_not_of(" \t");
+        if (i == std::string::npos || line[i] != '#') {
+            continue;
+        }
+        i = line.find_first_not_of(" \t", i + 1);
+        if (i == std::string::npos || line.compare(i, 7, "include") != 0) {
+            continue;
+        }
+        i = line.find_first_not_of(" \t", i + 7);
+        if (i == std::string::npos || (line[i] != '"' && line[i] != '<')) {
+            continue;
+        }
+        const bool quoted = line[i] == '"';
+        const size_t end = line.find(quoted ? '"' : '>', i + 1);
+        if (end == std::string::npos) {
+            continue;
+        }
+        includes.emplace_back(quoted, line.substr(i + 1, end - i - 1));
+    }
+    return includes;
+}
+
+// ---------------------------------------------------------------------------
+// SHA-256 (FIPS 180-4)
+// ---------------------------------------------------------------------------
+
+const uint32_t kSha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+inline uint32_t Rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+void Sha256Block(uint32_t h[8], const unsigned char* p) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (static_cast<uint32_t>(p[4 * i]) << 24) | (static_cast<uint32_t>(p[4 * i + 1]) << 16) |
+               (static_cast<uint32_t>(p[4 * i + 2]) << 8) | static_cast<uint32_t>(p[4 * i + 3]);
+    }
+    for (int i = 16; i < 64; i++) {
+        const uint32_t s0 = Rotr(w[i - 15], 7) ^ Rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const uint32_t s1 = Rotr(w[i - 2], 17) ^ Rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+    for (int i = 0; i < 64; i++) {
+        const uint32_t s1 = Rotr(e, 6) ^ Rotr(e, 11) ^ Rotr(e, 25);
+        const uint32_t ch = (e & f) ^ (~e & g);
+        const uint32_t t1 = hh + s1 + ch + kSha256K[i] + w[i];
+        const uint32_t s0 = Rotr(a, 2) ^ Rotr(a, 13) ^ Rotr(a, 22);
+        const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        const uint32_t t2 = s0 + maj;
+        hh = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+    h[5] += f;
+    h[6] += g;
+    h[7] += hh;
+}
+
+}  // namespace
+
+std::string KernelCache::Sha256Hex(const std::string& data) {
+    uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                     0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+    const size_t len = data.size();
+    size_t off = 0;
+    for (; off + 64 <= len; off += 64) {
+        Sha256Block(h, p + off);
+    }
+
+    // Padding: 0x80, zeros, 64-bit big-endian bit length.
+    unsigned char tail[128] = {0};
+    const size_t rest = len - off;
+    std::memcpy(tail, p + off, rest);
+    tail[rest] = 0x80;
+    const size_t tailLen = (rest < 56) ? 64 : 128;
+    const uint64_t bits = static_cast<uint64_t>(len) * 8;
+    for (int i = 0; i < 8; i++) {
+        tail[tailLen - 1 - i] = static_cast<unsigned char>(bits >> (8 * i));
+    }
+    Sha256Block(h, tail);
+    if (tailLen == 128) {
+        Sha256Block(h, tail + 64);
+    }
+
+    static const char* hex = "0123456789abcdef";
+    std::string out(64, '0');
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            out[i * 8 + j] = hex[(h[i] >> (28 - 4 * j)) & 0xf];
+        }
+    }
+    return out;
+}
+
+KernelCache::KernelCache(const std::string& dir, uint64_t maxBytes)
+    : dir_(dir), maxBytes_(maxBytes) {
+    while (dir_.size() > 1 && dir_.back() == '/') {
+        dir_.pop_back();
+    }
+}
+
+KernelCache& KernelCache::Default() {
+    static KernelCache cache = [] {
+        const char* enabled = std::getenv("PTO_KERNEL_CACHE");
+        if (enabled != nullptr && (std::string(enabled) == "0" || std::string(enabled) == "off")) {
+            return KernelCache("", 0);
+        }
+
+        std::string dir;
+        const char* env = std::getenv("PTO_KERNEL_CACHE_DIR");
+        const char* xdg = std::getenv("XDG_CACHE_HOME");
+        const char* home = std::getenv("HOME");
+        if (env != nullptr && std::strlen(env) > 0) {
+            dir = env;
+        } else if (xdg != nullptr && std::strlen(xdg) > 0) {
+            dir = std::string(xdg) + "/pto-isa/kernels";
+        } else if (home != nullptr && std::strlen(home) > 0) {
+            dir = std::string(home) + "/.cache/pto-isa/kernels";
+        } else {
+            dir = "/tmp/pto-isa-kernels-" + std::to_string(getuid());
+        }
+
+        uint64_t maxMb = 2048;
+        const char* maxEnv = std::getenv("PTO_KERNEL_CACHE_MAX_MB");
+        if (maxEnv != nullptr && std::strlen(maxEnv) > 0) {
+            maxMb = std::strtoull(maxEnv, nullptr, 10);
+        }
+
+        if (!MakeDirs(dir)) {
+            std::cerr << "Warning: kernel cache disabled, cannot create " << dir << std::endl;
+            return KernelCache("", 0);
+        }
+        return KernelCache(dir, maxMb << 20);
+    }();
+    return cache;
+}
+
+std::string KernelCache::EntryPath(const std::string& key) const {
+    return dir_ + "/" + key.substr(0, 2) + "/" + key + kEntrySuffix;
+}
+
+const KernelCache::FileDigest* KernelCache::Digest(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return nullptr;
+    }
+    FileDigest& d = digests_[path];
+    if (d.mtimeNs == MtimeNs(st) && d.size == static_cast<int64_t>(st.st_size)) {
+        return &d;
+    }
+    std::string text;
+    if (!ReadFile(path, text)) {
+        digests_.erase(path);
+        return nullptr;
+    }
+    d.mtimeNs = MtimeNs(st);
+    d.size = static_cast<int64_t>(st.st_size);
+    d.digest = Sha256Hex(text);
+    d.includes = ParseIncludes(text);
+    return &d;
+}
+
+std::string KernelCache::CompilerIdentity(const std::string& compilerPath) {
+    // A reinstalled compiler at the same path changes size or mtime.
+    std::string memoKey = compilerPath;
+    struct stat st;
+    if (compilerPath.find('/') != std::string::npos && stat(compilerPath.c_str(), &st) == 0) {
+        memoKey += "|" + std::to_string(MtimeNs(st)) + "|" + std::to_string(st.st_size);
+    }
+    auto it = compilers_.find(memoKey);
+    if (it != compilers_.end()) {
+        return it->second;
+    }
+
+    std::string version;
+    const std::string command = compilerPath + " --version 2>&1";
+    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(command.c_str(), "r"), pclose);
+    if (pipe) {
+        std::array<char, 256> buffer;
+        while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
+            version += buffer.data();
+        }
+    }
+    std::string identity = compilerPath + "\n" + version;
+    compilers_[memoKey] = identity;
+    return identity;
+}
+
+void KernelCache::CollectHeaders(const std::string& path,
+                                 const std::vector<std::string>& includeDirs,
+                                 std::map<std::string, std::string>& headers) {
+    const FileDigest* d = Digest(path);
+    if (d == nullptr) {
+        return;
+    }
+    // Copy: std::map keeps d valid across the insertions below, but a nested
+    // Digest() of this same path rewrites or erases it if the file changed.
+    const std::vector<std::pair<bool, std::string>> includes = d->includes;
+    const std::string dir = DirName(path);
+    for (const auto& inc : includes) {
+        std::string resolved;
+        if (inc.first) {
+            const std::string cand = dir + "/" + inc.second;
+            if (access(cand.c_str(), R_OK) == 0) {
+                resolved = cand;
+            }
+        }
+        for (size_t i = 0; resolved.empty() && i < includeDirs.size(); i++) {
+            const std::string cand = includeDirs[i] + "/" + inc.second;
+            if (access(cand.c_str(), R_OK) == 0) {
+                resolved = cand;
+            }
+        }
+        if (resolved.empty() || headers.count(resolved) != 0) {
+            continue;
+        }
+        const FileDigest* hd = Digest(resolved);
+        if (hd == nullptr) {
+            continue;
+        }
+        headers[resolved] = hd->digest;
+        CollectHeaders(resolved, includeDirs, headers);
+    }
+}
+
+std::string KernelCache::MakeKey(const std::string& compilerPath,
+                                 const std::string& flags,
+                                 const std::string& sourcePath,
+                                 const std::vector<std::string>& includeDirs) {
+    if (!Enabled()) {
+        return "";
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    const FileDigest* source = Digest(sourcePath);
+    if (source == nullptr) {
+        return "";
+    }
+    const std::string sourceDigest = source->digest;
+
+    std::map<std::string, std::string> headers;
+    CollectHeaders(sourcePath, includeDirs, headers);
+
+    std::ostringstream material;
+    material << kKeyVersion << '\n';
+    material << CompilerIdentity(compilerPath) << '\n';
+    material << flags << '\n';
+    material << sourceDigest << '\n';
+    for (const auto& h : headers) {
+        material << h.first << ' ' << h.second << '\n';
+    }
+    return Sha256Hex(material.str());
+}
+
+bool KernelCache::CopyEntry(const std::string& key, const std::string& outputPath) {
+    const std::string entry = EntryPath(key);
+    struct stat st;
+    // Zero-length entries can only come from a crash between rename and
+    // write-back; treat them as missing.
+    if (stat(entry.c_str(), &st) != 0 || st.st_size == 0) {
+        return false;
+    }
+    if (!CopyFile(entry, outputPath)) {
+        return false;
+    }
+    // LRU: a lookup counts as a use.
+    utimensat(AT_FDCWD, entry.c_str(), nullptr, 0);
+    return true;
+}
+
+bool KernelCache::Fetch(const std::string& key, const std::string& outputPath) {
+    if (!Enabled() || key.empty()) {
+        return false;
+    }
+    if (CopyEntry(key, outputPath)) {
+        hits_++;
+        return true;
+    }
+    misses_++;
+    return false;
+}
+
+bool KernelCache::FetchBytes(const std::string& key, std::vector<uint8_t>& data) {
+    if (!Enabled() || key.empty()) {
+        return false;
+    }
+    const std::string entry = EntryPath(key);
+    std::ifstream in(entry, std::ios::binary | std::ios::ate);
+    const std::streamsize size = in.good() ? static_cast<std::streamsize>(in.tellg()) : 0;
+    if (size <= 0) {
+        misses_++;
+        return false;
+    }
+    data.resize(static_cast<size_t>(size));
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(data.data()), size)) {
+        data.clear();
+        misses_++;
+        return false;
+    }
+    utimensat(AT_FDCWD, entry.c_str(), nullptr, 0);
+    hits_++;
+    return true;
+}
+
+int KernelCache::Publish(const std::string& key, const std::function<bool(const std::string&)>& write) {
+    if (!Enabled() || key.empty()) {
+        return -1;
+    }
+    const std::string subdir = dir_ + "/" + key.substr(0, 2);
+    if (!MakeDirs(subdir)) {
+        return -1;
+    }
+
+    // Write under a private name, then rename over the entry: readers see
+    // either no entry or a complete one.
+    static std::atomic<int> sequence{0};
+    std::ostringstream tmp;
+    tmp << subdir << "/" << kTempPrefix << getpid() << "." << sequence.fetch_add(1);
+    const std::string tmpPath = tmp.str();
+    if (!write(tmpPath)) {
+        unlink(tmpPath.c_str());
+        return -1;
+    }
+    if (rename(tmpPath.c_str(), EntryPath(key).c_str()) != 0) {
+        unlink(tmpPath.c_str());
+        return -1;
+    }
+    stores_++;
+
+    if (maxBytes_ > 0) {
+        Evict(key);
+    }
+    return 0;
+}
+
+int KernelCache::Store(const std::string& key, const std::string& objectPath) {
+    return Publish(key, [&](const std::string& tmpPath) { return CopyFile(objectPath, tmpPath); });
+}
+
+int KernelCache::StoreBytes(const std::string& key, const void* data, size_t size) {
+    return Publish(key, [&](const std::string& tmpPath) {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        out.flush();
+        return out.good();
+    });
+}
+
+int KernelCache::GetOrCompile(const std::string& key,
+                              const std::string& outputPath,
+                              const std::function<int()>& compile,
+                              bool* hit) {
+    if (hit != nullptr) {
+        *hit = false;
+    }
+    if (!Enabled() || key.empty()) {
+        return compile();
+    }
+    if (CopyEntry(key, outputPath)) {
+        hits_++;
+        if (hit != nullptr) {
+            *hit = true;
+        }
+        return 0;
+    }
+
+    // Serialize compilation of this key across processes. If the lock file
+    // cannot be used, compile anyway: the rename in Store keeps it safe.
+    int lockFd = -1;
+    const std::string subdir = dir_ + "/" + key.substr(0, 2);
+    if (MakeDirs(subdir)) {
+        lockFd = LockKeyFile(subdir + "/" + key + kLockSuffix);
+    }
+
+    int rc = 0;
+    bool served = CopyEntry(key, outputPath);  // another process may have finished it
+    if (served) {
+        hits_++;
+    } else {
+        misses_++;
+        rc = compile();
+        if (rc == 0) {
+            Store(key, outputPath);
+        }
+    }
+
+    if (lockFd >= 0) {
+        flock(lockFd, LOCK_UN);
+        close(lockFd);
+    }
+    if (hit != nullptr) {
+        *hit = served;
+    }
+    return rc;
+}
+
+void KernelCache::Evict(const std::string& keepKey) {
+    struct Entry {
+        int64_t mtimeNs;
+        uint64_t size;
+        std::string path;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    const int64_t now = NowNs();
+    const std::string keep = EntryPath(keepKey);
+
+    DIR* top = opendir(dir_.c_str());
+    if (top == nullptr) {
+        return;
+    }
+    while (struct dirent* sub = readdir(top)) {
+        if (sub->d_name[0] == '.') {
+            continue;
+        }
+        const std::string subdir = dir_ + "/" + sub->d_name;
+        DIR* d = opendir(subdir.c_str());
+        if (d == nullptr) {
+            continue;
+        }
+        while (struct dirent* ent = readdir(d)) {
+            const std::string name = ent->d_name;
+            if (name == "." || name == "..") {
+                continue;
+            }
+            const std::string path = subdir + "/" + name;
+            struct stat st;
+            if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+                continue;
+            }
+            if (name.compare(0, std::strlen(kTempPrefix), kTempPrefix) == 0) {
+                if (now - MtimeNs(st) > kStaleNs) {
+                    unlink(path.c_str());
+                }
+                continue;
+            }
+            if (EndsWith(name, kLockSuffix)) {
+                // The mtime of a lock file says nothing about its holder; a
+                // compile may run for longer than kStaleNs.
+                if (now - MtimeNs(st) > kStaleNs) {
+                    RemoveUnheldLockFile(path);
+                }
+                continue;
+            }
+            if (!EndsWith(name, kEntrySuffix)) {
+                continue;
+            }
+            total += static_cast<uint64_t>(st.st_size);
+            if (path != keep) {
+                entries.push_back({MtimeNs(st), static_cast<uint64_t>(st.st_size), path});
+            }
+        }
+        closedir(d);
+    }
+    closedir(top);
+
+    if (total <= maxBytes_) {
+        return;
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.mtimeNs < b.mtimeNs; });
+    for (const Entry& e : entries) {
+        if (total <= maxBytes_) {
+            break;
+        }
+        // Another process may be evicting too; only count what we removed.
+        if (unlink(e.path.c_str()) == 0) {
+            evictions_++;
+        }
+        total -= e.size;
+    }
+}
+
+KernelCache::Stats KernelCache::GetStats() const {
+    Stats s;
+    s.hits = hits_.load();
+    s.misses = misses_.load();
+    s.stores = stores_.load();
+    s.evictions = evictions_.load();
+    return s;
+}
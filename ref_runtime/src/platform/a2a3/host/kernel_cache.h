@@ -0,0 +1,168 @@
+/**
+ * On-disk Compiled Kernel Cache
+ *
+ * Content-addressed store for compiled kernel binaries, shared by the a2a3
+ * and CPU KernelCompiler implementations and by python/kernel_cache.py.
+ *
+ * Cache key: SHA-256 over
+ * - compiler identity (`<compiler> --version` output)
+ * - compilation flags (command line without source and output paths)
+ * - kernel source contents
+ * - contents of every header reachable through `#include` from the source,
+ *   resolved against the source directory and the given include directories
+ *   (headers that do not resolve there, e.g. CANN and libc headers, are
+ *   covered by the compiler identity)
+ *
+ * Layout: `<dir>/<key[0:2]>/<key>.bin`. Entries are published with an
+ * atomic rename, so concurrent processes never observe a partial binary.
+ * A per-key lock file serializes compilation of the same key across
+ * processes; readers take no lock. Lookups refresh the entry mtime and the
+ * least recently used entries are evicted once the cache exceeds its size
+ * limit.
+ *
+ * Environment:
+ * - PTO_KERNEL_CACHE=0           disable the cache
+ * - PTO_KERNEL_CACHE_DIR=<path>  cache directory
+ *                                (default $XDG_CACHE_HOME/pto-isa/kernels or
+ *                                ~/.cache/pto-isa/kernels)
+ * - PTO_KERNEL_CACHE_MAX_MB=<n>  size limit in MiB (default 2048)
+ */
+
+#ifndef RUNTIME_KERNEL_CACHE_H
+#define RUNTIME_KERNEL_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Compiled kernel cache
+ *
+ * Usage from a compiler:
+ *   KernelCache& cache = KernelCache::Default();
+ *   std::string key = cache.MakeKey(compilerPath, flags, sourcePath, includeDirs);
+ *   rc = cache.GetOrCompile(key, outputPath, [&] { return RunCompiler(...); }, &hit);
+ */
+class KernelCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;       // lookups served from the cache
+        uint64_t misses = 0;     // lookups that ran the compiler
+        uint64_t stores = 0;     // entries published
+        uint64_t evictions = 0;  // entries removed by LRU eviction
+    };
+
+    /**
+     * @param dir       Cache directory (created on demand); empty disables the cache
+     * @param maxBytes  Size limit for all entries; 0 means unlimited
+     */
+    KernelCache(const std::string& dir, uint64_t maxBytes);
+
+    /**
+     * Process-wide cache configured from the environment (see file comment)
+     */
+    static KernelCache& Default();
+
+    bool Enabled() const { return !dir_.empty(); }
+    const std::string& Dir() const { return dir_; }
+
+    /**
+     * Build the cache key of one compilation
+     *
+     * @param compilerPath  Compiler executable (identified by its --version output)
+     * @param flags         Compilation flags, without source and output paths
+     * @param sourcePath    Kernel source file
+     * @param includeDirs   Directories searched for `#include <...>` headers
+     * @return 64-character hex key, or empty string if the source is unreadable
+     */
+    std::string MakeKey(const std::string& compilerPath,
+                        const std::string& flags,
+                        const std::string& sourcePath,
+                        const std::vector<std::string>& includeDirs);
+
+    /**
+     * Copy the entry for `key` to outputPath
+     *
+     * @return true on hit
+     */
+    bool Fetch(const std::string& key, const std::string& outputPath);
+
+    /**
+     * Publish the binary at objectPath as the entry for `key`
+     *
+     * @return 0 on success, -1 on error (the cache is left unchanged)
+     */
+    int Store(const std::string& key, const std::string& objectPath);
+
+    /**
+     * Read the entry for `key` into memory
+     *
+     * @return true on hit
+     */
+    bool FetchBytes(const std::string& key, std::vector<uint8_t>& data);
+
+    /**
+     * Publish an in-memory binary as the entry for `key`
+     *
+     * @return 0 on success, -1 on error (the cache is left unchanged)
+     */
+    int StoreBytes(const std::string& key, const void* data, size_t size);
+
+    /**
+     * Produce the binary for `key` at outputPath, running `compile` on a miss
+     *
+     * `compile` must write outputPath and return 0 on success. Processes
+     * missing on the same key wait for each other, so only one compiles.
+     * With the cache disabled or an empty key this just calls `compile`.
+     *
+     * @param hit  Optional output - true if served from the cache
+     * @return Return code of `compile`, or 0 on a hit
+     */
+    int GetOrCompile(const std::string& key,
+                     const std::string& outputPath,
+                     const std::function<int()>& compile,
+                     bool* hit = nullptr);
+
+    Stats GetStats() const;
+
+    /**
+     * SHA-256 of a byte string as lowercase hex
+     */
+    static std::string Sha256Hex(const std::string& data);
+
+private:
+    struct FileDigest {
+        int64_t mtimeNs = 0;
+        int64_t size = -1;
+        std::string digest;
+        std::vector<std::pair<bool, std::string>> includes;  // (quoted, name)
+    };
+
+    std::string EntryPath(const std::string& key) const;
+    int Publish(const std::string& key, const std::function<bool(const std::string&)>& write);
+    bool CopyEntry(const std::string& key, const std::string& outputPath);
+    const FileDigest* Digest(const std::string& path);
+    std::string CompilerIdentity(const std::string& compilerPath);
+    void CollectHeaders(const std::string& path,
+                        const std::vector<std::string>& includeDirs,
+                        std::map<std::string, std::string>& headers);
+    void Evict(const std::string& keepKey);
+
+    std::string dir_;
+    uint64_t maxBytes_;
+
+    std::mutex mutex_;  // guards the memo tables
+    std::map<std::string, FileDigest> digests_;
+    std::map<std::string, std::string> compilers_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> stores_{0};
+    std::atomic<uint64_t> evictions_{0};
+};
+
+#endif  // RUNTIME_KERNEL_CACHE_H
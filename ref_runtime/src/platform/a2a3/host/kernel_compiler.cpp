@@ -3,6 +3,7 @@
  */
 
 #include "kernel_compiler.h"
+#include "kernel_cache.h"
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
@@ -47,11 +48,39 @@ int KernelCompiler::CompileKernel(const std::string& sourcePath,
     // Step 5: Build compilation command
     std::string command = BuildCompileCommand(compilerPath, sourcePath, outputPath, ptoIsaRoot, coreType);
 
-    // Step 6: Execute compilation
+    // Step 6: Compile, unless the kernel cache already holds this build
+    KernelCache& cache = KernelCache::Default();
+    const std::string cacheKey = cache.MakeKey(compilerPath,
+                                               BuildCompileCommand(compilerPath, "", "", ptoIsaRoot, coreType),
+                                               sourcePath,
+                                               {ptoIsaRoot + "/include", ptoIsaRoot + "/include/pto"});
     const char* coreTypeName = (coreType == 1) ? "AIV" : "AIC";
-    std::cout << "Compiling kernel (" << coreTypeName << "): " << sourcePath << std::endl;
-    std::cout << "Command: " << command << std::endl;
+    bool cacheHit = false;
+    int rc = cache.GetOrCompile(cacheKey, outputPath, [&]() {
+        std::cout << "Compiling kernel (" << coreTypeName << "): " << sourcePath << std::endl;
+        std::cout << "Command: " << command << std::endl;
+        return RunCompileCommand(command, errorMsg);
+    }, &cacheHit);
+    if (rc != 0) {
+        return -1;
+    }
+    if (cacheHit) {
+        std::cout << "Kernel cache hit (" << coreTypeName << "): " << sourcePath << std::endl;
+    }
 
+    // Step 7: Verify output file exists
+    std::ifstream outputFile(outputPath);
+    if (!outputFile.good()) {
+        errorMsg = "Compilation succeeded but output file not found: " + outputPath;
+        return -1;
+    }
+    outputFile.close();
+
+    std::cout << "Compilation successful: " << outputPath << std::endl;
+    return 0;
+}
+
+int KernelCompiler::RunCompileCommand(const std::string& command, std::string& errorMsg) {
     // Redirect stderr to capture compiler output
     std::string redirectedCommand = command + " 2>&1";
 
@@ -75,16 +104,6 @@ int KernelCompiler::CompileKernel(const std::string& sourcePath,
         std::cerr << errorMsg << std::endl;
         return -1;
     }
-
-    // Step 7: Verify output file exists
-    std::ifstream outputFile(outputPath);
-    if (!outputFile.good()) {
-        errorMsg = "Compilation succeeded but output file not found: " + outputPath;
-        return -1;
-    }
-    outputFile.close();
-
-    std::cout << "Compilation successful: " << outputPath << std::endl;
     return 0;
 }
 
@@ -4,8 +4,10 @@
  * This module provides runtime compilation of AICore kernel source files (.cpp)
  * to ELF object files (.o) using the ccec compiler.
  *
- * Compilation is performed on-demand without caching - each call to CompileKernel
- * invokes the ccec compiler and generates a new .o file in /tmp.
+ * Each call to CompileKernel produces a new .o file in /tmp. The object is
+ * taken from the on-disk kernel cache (kernel_cache.h) when the same source,
+ * headers, compiler and flags were compiled before; otherwise the ccec
+ * compiler is invoked and the result is added to the cache.
  *
  * Requirements:
  * - ASCEND_HOME_PATH environment variable must be set
@@ -34,7 +36,8 @@ public:
      * 2. Validates PTO-ISA header location
      * 3. Generates unique output path in /tmp
      * 4. Builds ccec command with all required flags
-     * 5. Invokes compiler and captures output
+     * 5. Copies the object from the kernel cache, or invokes the compiler
+     *    and stores the result in the cache
      * 6. Returns path to compiled .o file
      *
      * Compilation flags used:
@@ -86,6 +89,14 @@ private:
      */
     static bool ValidatePtoIsaHeaders(const std::string& ptoIsaRoot);
 
+    /**
+     * Run a compilation command and capture its output
+     * @param command   Complete compilation command
+     * @param errorMsg  Output parameter - compiler output on failure
+     * @return 0 on success, -1 on error
+     */
+    static int RunCompileCommand(const std::string& command, std::string& errorMsg);
+
     /**
      * Generate unique output filename in /tmp
      * @return Path to output .o file
@@ -0,0 +1,120 @@
+/**
+ * Emulated AICore kernel (CPU backend)
+ *
+ * Host-thread counterpart of platform/a2a3/aicore/kernel.cpp. Each emulated
+ * core polls its own Handshake entry, exactly like the device kernel, and
+ * runs assigned tasks through `functionBinAddr`, which on this backend holds
+ * the address of a host function with the unified kernel signature.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <sched.h>
+#include <thread>
+#include "graph.h"
+#include "kernel_entry.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Unified function pointer type for kernel dispatch
+ *
+ * Same signature as the device kernels; CPU kernels are the example kernel
+ * sources compiled for the host (see host/kernel_compiler.h).
+ */
+typedef void (*UnifiedKernelFunc)(int64_t*);
+
+// Polls spent spinning before an idle core starts yielding its time slice.
+// Spinning keeps dispatch latency close to the device polling loop when there
+// are spare host CPUs; yielding keeps oversubscribed hosts (more emulated cores
+// than CPUs) making progress.
+static constexpr uint32_t kIdleSpinPolls = 1024;
+
+static inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+static inline void IdleBackoff(uint32_t& idlePolls) {
+    if (idlePolls < kIdleSpinPolls) {
+        idlePolls++;
+        CpuRelax();
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+static inline uint64_t ReadDeviceClock() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static void execute_task(Task* task) {
+    if (task == nullptr || task->functionBinAddr == 0) {
+        return;
+    }
+    UnifiedKernelFunc kernel = reinterpret_cast<UnifiedKernelFunc>(task->functionBinAddr);
+    kernel(reinterpret_cast<int64_t*>(task->args));
+}
+
+void CpuAicoreKernel(Handshake* hank, int blockIdx, int nrAic) {
+    volatile Handshake* my_hank = &hank[blockIdx];
+    const uint32_t coreType = (blockIdx < nrAic) ? 1U : 2U;  // 1=AIC, 2=AIV
+    uint32_t idlePolls = 0;
+
+    // Phase 1: Wait for AICPU initialization signal. Also watch `control` so a
+    // failed AICPU launch cannot leave the emulated cores spinning forever.
+    while (my_hank->aicpu_ready == 0) {
+        if (my_hank->control == 1) {
+            return;
+        }
+        IdleBackoff(idlePolls);
+    }
+
+    // Phase 2: Signal AICore is ready (use core_id + 1 to avoid 0)
+    std::atomic_thread_fence(std::memory_order_acquire);
+    my_hank->aicore_done = static_cast<uint32_t>(blockIdx) + 1;
+
+    // Phase 3: Main execution loop - poll for tasks until quit signal
+    idlePolls = 0;
+    while (true) {
+        if (my_hank->control == 1) {
+            break;
+        }
+
+        if (my_hank->task != 0 && my_hank->task_status != 0) {
+            // Pairs with the AICPU's store of task/task_status: the task body
+            // and its arguments must be visible before we read them.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            Task* task_ptr = reinterpret_cast<Task*>(my_hank->task);
+            if (my_hank->profile_enable != 0) {
+                task_ptr->profile.exec_core_id = static_cast<uint32_t>(blockIdx);
+                task_ptr->profile.exec_core_type = coreType;
+                const int cpu = sched_getcpu();
+                task_ptr->profile.exec_phys_core_id = cpu < 0 ? 0U : static_cast<uint32_t>(cpu);
+
+                const uint64_t t0 = ReadDeviceClock();
+                task_ptr->profile.start_time = t0;
+                task_ptr->profile.end_time = 0;
+                execute_task(task_ptr);
+                const uint64_t t1 = ReadDeviceClock();
+                task_ptr->profile.end_time = t1;
+                task_ptr->profile.pmu_cnt[0] = static_cast<uint32_t>(t1 - t0);
+            } else {
+                execute_task(task_ptr);
+            }
+            // Publish kernel outputs and profile before reporting completion.
+            std::atomic_thread_fence(std::memory_order_release);
+            my_hank->task_status = 0;
+            idlePolls = 0;
+        } else {
+            IdleBackoff(idlePolls);
+        }
+    }
+}
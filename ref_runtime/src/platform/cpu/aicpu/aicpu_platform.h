@@ -0,0 +1,30 @@
+/**
+ * AICPU scheduler platform hooks for the CPU emulation backend
+ *
+ * Picked up by runtime/aicpu/graphexecutor.cpp when present on the include
+ * path. The emulated AICPU and AICore threads may share fewer host CPUs than
+ * there are threads, so an idle scheduler spins briefly and then yields.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <sched.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+static inline void AicpuIdlePoll(uint32_t idleSweeps) {
+    if (idleSweeps < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#endif
+    } else {
+        sched_yield();
+    }
+}
+
+#define AICPU_IDLE_POLL(idle_sweeps) AicpuIdlePoll(idle_sweeps)
@@ -0,0 +1,31 @@
+/**
+ * Device logging implementation for the emulated AICPU (CPU backend)
+ */
+
+#include "device_log.h"
+#include <cstdlib>
+#include <cstring>
+
+bool g_isLogEnableDebug = false;
+bool g_isLogEnableInfo = false;
+bool g_isLogEnableWarn = true;
+bool g_isLogEnableError = true;
+
+void InitLogSwitch() {
+    // 0=debug, 1=info, 2=warn, 3=error
+    int level = 2;
+    const char* env = std::getenv("PTO_DEVICE_LOG_LEVEL");
+    if (env != nullptr) {
+        if (std::strcmp(env, "debug") == 0) {
+            level = 0;
+        } else if (std::strcmp(env, "info") == 0) {
+            level = 1;
+        } else if (std::strcmp(env, "error") == 0) {
+            level = 3;
+        }
+    }
+    g_isLogEnableDebug = level <= 0;
+    g_isLogEnableInfo = level <= 1;
+    g_isLogEnableWarn = level <= 2;
+    g_isLogEnableError = true;
+}
@@ -0,0 +1,61 @@
+/**
+ * Device logging header for the emulated AICPU (CPU backend)
+ *
+ * Same DEV_* interface as the a2a3 AICPU logger, backed by stderr instead of
+ * the CANN dlog library. The level is read once by InitLogSwitch() from
+ * PTO_DEVICE_LOG_LEVEL (debug|info|warn|error, default: warn).
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstdio>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+extern bool g_isLogEnableDebug;
+extern bool g_isLogEnableInfo;
+extern bool g_isLogEnableWarn;
+extern bool g_isLogEnableError;
+
+static inline bool IsLogEnableDebug() { return g_isLogEnableDebug; }
+static inline bool IsLogEnableInfo() { return g_isLogEnableInfo; }
+static inline bool IsLogEnableWarn() { return g_isLogEnableWarn; }
+static inline bool IsLogEnableError() { return g_isLogEnableError; }
+
+#define GET_TID() syscall(__NR_gettid)
+
+inline bool IsDebugMode() {
+    return g_isLogEnableDebug;
+}
+
+#define D_DEV_LOG(ENABLED, LEVEL, fmt, ...)                                                      \
+    do {                                                                                         \
+        if (ENABLED()) {                                                                         \
+            fprintf(stderr, "[AICPU-CPU][" LEVEL "] %ld %s: " fmt "\n", static_cast<long>(GET_TID()), \
+                    __FUNCTION__, ##__VA_ARGS__);                                                \
+        }                                                                                        \
+    } while (false)
+
+#define DEV_DEBUG(fmt, args...) D_DEV_LOG(IsLogEnableDebug, "DEBUG", fmt, ##args)
+#define DEV_INFO(fmt, args...) D_DEV_LOG(IsLogEnableInfo, "INFO", fmt, ##args)
+#define DEV_WARN(fmt, args...) D_DEV_LOG(IsLogEnableWarn, "WARN", fmt, ##args)
+#define DEV_ERROR(fmt, args...) D_DEV_LOG(IsLogEnableError, "ERROR", fmt, ##args)
+
+#define DEV_ASSERT_MSG(expr, fmt, args...)                              \
+    do {                                                                \
+        if (!(expr)) {                                                  \
+            DEV_ERROR("Assertion failed (%s): " fmt, #expr, ##args);    \
+            assert(0);                                                  \
+        }                                                               \
+    } while (0)
+
+#define DEV_ASSERT(expr)                                                \
+    do {                                                                \
+        if (!(expr)) {                                                  \
+            DEV_ERROR("Assertion failed (%s)", #expr);                  \
+            assert(0);                                                  \
+        }                                                               \
+    } while (0)
+
+void InitLogSwitch();
@@ -0,0 +1,119 @@
+/**
+ * Emulated AICPU kernel (CPU backend)
+ *
+ * Host-thread counterpart of platform/a2a3/aicpu/kernel.cpp. The scheduling
+ * itself is done by the shared graph executor (runtime/aicpu/graphexecutor.cpp);
+ * this file only provides the handshake / shutdown protocol around it.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "device_log.h"
+#include "graph.h"
+#include "kernel_args.h"
+#include "kernel_entry.h"
+
+int execute(CsrGraph& g, Handshake* hank, int core_num, int threadId, int threadNum);
+void abort_execute(CsrGraph& g);
+
+/**
+ * Handshake AICore - Initialize and synchronize with the emulated cores
+ *
+ * Sets aicpu_ready for every core, then waits for each one to answer with
+ * aicore_done. Mirrors the device protocol so that the executor starts from
+ * the same handshake state as on hardware.
+ *
+ * @param rtargs Runtime mailbox
+ * @return 0 on success, -1 on invalid runtime args
+ */
+static int HankAiCore(PtoRuntimeArgs* rtargs) {
+    if (rtargs == nullptr || rtargs->hankArgs == nullptr) {
+        DEV_ERROR("%s", "HankAiCore: invalid runtime args");
+        return -1;
+    }
+    const int64_t core_num = rtargs->core_num;
+    if (core_num <= 0 || core_num > GRAPH_MAX_WORKER) {
+        DEV_ERROR("HankAiCore: core_num %ld outside [1, %d]", static_cast<long>(core_num), GRAPH_MAX_WORKER);
+        return -1;
+    }
+
+    // Phase 1: Signal all cores that AICPU is ready
+    for (int64_t i = 0; i < core_num; i++) {
+        Handshake* hank = rtargs->hankArgs + i;
+        std::atomic_thread_fence(std::memory_order_release);
+        hank->aicpu_ready = 1;
+    }
+
+    // Phase 2: Wait for all cores to acknowledge. The cores are host threads,
+    // so yield instead of burning the time slice they need to answer.
+    for (int64_t i = 0; i < core_num; i++) {
+        Handshake* hank = rtargs->hankArgs + i;
+        while (hank->aicore_done == 0) {
+            std::this_thread::yield();
+        }
+        DEV_INFO("core %ld ready, aicore_done = %u", static_cast<long>(i), hank->aicore_done);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return 0;
+}
+
+/**
+ * Shutdown AICore - Send quit signal to all emulated cores
+ *
+ * @param rtargs Runtime mailbox
+ * @return 0 on success
+ */
+static int ShutdownAiCore(PtoRuntimeArgs* rtargs) {
+    if (rtargs == nullptr || rtargs->hankArgs == nullptr) {
+        DEV_ERROR("%s", "ShutdownAiCore: invalid runtime args");
+        return -1;
+    }
+    for (int64_t i = 0; i < rtargs->core_num; i++) {
+        rtargs->hankArgs[i].control = 1;  // Set quit signal
+    }
+    return 0;
+}
+
+int CpuAicpuKernelServerInit(PtoRuntimeArgs* rtargs) {
+    InitLogSwitch();
+    if (rtargs == nullptr) {
+        DEV_ERROR("%s", "Invalid kernel arguments: null pointer");
+        return -1;
+    }
+    DEV_INFO("%s", "Graph Executor Init: Initializing emulated AICPU kernel");
+    return 0;
+}
+
+int CpuAicpuKernelServer(PtoRuntimeArgs* rtargs, int threadId, int threadNum) {
+    if (rtargs == nullptr || rtargs->hankArgs == nullptr) {
+        DEV_ERROR("%s", "Invalid runtime mailbox (missing hankArgs)");
+        return -1;
+    }
+
+    // Only the first instance owns the handshake, as on the device where the
+    // extra AICPU instances are pure schedulers. They wait for thread 0 inside
+    // execute(), so a failed handshake has to release them.
+    if (threadId == 0) {
+        int rc = HankAiCore(rtargs);
+        if (rc != 0) {
+            if (rtargs->graphArgs != nullptr) {
+                abort_execute(*rtargs->graphArgs);
+            }
+            return rc;
+        }
+    }
+
+    if (rtargs->graphArgs != nullptr) {
+        CsrGraph* g = rtargs->graphArgs;
+        const int core_num = static_cast<int>(rtargs->core_num);
+        DEV_INFO("Thread %d: graph has %d tasks", threadId, g->get_task_count());
+        int completed = execute(*g, rtargs->hankArgs, core_num, threadId, threadNum);
+        DEV_INFO("Thread %d: executed %d tasks from graph", threadId, completed);
+    }
+
+    if (threadId == 0) {
+        return ShutdownAiCore(rtargs);
+    }
+    return 0;
+}
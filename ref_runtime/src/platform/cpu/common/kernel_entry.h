@@ -0,0 +1,52 @@
+/**
+ * Kernel entry points of the CPU backend
+ *
+ * On Ascend devices the AICPU and AICore kernels are launched by the CANN
+ * runtime. The CPU backend runs the same protocol on host threads instead:
+ * DeviceRunner starts one thread per emulated core and per AICPU instance and
+ * calls these entries directly. All of them share the `Handshake` array and
+ * the `PtoRuntimeArgs` mailbox layout used on the device.
+ */
+
+#ifndef RUNTIME_CPU_KERNEL_ENTRY_H
+#define RUNTIME_CPU_KERNEL_ENTRY_H
+
+#include <cstdint>
+
+struct Handshake;
+struct PtoRuntimeArgs;
+
+/**
+ * Emulated AICPU init kernel (DynTileFwkBackendKernelServerInit counterpart)
+ *
+ * @param rtargs  Runtime mailbox
+ * @return 0 on success, -1 on error
+ */
+int CpuAicpuKernelServerInit(PtoRuntimeArgs* rtargs);
+
+/**
+ * Emulated AICPU main kernel (DynTileFwkBackendKernelServer counterpart)
+ *
+ * Thread 0 performs the AICore handshake, runs the graph executor and sends
+ * the quit signal. Every thread runs the executor on its share of the cores.
+ *
+ * @param rtargs     Runtime mailbox
+ * @param threadId   AICPU instance index in [0, threadNum)
+ * @param threadNum  Number of AICPU instances (launchAicpuNum)
+ * @return 0 on success, non-zero on error
+ */
+int CpuAicpuKernelServer(PtoRuntimeArgs* rtargs, int threadId, int threadNum);
+
+/**
+ * Emulated AICore kernel (aicore_kernel_0_mix_aic/aiv counterpart)
+ *
+ * Polls hank[blockIdx] until the quit signal and runs every task assigned to
+ * it by calling its functionBinAddr as a host function pointer.
+ *
+ * @param hank      Handshake array (one entry per core)
+ * @param blockIdx  Core index; cores [0, nrAic) are AIC, the rest AIV
+ * @param nrAic     Number of AIC cores
+ */
+void CpuAicoreKernel(Handshake* hank, int blockIdx, int nrAic);
+
+#endif  // RUNTIME_CPU_KERNEL_ENTRY_H
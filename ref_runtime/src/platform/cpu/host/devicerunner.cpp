@@ -0,0 +1,354 @@
+/**
+ * Device Runner Implementation - CPU Emulation Backend
+ */
+
+#include "devicerunner.h"
+#include "kernel_compiler.h"
+#include "../../a2a3/host/kernel_cache.h"
+#include "kernel_entry.h"
+#include "graph.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+DeviceRunner &DeviceRunner::Get() {
+    static DeviceRunner runner;
+    return runner;
+}
+
+int DeviceRunner::Init(int deviceId, const std::vector<uint8_t>& aicpuSoBinary,
+                       const std::vector<uint8_t>& aicoreKernelBinary, const std::string& ptoIsaRoot) {
+    (void)aicpuSoBinary;
+    (void)aicoreKernelBinary;
+    if (initialized_) {
+        std::cerr << "Error: DeviceRunner already initialized\n";
+        return -1;
+    }
+
+    deviceId_ = deviceId;
+    ptoIsaRoot_ = ptoIsaRoot;
+    numCores_ = 0;
+    totalCores_ = 0;
+
+    initialized_ = true;
+    std::cout << "DeviceRunner initialized: device=" << deviceId << " (CPU emulation)\n";
+    return 0;
+}
+
+void* DeviceRunner::AllocateTensor(size_t bytes) {
+    if (!initialized_) {
+        std::cerr << "Error: DeviceRunner not initialized\n";
+        return nullptr;
+    }
+    // aligned_alloc requires a size that is a multiple of the alignment.
+    const size_t rounded = std::max<size_t>(64, (bytes + 63) & ~static_cast<size_t>(63));
+    void* ptr = std::aligned_alloc(64, rounded);
+    if (ptr != nullptr) {
+        tensors_.insert(ptr);
+    }
+    return ptr;
+}
+
+void DeviceRunner::FreeTensor(void* devPtr) {
+    if (devPtr != nullptr && tensors_.erase(devPtr) != 0) {
+        std::free(devPtr);
+    }
+}
+
+int DeviceRunner::CopyToDevice(void* devPtr, const void* hostPtr, size_t bytes) {
+    if (!initialized_) {
+        std::cerr << "Error: DeviceRunner not initialized\n";
+        return -1;
+    }
+    std::memcpy(devPtr, hostPtr, bytes);
+    return 0;
+}
+
+int DeviceRunner::CopyFromDevice(void* hostPtr, const void* devPtr, size_t bytes) {
+    if (!initialized_) {
+        std::cerr << "Error: DeviceRunner not initialized\n";
+        return -1;
+    }
+    std::memcpy(hostPtr, devPtr, bytes);
+    return 0;
+}
+
+int DeviceRunner::Run(Graph& graph, int numCores, int launchAicpuNum) {
+    if (!initialized_) {
+        std::cerr << "Error: DeviceRunner not initialized\n";
+        return -1;
+    }
+    if (numCores <= 0) {
+        std::cerr << "Error: numCores must be > 0\n";
+        return -1;
+    }
+    if (numCores > GRAPH_MAX_WORKER) {
+        std::cerr << "Error: numCores (" << numCores << ") exceeds GRAPH_MAX_WORKER (" << GRAPH_MAX_WORKER << ")\n";
+        return -1;
+    }
+    if (launchAicpuNum <= 0) {
+        std::cerr << "Error: launchAicpuNum must be > 0\n";
+        return -1;
+    }
+
+    totalCores_ = numCores;
+    // Same worker split as the A2/A3 mix launch: 1/3 AIC, 2/3 AIV.
+    numCores_ = (totalCores_ + 2) / 3;
+    if (numCores_ > totalCores_) {
+        numCores_ = totalCores_;
+    }
+
+    hankArgs_.assign(static_cast<size_t>(totalCores_), Handshake{});
+    for (int i = 0; i < totalCores_; i++) {
+        hankArgs_[i].core_type = (i < numCores_) ? 0 : 1;
+        hankArgs_[i].profile_enable = enableProfile_ ? 1U : 0U;
+    }
+
+    // The CSR image is executed in place: there is no device copy, so the
+    // buffer also carries the executor's scratch area.
+    const size_t graphBytes = graph.csr_bytes();
+    std::unique_ptr<uint8_t, decltype(&std::free)> graphBuf(
+        static_cast<uint8_t*>(std::aligned_alloc(64, graphBytes)), &std::free);
+    CsrGraph* csr = graphBuf ? graph.build_csr(graphBuf.get(), graphBytes) : nullptr;
+    if (csr == nullptr) {
+        std::cerr << "Error: Failed to build CSR graph image (" << graphBytes << " bytes)\n";
+        return -1;
+    }
+
+    for (int i = 0; i < csr->get_task_count(); i++) {
+        Task* task = csr->get_task(i);
+        task->functionBinAddr = GetFunctionBinAddr(task->func_id);
+    }
+
+    runtimeArgs_.hankArgs = hankArgs_.data();
+    runtimeArgs_.graphArgs = csr;
+    runtimeArgs_.core_num = totalCores_;
+
+    int rc = CpuAicpuKernelServerInit(&runtimeArgs_);
+    if (rc != 0) {
+        std::cerr << "Error: AICPU init kernel failed: " << rc << '\n';
+        return rc;
+    }
+
+    // Start the emulated cores first; they wait for aicpu_ready like on device.
+    std::vector<std::thread> aicoreThreads;
+    aicoreThreads.reserve(static_cast<size_t>(totalCores_));
+    for (int i = 0; i < totalCores_; i++) {
+        aicoreThreads.emplace_back(CpuAicoreKernel, hankArgs_.data(), i, numCores_);
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<int> aicpuRc(static_cast<size_t>(launchAicpuNum), 0);
+    std::vector<std::thread> aicpuThreads;
+    aicpuThreads.reserve(static_cast<size_t>(launchAicpuNum));
+    for (int i = 0; i < launchAicpuNum; i++) {
+        aicpuThreads.emplace_back([this, &aicpuRc, i, launchAicpuNum]() {
+            aicpuRc[static_cast<size_t>(i)] = CpuAicpuKernelServer(&runtimeArgs_, i, launchAicpuNum);
+        });
+    }
+    for (std::thread& t : aicpuThreads) {
+        t.join();
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    lastRunNanos_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+
+    // Normally a no-op (the AICPU already sent quit); guarantees the cores
+    // exit if the AICPU kernel bailed out early.
+    for (Handshake& h : hankArgs_) {
+        h.control = 1;
+    }
+    for (std::thread& t : aicoreThreads) {
+        t.join();
+    }
+
+    rc = 0;
+    for (int i = 0; i < launchAicpuNum; i++) {
+        if (aicpuRc[static_cast<size_t>(i)] != 0) {
+            std::cerr << "Error: AICPU kernel " << i << " failed: " << aicpuRc[static_cast<size_t>(i)] << '\n';
+            rc = aicpuRc[static_cast<size_t>(i)];
+        }
+    }
+
+    hasLastGraph_ = false;
+    if (rc == 0 && enableProfile_) {
+        lastTasks_.assign(csr->tasks(), csr->tasks() + csr->get_task_count());
+        hasLastGraph_ = true;
+    }
+
+    runtimeArgs_.graphArgs = nullptr;
+    return rc;
+}
+
+void DeviceRunner::PrintHandshakeResults(Graph& graph) {
+    if (!initialized_ || hankArgs_.empty() || totalCores_ <= 0) {
+        return;
+    }
+
+    graph.worker_count = std::min(totalCores_, GRAPH_MAX_WORKER);
+    std::copy(hankArgs_.begin(), hankArgs_.begin() + graph.worker_count, graph.workers);
+
+    std::cout << "Handshake results for " << graph.worker_count << " cores:" << std::endl;
+    for (int i = 0; i < graph.worker_count; i++) {
+        std::cout << "  Core " << i << ": aicore_done=" << graph.workers[i].aicore_done
+                  << " aicpu_ready=" << graph.workers[i].aicpu_ready
+                  << " control=" << graph.workers[i].control
+                  << " task=" << graph.workers[i].task << std::endl;
+    }
+}
+
+void DeviceRunner::SetProfileEnabled(bool enabled) {
+    enableProfile_ = enabled;
+    if (!enableProfile_) {
+        hasLastGraph_ = false;
+    }
+}
+
+bool DeviceRunner::ProfileEnabled() const {
+    return enableProfile_;
+}
+
+bool DeviceRunner::HasLastProfile() const {
+    return hasLastGraph_;
+}
+
+std::vector<TaskProfileRecord> DeviceRunner::GetLastProfile() const {
+    std::vector<TaskProfileRecord> out;
+    if (!hasLastGraph_) {
+        return out;
+    }
+    out.reserve(lastTasks_.size());
+    for (const Task& t : lastTasks_) {
+        TaskProfileRecord rec;
+        rec.task_id = t.task_id;
+        rec.func_id = t.func_id;
+        rec.core_type = t.core_type;
+        rec.exec_core_id = t.profile.exec_core_id;
+        rec.exec_core_type = t.profile.exec_core_type;
+        rec.exec_phys_core_id = t.profile.exec_phys_core_id;
+        rec.start_time = t.profile.start_time;
+        rec.end_time = t.profile.end_time;
+        for (size_t j = 0; j < rec.pmu_cnt.size(); j++) {
+            rec.pmu_cnt[j] = t.profile.pmu_cnt[j];
+        }
+        out.push_back(rec);
+    }
+    return out;
+}
+
+uint64_t DeviceRunner::LastRunNanos() const {
+    return lastRunNanos_;
+}
+
+int DeviceRunner::RunTask(const std::vector<uint64_t>& args, int funcId, int launchAicpuNum) {
+    Graph graph;
+    std::vector<uint64_t> argsCopy = args;
+    int taskId = graph.add_task(argsCopy.data(), static_cast<int>(argsCopy.size()), funcId);
+    if (taskId < 0) {
+        std::cerr << "Error: Graph::add_task failed\n";
+        return -1;
+    }
+    const int cores = (totalCores_ > 0) ? totalCores_ : 3;
+    return Run(graph, cores, launchAicpuNum);
+}
+
+int DeviceRunner::Finalize() {
+    if (!initialized_) {
+        return 0;
+    }
+
+    // Report kernel cache effectiveness for this process
+    const KernelCache::Stats cacheStats = KernelCache::Default().GetStats();
+    if (cacheStats.hits + cacheStats.misses > 0) {
+        std::cout << "Kernel cache: " << cacheStats.hits << " hits, " << cacheStats.misses << " misses, "
+                  << cacheStats.evictions << " evictions (" << KernelCache::Default().Dir() << ")\n";
+    }
+
+    for (void* p : tensors_) {
+        std::free(p);
+    }
+    tensors_.clear();
+
+    funcIdToAddr_.clear();
+    for (void* lib : kernelLibs_) {
+        dlclose(lib);
+    }
+    kernelLibs_.clear();
+
+    initialized_ = false;
+    deviceId_ = -1;
+    numCores_ = 0;
+    totalCores_ = 0;
+    ptoIsaRoot_.clear();
+    hankArgs_.clear();
+    runtimeArgs_ = PtoRuntimeArgs{};
+    lastTasks_.clear();
+    hasLastGraph_ = false;
+    enableProfile_ = false;
+    lastRunNanos_ = 0;
+
+    std::cout << "DeviceRunner finalized\n";
+    return 0;
+}
+
+void DeviceRunner::RegisterKernelFunc(int funcId, KernelFunc func) {
+    funcIdToAddr_[funcId] = reinterpret_cast<uint64_t>(func);
+}
+
+uint64_t DeviceRunner::GetFunctionBinAddr(int funcId) {
+    auto it = funcIdToAddr_.find(funcId);
+    if (it == funcIdToAddr_.end()) {
+        std::cerr << "Warning: functionBinAddr not found for func_id=" << funcId << '\n';
+        return 0;
+    }
+    return it->second;
+}
+
+// =============================================================================
+// Runtime Kernel Compilation Implementation
+// =============================================================================
+
+int DeviceRunner::CompileAndLoadKernel(int funcId,
+                                       const std::string& sourcePath,
+                                       int coreType) {
+    if (!initialized_) {
+        std::cerr << "Error: DeviceRunner not initialized. Call Init() first.\n";
+        return -1;
+    }
+
+    std::string outputPath;
+    std::string errorMsg;
+    int rc = KernelCompiler::CompileKernel(sourcePath, ptoIsaRoot_, coreType, outputPath, errorMsg);
+    if (rc != 0) {
+        std::cerr << "Error: Kernel compilation failed: " << errorMsg << '\n';
+        return -1;
+    }
+
+    void* lib = dlopen(outputPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+    // The mapping stays valid after unlinking; don't leave one .so per call in /tmp.
+    std::remove(outputPath.c_str());
+    if (lib == nullptr) {
+        std::cerr << "Error: dlopen(" << outputPath << ") failed: " << dlerror() << '\n';
+        return -1;
+    }
+
+    const std::string symbol = KernelCompiler::EntrySymbol(sourcePath);
+    void* entry = dlsym(lib, symbol.c_str());
+    if (entry == nullptr) {
+        std::cerr << "Error: kernel entry '" << symbol << "' not found in " << sourcePath << '\n';
+        dlclose(lib);
+        return -1;
+    }
+    kernelLibs_.push_back(lib);
+    RegisterKernelFunc(funcId, reinterpret_cast<KernelFunc>(entry));
+
+    std::cout << "  func_id=" << funcId << " -> " << symbol << " @ 0x"
+              << std::hex << GetFunctionBinAddr(funcId) << std::dec << '\n';
+    return 0;
+}
@@ -0,0 +1,213 @@
+/**
+ * Device Runner - CPU Emulation Backend
+ *
+ * Host-only implementation of the DeviceRunner API. Instead of launching
+ * AICPU/AICore kernels through CANN, Run() starts host threads:
+ * - one emulated AICore thread per worker, polling its Handshake entry
+ * - `launchAicpuNum` emulated AICPU threads running the shared graph executor
+ *   (runtime/aicpu/graphexecutor.cpp)
+ *
+ * "Device" memory is ordinary host memory, and kernels are host functions:
+ * either compiled from the AICore kernel sources (CompileAndLoadKernel) or
+ * registered directly (RegisterKernelFunc). This makes dispatch latency,
+ * scheduler changes and TaskProfile output testable without Ascend hardware.
+ */
+
+#ifndef RUNTIME_DEVICERUNNER_H
+#define RUNTIME_DEVICERUNNER_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "graph.h"
+#include "kernel_args.h"
+
+struct TaskProfileRecord {
+    int task_id{0};
+    int func_id{0};
+    int core_type{0};  // requested core type (0=any, 1=AIC, 2=AIV)
+    uint32_t exec_core_id{0};
+    uint32_t exec_core_type{0};  // executing core type (1=AIC, 2=AIV)
+    uint32_t exec_phys_core_id{0};  // host CPU the emulated core ran on
+    uint64_t start_time{0};  // steady_clock nanoseconds
+    uint64_t end_time{0};
+    std::array<uint32_t, 8> pmu_cnt{};
+};
+
+/**
+ * Device runner singleton for CPU-emulated execution
+ *
+ * Provides the same interface as the a2a3 DeviceRunner so that graph
+ * builders and the C API compile unchanged against either backend.
+ */
+class DeviceRunner {
+public:
+    /**
+     * Unified kernel signature (host build of `void kernel(__gm__ int64_t* args)`)
+     */
+    typedef void (*KernelFunc)(int64_t*);
+
+    /**
+     * Get singleton instance
+     *
+     * @return Reference to the singleton DeviceRunner instance
+     */
+    static DeviceRunner &Get();
+
+    /**
+     * Initialize runtime resources
+     *
+     * The AICPU/AICore binaries are ignored on this backend (the emulation
+     * is linked in); the parameters are kept for API compatibility.
+     *
+     * @param deviceId            Device ID (informational only)
+     * @param aicpuSoBinary       Unused
+     * @param aicoreKernelBinary  Unused
+     * @param ptoIsaRoot          Path to PTO-ISA root directory (headers for kernel compilation)
+     * @return 0 on success, error code on failure
+     */
+    int Init(int deviceId, const std::vector<uint8_t>& aicpuSoBinary,
+             const std::vector<uint8_t>& aicoreKernelBinary, const std::string& ptoIsaRoot);
+
+    /**
+     * Allocate tensor memory (64-byte aligned host memory)
+     *
+     * @param bytes  Size of tensor in bytes
+     * @return Pointer on success, nullptr on failure
+     */
+    void* AllocateTensor(size_t bytes);
+
+    /**
+     * Free tensor memory
+     *
+     * @param devPtr  Pointer returned by AllocateTensor()
+     */
+    void FreeTensor(void* devPtr);
+
+    /**
+     * Copy data from host to "device" (memcpy)
+     *
+     * @return 0 on success, error code on failure
+     */
+    int CopyToDevice(void* devPtr, const void* hostPtr, size_t bytes);
+
+    /**
+     * Copy data from "device" to host (memcpy)
+     *
+     * @return 0 on success, error code on failure
+     */
+    int CopyFromDevice(void* hostPtr, const void* devPtr, size_t bytes);
+
+    /**
+     * Execute a graph on emulated cores
+     *
+     * Builds the CSR image, resets the handshake buffers, starts the AICore
+     * and AICPU threads and joins them once the executor has shut the cores
+     * down. Core split follows the a2a3 mix layout: (numCores + 2) / 3 AIC,
+     * the rest AIV.
+     *
+     * @param graph          Graph to execute
+     * @param numCores       Number of emulated cores (e.g., 3 for 1c2v)
+     * @param launchAicpuNum Number of AICPU threads (default: 1)
+     * @return 0 on success, error code on failure
+     */
+    int Run(Graph& graph, int numCores, int launchAicpuNum = 1);
+
+    void SetProfileEnabled(bool enabled);
+    bool ProfileEnabled() const;
+    bool HasLastProfile() const;
+    std::vector<TaskProfileRecord> GetLastProfile() const;
+
+    /**
+     * Wall-clock time of the last Run() between starting the AICPU threads
+     * and joining them (handshake + scheduling + kernels + shutdown)
+     *
+     * @return Nanoseconds, or 0 if nothing has run yet
+     */
+    uint64_t LastRunNanos() const;
+
+    /**
+     * Execute a single task (convenience wrapper)
+     *
+     * @param args           Kernel argument list (pointers/scalars encoded as uint64_t)
+     * @param funcId         Function identifier
+     * @param launchAicpuNum Number of AICPU threads (default: 1)
+     * @return 0 on success, error code on failure
+     */
+    int RunTask(const std::vector<uint64_t>& args, int funcId, int launchAicpuNum = 1);
+
+    /**
+     * Print handshake results of the last Run()
+     *
+     * @param graph  The graph whose handshake results should be printed
+     */
+    void PrintHandshakeResults(Graph& graph);
+
+    /**
+     * Cleanup all resources
+     *
+     * Frees all tensors, unloads kernel libraries and resets state.
+     *
+     * @return 0 on success, error code on failure
+     */
+    int Finalize();
+
+    /**
+     * Register a host function as the kernel for a func_id
+     *
+     * @param funcId  Function identifier
+     * @param func    Kernel entry with the unified signature
+     */
+    void RegisterKernelFunc(int funcId, KernelFunc func);
+
+    /**
+     * Get functionBinAddr for a given func_id
+     *
+     * On this backend the address is the host function pointer.
+     *
+     * @param funcId  Function identifier
+     * @return Kernel address, or 0 if not found
+     */
+    uint64_t GetFunctionBinAddr(int funcId);
+
+    /**
+     * Compile and load a kernel at runtime
+     *
+     * Compiles the source into a host .so (see KernelCompiler), loads it and
+     * binds `funcId` to its entry symbol (named after the source file).
+     *
+     * @param funcId      Function identifier for this kernel
+     * @param sourcePath  Path to kernel source file (.cpp)
+     * @param coreType    Core type: 0=AIC, 1=AIV
+     * @return 0 on success, -1 on error
+     */
+    int CompileAndLoadKernel(int funcId,
+                            const std::string& sourcePath,
+                            int coreType);
+
+private:
+    DeviceRunner() = default;
+
+    bool initialized_{false};
+    int deviceId_{-1};
+    int numCores_{0};     // AIC workers
+    int totalCores_{0};   // total workers (AIC + AIV)
+    std::string ptoIsaRoot_;
+
+    std::set<void*> tensors_;
+    std::vector<Handshake> hankArgs_;
+    PtoRuntimeArgs runtimeArgs_{};
+
+    std::map<int, uint64_t> funcIdToAddr_;  // func_id -> host function address
+    std::vector<void*> kernelLibs_;         // dlopen handles of compiled kernels
+
+    bool enableProfile_{false};
+    bool hasLastGraph_{false};
+    std::vector<Task> lastTasks_;
+    uint64_t lastRunNanos_{0};
+};
+
+#endif  // RUNTIME_DEVICERUNNER_H
@@ -0,0 +1,169 @@
+/**
+ * Runtime Kernel Compiler Implementation (CPU backend)
+ */
+
+#include "kernel_compiler.h"
+#include "../../a2a3/host/kernel_cache.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+int KernelCompiler::CompileKernel(const std::string& sourcePath,
+                                  const std::string& ptoIsaRoot,
+                                  int coreType,
+                                  std::string& outputPath,
+                                  std::string& errorMsg) {
+    // Step 1: Get compiler path
+    std::string compilerPath;
+    GetCompilerPath(compilerPath);
+
+    // Step 2: Validate source file exists
+    std::ifstream sourceFile(sourcePath);
+    if (!sourceFile.good()) {
+        errorMsg = "Source file not found: " + sourcePath;
+        return -1;
+    }
+    sourceFile.close();
+
+    // Step 3: Generate output path
+    outputPath = GenerateOutputPath();
+
+    // Step 4: Build compilation command
+    std::string command = BuildCompileCommand(compilerPath, sourcePath, outputPath, ptoIsaRoot, coreType);
+
+    // Step 5: Compile, unless the kernel cache already holds this build
+    KernelCache& cache = KernelCache::Default();
+    std::vector<std::string> includeDirs;
+    if (!ptoIsaRoot.empty()) {
+        includeDirs = {ptoIsaRoot + "/include", ptoIsaRoot + "/include/pto"};
+    }
+    const std::string cacheKey = cache.MakeKey(compilerPath,
+                                               BuildCompileCommand(compilerPath, "", "", ptoIsaRoot, coreType),
+                                               sourcePath,
+                                               includeDirs);
+    const char* coreTypeName = (coreType == 1) ? "AIV" : "AIC";
+    bool cacheHit = false;
+    int rc = cache.GetOrCompile(cacheKey, outputPath, [&]() {
+        std::cout << "Compiling kernel (" << coreTypeName << ", CPU): " << sourcePath << std::endl;
+        std::cout << "Command: " << command << std::endl;
+        return RunCompileCommand(command, errorMsg);
+    }, &cacheHit);
+    if (rc != 0) {
+        return -1;
+    }
+    if (cacheHit) {
+        std::cout << "Kernel cache hit (" << coreTypeName << ", CPU): " << sourcePath << std::endl;
+    }
+
+    // Step 6: Verify output file exists
+    struct stat st;
+    if (stat(outputPath.c_str(), &st) != 0) {
+        errorMsg = "Compilation succeeded but output file not found: " + outputPath;
+        return -1;
+    }
+
+    std::cout << "Compilation successful: " << outputPath << std::endl;
+    return 0;
+}
+
+int KernelCompiler::RunCompileCommand(const std::string& command, std::string& errorMsg) {
+    // Redirect stderr to capture compiler output
+    std::string redirectedCommand = command + " 2>&1";
+
+    std::array<char, 128> buffer;
+    std::string result;
+    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(redirectedCommand.c_str(), "r"), pclose);
+
+    if (!pipe) {
+        errorMsg = "Failed to execute compiler command";
+        return -1;
+    }
+
+    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
+        result += buffer.data();
+    }
+
+    int exitCode = pclose(pipe.release());
+
+    if (exitCode != 0) {
+        errorMsg = "Compilation failed with exit code " + std::to_string(exitCode) + ":\n" + result;
+        std::cerr << errorMsg << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+std::string KernelCompiler::EntrySymbol(const std::string& sourcePath) {
+    size_t begin = sourcePath.find_last_of('/');
+    begin = (begin == std::string::npos) ? 0 : begin + 1;
+    size_t end = sourcePath.find_last_of('.');
+    if (end == std::string::npos || end < begin) {
+        end = sourcePath.size();
+    }
+    return sourcePath.substr(begin, end - begin);
+}
+
+void KernelCompiler::GetCompilerPath(std::string& compilerPath) {
+    const char* candidates[] = {"PTO_CPU_KERNEL_CXX", "CXX"};
+    for (const char* name : candidates) {
+        const char* value = std::getenv(name);
+        if (value != nullptr && std::strlen(value) > 0) {
+            compilerPath = value;
+            return;
+        }
+    }
+    compilerPath = "c++";
+}
+
+std::string KernelCompiler::GenerateOutputPath() {
+    // Timestamp + PID + sequence number: several kernels are usually compiled
+    // within the same millisecond.
+    static std::atomic<int> sequence{0};
+    auto now = std::chrono::system_clock::now();
+    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now.time_since_epoch()).count();
+    pid_t pid = getpid();
+
+    std::ostringstream oss;
+    oss << "/tmp/kernel_cpu_" << timestamp << "_" << pid << "_" << sequence.fetch_add(1) << ".so";
+    return oss.str();
+}
+
+std::string KernelCompiler::BuildCompileCommand(const std::string& compilerPath,
+                                               const std::string& sourcePath,
+                                               const std::string& outputPath,
+                                               const std::string& ptoIsaRoot,
+                                               int coreType) {
+    std::ostringstream cmd;
+
+    cmd << compilerPath;
+    cmd << " -shared -fPIC -O2 -g -std=c++17";
+
+    // CPU simulation of the PTO-ISA headers; drop the AICore function attribute.
+    cmd << " -D__CPU_SIM -D__aicore__=";
+    if (coreType == 1) {  // AIV
+        cmd << " -D__AIV__";
+    } else {  // AIC
+        cmd << " -D__AIC__";
+    }
+
+    if (!ptoIsaRoot.empty()) {
+        cmd << " -I" << ptoIsaRoot << "/include";
+        cmd << " -I" << ptoIsaRoot << "/include/pto";
+    }
+
+    cmd << " -o " << outputPath;
+    cmd << " " << sourcePath;
+
+    return cmd.str();
+}
@@ -0,0 +1,91 @@
+/**
+ * Runtime Kernel Compiler (CPU backend)
+ *
+ * Compiles AICore kernel source files (.cpp) into host shared objects (.so)
+ * so that the emulated AICore threads can call them. Kernels are built with
+ * the PTO-ISA CPU simulation headers (`__CPU_SIM`) and with `__aicore__`
+ * defined empty; `__gm__` and friends already default to nothing in the
+ * kernel sources.
+ *
+ * The host compiler is taken from PTO_CPU_KERNEL_CXX, then CXX, then `c++`.
+ * Builds go through the shared on-disk kernel cache (a2a3/host/kernel_cache.h).
+ */
+
+#ifndef RUNTIME_KERNEL_COMPILER_H
+#define RUNTIME_KERNEL_COMPILER_H
+
+#include <string>
+
+/**
+ * Runtime kernel compiler class
+ *
+ * Same interface as the a2a3 KernelCompiler, producing a .so instead of an
+ * AICore ELF object.
+ */
+class KernelCompiler {
+public:
+    /**
+     * Compile a kernel source file to a host shared object
+     *
+     * @param sourcePath  Path to kernel source file (.cpp)
+     * @param ptoIsaRoot  Path to PTO-ISA root directory (headers location)
+     * @param coreType    Core type: 0=AIC, 1=AIV (selects __AIC__/__AIV__ defines)
+     * @param outputPath  Output parameter - path to compiled .so file
+     * @param errorMsg    Output parameter - error message if compilation fails
+     * @return 0 on success, -1 on error
+     */
+    static int CompileKernel(const std::string& sourcePath,
+                            const std::string& ptoIsaRoot,
+                            int coreType,
+                            std::string& outputPath,
+                            std::string& errorMsg);
+
+    /**
+     * Kernel entry symbol for a source file
+     *
+     * Kernels export one `extern "C"` entry named after the file, e.g.
+     * `kernels/aiv/kernel_add.cpp` exports `kernel_add`.
+     *
+     * @param sourcePath  Path to kernel source file
+     * @return Entry symbol name
+     */
+    static std::string EntrySymbol(const std::string& sourcePath);
+
+private:
+    /**
+     * Get host compiler path
+     * @param compilerPath  Output parameter - compiler executable
+     */
+    static void GetCompilerPath(std::string& compilerPath);
+
+    /**
+     * Run a compilation command and capture its output
+     * @param command   Complete compilation command
+     * @param errorMsg  Output parameter - compiler output on failure
+     * @return 0 on success, -1 on error
+     */
+    static int RunCompileCommand(const std::string& command, std::string& errorMsg);
+
+    /**
+     * Generate unique output filename in /tmp
+     * @return Path to output .so file
+     */
+    static std::string GenerateOutputPath();
+
+    /**
+     * Build host compilation command
+     * @param compilerPath  Host C++ compiler
+     * @param sourcePath    Path to source file
+     * @param outputPath    Path to output .so file
+     * @param ptoIsaRoot    Path to PTO-ISA headers (may be empty)
+     * @param coreType      Core type: 0=AIC, 1=AIV
+     * @return Complete compilation command
+     */
+    static std::string BuildCompileCommand(const std::string& compilerPath,
+                                          const std::string& sourcePath,
+                                          const std::string& outputPath,
+                                          const std::string& ptoIsaRoot,
+                                          int coreType);
+};
+
+#endif  // RUNTIME_KERNEL_COMPILER_H
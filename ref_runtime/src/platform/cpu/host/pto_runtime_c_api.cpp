@@ -0,0 +1,11 @@
+/**
+ * PTO Runtime C API - CPU Emulation Backend
+ *
+ * The C API only talks to DeviceRunner through its public interface, so the
+ * a2a3 implementation is reused as-is. The CPU devicerunner.h is included
+ * first; it shares the include guard with the a2a3 header, which therefore
+ * becomes a no-op inside the reused source.
+ */
+
+#include "devicerunner.h"
+#include "../../a2a3/host/pto_runtime_c_api.cpp"
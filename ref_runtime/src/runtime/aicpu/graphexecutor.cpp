@@ -1,157 +1,304 @@
 #include <cstdint>
+#include <cstring>
 #include "device_log.h"
 #include "graph.h"
 
+// Optional platform hook, called with the number of consecutive sweeps that
+// found nothing to do. Devices keep spinning (the AICPU is dedicated to the
+// scheduler); host emulation yields so the emulated cores can run.
+#if defined(__has_include)
+#if __has_include("aicpu_platform.h")
+#include "aicpu_platform.h"
+#endif
+#endif
+#ifndef AICPU_IDLE_POLL
+#define AICPU_IDLE_POLL(idle_sweeps) ((void)(idle_sweeps))
+#endif
+
+namespace {
+
+// Ready queues in the CsrGraph scratch area.
+enum ReadyQueue { kQueueAic = 0, kQueueAiv = 1, kQueueAny = 2 };
+static_assert(GRAPH_READY_QUEUES >= 3, "graph executor needs AIC, AIV and ANY ready queues");
+
+// Worker core classes (Handshake::core_type: 0 = AIC, 1 = AIV).
+enum CoreClass { kCoreAic = 0, kCoreAiv = 1, kCoreClasses = 2 };
+
+constexpr int kMaskWords = (GRAPH_MAX_WORKER + 63) / 64;
+
+inline int ready_queue_of(const Task* task) {
+    // Task core_type follows graph.h: 0 = any, 1 = AIC (cube), 2 = AIV (vector)
+    if (task->core_type == 1) {
+        return kQueueAic;
+    }
+    if (task->core_type == 2) {
+        return kQueueAiv;
+    }
+    return kQueueAny;
+}
+
+/**
+ * Append a task to a ready queue
+ *
+ * Slots hold task_id + 1 so that a consumer sharing the queue can tell a
+ * reserved-but-unwritten slot (0) from a published one.
+ */
+inline void ready_push(CsrGraph& g, GraphExecState* st, int queue, int task_id, bool shared) {
+    int* slots = g.ready_queue(queue);
+    GraphReadyQueueState& qs = st->queues[queue];
+    if (!shared) {
+        slots[qs.tail++] = task_id + 1;
+        return;
+    }
+    const int pos = __atomic_fetch_add(&qs.tail, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&slots[pos], task_id + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Take up to `max` tasks from the front of a ready queue with one head update
+ *
+ * @return Number of task IDs written to out
+ */
+inline int ready_pop(CsrGraph& g, GraphExecState* st, int queue, int* out, int max, bool shared) {
+    int* slots = g.ready_queue(queue);
+    GraphReadyQueueState& qs = st->queues[queue];
+    if (!shared) {
+        int n = qs.tail - qs.head;
+        n = (n < max) ? n : max;
+        for (int i = 0; i < n; i++) {
+            out[i] = slots[qs.head + i] - 1;
+        }
+        qs.head += (n > 0) ? n : 0;
+        return (n > 0) ? n : 0;
+    }
+
+    int head = __atomic_load_n(&qs.head, __ATOMIC_ACQUIRE);
+    while (true) {
+        const int tail = __atomic_load_n(&qs.tail, __ATOMIC_ACQUIRE);
+        int n = tail - head;
+        n = (n < max) ? n : max;
+        if (n <= 0) {
+            return 0;
+        }
+        if (__atomic_compare_exchange_n(&qs.head, &head, head + n, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            for (int i = 0; i < n; i++) {
+                // The producer may still be between reserving and writing the slot.
+                int v;
+                uint32_t spins = 0;
+                while ((v = __atomic_load_n(&slots[head + i], __ATOMIC_ACQUIRE)) == 0) {
+                    AICPU_IDLE_POLL(++spins);
+                }
+                out[i] = v - 1;
+            }
+            return n;
+        }
+    }
+}
+
+}  // namespace
+
 /**
  * Execute task graph using polling-based dispatch to AICore
  *
  * This function implements a dynamic task scheduler that:
- * 1. Maintains two separate ready queues - one for AIC tasks, one for AIV tasks
- * 2. Polls each AICore handshake buffer to check for idle cores
- * 3. Dispatches ready tasks to idle cores based on core type matching
+ * 1. Keeps three ready queues (AIC / AIV / ANY) in the graph's scratch area
+ * 2. Polls only the handshake buffers of busy cores for completions
+ * 3. Keeps idle cores in per-type free lists and hands each of them a task
+ *    in one batch per sweep: AIC/AIV tasks first, then ANY tasks fill
+ *    whichever idle cores remain
  * 4. Tracks task completion and updates successor dependencies
  *
- * The scheduler supports arbitrary DAG topologies and automatically handles
- * parallelism across multiple cores based on data dependencies and core types.
+ * Busy cores are tracked in a bitmask, so a sweep touches one handshake cache
+ * line per in-flight task instead of one per core.
  *
- * Algorithm:
- * - Separate initially ready tasks by core type into two queues
- * - Loop while there are tasks ready to run OR tasks currently executing
- * - For each core:
- *   - If task completed (idle + task != 0): update dependencies, add to appropriate queue
- *   - If core idle: dispatch from matching queue (AIC core -> AIC queue, AIV core -> AIV queue)
+ * Several AICPU threads may run the same graph: thread t owns the cores with
+ * core_id % threadNum == t, the ready queues are shared, and fanin counters
+ * are decremented atomically. Thread 0 initializes the scratch area; the other
+ * threads wait for CsrGraph::exec_ready and return without executing if thread
+ * 0 calls abort_execute() instead.
  *
- * @param g Task graph containing all tasks and dependencies
+ * @param g CSR task graph image; its scratch area holds the ready queues
  * @param hank Array of handshake buffers (one per core)
  * @param core_num Number of AICore instances available
- * @return Number of tasks completed
+ * @param threadId Index of this AICPU thread
+ * @param threadNum Number of AICPU threads executing this graph
+ * @return Number of tasks completed on cores owned by this thread
  */
-int execute(Graph& g, Handshake* hank, int core_num, int threadId) {
+int execute(CsrGraph& g, Handshake* hank, int core_num, int threadId, int threadNum) {
+    if (threadNum < 1) {
+        threadNum = 1;
+    }
+    if (threadId < 0 || threadId >= threadNum) {
+        return 0;
+    }
+    if (core_num > GRAPH_MAX_WORKER) {
+        DEV_ERROR("core_num %d exceeds GRAPH_MAX_WORKER %d", core_num, GRAPH_MAX_WORKER);
+        core_num = GRAPH_MAX_WORKER;
+    }
+    const bool shared = threadNum > 1;
+    const int task_count = g.get_task_count();
+    GraphExecState* st = g.exec_state();
+
     if (threadId == 0) {
-        DEV_INFO("Thread %d: Executing graph", threadId);
+        DEV_INFO("Thread %d: Executing graph (%d AICPU threads)", threadId, threadNum);
+        memset(static_cast<void*>(st), 0, sizeof(GraphExecState));
+        if (shared) {
+            memset(g.ready_queue(0), 0, sizeof(int) * GRAPH_READY_QUEUES * static_cast<size_t>(task_count));
+        }
+        // Initially ready tasks (fanin == 0); no other thread runs yet.
+        for (int task_id = 0; task_id < task_count; task_id++) {
+            Task* task = g.get_task(task_id);
+            if (task->fanin == 0) {
+                ready_push(g, st, ready_queue_of(task), task_id, false);
+            }
+        }
+        DEV_INFO("Initially ready: AIC=%d, AIV=%d, ANY=%d", st->queues[kQueueAic].tail,
+                 st->queues[kQueueAiv].tail, st->queues[kQueueAny].tail);
+        __atomic_store_n(&g.exec_ready, 1, __ATOMIC_RELEASE);
     } else {
-        return 0;
+        uint32_t spins = 0;
+        int ready;
+        while ((ready = __atomic_load_n(&g.exec_ready, __ATOMIC_ACQUIRE)) == 0) {
+            AICPU_IDLE_POLL(++spins);
+        }
+        if (ready < 0) {
+            DEV_ERROR("Thread %d: graph execution aborted by thread 0", threadId);
+            return 0;
+        }
     }
-    // Separate ready queues for each core type.
-    //
-    // Task core_type follows graph.h:
-    //   0 = any, 1 = AIC (cube), 2 = AIV (vector)
-    int ready_queue_aic[GRAPH_MAX_TASKS];
-    int ready_queue_aiv[GRAPH_MAX_TASKS];
-    int ready_queue_any[GRAPH_MAX_TASKS];
-    int ready_count_aic = 0;
-    int ready_count_aiv = 0;
-    int ready_count_any = 0;
-
-    // Get initially ready tasks and separate by core type
-    int initial_ready[GRAPH_MAX_TASKS];
-    int initial_count = g.get_initial_ready_tasks(initial_ready);
-
-    DEV_INFO("Found %d initially ready tasks", initial_count);
-    for (int i = 0; i < initial_count; i++) {
-        Task* task = g.get_task(initial_ready[i]);
-        if (task->core_type == 2) {  // AIV
-            ready_queue_aiv[ready_count_aiv++] = initial_ready[i];
-            DEV_INFO("  Task %d -> AIV queue", initial_ready[i]);
-        } else if (task->core_type == 1) {  // AIC
-            ready_queue_aic[ready_count_aic++] = initial_ready[i];
-            DEV_INFO("  Task %d -> AIC queue", initial_ready[i]);
-        } else {  // any
-            ready_queue_any[ready_count_any++] = initial_ready[i];
-            DEV_INFO("  Task %d -> ANY queue", initial_ready[i]);
+
+    // Per-thread core bookkeeping: idle free list per core class, busy bitmask.
+    int8_t core_class[GRAPH_MAX_WORKER];
+    int idle_cores[kCoreClasses][GRAPH_MAX_WORKER];
+    int idle_count[kCoreClasses] = {0, 0};
+    uint64_t busy_mask[kMaskWords] = {};
+    for (int core_id = core_num - 1; core_id >= 0; core_id--) {
+        if (core_id % threadNum != threadId) {
+            continue;
         }
+        const int cls = (hank[core_id].core_type == 0) ? kCoreAic : kCoreAiv;
+        core_class[core_id] = static_cast<int8_t>(cls);
+        idle_cores[cls][idle_count[cls]++] = core_id;
     }
+    DEV_INFO("Thread %d owns %d AIC + %d AIV cores", threadId, idle_count[kCoreAic], idle_count[kCoreAiv]);
 
     int completed = 0;
     int tasks_in_flight = 0;
+    uint32_t idle_sweeps = 0;
+    int picked[GRAPH_MAX_WORKER];
 
-    DEV_INFO(
-        "Starting execution loop: AIC ready=%d, AIV ready=%d, ANY ready=%d",
-        ready_count_aic,
-        ready_count_aiv,
-        ready_count_any);
-
-    // Execute tasks using polling-based dispatch
-    // Loop until all tasks are dispatched and completed
-    while (ready_count_aic > 0 || ready_count_aiv > 0 || ready_count_any > 0 || tasks_in_flight > 0) {
-        // Iterate through each core
-        for (int core_id = 0; core_id < core_num; core_id++) {
-            DEV_INFO("  Checking core %d (type=%d)", core_id, hank[core_id].core_type);
-            Handshake* h = &hank[core_id];
-
-            // Case 1: Core finished a task (idle + task not null)
-            if (h->task_status == 0 && h->task != 0) {
-                // Get completed task
-                Task* task = reinterpret_cast<Task*>(h->task);
-                int task_id = task->task_id;
+    while (true) {
+        bool progress = false;
 
-                DEV_INFO("  Core %d completed task %d", core_id, task_id);
+        // Phase 1: Collect completions from busy cores only.
+        int done_now = 0;
+        for (int w = 0; w < kMaskWords; w++) {
+            uint64_t m = busy_mask[w];
+            while (m != 0) {
+                const int bit = __builtin_ctzll(m);
+                m &= m - 1;
+                const int core_id = w * 64 + bit;
+                Handshake* h = &hank[core_id];
+                if (h->task_status != 0) {
+                    continue;
+                }
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
 
-                // Update fanin of successors and add to appropriate ready queue
+                Task* task = reinterpret_cast<Task*>(h->task);
+                DEV_INFO("  Core %d completed task %d", core_id, task->task_id);
+
+                // Update fanin of successors and add newly ready ones to their queue
+                const int* fanout = g.fanout(task);
                 for (int i = 0; i < task->fanout_count; i++) {
-                    int dep_id = task->fanout[i];
+                    const int dep_id = fanout[i];
                     Task* dep = g.get_task(dep_id);
-                    dep->fanin--;
-
-                    // Add to ready queue if ready
-                    if (dep->fanin == 0) {
-                        if (dep->core_type == 2) {  // AIV
-                            ready_queue_aiv[ready_count_aiv++] = dep_id;
-                            DEV_INFO("    Task %d now ready -> AIV queue", dep_id);
-                        } else if (dep->core_type == 1) {  // AIC
-                            ready_queue_aic[ready_count_aic++] = dep_id;
-                            DEV_INFO("    Task %d now ready -> AIC queue", dep_id);
-                        } else {  // any
-                            ready_queue_any[ready_count_any++] = dep_id;
-                            DEV_INFO("    Task %d now ready -> ANY queue", dep_id);
-                        }
+                    const int left = shared ? __atomic_sub_fetch(&dep->fanin, 1, __ATOMIC_ACQ_REL) : --dep->fanin;
+                    if (left == 0) {
+                        ready_push(g, st, ready_queue_of(dep), dep_id, shared);
+                        DEV_INFO("    Task %d now ready -> queue %d", dep_id, ready_queue_of(dep));
                     }
                 }
 
-                // Clear task pointer
                 h->task = 0;
-                completed++;
+                busy_mask[w] &= ~(1ULL << bit);
+                const int cls = core_class[core_id];
+                idle_cores[cls][idle_count[cls]++] = core_id;
                 tasks_in_flight--;
+                done_now++;
+            }
+        }
+        if (done_now > 0) {
+            completed += done_now;
+            if (shared) {
+                __atomic_add_fetch(&st->completed, done_now, __ATOMIC_RELEASE);
+            } else {
+                st->completed += done_now;
             }
+            progress = true;
+        }
 
-            // Case 2: Core is idle and available (idle + task is null)
-            if (h->task_status == 0 && h->task == 0) {
-                // Dispatch from matching queue based on core type
-                if (h->core_type == 0) {  // AIC core
-                    int task_id = -1;
-                    if (ready_count_aic > 0) {
-                        task_id = ready_queue_aic[--ready_count_aic];
-                        DEV_INFO("  Dispatching AIC task %d to core %d", task_id, core_id);
-                    } else if (ready_count_any > 0) {
-                        task_id = ready_queue_any[--ready_count_any];
-                        DEV_INFO("  Dispatching ANY task %d to AIC core %d", task_id, core_id);
-                    }
-                    if (task_id >= 0) {
-                        Task* task = g.get_task(task_id);
-                        h->task = reinterpret_cast<uint64_t>(task);
-                        h->task_status = 1;  // Mark as busy
-                        tasks_in_flight++;
-                    }
-                } else if (h->core_type == 1) {  // AIV core
-                    int task_id = -1;
-                    if (ready_count_aiv > 0) {
-                        task_id = ready_queue_aiv[--ready_count_aiv];
-                        DEV_INFO("  Dispatching AIV task %d to core %d", task_id, core_id);
-                    } else if (ready_count_any > 0) {
-                        task_id = ready_queue_any[--ready_count_any];
-                        DEV_INFO("  Dispatching ANY task %d to AIV core %d", task_id, core_id);
-                    }
-                    if (task_id >= 0) {
-                        Task* task = g.get_task(task_id);
-                        h->task = reinterpret_cast<uint64_t>(task);
-                        h->task_status = 1;  // Mark as busy
-                        tasks_in_flight++;
-                    }
-                }
+        // Phase 2: Batched dispatch, one ready-queue pop per core class.
+        for (int cls = 0; cls < kCoreClasses; cls++) {
+            const int want = idle_count[cls];
+            if (want == 0) {
+                continue;
+            }
+            const int typed_queue = (cls == kCoreAic) ? kQueueAic : kQueueAiv;
+            int n = ready_pop(g, st, typed_queue, picked, want, shared);
+            if (n < want) {
+                n += ready_pop(g, st, kQueueAny, picked + n, want - n, shared);
+            }
+            if (n == 0) {
+                continue;
+            }
+
+            // Pop n cores off the free list; they stay readable at
+            // idle_cores[cls][idle_count[cls] .. + n) for the status writes.
+            idle_count[cls] -= n;
+            const int* cores = &idle_cores[cls][idle_count[cls]];
+            for (int i = 0; i < n; i++) {
+                const int core_id = cores[i];
+                hank[core_id].task = reinterpret_cast<uint64_t>(g.get_task(picked[i]));
+                busy_mask[core_id / 64] |= 1ULL << (core_id % 64);
+                DEV_INFO("  Dispatching task %d to core %d", picked[i], core_id);
+            }
+            // Task pointers (and all earlier task/graph writes) before busy flags.
+            __atomic_thread_fence(__ATOMIC_RELEASE);
+            for (int i = 0; i < n; i++) {
+                hank[cores[i]].task_status = 1;  // Mark as busy
+            }
+            tasks_in_flight += n;
+            progress = true;
+        }
+
+        // Phase 3: Done once every task of the graph has completed.
+        if (tasks_in_flight == 0) {
+            const int done = shared ? __atomic_load_n(&st->completed, __ATOMIC_ACQUIRE) : st->completed;
+            if (done >= task_count) {
+                break;
             }
         }
+
+        if (progress) {
+            idle_sweeps = 0;
+        } else {
+            AICPU_IDLE_POLL(++idle_sweeps);
+        }
     }
 
-    DEV_INFO("Execution complete: %d tasks completed", completed);
+    DEV_INFO("Thread %d: execution complete, %d tasks completed", threadId, completed);
     return completed;
 }
+
+/**
+ * Release the executor threads waiting for thread 0 without running the graph
+ *
+ * Called by the owner of executor thread 0 when it fails before calling
+ * execute(), e.g. in the AICore handshake; execute() then returns 0 on every
+ * other thread instead of waiting for exec_ready forever.
+ *
+ * @param g CSR task graph image shared by the executor threads
+ */
+void abort_execute(CsrGraph& g) {
+    __atomic_store_n(&g.exec_ready, -1, __ATOMIC_RELEASE);
+}
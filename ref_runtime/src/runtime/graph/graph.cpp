@@ -1,24 +1,69 @@
 /**
  * Graph Class - Implementation
  *
- * Task dependency graph management with circular ready queue.
+ * Task dependency graph management and CSR export.
  * Follows patterns from pto_runtime.c for consistency.
  */
 
 #include "graph.h"
 #include <limits>
+#include <new>
+
+// Initial capacities; arrays double when full.
+static constexpr int kInitialTaskCapacity = 64;
+static constexpr int kInitialEdgeCapacity = 128;
+
+// build_csr() stages task_count + 1 CSR offsets in the scratch area.
+static_assert(GRAPH_READY_QUEUES >= 2, "GRAPH_READY_QUEUES must be at least 2");
+
+static inline uint64_t align_up_64(uint64_t v) {
+    return (v + 63) & ~static_cast<uint64_t>(63);
+}
+
+// Grow `array` (holding `count` valid items) to at least `needed` slots.
+template <typename T>
+static bool grow_array(T*& array, int& capacity, int count, int needed, int initial) {
+    if (needed <= capacity) {
+        return true;
+    }
+    int new_capacity = capacity > 0 ? capacity : initial;
+    while (new_capacity < needed) {
+        if (new_capacity > std::numeric_limits<int>::max() / 2) {
+            return false;
+        }
+        new_capacity *= 2;
+    }
+    T* grown = new (std::nothrow) T[new_capacity];
+    if (grown == nullptr) {
+        return false;
+    }
+    if (count > 0) {
+        memcpy(static_cast<void*>(grown), array, static_cast<size_t>(count) * sizeof(T));
+    }
+    delete[] array;
+    array = grown;
+    capacity = new_capacity;
+    return true;
+}
 
 // =============================================================================
 // Constructor
 // =============================================================================
 
 Graph::Graph() {
-    // Zero-initialize all arrays
-    memset(tasks, 0, sizeof(tasks));
     memset(workers, 0, sizeof(workers));
-    next_task_id = 0;
-    initial_ready_count = 0;
     worker_count = 0;
+    tasks = nullptr;
+    next_task_id = 0;
+    task_capacity = 0;
+    edges = nullptr;
+    edge_count = 0;
+    edge_capacity = 0;
+}
+
+Graph::~Graph() {
+    delete[] tasks;
+    delete[] edges;
 }
 
 // =============================================================================
@@ -31,12 +76,6 @@ int Graph::add_task(uint64_t* args, int num_args, int func_id) {
     return add_task(args, num_args, func_id, /*core_type=*/1);
 }
 int Graph::add_task(uint64_t* args, int num_args, int func_id, int core_type) {
-    // Check bounds
-    if (next_task_id >= GRAPH_MAX_TASKS) {
-        fprintf(stderr, "[Graph] ERROR: Task table full (max=%d)\n", GRAPH_MAX_TASKS);
-        return -1;
-    }
-
     if (num_args > GRAPH_MAX_ARGS) {
         fprintf(stderr, "[Graph] ERROR: Too many args (%d > %d)\n",
                 num_args, GRAPH_MAX_ARGS);
@@ -49,6 +88,10 @@ int Graph::add_task(uint64_t* args, int num_args, int func_id, int core_type) {
     }
 
     // Allocate task
+    if (!grow_array(tasks, task_capacity, next_task_id, next_task_id + 1, kInitialTaskCapacity)) {
+        fprintf(stderr, "[Graph] ERROR: Out of memory growing task table (%d tasks)\n", next_task_id);
+        return -1;
+    }
     int task_id = next_task_id++;
     Task* task = &tasks[task_id];
 
@@ -62,8 +105,8 @@ int Graph::add_task(uint64_t* args, int num_args, int func_id, int core_type) {
     }
     task->functionBinAddr = 0;  // Will be set by host before copying to device
     task->fanin = 0;
+    task->fanout_offset = 0;
     task->fanout_count = 0;
-    memset(task->fanout, 0, sizeof(task->fanout));
     // Reset profiling (filled by AICore at runtime).
     memset(&task->profile, 0, sizeof(task->profile));
     task->profile.exec_core_id = std::numeric_limits<uint32_t>::max();
@@ -85,18 +128,16 @@ void Graph::add_successor(int from_task, int to_task) {
         return;
     }
 
-    Task* from = &tasks[from_task];
-    Task* to = &tasks[to_task];
-
-    // Add to_task to from_task's fanout
-    if (from->fanout_count >= GRAPH_MAX_FANOUT) {
-        fprintf(stderr, "[Graph] ERROR: Fanout overflow for task %d (max=%d)\n",
-                from_task, GRAPH_MAX_FANOUT);
+    if (!grow_array(edges, edge_capacity, edge_count, edge_count + 1, kInitialEdgeCapacity)) {
+        fprintf(stderr, "[Graph] ERROR: Out of memory growing edge list (%d edges)\n", edge_count);
         return;
     }
 
-    from->fanout[from->fanout_count++] = to_task;
-    to->fanin++;
+    edges[edge_count].from = from_task;
+    edges[edge_count].to = to_task;
+    edge_count++;
+    tasks[from_task].fanout_count++;
+    tasks[to_task].fanin++;
 }
 
 // =============================================================================
@@ -121,18 +162,82 @@ int Graph::get_task_count() const {
     return next_task_id;
 }
 
-int Graph::get_initial_ready_tasks(int* ready_tasks) {
-    initial_ready_count = 0;
+int Graph::get_edge_count() const {
+    return edge_count;
+}
+
+int Graph::get_initial_ready_tasks(int* ready_tasks) const {
+    int ready_count = 0;
     for (int i = 0; i < next_task_id; i++) {
         if (tasks[i].fanin == 0) {
-            initial_ready_tasks[initial_ready_count] = i;
             if (ready_tasks != nullptr) {
-                ready_tasks[initial_ready_count] = i;
+                ready_tasks[ready_count] = i;
             }
-            initial_ready_count++;
+            ready_count++;
         }
     }
-    return initial_ready_count;
+    return ready_count;
+}
+
+// =============================================================================
+// CSR Export
+// =============================================================================
+
+void Graph::fill_csr(int* out_offsets, int* out_edges) const {
+    // Exclusive prefix sum of fanout counts, then a stable scatter of the edge
+    // list so each producer's successors keep their insertion order.
+    out_offsets[0] = 0;
+    for (int i = 0; i < next_task_id; i++) {
+        out_offsets[i + 1] = out_offsets[i] + tasks[i].fanout_count;
+    }
+    for (int e = 0; e < edge_count; e++) {
+        // out_offsets[from] is used as the write cursor and restored below
+        out_edges[out_offsets[edges[e].from]++] = edges[e].to;
+    }
+    for (int i = next_task_id; i > 0; i--) {
+        out_offsets[i] = out_offsets[i - 1];
+    }
+    out_offsets[0] = 0;
+}
+
+size_t Graph::csr_bytes() const {
+    uint64_t bytes = align_up_64(sizeof(CsrGraph));
+    bytes += static_cast<uint64_t>(next_task_id) * sizeof(Task);
+    bytes = align_up_64(bytes + static_cast<uint64_t>(edge_count) * sizeof(int));
+    bytes += sizeof(GraphExecState);
+    bytes += static_cast<uint64_t>(GRAPH_READY_QUEUES) * static_cast<uint64_t>(next_task_id) * sizeof(int);
+    return static_cast<size_t>(align_up_64(bytes));
+}
+
+CsrGraph* Graph::build_csr(void* buffer, size_t bytes) const {
+    if (buffer == nullptr || bytes < csr_bytes()) {
+        fprintf(stderr, "[Graph] ERROR: CSR buffer too small (%zu < %zu bytes)\n", bytes, csr_bytes());
+        return nullptr;
+    }
+
+    CsrGraph* g = static_cast<CsrGraph*>(buffer);
+    memset(static_cast<void*>(g), 0, sizeof(CsrGraph));
+    g->task_count = next_task_id;
+    g->edge_count = edge_count;
+    g->tasks_offset = align_up_64(sizeof(CsrGraph));
+    g->edges_offset = g->tasks_offset + static_cast<uint64_t>(next_task_id) * sizeof(Task);
+    g->scratch_offset = align_up_64(g->edges_offset + static_cast<uint64_t>(edge_count) * sizeof(int));
+    g->image_bytes = g->edges_offset + static_cast<uint64_t>(edge_count) * sizeof(int);
+    g->total_bytes = csr_bytes();
+
+    Task* out_tasks = g->tasks();
+    int* out_edges = const_cast<int*>(g->edges());
+    if (next_task_id > 0) {
+        memcpy(static_cast<void*>(out_tasks), tasks, static_cast<size_t>(next_task_id) * sizeof(Task));
+
+        // Offsets are staged in the scratch area, which the executor overwrites later.
+        int* offsets = g->ready_queue(0);
+        fill_csr(offsets, out_edges);
+        for (int i = 0; i < next_task_id; i++) {
+            out_tasks[i].fanout_offset = offsets[i];
+        }
+    }
+    return g;
 }
 
 // =============================================================================
@@ -165,6 +270,12 @@ void Graph::print_graph() const {
     printf("\nTask Table:\n");
     printf("--------------------------------------------------------------------------------\n");
 
+    int* offsets = new (std::nothrow) int[next_task_id + 1];
+    int* fanout = new (std::nothrow) int[edge_count > 0 ? edge_count : 1];
+    if (offsets != nullptr && fanout != nullptr) {
+        fill_csr(offsets, fanout);
+    }
+
     for (int i = 0; i < next_task_id; i++) {
         const Task* t = &tasks[i];
 
@@ -172,12 +283,17 @@ void Graph::print_graph() const {
                i, t->func_id, t->fanin, t->fanout_count, t->num_args);
 
         // Print fanout list
-        for (int j = 0; j < t->fanout_count; j++) {
-            printf("%d%s", t->fanout[j],
-                   j < t->fanout_count - 1 ? "," : "");
+        if (offsets != nullptr && fanout != nullptr) {
+            for (int j = 0; j < t->fanout_count; j++) {
+                printf("%d%s", fanout[offsets[i] + j],
+                       j < t->fanout_count - 1 ? "," : "");
+            }
         }
         printf("]\n");
     }
 
+    delete[] offsets;
+    delete[] fanout;
+
     printf("================================================================================\n\n");
 }
@@ -2,14 +2,16 @@
  * Graph Class - Task Dependency Graph Management
  *
  * This is a simplified, standalone graph class for managing task dependencies.
- * Tasks are stored in a fixed-size array with compile-time configurable bounds.
- * Each task has:
+ * Tasks and edges are stored in growable host arrays, so graph size is bounded
+ * only by memory. Each task has:
  * - Unique ID (array index)
  * - Arguments (uint64_t array)
  * - Fanin (predecessor count)
- * - Fanout (array of successor task IDs)
+ * - Fanout (successor task IDs, stored as a CSR edge range)
  *
- * The graph maintains a ready queue for tasks with fanin == 0.
+ * For execution the graph is flattened into a CsrGraph image: one contiguous
+ * block holding the task array, the CSR edge array and executor scratch space,
+ * sized to the actual graph and copied to the device with a single memcpy.
  *
  * Based on patterns from pto_runtime.h/c but simplified for educational
  * and lightweight scheduling use cases.
@@ -19,6 +21,7 @@
 #define GRAPH_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>  // for fprintf, printf
 #include <string.h> // for memset
@@ -30,16 +33,14 @@ class DeviceRunner;
 // Configuration Macros
 // =============================================================================
 
-#ifndef GRAPH_MAX_TASKS
-#define GRAPH_MAX_TASKS 1024
-#endif
-
 #ifndef GRAPH_MAX_ARGS
 #define GRAPH_MAX_ARGS 16
 #endif
 
-#ifndef GRAPH_MAX_FANOUT
-#define GRAPH_MAX_FANOUT 512
+// Ready queues an executor may keep in the CsrGraph scratch area
+// (e.g. AIC / AIV / any), each sized to hold every task.
+#ifndef GRAPH_READY_QUEUES
+#define GRAPH_READY_QUEUES 3
 #endif
 
 #ifndef GRAPH_MAX_WORKER
@@ -135,25 +136,132 @@ typedef struct {
   uint64_t functionBinAddr;     // Address of kernel in device GM memory
 
   int fanin;                    // Number of predecessors (dependencies)
-  int fanout[GRAPH_MAX_FANOUT]; // Successor task IDs
+  int fanout_offset;            // First successor in the CSR edge array
   int fanout_count;             // Number of successors
 
   // DFX/perf fields (written by AICore).
   TaskProfile profile;
 } Task;
 
+// =============================================================================
+// CSR Graph Image
+// =============================================================================
+
+/**
+ * Head/tail of one executor ready queue
+ *
+ * The queue holds ready_queue(i)[head, tail). Every task becomes ready at most
+ * once per run, so the queues never wrap. Each queue gets its own cache line
+ * because several AICPU threads may update them concurrently.
+ */
+struct alignas(64) GraphReadyQueueState {
+  int head;
+  int tail;
+};
+
+/**
+ * Executor bookkeeping at the start of the CsrGraph scratch area
+ *
+ * Initialized by executor thread 0 at the start of every run.
+ */
+struct alignas(64) GraphExecState {
+  GraphReadyQueueState queues[GRAPH_READY_QUEUES];
+  alignas(64) int completed;  // Tasks completed by all executor threads
+};
+
+/**
+ * Flattened, position-independent task graph as executed on the device
+ *
+ * Layout of one contiguous block (all offsets in bytes from the header):
+ *
+ *   [CsrGraph header][Task tasks[task_count]][int edges[edge_count]][scratch]
+ *
+ * The successors of task t are edges[t.fanout_offset .. t.fanout_offset +
+ * t.fanout_count). Only the first image_bytes hold graph data and need to be
+ * copied; the trailing scratch area (GraphExecState followed by
+ * GRAPH_READY_QUEUES * task_count ints) is owned by the executor for its
+ * ready queues.
+ */
+struct alignas(64) CsrGraph {
+  uint64_t total_bytes;   // Header + tasks + edges + scratch
+  uint64_t image_bytes;   // Header + tasks + edges (the part that is copied)
+  uint64_t tasks_offset;
+  uint64_t edges_offset;
+  uint64_t scratch_offset;
+  int task_count;
+  int edge_count;
+  // 0 in the image; set to 1 by executor thread 0 once GraphExecState is set
+  // up, so that further executor threads may start, or to -1 by abort_execute()
+  // when thread 0 bails out before executing, so that they return instead.
+  int exec_ready;
+
+  Task *tasks() { return reinterpret_cast<Task *>(reinterpret_cast<uint8_t *>(this) + tasks_offset); }
+  const Task *tasks() const {
+    return reinterpret_cast<const Task *>(reinterpret_cast<const uint8_t *>(this) + tasks_offset);
+  }
+  const int *edges() const {
+    return reinterpret_cast<const int *>(reinterpret_cast<const uint8_t *>(this) + edges_offset);
+  }
+
+  int get_task_count() const { return task_count; }
+
+  Task *get_task(int task_id) {
+    return (task_id >= 0 && task_id < task_count) ? &tasks()[task_id] : nullptr;
+  }
+  const Task *get_task(int task_id) const {
+    return (task_id >= 0 && task_id < task_count) ? &tasks()[task_id] : nullptr;
+  }
+
+  /**
+   * Successor IDs of a task (task->fanout_count entries)
+   */
+  const int *fanout(const Task *task) const { return edges() + task->fanout_offset; }
+
+  /**
+   * Executor state at the start of the scratch area
+   */
+  GraphExecState *exec_state() {
+    return reinterpret_cast<GraphExecState *>(reinterpret_cast<uint8_t *>(this) + scratch_offset);
+  }
+
+  /**
+   * Executor scratch queue `index` (< GRAPH_READY_QUEUES), room for task_count IDs
+   */
+  int *ready_queue(int index) {
+    return reinterpret_cast<int *>(reinterpret_cast<uint8_t *>(this) + scratch_offset + sizeof(GraphExecState)) +
+           static_cast<size_t>(index) * static_cast<size_t>(task_count);
+  }
+
+  /**
+   * Write the IDs of tasks with fanin == 0 to ready_tasks (room for task_count)
+   *
+   * @return Number of initially ready tasks
+   */
+  int get_initial_ready_tasks(int *ready_tasks) const {
+    int count = 0;
+    const Task *t = tasks();
+    for (int i = 0; i < task_count; i++) {
+      if (t[i].fanin == 0) {
+        ready_tasks[count++] = i;
+      }
+    }
+    return count;
+  }
+};
+
 // =============================================================================
 // Graph Class
 // =============================================================================
 
 /**
- * Graph class for task dependency management
+ * Graph class for task dependency management (host-side builder)
  *
- * Maintains a fixed-size array of tasks and uses a Queue for ready tasks.
+ * Tasks and dependency edges are appended to arrays that grow on demand.
  * Tasks are allocated monotonically and never reused within the same
  * graph instance.
  *
- * Dependencies are managed manually via add_successor().
+ * Dependencies are managed manually via add_successor(). Before execution the
+ * graph is flattened with build_csr().
  */
 class Graph {
 public:
@@ -163,19 +271,33 @@ public:
   int worker_count;                      // Number of active workers
 
 private:
+  struct Edge {
+    int from;
+    int to;
+  };
+
   // Task storage
-  Task tasks[GRAPH_MAX_TASKS]; // Fixed-size task array
-  int next_task_id;            // Next available task ID
+  Task *tasks;          // Growable task array (64-byte aligned)
+  int next_task_id;     // Next available task ID
+  int task_capacity;
+
+  // Dependency edges in insertion order; grouped by producer in build_csr()
+  Edge *edges;
+  int edge_count;
+  int edge_capacity;
 
-  // Initial ready tasks (computed once, read-only after)
-  int initial_ready_tasks[GRAPH_MAX_TASKS];
-  int initial_ready_count;
+  // Fill out_offsets[task_count + 1] / out_edges[edge_count] (CSR by producer).
+  void fill_csr(int *out_offsets, int *out_edges) const;
 
 public:
   /**
-   * Constructor - zero-initialize all arrays
+   * Constructor - empty graph, zeroed handshake buffers
    */
   Graph();
+  ~Graph();
+
+  Graph(const Graph &) = delete;
+  Graph &operator=(const Graph &) = delete;
 
   // =========================================================================
   // Task Management
@@ -196,8 +318,8 @@ public:
   /**
    * Add a dependency edge: from_task -> to_task
    *
-   * This adds to_task to from_task's fanout array and increments
-   * to_task's fanin counter.
+   * This records the edge, adds it to from_task's fanout count and
+   * increments to_task's fanin counter.
    *
    * @param from_task  Producer task ID
    * @param to_task    Consumer task ID (depends on from_task)
@@ -224,6 +346,11 @@ public:
    */
   int get_task_count() const;
 
+  /**
+   * Get the total number of dependency edges in the graph
+   */
+  int get_edge_count() const;
+
   /**
    * Get initially ready tasks (fanin == 0) as entry point for execution
    *
@@ -234,7 +361,26 @@ public:
    * @param ready_tasks  Array to populate with ready task IDs (can be nullptr)
    * @return Number of initially ready tasks
    */
-  int get_initial_ready_tasks(int *ready_tasks);
+  int get_initial_ready_tasks(int *ready_tasks) const;
+
+  // =========================================================================
+  // CSR Export
+  // =========================================================================
+
+  /**
+   * Size in bytes of the CsrGraph image for the current graph
+   * (including executor scratch), a multiple of 64
+   */
+  size_t csr_bytes() const;
+
+  /**
+   * Flatten the graph into a CsrGraph image
+   *
+   * @param buffer  64-byte aligned destination of at least csr_bytes() bytes
+   * @param bytes   Size of buffer
+   * @return The image header (== buffer), or nullptr if buffer is too small
+   */
+  CsrGraph *build_csr(void *buffer, size_t bytes) const;
 
   // =========================================================================
   // Utility Methods
@@ -17,7 +17,6 @@
  *   task2 -> task3
  */
 
-#include "graph/graph.h"
 #include <stdint.h>
 #include <stddef.h>
 #include <new>
@@ -0,0 +1,12 @@
+/**
+ * Host stand-in for the AICPU scheduler platform hooks
+ *
+ * The fake AICore workers in the unit tests are host threads; yield while the
+ * scheduler is idle so they get CPU time on small machines.
+ */
+
+#pragma once
+
+#include <sched.h>
+
+#define AICPU_IDLE_POLL(idle_sweeps) ((void)(idle_sweeps), sched_yield())
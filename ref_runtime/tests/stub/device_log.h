@@ -0,0 +1,23 @@
+/**
+ * Host stand-in for the AICPU device logging header
+ *
+ * Lets AICPU scheduler sources compile and run in host unit tests without
+ * the CANN dlog library. Log calls are compiled (arguments stay referenced
+ * and format-checked) but never print.
+ */
+
+#pragma once
+
+#include <cstdio>
+
+#define DEV_LOG_DISABLED(fmt, ...)            \
+    do {                                      \
+        if (false) {                          \
+            printf(fmt, ##__VA_ARGS__);       \
+        }                                     \
+    } while (false)
+
+#define DEV_DEBUG(fmt, ...) DEV_LOG_DISABLED(fmt, ##__VA_ARGS__)
+#define DEV_INFO(fmt, ...) DEV_LOG_DISABLED(fmt, ##__VA_ARGS__)
+#define DEV_WARN(fmt, ...) DEV_LOG_DISABLED(fmt, ##__VA_ARGS__)
+#define DEV_ERROR(fmt, ...) DEV_LOG_DISABLED(fmt, ##__VA_ARGS__)
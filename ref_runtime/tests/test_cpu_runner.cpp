@@ -0,0 +1,309 @@
+/**
+ * Host-side test for the CPU emulation backend of DeviceRunner
+ *
+ * Runs graphs end to end through platform/cpu: emulated AICPU threads drive
+ * the shared graph executor and emulated AICore threads execute host kernels
+ * over the Handshake protocol.
+ *
+ * Checks:
+ * - results of the (a + b + 1)(a + b + 2) diamond graph
+ * - TaskProfile records: every task profiled, on a core of the requested type,
+ *   and never started before its predecessors ended
+ * - extra AICPU instances (launchAicpuNum > 1) do not disturb execution
+ * - a failed AICore handshake on AICPU thread 0 releases the other AICPU
+ *   threads instead of leaving them waiting for the executor forever
+ * - the example kernel sources compile and run through CompileAndLoadKernel
+ *
+ * Also prints the average dispatch cost per task for a graph of empty tasks.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "devicerunner.h"
+#include "graph.h"
+#include "kernel_args.h"
+#include "kernel_entry.h"
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "CHECK failed at %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+        }                                                                   \
+    } while (0)
+
+enum { kFuncAdd = 0, kFuncAddScalar = 1, kFuncMul = 2, kFuncNop = 3 };
+
+static void KernelAdd(int64_t* args) {
+    const float* a = reinterpret_cast<const float*>(args[0]);
+    const float* b = reinterpret_cast<const float*>(args[1]);
+    float* out = reinterpret_cast<float*>(args[2]);
+    for (int64_t i = 0; i < args[3]; i++) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+static void KernelAddScalar(int64_t* args) {
+    const float* a = reinterpret_cast<const float*>(args[0]);
+    float* out = reinterpret_cast<float*>(args[1]);
+    for (int64_t i = 0; i < args[2]; i++) {
+        out[i] = a[i] + static_cast<float>(args[3]);
+    }
+}
+
+static void KernelMul(int64_t* args) {
+    const float* a = reinterpret_cast<const float*>(args[0]);
+    const float* b = reinterpret_cast<const float*>(args[1]);
+    float* out = reinterpret_cast<float*>(args[2]);
+    for (int64_t i = 0; i < args[3]; i++) {
+        out[i] = a[i] * b[i];
+    }
+}
+
+static void KernelNop(int64_t* args) {
+    (void)args;
+}
+
+static uint64_t Ptr(void* p) {
+    return reinterpret_cast<uint64_t>(p);
+}
+
+/**
+ * f = (a + b + 1)(a + b + 2) with task core types AIV, AIC, any, AIV.
+ */
+static void TestDiamond(int launchAicpuNum) {
+    DeviceRunner& runner = DeviceRunner::Get();
+    const int n = 1024;
+    const size_t bytes = n * sizeof(float);
+    std::vector<float> ha(n, 2.0f);
+    std::vector<float> hb(n, 3.0f);
+    void* a = runner.AllocateTensor(bytes);
+    void* b = runner.AllocateTensor(bytes);
+    void* c = runner.AllocateTensor(bytes);
+    void* d = runner.AllocateTensor(bytes);
+    void* e = runner.AllocateTensor(bytes);
+    void* f = runner.AllocateTensor(bytes);
+    CHECK(runner.CopyToDevice(a, ha.data(), bytes) == 0);
+    CHECK(runner.CopyToDevice(b, hb.data(), bytes) == 0);
+
+    Graph g;
+    uint64_t args0[4] = {Ptr(a), Ptr(b), Ptr(c), n};
+    uint64_t args1[4] = {Ptr(c), Ptr(d), n, 1};
+    uint64_t args2[4] = {Ptr(c), Ptr(e), n, 2};
+    uint64_t args3[4] = {Ptr(d), Ptr(e), Ptr(f), n};
+    int t0 = g.add_task(args0, 4, kFuncAdd, 2);
+    int t1 = g.add_task(args1, 4, kFuncAddScalar, 1);
+    int t2 = g.add_task(args2, 4, kFuncAddScalar, 0);
+    int t3 = g.add_task(args3, 4, kFuncMul, 2);
+    g.add_successor(t0, t1);
+    g.add_successor(t0, t2);
+    g.add_successor(t1, t3);
+    g.add_successor(t2, t3);
+
+    runner.SetProfileEnabled(true);
+    CHECK(runner.Run(g, 6, launchAicpuNum) == 0);
+
+    std::vector<float> hf(n, 0.0f);
+    CHECK(runner.CopyFromDevice(hf.data(), f, bytes) == 0);
+    int wrong = 0;
+    for (float v : hf) {
+        if (v != 42.0f) {
+            wrong++;
+        }
+    }
+    CHECK(wrong == 0);
+
+    CHECK(runner.HasLastProfile());
+    std::vector<TaskProfileRecord> prof = runner.GetLastProfile();
+    CHECK(prof.size() == 4);
+    if (prof.size() == 4) {
+        for (const TaskProfileRecord& r : prof) {
+            CHECK(r.exec_core_type == 1 || r.exec_core_type == 2);
+            CHECK(r.core_type == 0 || static_cast<uint32_t>(r.core_type) == r.exec_core_type);
+            CHECK(r.start_time != 0 && r.start_time <= r.end_time);
+            CHECK(r.exec_core_id < 6);
+            // 6 cores -> 2 AIC (ids 0..1) + 4 AIV
+            CHECK((r.exec_core_type == 1) == (r.exec_core_id < 2));
+        }
+        CHECK(prof[1].start_time >= prof[0].end_time);
+        CHECK(prof[2].start_time >= prof[0].end_time);
+        CHECK(prof[3].start_time >= prof[1].end_time);
+        CHECK(prof[3].start_time >= prof[2].end_time);
+    }
+    runner.SetProfileEnabled(false);
+
+    for (void* p : {a, b, c, d, e, f}) {
+        runner.FreeTensor(p);
+    }
+}
+
+/**
+ * Dispatch benchmark: kTasks empty tasks, task i depends on task i - numCores,
+ * so every core is refilled as soon as its previous task completes.
+ *
+ * Reports wall time per task and, from TaskProfile, the mean dispatch gap:
+ * time from a predecessor's end to its successor's start (completion
+ * detection + fanin update + dispatch + AICore pickup).
+ */
+static void BenchDispatch(int numCores, int launchAicpuNum) {
+    DeviceRunner& runner = DeviceRunner::Get();
+    const int kTasks = 2000;
+
+    Graph g;
+    uint64_t args[1] = {0};
+    for (int i = 0; i < kTasks; i++) {
+        g.add_task(args, 1, kFuncNop, i % 3);
+        if (i >= numCores) {
+            g.add_successor(i - numCores, i);
+        }
+    }
+    runner.SetProfileEnabled(true);
+    CHECK(runner.Run(g, numCores, launchAicpuNum) == 0);
+    std::vector<TaskProfileRecord> prof = runner.GetLastProfile();
+    runner.SetProfileEnabled(false);
+
+    CHECK(prof.size() == static_cast<size_t>(kTasks));
+    if (prof.size() != static_cast<size_t>(kTasks)) {
+        return;
+    }
+    double gapSum = 0.0;
+    int ordering = 0;
+    for (int i = numCores; i < kTasks; i++) {
+        const TaskProfileRecord& pred = prof[static_cast<size_t>(i - numCores)];
+        const TaskProfileRecord& succ = prof[static_cast<size_t>(i)];
+        if (succ.start_time < pred.end_time) {
+            ordering++;
+            continue;
+        }
+        gapSum += static_cast<double>(succ.start_time - pred.end_time);
+    }
+    CHECK(ordering == 0);
+
+    const double ns = static_cast<double>(runner.LastRunNanos());
+    printf("  %d tasks, %d cores, %d AICPU: %.0f ns/task, mean dispatch gap %.0f ns\n",
+           kTasks, numCores, launchAicpuNum, ns / kTasks, gapSum / (kTasks - numCores));
+}
+
+static void TestCompiledKernel() {
+    DeviceRunner& runner = DeviceRunner::Get();
+    const std::string kernel = std::string(PTO_REF_RUNTIME_DIR) + "/example/kernels/aiv/kernel_add.cpp";
+    CHECK(runner.CompileAndLoadKernel(10, kernel, 1) == 0);
+
+    const int n = 256;
+    std::vector<float> ha(n, 1.5f);
+    std::vector<float> hb(n, 2.0f);
+    std::vector<float> hc(n, 0.0f);
+    void* a = runner.AllocateTensor(n * sizeof(float));
+    void* b = runner.AllocateTensor(n * sizeof(float));
+    void* c = runner.AllocateTensor(n * sizeof(float));
+    runner.CopyToDevice(a, ha.data(), n * sizeof(float));
+    runner.CopyToDevice(b, hb.data(), n * sizeof(float));
+
+    CHECK(runner.RunTask({Ptr(a), Ptr(b), Ptr(c), n}, 10) == 0);
+    runner.CopyFromDevice(hc.data(), c, n * sizeof(float));
+    int wrong = 0;
+    for (float v : hc) {
+        if (v != 3.5f) {
+            wrong++;
+        }
+    }
+    CHECK(wrong == 0);
+
+    runner.FreeTensor(a);
+    runner.FreeTensor(b);
+    runner.FreeTensor(c);
+}
+
+/**
+ * Drive the emulated AICPU kernel directly with a core count the handshake
+ * rejects (DeviceRunner::Run would refuse it up front). Thread 0 fails before
+ * the executor starts; threads 1..n-1 must still return.
+ */
+static void TestHandshakeFailure(int launchAicpuNum) {
+    Graph g;
+    uint64_t args[1] = {0};
+    g.add_task(args, 1, kFuncNop, 2);
+    const size_t bytes = g.csr_bytes();
+    std::unique_ptr<uint8_t, decltype(&std::free)> buf(static_cast<uint8_t*>(std::aligned_alloc(64, bytes)),
+                                                       &std::free);
+    CsrGraph* csr = buf ? g.build_csr(buf.get(), bytes) : nullptr;
+    CHECK(csr != nullptr);
+    if (csr == nullptr) {
+        return;
+    }
+
+    std::vector<Handshake> hank(GRAPH_MAX_WORKER + 1, Handshake{});
+    PtoRuntimeArgs rtargs;
+    rtargs.hankArgs = hank.data();
+    rtargs.graphArgs = csr;
+    rtargs.core_num = GRAPH_MAX_WORKER + 1;
+
+    std::vector<int> rc(static_cast<size_t>(launchAicpuNum), 0);
+    std::atomic<int> returned{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < launchAicpuNum; i++) {
+        threads.emplace_back([&rtargs, &rc, &returned, i, launchAicpuNum]() {
+            rc[static_cast<size_t>(i)] = CpuAicpuKernelServer(&rtargs, i, launchAicpuNum);
+            returned.fetch_add(1);
+        });
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (returned.load() < launchAicpuNum && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (returned.load() < launchAicpuNum) {
+        // The stuck threads cannot be joined; fail without waiting for them.
+        fprintf(stderr, "CHECK failed: %d of %d AICPU threads still waiting after a failed handshake\n",
+                launchAicpuNum - returned.load(), launchAicpuNum);
+        printf("FAILED\n");
+        std::_Exit(1);
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    CHECK(rc[0] != 0);
+    for (int i = 1; i < launchAicpuNum; i++) {
+        CHECK(rc[static_cast<size_t>(i)] == 0);
+    }
+    CHECK(csr->exec_ready < 0);
+}
+
+int main() {
+    DeviceRunner& runner = DeviceRunner::Get();
+    CHECK(runner.Init(0, {}, {}, PTO_ISA_ROOT_DIR) == 0);
+    runner.RegisterKernelFunc(kFuncAdd, KernelAdd);
+    runner.RegisterKernelFunc(kFuncAddScalar, KernelAddScalar);
+    runner.RegisterKernelFunc(kFuncMul, KernelMul);
+    runner.RegisterKernelFunc(kFuncNop, KernelNop);
+
+    printf("test_cpu_runner: diamond graph\n");
+    TestDiamond(1);
+    printf("test_cpu_runner: diamond graph, 2 AICPU instances\n");
+    TestDiamond(2);
+    printf("test_cpu_runner: failed handshake, 3 AICPU instances\n");
+    TestHandshakeFailure(3);
+    printf("test_cpu_runner: dispatch benchmark\n");
+    BenchDispatch(6, 1);
+    BenchDispatch(24, 1);
+    BenchDispatch(24, 2);
+    printf("test_cpu_runner: compiled example kernel\n");
+    TestCompiledKernel();
+
+    CHECK(runner.Finalize() == 0);
+
+    if (g_failures != 0) {
+        printf("FAILED (%d checks)\n", g_failures);
+        return 1;
+    }
+    printf("PASSED\n");
+    return 0;
+}
@@ -0,0 +1,256 @@
+/**
+ * Host-side unit test for the CSR task graph
+ *
+ * Builds large graphs with Graph, flattens them with build_csr(), copies the
+ * image into a stand-in "device memory" buffer the same way DeviceRunner::Run
+ * does, and runs the AICPU scheduler (graphexecutor.cpp) against it. Simulated
+ * AICore workers are host threads that follow the Handshake protocol.
+ *
+ * Checks:
+ * - CSR edges match the edges passed to add_successor() (in insertion order)
+ * - graphs beyond the old 1024-task / 512-fanout limits are accepted
+ * - every task runs exactly once, on a core of the requested type, and only
+ *   after all of its predecessors completed
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "graph.h"
+
+int execute(CsrGraph& g, Handshake* hank, int core_num, int threadId, int threadNum);
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "CHECK failed at %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+        }                                                                   \
+    } while (0)
+
+struct EdgeRef {
+    int from;
+    int to;
+};
+
+// Stand-in device memory: a separate 64-byte aligned allocation that only
+// receives the first image_bytes of the host image, like rtMemcpy H2D.
+static CsrGraph* CopyToFakeDevice(const Graph& graph, std::vector<uint8_t*>& allocations) {
+    const size_t bytes = graph.csr_bytes();
+    uint8_t* host = static_cast<uint8_t*>(std::aligned_alloc(64, bytes));
+    uint8_t* device = static_cast<uint8_t*>(std::aligned_alloc(64, bytes));
+    allocations.push_back(host);
+    allocations.push_back(device);
+    if (host == nullptr || device == nullptr) {
+        return nullptr;
+    }
+    memset(device, 0xA5, bytes);  // Scratch must not rely on being zeroed
+    CsrGraph* image = graph.build_csr(host, bytes);
+    if (image == nullptr) {
+        return nullptr;
+    }
+    memcpy(device, host, image->image_bytes);
+    return reinterpret_cast<CsrGraph*>(device);
+}
+
+static void TestCsrLayout() {
+    Graph g;
+    uint64_t args[2] = {7, 9};
+    const int kTasks = 5000;
+    const int kHubFanout = 4000;  // Above the old GRAPH_MAX_FANOUT of 512
+    for (int i = 0; i < kTasks; i++) {
+        CHECK(g.add_task(args, 2, i % 3, i % 3) == i);
+    }
+
+    std::vector<EdgeRef> edges;
+    // Interleave producers so the builder has to regroup edges by source.
+    for (int i = 1; i <= kHubFanout; i++) {
+        edges.push_back({0, i});
+        if (i + 1 < kTasks) {
+            edges.push_back({i, i + 1});
+        }
+    }
+    for (const EdgeRef& e : edges) {
+        g.add_successor(e.from, e.to);
+    }
+    CHECK(g.get_edge_count() == static_cast<int>(edges.size()));
+
+    std::vector<uint8_t*> allocations;
+    CsrGraph* csr = CopyToFakeDevice(g, allocations);
+    CHECK(csr != nullptr);
+    if (csr != nullptr) {
+        CHECK(csr->get_task_count() == kTasks);
+        CHECK(csr->edge_count == static_cast<int>(edges.size()));
+        CHECK(csr->tasks_offset % 64 == 0);
+        CHECK(csr->image_bytes <= csr->total_bytes);
+
+        // Expected successor lists in insertion order.
+        std::vector<std::vector<int>> expected(kTasks);
+        for (const EdgeRef& e : edges) {
+            expected[e.from].push_back(e.to);
+        }
+        int fanin_sum = 0;
+        for (int t = 0; t < kTasks; t++) {
+            const Task* task = csr->get_task(t);
+            CHECK(task->task_id == t);
+            CHECK(task->args[0] == 7 && task->args[1] == 9 && task->num_args == 2);
+            CHECK(task->fanout_count == static_cast<int>(expected[t].size()));
+            for (int j = 0; j < task->fanout_count && j < static_cast<int>(expected[t].size()); j++) {
+                CHECK(csr->fanout(task)[j] == expected[t][j]);
+            }
+            fanin_sum += task->fanin;
+        }
+        CHECK(fanin_sum == csr->edge_count);
+        CHECK(csr->get_task(kTasks) == nullptr);
+        CHECK(csr->get_task(-1) == nullptr);
+    }
+
+    // A buffer that is too small is rejected.
+    std::vector<uint8_t> small(64);
+    CHECK(g.build_csr(small.data(), small.size()) == nullptr);
+
+    for (uint8_t* p : allocations) {
+        std::free(p);
+    }
+}
+
+static void TestEmptyGraph() {
+    Graph g;
+    std::vector<uint8_t*> allocations;
+    CsrGraph* csr = CopyToFakeDevice(g, allocations);
+    CHECK(csr != nullptr);
+    if (csr != nullptr) {
+        CHECK(csr->get_task_count() == 0);
+        Handshake hank[1];
+        memset(hank, 0, sizeof(hank));
+        CHECK(execute(*csr, hank, 1, 0, 1) == 0);
+    }
+    for (uint8_t* p : allocations) {
+        std::free(p);
+    }
+}
+
+// Simulated AICore: completes whatever task the scheduler hands it.
+static void FakeCore(Handshake* h, int core_id, std::atomic<int>* seq, std::vector<int>* finish_seq,
+                     std::vector<int>* start_seq, std::vector<int>* ran_on) {
+    while (h->control == 0) {
+        if (h->task_status == 1 && h->task != 0) {
+            Task* task = reinterpret_cast<Task*>(h->task);
+            (*start_seq)[task->task_id] = seq->fetch_add(1);
+            (*ran_on)[task->task_id] = core_id;
+            (*finish_seq)[task->task_id] = seq->fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            h->task_status = 0;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+static void TestExecuteLargeGraph() {
+    const int kTasks = 100000;
+    const int kAic = 8;
+    const int kAiv = 16;
+    const int kCores = kAic + kAiv;
+
+    Graph g;
+    uint64_t args[1] = {0};
+    std::vector<EdgeRef> edges;
+    for (int i = 0; i < kTasks; i++) {
+        g.add_task(args, 1, 0, i % 3);  // Mix any / AIC / AIV tasks
+    }
+    // Layered DAG: each task feeds a few tasks further ahead.
+    for (int i = 0; i < kTasks; i++) {
+        const int succ[3] = {i + 1, i + 64, i + 1000};
+        for (int s : succ) {
+            if (s < kTasks && (i % 4 != 0 || s == i + 1000)) {
+                g.add_successor(i, s);
+                edges.push_back({i, s});
+            }
+        }
+    }
+
+    std::vector<uint8_t*> allocations;
+    CsrGraph* csr = CopyToFakeDevice(g, allocations);
+    CHECK(csr != nullptr);
+    if (csr == nullptr) {
+        return;
+    }
+    printf("  %d tasks, %d edges: CSR image %llu bytes (%zu bytes/task)\n", csr->get_task_count(),
+           csr->edge_count, static_cast<unsigned long long>(csr->image_bytes), sizeof(Task));
+
+    std::vector<Handshake> hank(kCores);
+    memset(static_cast<void*>(hank.data()), 0, sizeof(Handshake) * hank.size());
+    for (int i = 0; i < kCores; i++) {
+        hank[i].core_type = (i < kAic) ? 0 : 1;  // Executor: 0 = AIC core, 1 = AIV core
+    }
+
+    std::atomic<int> seq{0};
+    std::vector<int> start_seq(kTasks, -1);
+    std::vector<int> finish_seq(kTasks, -1);
+    std::vector<int> ran_on(kTasks, -1);
+    std::vector<std::thread> cores;
+    for (int i = 0; i < kCores; i++) {
+        cores.emplace_back(FakeCore, &hank[i], i, &seq, &finish_seq, &start_seq, &ran_on);
+    }
+
+    int completed = execute(*csr, hank.data(), kCores, 0, 1);
+
+    for (int i = 0; i < kCores; i++) {
+        hank[i].control = 1;
+    }
+    for (std::thread& t : cores) {
+        t.join();
+    }
+
+    CHECK(completed == kTasks);
+    int not_run = 0;
+    int wrong_core = 0;
+    for (int t = 0; t < kTasks; t++) {
+        if (finish_seq[t] < 0) {
+            not_run++;
+            continue;
+        }
+        const int core_type = t % 3;
+        const bool is_aic = ran_on[t] < kAic;
+        if ((core_type == 1 && !is_aic) || (core_type == 2 && is_aic)) {
+            wrong_core++;
+        }
+    }
+    CHECK(not_run == 0);
+    CHECK(wrong_core == 0);
+
+    int order_violations = 0;
+    for (const EdgeRef& e : edges) {
+        if (finish_seq[e.from] < 0 || start_seq[e.to] < finish_seq[e.from]) {
+            order_violations++;
+        }
+    }
+    CHECK(order_violations == 0);
+
+    for (uint8_t* p : allocations) {
+        std::free(p);
+    }
+}
+
+int main() {
+    printf("test_graph_csr: layout\n");
+    TestCsrLayout();
+    printf("test_graph_csr: empty graph\n");
+    TestEmptyGraph();
+    printf("test_graph_csr: execute large graph\n");
+    TestExecuteLargeGraph();
+
+    if (g_failures != 0) {
+        printf("FAILED (%d checks)\n", g_failures);
+        return 1;
+    }
+    printf("PASSED\n");
+    return 0;
+}
@@ -0,0 +1,328 @@
+/**
+ * Host-side test for the on-disk compiled kernel cache
+ *
+ * Drives the CPU backend's KernelCompiler with a fake compiler script that
+ * logs every invocation, so cache hits are observable without a toolchain.
+ *
+ * Checks:
+ * - SHA-256 against the FIPS 180-4 test vectors
+ * - cold compile misses, warm compile hits without running the compiler
+ * - key changes with source, quoted and <pto/...> headers, flags and compiler
+ * - a second KernelCache on the same directory (a new process) hits
+ * - LRU eviction removes the least recently used entry
+ * - eviction removes stale lock files only while nobody holds them
+ * - concurrent processes compiling the same kernel run the compiler once
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "kernel_cache.h"
+#include "kernel_compiler.h"
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "CHECK failed at %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+        }                                                                   \
+    } while (0)
+
+static std::string g_root;  // scratch directory of this run
+
+static void WriteFile(const std::string& path, const std::string& text) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << text;
+}
+
+static std::string ReadFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream oss;
+    oss << in.rdbuf();
+    return oss.str();
+}
+
+static int CountLines(const std::string& path) {
+    std::ifstream in(path);
+    int n = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        n++;
+    }
+    return n;
+}
+
+/**
+ * Fake compiler: answers --version, logs each compilation and writes
+ * "<version>:<source contents>" to the -o file after an optional delay.
+ */
+static std::string MakeFakeCompiler(const std::string& name, const std::string& version) {
+    const std::string path = g_root + "/" + name;
+    WriteFile(path,
+              "#!/bin/sh\n"
+              "if [ \"$1\" = \"--version\" ]; then echo \"" + version + "\"; exit 0; fi\n"
+              "out=\"\"; src=\"\"\n"
+              "while [ $# -gt 0 ]; do\n"
+              "  case \"$1\" in\n"
+              "    -o) out=\"$2\"; shift ;;\n"
+              "    -*) ;;\n"
+              "    *) src=\"$1\" ;;\n"
+              "  esac\n"
+              "  shift\n"
+              "done\n"
+              "echo \"$src\" >> \"" + g_root + "/compile.log\"\n"
+              "if [ -n \"$FAKE_CC_DELAY\" ]; then sleep \"$FAKE_CC_DELAY\"; fi\n"
+              "{ printf '" + version + ":'; cat \"$src\"; } > \"$out\"\n");
+    chmod(path.c_str(), 0755);
+    return path;
+}
+
+static int Compile(const std::string& source, int coreType, std::string& output) {
+    std::string errorMsg;
+    int rc = KernelCompiler::CompileKernel(source, g_root + "/isa", coreType, output, errorMsg);
+    if (rc != 0) {
+        fprintf(stderr, "compile failed: %s\n", errorMsg.c_str());
+    }
+    return rc;
+}
+
+static int Compilations() {
+    return CountLines(g_root + "/compile.log");
+}
+
+static void TestSha256() {
+    CHECK(KernelCache::Sha256Hex("") ==
+          "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    CHECK(KernelCache::Sha256Hex("abc") ==
+          "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    CHECK(KernelCache::Sha256Hex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+          "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    CHECK(KernelCache::Sha256Hex(std::string(1000000, 'a')) ==
+          "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+static void TestCompileHitsAndKeys() {
+    const std::string src = g_root + "/kernel_a.cpp";
+    WriteFile(src, "#include \"local.h\"\n#include <pto/tile.hpp>\nint a;\n");
+    WriteFile(g_root + "/local.h", "int local;\n");
+
+    // Cold: the compiler runs and the output is the fake object.
+    std::string out1;
+    CHECK(Compile(src, 1, out1) == 0);
+    CHECK(Compilations() == 1);
+    CHECK(ReadFile(out1) == "fakecc 1.0:" + ReadFile(src));
+    KernelCache::Stats s = KernelCache::Default().GetStats();
+    CHECK(s.hits == 0 && s.misses == 1 && s.stores == 1);
+
+    // Warm: served from the cache into a fresh output path.
+    std::string out2;
+    CHECK(Compile(src, 1, out2) == 0);
+    CHECK(Compilations() == 1);
+    CHECK(out2 != out1);
+    CHECK(ReadFile(out2) == ReadFile(out1));
+    s = KernelCache::Default().GetStats();
+    CHECK(s.hits == 1 && s.misses == 1);
+
+    // Flags: AIC vs AIV.
+    std::string out3;
+    CHECK(Compile(src, 0, out3) == 0);
+    CHECK(Compilations() == 2);
+
+    // Quoted header next to the source (size changes so the mtime/size memo
+    // notices even within one timestamp tick).
+    WriteFile(g_root + "/local.h", "int local_changed;\n");
+    CHECK(Compile(src, 1, out3) == 0);
+    CHECK(Compilations() == 3);
+
+    // Header found through the PTO-ISA include directories.
+    WriteFile(g_root + "/isa/include/pto/tile.hpp", "// tile v2, longer\n");
+    CHECK(Compile(src, 1, out3) == 0);
+    CHECK(Compilations() == 4);
+    CHECK(Compile(src, 1, out3) == 0);
+    CHECK(Compilations() == 4);
+
+    // Source contents.
+    WriteFile(src, "#include \"local.h\"\n#include <pto/tile.hpp>\nint a2;\n");
+    CHECK(Compile(src, 1, out3) == 0);
+    CHECK(Compilations() == 5);
+
+    // Same contents at another path hits: the key is content-addressed.
+    const std::string copy = g_root + "/kernel_a_copy.cpp";
+    WriteFile(copy, ReadFile(src));
+    CHECK(Compile(copy, 1, out3) == 0);
+    CHECK(Compilations() == 5);
+
+    // Compiler identity.
+    const std::string cc2 = MakeFakeCompiler("fakecc2", "fakecc 2.0");
+    setenv("PTO_CPU_KERNEL_CXX", cc2.c_str(), 1);
+    CHECK(Compile(src, 1, out3) == 0);
+    CHECK(Compilations() == 6);
+    CHECK(ReadFile(out3).compare(0, 11, "fakecc 2.0:") == 0);
+    setenv("PTO_CPU_KERNEL_CXX", (g_root + "/fakecc").c_str(), 1);
+
+    // A new cache object on the same directory models a warm process start.
+    KernelCache other(KernelCache::Default().Dir(), 0);
+    const std::string key = other.MakeKey(g_root + "/fakecc", "flags", src, {});
+    CHECK(key.size() == 64);
+    CHECK(other.MakeKey(g_root + "/fakecc", "flags", src, {}) == key);
+    CHECK(other.MakeKey(g_root + "/fakecc", "flags2", src, {}) != key);
+    CHECK(!other.Fetch(key, g_root + "/fetched.bin"));
+    CHECK(other.Store(key, out1) == 0);
+    KernelCache third(KernelCache::Default().Dir(), 0);
+    CHECK(third.Fetch(key, g_root + "/fetched.bin"));
+    CHECK(ReadFile(g_root + "/fetched.bin") == ReadFile(out1));
+
+    for (const std::string& p : {out1, out2, out3}) {
+        unlink(p.c_str());
+    }
+}
+
+static void TestLruEviction() {
+    const std::string dir = g_root + "/lru";
+    const std::string blob = g_root + "/blob.bin";
+    WriteFile(blob, std::string(1000, 'x'));
+    KernelCache cache(dir, 3000);
+
+    auto key = [](int i) { return KernelCache::Sha256Hex("entry" + std::to_string(i)); };
+    // File timestamps may be tick-granular; space the operations out.
+    auto tick = [] { std::this_thread::sleep_for(std::chrono::milliseconds(20)); };
+    for (int i = 0; i < 3; i++) {
+        CHECK(cache.Store(key(i), blob) == 0);
+        tick();
+    }
+    // Use entry 0 so that entry 1 becomes the least recently used.
+    CHECK(cache.Fetch(key(0), g_root + "/lru_out.bin"));
+    tick();
+    CHECK(cache.Store(key(3), blob) == 0);
+
+    CHECK(cache.GetStats().evictions == 1);
+    CHECK(cache.Fetch(key(0), g_root + "/lru_out.bin"));
+    CHECK(!cache.Fetch(key(1), g_root + "/lru_out.bin"));
+    CHECK(cache.Fetch(key(2), g_root + "/lru_out.bin"));
+    CHECK(cache.Fetch(key(3), g_root + "/lru_out.bin"));
+}
+
+static void TestStaleLockFiles() {
+    const std::string dir = g_root + "/locks";
+    const std::string blob = g_root + "/blob.bin";
+    WriteFile(blob, std::string(1000, 'x'));
+    KernelCache cache(dir, 1 << 20);
+
+    auto lockPath = [&](const std::string& key) {
+        const std::string subdir = dir + "/" + key.substr(0, 2);
+        mkdir(dir.c_str(), 0755);
+        mkdir(subdir.c_str(), 0755);
+        return subdir + "/" + key + ".lock";
+    };
+    // Two hours old: past the staleness limit, as for a long-running compile.
+    auto age = [](const std::string& path) {
+        struct timespec times[2];
+        clock_gettime(CLOCK_REALTIME, &times[0]);
+        times[0].tv_sec -= 7200;
+        times[1] = times[0];
+        CHECK(utimensat(AT_FDCWD, path.c_str(), times, 0) == 0);
+    };
+    auto exists = [](const std::string& path) { return access(path.c_str(), F_OK) == 0; };
+
+    const std::string held = lockPath(KernelCache::Sha256Hex("held"));
+    const std::string unheld = lockPath(KernelCache::Sha256Hex("unheld"));
+    const int fd = open(held.c_str(), O_RDWR | O_CREAT, 0644);
+    CHECK(fd >= 0 && flock(fd, LOCK_EX) == 0);
+    WriteFile(unheld, "");
+    age(held);
+    age(unheld);
+
+    CHECK(cache.Store(KernelCache::Sha256Hex("entry"), blob) == 0);  // Store runs Evict
+    CHECK(exists(held));
+    CHECK(!exists(unheld));
+
+    flock(fd, LOCK_UN);
+    close(fd);
+    age(held);
+    CHECK(cache.Store(KernelCache::Sha256Hex("entry"), blob) == 0);
+    CHECK(!exists(held));
+}
+
+static void TestConcurrentProcesses() {
+    const std::string src = g_root + "/kernel_shared.cpp";
+    WriteFile(src, "int shared_kernel;\n");
+    const int before = Compilations();
+
+    setenv("FAKE_CC_DELAY", "0.3", 1);
+    const int kProcs = 4;
+    std::vector<pid_t> pids;
+    fflush(stdout);
+    for (int i = 0; i < kProcs; i++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            // Children share only the cache directory with each other.
+            std::string out;
+            int rc = Compile(src, 1, out);
+            bool ok = rc == 0 && ReadFile(out) == "fakecc 1.0:" + ReadFile(src);
+            unlink(out.c_str());
+            _exit(ok ? 0 : 1);
+        }
+        pids.push_back(pid);
+    }
+    for (pid_t pid : pids) {
+        int status = 0;
+        CHECK(waitpid(pid, &status, 0) == pid);
+        CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    unsetenv("FAKE_CC_DELAY");
+    CHECK(Compilations() == before + 1);
+}
+
+int main() {
+    char tmpl[] = "/tmp/test_kernel_cache_XXXXXX";
+    if (mkdtemp(tmpl) == nullptr) {
+        perror("mkdtemp");
+        return 1;
+    }
+    g_root = tmpl;
+    mkdir((g_root + "/isa").c_str(), 0755);
+    mkdir((g_root + "/isa/include").c_str(), 0755);
+    mkdir((g_root + "/isa/include/pto").c_str(), 0755);
+    WriteFile(g_root + "/isa/include/pto/tile.hpp", "// tile v1\n");
+
+    // Must be set before the first KernelCache::Default() call.
+    const std::string cc = MakeFakeCompiler("fakecc", "fakecc 1.0");
+    setenv("PTO_CPU_KERNEL_CXX", cc.c_str(), 1);
+    setenv("PTO_KERNEL_CACHE_DIR", (g_root + "/cache").c_str(), 1);
+    unsetenv("PTO_KERNEL_CACHE");
+
+    printf("test_kernel_cache: sha256\n");
+    TestSha256();
+    printf("test_kernel_cache: hits and key inputs\n");
+    TestCompileHitsAndKeys();
+    printf("test_kernel_cache: LRU eviction\n");
+    TestLruEviction();
+    printf("test_kernel_cache: stale lock files\n");
+    TestStaleLockFiles();
+    printf("test_kernel_cache: concurrent processes\n");
+    TestConcurrentProcesses();
+
+    if (g_failures == 0) {
+        std::string cmd = "rm -rf " + g_root;
+        if (system(cmd.c_str()) != 0) {
+            fprintf(stderr, "warning: could not remove %s\n", g_root.c_str());
+        }
+        printf("PASSED\n");
+        return 0;
+    }
+    printf("FAILED (%d checks, scratch kept in %s)\n", g_failures, g_root.c_str());
+    return 1;
+}
@@ -0,0 +1,241 @@
+/**
+ * Host-side test for the packed kernel-binary loader (a2a3/host/binary_loader)
+ *
+ * Writes synthetic ELF64 objects (.data + .text + .shstrtab) and checks:
+ * - PackKernelBinaries() produces the same CoreFunctionBinCache image as
+ *   the per-kernel path it replaces (read file, extract .text, copy, pack)
+ * - single-threaded and parallel packing agree
+ * - LoadPackedKernelImage() persists the image, reuses it on the next call
+ *   and re-packs when an object changes
+ * - broken objects are rejected
+ *
+ * Also prints the load time for kKernels objects: per-kernel read + pack,
+ * mmap pack, and the persisted image (page-cache warm in all three cases).
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <elf.h>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "binary_loader.h"
+#include "function_cache.h"
+#include "kernel_cache.h"
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "CHECK failed at %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+        }                                                                   \
+    } while (0)
+
+static const int kKernels = 128;
+
+/**
+ * Write a relocatable ELF64 object: [Ehdr][.data][.text][.shstrtab][Shdr x4]
+ */
+static void WriteElfObject(const std::string& path, size_t textSize, uint8_t seed) {
+    const char shstr[] = "\0.data\0.text\0.shstrtab";
+    const size_t dataSize = 40 + seed % 24;
+    std::vector<uint8_t> data(dataSize, 0xdd);
+    std::vector<uint8_t> text(textSize);
+    for (size_t i = 0; i < textSize; i++) {
+        text[i] = static_cast<uint8_t>(i * 31 + seed);
+    }
+
+    Elf64_Ehdr eh;
+    std::memset(&eh, 0, sizeof(eh));
+    std::memcpy(eh.e_ident, ELFMAG, SELFMAG);
+    eh.e_ident[EI_CLASS] = ELFCLASS64;
+    eh.e_ident[EI_DATA] = ELFDATA2LSB;
+    eh.e_ident[EI_VERSION] = EV_CURRENT;
+    eh.e_type = ET_REL;
+    eh.e_version = EV_CURRENT;
+    eh.e_ehsize = sizeof(Elf64_Ehdr);
+    eh.e_shentsize = sizeof(Elf64_Shdr);
+    eh.e_shnum = 4;
+    eh.e_shstrndx = 3;
+
+    const uint64_t dataOff = sizeof(Elf64_Ehdr);
+    const uint64_t textOff = dataOff + dataSize;
+    const uint64_t strOff = textOff + textSize;
+    eh.e_shoff = strOff + sizeof(shstr);
+
+    Elf64_Shdr sh[4];
+    std::memset(sh, 0, sizeof(sh));
+    sh[1].sh_name = 1;  // .data
+    sh[1].sh_type = SHT_PROGBITS;
+    sh[1].sh_offset = dataOff;
+    sh[1].sh_size = dataSize;
+    sh[2].sh_name = 7;  // .text
+    sh[2].sh_type = SHT_PROGBITS;
+    sh[2].sh_flags = SHF_ALLOC | SHF_EXECINSTR;
+    sh[2].sh_offset = textOff;
+    sh[2].sh_size = textSize;
+    sh[3].sh_name = 13;  // .shstrtab
+    sh[3].sh_type = SHT_STRTAB;
+    sh[3].sh_offset = strOff;
+    sh[3].sh_size = sizeof(shstr);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&eh), sizeof(eh));
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    out.write(reinterpret_cast<const char*>(text.data()), static_cast<std::streamsize>(text.size()));
+    out.write(shstr, sizeof(shstr));
+    out.write(reinterpret_cast<const char*>(sh), sizeof(sh));
+}
+
+/**
+ * The per-kernel path LoadKernelsToDevice used before packing: read each
+ * file, extract .text into its own buffer, then copy into the image.
+ */
+static bool ReferencePack(const std::vector<std::string>& paths, std::vector<uint8_t>& image) {
+    std::vector<std::vector<uint8_t>> texts;
+    for (const std::string& path : paths) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        const std::streamsize size = file.tellg();
+        std::vector<char> buf(static_cast<size_t>(size));
+        file.seekg(0);
+        file.read(buf.data(), size);
+        auto eh = reinterpret_cast<Elf64_Ehdr*>(buf.data());
+        auto sh = reinterpret_cast<Elf64_Shdr*>(buf.data() + eh->e_shoff);
+        const char* strtbl = buf.data() + sh[eh->e_shstrndx].sh_offset;
+        std::vector<uint8_t> text;
+        for (int i = 0; i < eh->e_shnum; i++) {
+            if (std::strcmp(strtbl + sh[i].sh_name, ".text") == 0) {
+                text.assign(buf.data() + sh[i].sh_offset, buf.data() + sh[i].sh_offset + sh[i].sh_size);
+                break;
+            }
+        }
+        if (text.empty()) {
+            return false;
+        }
+        texts.push_back(std::move(text));
+    }
+
+    const uint64_t headerSize = sizeof(CoreFunctionBinCache) + texts.size() * sizeof(uint64_t);
+    uint64_t dataSize = 0;
+    for (const auto& t : texts) {
+        dataSize += sizeof(uint64_t) + t.size();
+    }
+    image.assign(headerSize + dataSize, 0);
+    auto cache = reinterpret_cast<CoreFunctionBinCache*>(image.data());
+    cache->dataSize = dataSize;
+    cache->numKernels = texts.size();
+    uint64_t offset = 0;
+    for (size_t i = 0; i < texts.size(); i++) {
+        cache->GetOffsets()[i] = offset;
+        auto bin = reinterpret_cast<CoreFunctionBin*>(cache->GetBinaryData() + offset);
+        bin->size = texts[i].size();
+        std::memcpy(bin->data, texts[i].data(), texts[i].size());
+        offset += sizeof(uint64_t) + texts[i].size();
+    }
+    return true;
+}
+
+template <typename F>
+static double BestMicros(int reps, F fn) {
+    double best = 1e30;
+    for (int r = 0; r < reps; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::micro>(t1 - t0).count());
+    }
+    return best;
+}
+
+int main() {
+    char tmpl[] = "/tmp/test_kernel_loader_XXXXXX";
+    if (mkdtemp(tmpl) == nullptr) {
+        perror("mkdtemp");
+        return 1;
+    }
+    const std::string root = tmpl;
+    // Must be set before the first KernelCache::Default() call.
+    setenv("PTO_KERNEL_CACHE_DIR", (root + "/cache").c_str(), 1);
+    unsetenv("PTO_KERNEL_CACHE");
+
+    std::vector<std::string> paths;
+    size_t textBytes = 0;
+    for (int i = 0; i < kKernels; i++) {
+        const size_t textSize = 1024 + (static_cast<size_t>(i) * 7919) % 60000;
+        paths.push_back(root + "/kernel_" + std::to_string(i) + ".o");
+        WriteElfObject(paths.back(), textSize, static_cast<uint8_t>(i));
+        textBytes += textSize;
+    }
+
+    printf("test_kernel_loader: pack %d objects\n", kKernels);
+    std::vector<uint8_t> reference;
+    CHECK(ReferencePack(paths, reference));
+    std::vector<uint8_t> packed;
+    CHECK(PackKernelBinaries(paths, packed, 1) == 0);
+    CHECK(packed == reference);
+    std::vector<uint8_t> packedParallel;
+    CHECK(PackKernelBinaries(paths, packedParallel, 4) == 0);
+    CHECK(packedParallel == reference);
+    auto cache = reinterpret_cast<CoreFunctionBinCache*>(packed.data());
+    CHECK(cache->numKernels == static_cast<uint64_t>(kKernels));
+    CHECK(cache->GetKernel(5)->size == 1024 + (5u * 7919) % 60000);
+    CHECK(cache->GetKernel(5)->data[1] == static_cast<uint8_t>(31 + 5));
+
+    printf("test_kernel_loader: persisted image\n");
+    std::vector<uint8_t> image;
+    bool fromCache = true;
+    CHECK(LoadPackedKernelImage(paths, image, &fromCache) == 0);
+    CHECK(!fromCache);
+    CHECK(image == reference);
+    CHECK(LoadPackedKernelImage(paths, image, &fromCache) == 0);
+    CHECK(fromCache);
+    CHECK(image == reference);
+
+    // Rewriting one object (different size) invalidates the persisted image.
+    WriteElfObject(paths[7], 333, 7);
+    CHECK(LoadPackedKernelImage(paths, image, &fromCache) == 0);
+    CHECK(!fromCache);
+    CHECK(reinterpret_cast<CoreFunctionBinCache*>(image.data())->GetKernel(7)->size == 333);
+    WriteElfObject(paths[7], 1024 + (7u * 7919) % 60000, 7);
+
+    printf("test_kernel_loader: broken objects\n");
+    const std::string broken = root + "/broken.o";
+    std::ofstream(broken) << "not an elf file, just some text";
+    std::vector<std::string> withBroken = {paths[0], broken};
+    CHECK(PackKernelBinaries(withBroken, image) != 0);
+    CHECK(PackKernelBinaries({root + "/missing.o"}, image) != 0);
+    CHECK(LoadBinData(broken).empty());
+    CHECK(LoadBinData(paths[3]).size() == 1024 + (3u * 7919) % 60000);
+
+    printf("test_kernel_loader: load time, %d kernels, %zu KiB of .text\n", kKernels, textBytes / 1024);
+    std::vector<uint8_t> scratch;
+    const double refUs = BestMicros(5, [&] { ReferencePack(paths, scratch); });
+    const double pack1Us = BestMicros(5, [&] { PackKernelBinaries(paths, scratch, 1); });
+    const double packUs = BestMicros(5, [&] { PackKernelBinaries(paths, scratch); });
+    LoadPackedKernelImage(paths, scratch);
+    const double persistedUs = BestMicros(5, [&] { LoadPackedKernelImage(paths, scratch); });
+    printf("  per-kernel read + pack: %8.0f us\n", refUs);
+    printf("  mmap pack, 1 thread:    %8.0f us\n", pack1Us);
+    printf("  mmap pack, %u threads:   %8.0f us\n",
+           std::max(1u, std::min(std::thread::hardware_concurrency(), 8u)), packUs);
+    printf("  persisted image:        %8.0f us\n", persistedUs);
+
+    if (g_failures == 0) {
+        std::string cmd = "rm -rf " + root;
+        if (system(cmd.c_str()) != 0) {
+            fprintf(stderr, "warning: could not remove %s\n", root.c_str());
+        }
+        printf("PASSED\n");
+        return 0;
+    }
+    printf("FAILED (%d checks, scratch kept in %s)\n", g_failures, root.c_str());
+    return 1;
+}
@@ -0,0 +1,426 @@
+"""
+PTO Compiler - Tile Shape Auto-Tuner
+
+compute_tile_shape() picks one shape per (dtype, ISA) from fixed rules. The
+auto-tuner instead builds each InCore kernel at every candidate shape from
+candidate_tile_shapes(), scores the candidates and records the best one per
+(kernel, ISA, dtype, shape bucket) in the TuningDatabase. Kernel builders
+then get the tuned shape from compute_tile_shape(..., kernel=name).
+
+Scorers:
+- CoreSimScorer: simulated cycles of the generated Ascend code on the A2A3
+  core model (src/runtime/runtime_a2a3_sim/core_model, built as a shared
+  library on first use)
+- CPUTimingScorer: wall time of the generated ARM64 code on this host
+  (simd="scalar" on hosts without NEON)
+
+Candidates are compared by cost per element of a problem with bucket rows:
+ceil(bucket / rows) calls of one tile each, so tiles that overshoot a small
+problem pay for their padding. Bucket 0 compares cost per tile element.
+
+Usage:
+    python3 src/compile/pto_autotune.py examples/llama/pto_llama7B_dynamic.py \\
+        --target arm64 --scorer cpu --kernel rmsnorm_tile --cols 128 --problem-rows 4096
+
+Every `create_<kernel>(rows=..., cols=...)` function of the example is a
+tunable kernel.
+"""
+
+import ctypes
+import hashlib
+import importlib.util
+import inspect
+import io
+import contextlib
+import math
+import os
+import platform
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import warnings
+from dataclasses import dataclass
+from typing import Callable, Dict, List, Optional, Tuple
+
+# Add parent directories to path for imports
+_current_dir = os.path.dirname(os.path.abspath(__file__))
+_src_dir = os.path.dirname(_current_dir)
+if _src_dir not in sys.path:
+    sys.path.insert(0, _src_dir)
+
+from isa_definition.pto_isa_definition import (
+    ElementType, ARM64_TILE_ARENA_BUDGET, CUDA_SHARED_MEMORY_BUDGET, ASCEND_A2A3_BUFFER_SIZE,
+)
+from compile.pto_compile_common import PTOProgram, TileBufferAnalyzer
+from compile.pto_dynamic_tiling import (
+    ELEMENT_BYTES, MAX_TILE_BYTES, TuningDatabase, candidate_tile_shapes, shape_bucket,
+)
+
+__all__ = [
+    'CoreSimScorer', 'CPUTimingScorer', 'TuningResult', 'AutoTuner', 'fits_target',
+]
+
+_CORE_MODEL_DIR = os.path.join(_src_dir, "runtime", "runtime_a2a3_sim", "core_model")
+
+
+def _cache_dir(name: str) -> str:
+    xdg = os.getenv("XDG_CACHE_HOME", "").strip()
+    base = xdg if xdg else os.path.join(os.path.expanduser("~"), ".cache")
+    return os.path.join(base, "pto-isa", name)
+
+
+def fits_target(program: PTOProgram, target_isa: str) -> bool:
+    """Check that a kernel's tile arenas fit the target's on-chip budget."""
+    analyzer = TileBufferAnalyzer(program, fuse_rows=(target_isa == "arm64"))
+    analyzer.analyze()
+    if target_isa == "arm64":
+        budget = ARM64_TILE_ARENA_BUDGET
+    elif target_isa == "cuda":
+        # One shared-memory allocation holds every arena
+        return sum(analyzer.arenas.values()) <= CUDA_SHARED_MEMORY_BUDGET
+    else:
+        budget = ASCEND_A2A3_BUFFER_SIZE["UB"]
+    return not analyzer.over_budget({arena: budget for arena in analyzer.arenas})
+
+
+# =============================================================================
+# Scorers
+# =============================================================================
+
+class CoreSimScorer:
+    """
+    Score a kernel by the cycles the A2A3 core model simulates for the Ascend
+    code generated from it.
+    """
+
+    unit = "cycles"
+
+    def __init__(self, cc: Optional[str] = None):
+        from compile.pto_codegen_ascend import AscendCodeGenerator
+        self.codegen = AscendCodeGenerator(target="a2a3")
+        self.lib = ctypes.CDLL(self._build_library(cc or os.getenv("CC", "cc")))
+        self.lib.a2a3_incore_sim_create.restype = ctypes.c_void_p
+        self.lib.a2a3_incore_sim_destroy.argtypes = [ctypes.c_void_p]
+        self.lib.a2a3_incore_sim_register_code.restype = ctypes.c_int
+        self.lib.a2a3_incore_sim_register_code.argtypes = [
+            ctypes.c_void_p, ctypes.c_char_p, ctypes.c_int, ctypes.c_char_p,
+            ctypes.c_int, ctypes.c_int]
+        self.lib.a2a3_incore_sim_execute.restype = ctypes.c_int64
+        self.lib.a2a3_incore_sim_execute.argtypes = [ctypes.c_void_p, ctypes.c_int]
+        self.sim = self.lib.a2a3_incore_sim_create()
+        self.count = 0
+
+    def __del__(self):
+        if getattr(self, "sim", None):
+            self.lib.a2a3_incore_sim_destroy(self.sim)
+            self.sim = None
+
+    @staticmethod
+    def _build_library(cc: str) -> str:
+        """Build the core model as a shared library, cached by source hash."""
+        sources = ["a2a3_core_model.c", "a2a3_incore_sim.c"]
+        digest = hashlib.sha256(cc.encode())
+        for name in sources + ["a2a3_core_model.h", "a2a3_incore_sim.h"]:
+            with open(os.path.join(_CORE_MODEL_DIR, name), "rb") as f:
+                digest.update(f.read())
+        out_dir = _cache_dir("core_model")
+        lib_path = os.path.join(out_dir, f"liba2a3_core-{digest.hexdigest()[:16]}.so")
+        if os.path.exists(lib_path):
+            return lib_path
+        os.makedirs(out_dir, exist_ok=True)
+        fd, tmp = tempfile.mkstemp(dir=out_dir, suffix=".so")
+        os.close(fd)
+        cmd = [cc, "-O2", "-shared", "-fPIC", "-o", tmp] + \
+              [os.path.join(_CORE_MODEL_DIR, name) for name in sources]
+        result = subprocess.run(cmd, capture_output=True, text=True)
+        if result.returncode != 0:
+            os.unlink(tmp)
+            raise RuntimeError(f"Building the A2A3 core model failed:\n{result.stderr}")
+        os.replace(tmp, lib_path)
+        return lib_path
+
+    def __call__(self, program: PTOProgram, rows: int, cols: int, dtype: ElementType) -> float:
+        code = self.codegen.generate(program)
+        body = code[code.index(f" {program.name}("):]
+        body = body[body.index("{") + 1:]
+        core_type = 0 if getattr(program, 'is_cube', False) else 1  # CORE_TYPE_CUBE / VECTOR
+        # The core model assumes 4-byte elements
+        model_cols = max(1, cols * ELEMENT_BYTES.get(dtype, 4) // 4)
+        self.count += 1
+        name = f"{program.name}#{self.count}"
+        func_id = self.lib.a2a3_incore_sim_register_code(
+            self.sim, name.encode(), core_type, body.encode(), rows, model_cols)
+        if func_id < 0:
+            raise RuntimeError(f"Core model rejected {program.name}")
+        return float(self.lib.a2a3_incore_sim_execute(self.sim, func_id))
+
+
+_HARNESS = r"""
+#include <time.h>
+
+static double pto_tune_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(void) {
+    const long calls = %(calls)d;
+    const long step = %(step)d;
+    const long span = (calls + %(slack)d) * step;
+%(buffers)s
+    double best = 1e30;
+    for (int rep = 0; rep < %(repeats)d; rep++) {
+        double t0 = pto_tune_now_ns();
+        for (long i = 0; i < calls; i++) {
+            %(call)s;
+        }
+        double t = (pto_tune_now_ns() - t0) / calls;
+        if (rep > 0 && t < best) best = t;  /* rep 0 warms up */
+    }
+    printf("%%.3f\n", best);
+    return 0;
+}
+"""
+
+
+class CPUTimingScorer:
+    """
+    Score a kernel by timing the ARM64 code generated from it on this host.
+
+    Each call streams through fresh input and output tiles (about
+    stream_bytes per buffer), so the timing includes the memory traffic of
+    a kernel applied to a large tensor. Scalar parameters are set to 1.0
+    (floats) or 0 (integers, i.e. offsets).
+    """
+
+    unit = "ns"
+
+    def __init__(self, simd: Optional[str] = None, cc: Optional[str] = None,
+                 cflags: Tuple[str, ...] = ("-O2",), repeats: int = 5,
+                 stream_bytes: int = 8 << 20):
+        from compile.pto_codegen_arm64 import ARM64CodeGenerator
+        if simd is None:
+            simd = "neon" if platform.machine().lower() in ("aarch64", "arm64") else "scalar"
+        self.simd = simd
+        self.codegen = ARM64CodeGenerator(simd=simd)
+        self.cc = cc or os.getenv("CC", "cc")
+        self.cflags = list(cflags) + (["-march=armv8-a+sve"] if simd == "sve" else [])
+        self.repeats = repeats
+        self.stream_bytes = stream_bytes
+        self.work_dir = tempfile.mkdtemp(prefix="pto_tune_")
+
+    def __del__(self):
+        if getattr(self, "work_dir", None):
+            shutil.rmtree(self.work_dir, ignore_errors=True)
+
+    def __call__(self, program: PTOProgram, rows: int, cols: int, dtype: ElementType) -> float:
+        with warnings.catch_warnings():
+            warnings.simplefilter("ignore")
+            code = self.codegen.generate(program)
+        match = re.search(rf"^void {re.escape(program.name)}\(([^)]*)\) {{", code, re.M)
+        if match is None:
+            raise RuntimeError(f"No InCore function {program.name} in generated code")
+        params = [p.strip() for p in match.group(1).split(",") if p.strip() and p.strip() != "void"]
+
+        step = rows * cols
+        largest = max((t.shape.rows * t.shape.cols for t in program.tile_declarations.values()),
+                      default=step)
+        tile_bytes = step * ELEMENT_BYTES.get(dtype, 4)
+        calls = max(16, self.stream_bytes // max(tile_bytes, 1))
+        buffers, args = [], []
+        for i, param in enumerate(params):
+            c_type, name = param.rsplit(" ", 1)
+            if c_type.endswith("*"):
+                elem = c_type[:-1].strip()
+                buffers.append(f"    {elem}* buf{i} = ({elem}*)malloc(span * sizeof({elem}));")
+                buffers.append(f"    for (long j = 0; j < span; j++) buf{i}[j] = ({elem})(0.5 + (j % 97) / 194.0);")
+                args.append(f"buf{i} + i * step")
+            elif c_type in ("float", "double"):
+                args.append("1.0")
+            else:
+                args.append("0")
+        harness = _HARNESS % {
+            "calls": calls, "step": step, "slack": (largest + step - 1) // step,
+            "buffers": "\n".join(buffers), "repeats": self.repeats,
+            "call": f"{program.name}({', '.join(args)})",
+        }
+
+        base = os.path.join(self.work_dir, f"{program.name}_{rows}x{cols}")
+        with open(base + ".c", "w") as f:
+            f.write(code)
+            f.write(harness)
+        cmd = [self.cc] + self.cflags + ["-o", base, base + ".c", "-lm"]
+        result = subprocess.run(cmd, capture_output=True, text=True)
+        if result.returncode != 0:
+            raise RuntimeError(f"Compiling {program.name} failed:\n{result.stderr[-2000:]}")
+        result = subprocess.run([base], capture_output=True, text=True, timeout=600)
+        if result.returncode != 0:
+            raise RuntimeError(f"Running {program.name} failed (exit {result.returncode})")
+        return float(result.stdout.strip())
+
+
+# =============================================================================
+# Auto-Tuner
+# =============================================================================
+
+@dataclass
+class TuningResult:
+    """Outcome of tuning one kernel."""
+    kernel: str
+    bucket: int
+    rows: int
+    cols: int
+    cost: float                                  # per element, in scorer units
+    candidates: List[Tuple[int, int, float]]     # (rows, cols, cost per element)
+
+
+class AutoTuner:
+    """
+    Pick the best tile shape of a kernel and record it in the tuning database.
+
+    Example:
+        tuner = AutoTuner("arm64", CPUTimingScorer())
+        tuner.tune("rmsnorm_tile", lambda r, c: create_rmsnorm_tile(rows=r, cols=c),
+                   cols=128, problem_rows=4096)
+        rows, cols = compute_tile_shape(ElementType.F32, "arm64",
+                                        kernel="rmsnorm_tile", problem_rows=4096)
+    """
+
+    def __init__(self, target_isa: str, scorer: Callable,
+                 db: Optional[TuningDatabase] = None,
+                 dtype: ElementType = ElementType.F32,
+                 max_tile_bytes: int = MAX_TILE_BYTES,
+                 verbose: bool = False):
+        self.target_isa = target_isa
+        self.scorer = scorer
+        self.db = db if db is not None else TuningDatabase.default()
+        self.dtype = dtype
+        self.max_tile_bytes = max_tile_bytes
+        self.verbose = verbose
+
+    def tune(self, kernel: str, build: Callable[[int, int], PTOProgram],
+             rows: Optional[int] = None, cols: Optional[int] = None,
+             problem_rows: int = 0,
+             candidates: Optional[List[Tuple[int, int]]] = None) -> Optional[TuningResult]:
+        """
+        Score every candidate shape of a kernel and record the best one.
+
+        Args:
+            kernel: Name the kernel is recorded under
+            build: build(rows, cols) -> PTOProgram
+            rows / cols: Fix one dimension of the candidates
+            problem_rows: Rows of the tensor the kernel is applied to (0 = any)
+            candidates: Explicit (rows, cols) list instead of candidate_tile_shapes()
+
+        Returns:
+            TuningResult, or None if no candidate could be scored
+        """
+        bucket = shape_bucket(problem_rows)
+        if candidates is None:
+            candidates = candidate_tile_shapes(self.dtype, self.target_isa, self.max_tile_bytes,
+                                               rows=rows, cols=cols, max_rows=bucket)
+        scored = []
+        for r, c in candidates:
+            try:
+                with contextlib.redirect_stdout(io.StringIO()):
+                    program = build(r, c)
+                if not fits_target(program, self.target_isa):
+                    continue
+                cost = self.scorer(program, r, c, self.dtype)
+            except Exception as e:  # a shape the kernel does not support
+                if self.verbose:
+                    print(f"  {kernel} {r}x{c}: skipped ({str(e).splitlines()[0]})")
+                continue
+            if bucket:
+                per_element = math.ceil(bucket / r) * cost / (bucket * c)
+            else:
+                per_element = cost / (r * c)
+            scored.append((r, c, per_element))
+            if self.verbose:
+                print(f"  {kernel} {r}x{c}: {cost:.1f} {self.scorer.unit}/call, "
+                      f"{per_element:.4f} {self.scorer.unit}/element")
+        if not scored:
+            return None
+
+        best = min(scored, key=lambda s: s[2])
+        self.db.record(kernel, self.target_isa, self.dtype, bucket, best[0], best[1],
+                       cost=best[2], unit=f"{self.scorer.unit}/element",
+                       scorer=type(self.scorer).__name__, candidates=len(scored),
+                       host=platform.machine())
+        return TuningResult(kernel, bucket, best[0], best[1], best[2], scored)
+
+
+def _kernel_builders(module) -> Dict[str, Callable[[int, int], PTOProgram]]:
+    """Collect create_<kernel>(rows=..., cols=...) functions of an example module."""
+    builders = {}
+    for attr in dir(module):
+        fn = getattr(module, attr)
+        if not attr.startswith("create_") or not callable(fn):
+            continue
+        try:
+            params = inspect.signature(fn).parameters
+        except (TypeError, ValueError):
+            continue
+        if "rows" in params and "cols" in params:
+            builders[attr[len("create_"):]] = (
+                lambda f: lambda r, c: f(rows=r, cols=c))(fn)
+    return builders
+
+
+def main():
+    import argparse
+
+    parser = argparse.ArgumentParser(description="PTO tile shape auto-tuner")
+    parser.add_argument("example", help="Python file defining create_<kernel>(rows, cols) functions")
+    parser.add_argument("--target", default="arm64", choices=["arm64", "cuda", "ascend_a2a3"])
+    parser.add_argument("--scorer", default="cpu", choices=["cpu", "sim"],
+                        help="cpu: time ARM64 code on this host; sim: A2A3 core model")
+    parser.add_argument("--simd", default=None, help="ARM64 SIMD target for --scorer cpu")
+    parser.add_argument("--kernel", action="append", help="Kernel(s) to tune (default: all)")
+    parser.add_argument("--rows", type=int, default=None, help="Fix tile rows")
+    parser.add_argument("--cols", type=int, default=None, help="Fix tile cols")
+    parser.add_argument("--problem-rows", type=int, action="append",
+                        help="Problem size(s) to tune for (default: any)")
+    parser.add_argument("--max-kb", type=int, default=MAX_TILE_BYTES // 1024,
+                        help="Largest tile to consider (KB)")
+    parser.add_argument("--db", default=None, help="Tuning database (default: $PTO_TUNING_DB)")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args()
+
+    example_dir = os.path.dirname(os.path.abspath(args.example))
+    if example_dir not in sys.path:
+        sys.path.insert(0, example_dir)
+    spec = importlib.util.spec_from_file_location("pto_tuned_example", args.example)
+    module = importlib.util.module_from_spec(spec)
+    with contextlib.redirect_stdout(io.StringIO()):
+        spec.loader.exec_module(module)
+    builders = _kernel_builders(module)
+    if args.kernel:
+        missing = [k for k in args.kernel if k not in builders]
+        if missing:
+            parser.error(f"unknown kernel(s): {', '.join(missing)}")
+        builders = {k: builders[k] for k in args.kernel}
+
+    scorer = CPUTimingScorer(simd=args.simd) if args.scorer == "cpu" else CoreSimScorer()
+    db = TuningDatabase(args.db) if args.db else TuningDatabase.default()
+    tuner = AutoTuner(args.target, scorer, db, max_tile_bytes=args.max_kb * 1024,
+                      verbose=args.verbose)
+    for problem_rows in args.problem_rows or [0]:
+        for kernel, build in sorted(builders.items()):
+            result = tuner.tune(kernel, build, rows=args.rows, cols=args.cols,
+                                problem_rows=problem_rows)
+            label = f"{kernel} (bucket {shape_bucket(problem_rows) or 'any'})"
+            if result is None:
+                print(f"{label}: no candidate could be scored")
+            else:
+                print(f"{label}: {result.rows}x{result.cols}, "
+                      f"{result.cost:.4f} {scorer.unit}/element "
+                      f"({len(result.candidates)} candidates)")
+    print(f"Tuning database: {db.path}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,300 @@
+"""
+PTO Compiler - Incremental Native Build
+
+Builds generated C sources into executables without recompiling what has
+not changed:
+- Each source is compiled to an object keyed by the compiler, the flags
+  and the contents of every file the compiler read for it (its -MD
+  dependency list). Objects and archives are entries of the shared
+  on-disk KernelCache (ref_runtime/python/kernel_cache.py), so they share
+  its size limit, LRU eviction and per-key build locks with the runtime
+  binaries, and unchanged kernels are never rebuilt
+- Cache misses are compiled in parallel, one compiler process per core
+- The PTO runtime is built once per set of defines as a static library
+  (libpto_runtime.a) and linked, instead of being #included into every
+  orchestration file
+- Every step is timed; BuildReport.format() prints the breakdown
+
+Environment:
+    - PTO_KERNEL_CACHE, PTO_KERNEL_CACHE_DIR, PTO_KERNEL_CACHE_MAX_MB
+                             cache switch, directory and size limit (see kernel_cache.py)
+    - PTO_BUILD_JOBS=<n>     parallel compiler processes (default: CPU count)
+    - CC, AR                 compiler and archiver (default cc, ar)
+
+Usage:
+    builder = NativeBuilder(flags=["-O2", "-std=c11", "-DPTO_TASK_DUMP"])
+    exe = builder.build_executable(orch_file, kernel_files, exe_path)
+    print(builder.report.format())
+"""
+
+import hashlib
+import os
+import subprocess
+import sys
+import tempfile
+import time
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass, field
+from typing import List, Optional, Sequence, Tuple
+
+_current_dir = os.path.dirname(os.path.abspath(__file__))
+_repo_root = os.path.dirname(os.path.dirname(_current_dir))
+RUNTIME_DIR = os.path.join(os.path.dirname(_current_dir), "runtime")
+
+_ref_runtime_python = os.path.join(_repo_root, "ref_runtime", "python")
+if _ref_runtime_python not in sys.path:
+    sys.path.insert(0, _ref_runtime_python)
+
+from kernel_cache import KernelCache  # noqa: E402
+
+
+class BuildError(RuntimeError):
+    """A compile, archive or link command failed."""
+
+
+def parse_depfile(text: str) -> List[str]:
+    """Prerequisites of a make rule as written by the compiler's -MD."""
+    text = text.replace("\\\n", " ")
+    _, _, prereqs = text.partition(": ")
+    return [token.replace("\0", " ") for token in prereqs.replace("\\ ", "\0").split()]
+
+
+@dataclass
+class BuildStep:
+    name: str
+    seconds: float
+    detail: str = ""
+
+
+@dataclass
+class BuildReport:
+    """Wall time of each build step."""
+    steps: List[BuildStep] = field(default_factory=list)
+
+    def add(self, name: str, seconds: float, detail: str = "") -> None:
+        self.steps.append(BuildStep(name, seconds, detail))
+
+    @property
+    def total_seconds(self) -> float:
+        return sum(s.seconds for s in self.steps)
+
+    def format(self, indent: str = "  ") -> str:
+        lines = [f"{indent}{'step':<20} {'time(ms)':>10}  detail"]
+        for s in self.steps:
+            lines.append(f"{indent}{s.name:<20} {s.seconds * 1000:>10.1f}  {s.detail}")
+        lines.append(f"{indent}{'total':<20} {self.total_seconds * 1000:>10.1f}")
+        return "\n".join(lines)
+
+
+class NativeBuilder:
+    """Cached, parallel compile of generated sources plus the PTO runtime."""
+
+    def __init__(self, flags: Sequence[str] = ("-O2", "-std=c11"),
+                 include_dirs: Sequence[str] = (RUNTIME_DIR,),
+                 compiler: Optional[str] = None,
+                 cache: Optional[KernelCache] = None,
+                 jobs: Optional[int] = None):
+        self.flags = list(flags)
+        self.include_dirs = [os.path.abspath(d) for d in include_dirs]
+        self.compiler = compiler or os.getenv("CC", "cc")
+        self.archiver = os.getenv("AR", "ar")
+        self.cache = cache or KernelCache.default()
+        env_jobs = os.getenv("PTO_BUILD_JOBS", "").strip()
+        self.jobs = max(1, jobs or (int(env_jobs) if env_jobs.isdigit() else 0) or os.cpu_count() or 1)
+        self.report = BuildReport()
+        self.built = 0  # objects and archives this builder had to build
+
+    # -------------------------------------------------------------------------
+    # Cache keys
+    # -------------------------------------------------------------------------
+    #
+    # An object is looked up in two steps. The dependency key (compiler,
+    # flags, include directories, source text) finds the dependency list of
+    # the last compile; the object key adds the current contents of those
+    # files. A header edit therefore changes the object key even when the
+    # header lives outside include_dirs.
+
+    def _deps_key(self, source: str, flags: Sequence[str]) -> str:
+        return self.cache.make_key(["pto-build-deps", *flags, *self.include_dirs], [source], [self.compiler])
+
+    def _object_key(self, deps_key: str, deps: Sequence[str]) -> str:
+        return self.cache.make_key(["pto-build-object", deps_key], sorted(set(deps)))
+
+    # -------------------------------------------------------------------------
+    # Steps
+    # -------------------------------------------------------------------------
+
+    def _run(self, cmd: List[str], what: str) -> None:
+        result = subprocess.run(cmd, capture_output=True, text=True)
+        if result.returncode != 0:
+            raise BuildError(f"{what} failed:\n{' '.join(cmd)}\n{result.stderr}")
+
+    def _compile_one(self, source: str, flags: List[str]) -> Tuple[bytes, List[str]]:
+        """Compile source; returns the object and the files the compiler read."""
+        with tempfile.TemporaryDirectory(prefix="pto-build-") as tmp:
+            obj = os.path.join(tmp, "out.o")
+            depfile = os.path.join(tmp, "out.d")
+            cmd = [self.compiler, *flags, *[f"-I{d}" for d in self.include_dirs],
+                   "-MD", "-MF", depfile, "-c", source, "-o", obj]
+            self._run(cmd, f"Compiling {os.path.basename(source)}")
+            with open(obj, "rb") as f:
+                data = f.read()
+            with open(depfile) as f:
+                deps = [os.path.abspath(d) for d in parse_depfile(f.read())]
+        return data, deps
+
+    def _object(self, source: str, flags: List[str]) -> Tuple[bytes, bool]:
+        """Object code of source and whether it was compiled."""
+        deps_key = self._deps_key(source, flags)
+        compiled = []
+
+        def compile_and_record() -> bytes:
+            data, deps = self._compile_one(source, flags)
+            self.cache.put(deps_key, "\n".join(deps).encode())
+            compiled.append(deps)
+            return data
+
+        manifest = self.cache.get(deps_key)
+        if manifest is None:
+            data = compile_and_record()
+            self.cache.put(self._object_key(deps_key, compiled[0]), data)
+            return data, True
+        recorded = manifest.decode().split("\n")
+        data = self.cache.get_or_build(self._object_key(deps_key, recorded), compile_and_record)
+        if compiled and compiled[0] != recorded:
+            # The source now reads other files: publish under the key they give
+            self.cache.put(self._object_key(deps_key, compiled[0]), data)
+        return data, bool(compiled)
+
+    def compile_objects(self, sources: Sequence[str], out_dir: str, extra_flags: Sequence[str] = (),
+                        step: str = "compile") -> List[str]:
+        """Compile sources to objects in out_dir, reusing cached ones and building misses in parallel."""
+        start = time.perf_counter()
+        os.makedirs(out_dir, exist_ok=True)
+        flags = self.flags + list(extra_flags)
+        unique = list(dict.fromkeys(sources))
+        with ThreadPoolExecutor(max_workers=min(self.jobs, max(1, len(unique)))) as pool:
+            futures = [pool.submit(self._object, src, flags) for src in unique]
+            errors = [f.exception() for f in futures if f.exception() is not None]
+        if errors:
+            raise BuildError("\n".join(str(e) for e in errors))
+
+        paths = {}
+        built = 0
+        for index, (source, future) in enumerate(zip(unique, futures)):
+            data, was_built = future.result()
+            built += was_built
+            stem = os.path.splitext(os.path.basename(source))[0]
+            paths[source] = os.path.join(out_dir, f"{index:04d}-{stem}.o")
+            with open(paths[source], "wb") as f:
+                f.write(data)
+
+        self.report.add(step, time.perf_counter() - start,
+                        f"{len(unique)} sources: {len(unique) - built} cached, "
+                        f"{built} built, jobs={min(self.jobs, max(1, built))}")
+        self.built += built
+        return [paths[source] for source in sources]
+
+    def archive(self, objects: Sequence[str], stem: str, out_dir: str, step: str = "archive") -> str:
+        """Bundle objects into a static library in out_dir, cached by the object contents."""
+        start = time.perf_counter()
+        lib = os.path.join(out_dir, f"lib{stem}.a")
+        digests = []
+        for obj in objects:
+            with open(obj, "rb") as f:
+                digests.append(hashlib.sha256(f.read()).hexdigest())
+        key = self.cache.make_key(["pto-build-archive", stem, *digests], [], [self.archiver])
+        built = []
+
+        def build() -> bytes:
+            with tempfile.TemporaryDirectory(prefix="pto-build-") as tmp:
+                tmp_lib = os.path.join(tmp, os.path.basename(lib))
+                self._run([self.archiver, "rcs", tmp_lib, *objects], f"Archiving lib{stem}.a")
+                with open(tmp_lib, "rb") as f:
+                    built.append(True)
+                    return f.read()
+
+        data = self.cache.get_or_build(key, build)
+        with open(lib, "wb") as f:
+            f.write(data)
+        self.report.add(step, time.perf_counter() - start,
+                        f"{os.path.basename(lib)} ({'built' if built else 'cached'})")
+        self.built += len(built)
+        return lib
+
+    def runtime_library(self, out_dir: str, defines: Sequence[str] = ()) -> str:
+        """Static library of the PTO runtime (pto_runtime.c) for the given defines, in out_dir."""
+        objects = self.compile_objects([os.path.join(RUNTIME_DIR, "pto_runtime.c")], out_dir,
+                                       list(defines), step="runtime")
+        return self.archive(objects, "pto_runtime", out_dir, step="runtime archive")
+
+    def link(self, inputs: Sequence[str], output: str,
+             ldflags: Sequence[str] = ("-lpthread", "-lm")) -> str:
+        start = time.perf_counter()
+        os.makedirs(os.path.dirname(os.path.abspath(output)), exist_ok=True)
+        self._run([self.compiler, *inputs, "-o", output, *ldflags], f"Linking {os.path.basename(output)}")
+        self.report.add("link", time.perf_counter() - start, os.path.basename(output))
+        return output
+
+    def build_executable(self, main_source: str, kernel_sources: Sequence[str], output: str,
+                         runtime_defines: Sequence[str] = (),
+                         ldflags: Sequence[str] = ("-lpthread", "-lm")) -> str:
+        """
+        Compile the orchestration and its InCore kernels, then link them with
+        the runtime library. Kernels go into an archive, so only the ones the
+        orchestration references end up in the executable. Objects and
+        archives only exist in the cache and a scratch directory for the link.
+        """
+        with tempfile.TemporaryDirectory(prefix="pto-build-") as work_dir:
+            objects = self.compile_objects([main_source, *kernel_sources], work_dir)
+            inputs = [objects[0]]
+            if kernel_sources:
+                stem = os.path.splitext(os.path.basename(main_source))[0]
+                inputs.append(self.archive(objects[1:], f"{stem}_kernels", work_dir))
+            runtime_dir = os.path.join(work_dir, "runtime")
+            inputs.append(self.runtime_library(runtime_dir, runtime_defines))
+            return self.link(inputs, output, ldflags)
+
+
+def build_runner_executable(platform: str, code_dir: str, orch_file: str, exe_path: str,
+                            binary_expansion: bool = False, task_dump: bool = False) -> NativeBuilder:
+    """
+    Build step of the example runners (run_<platform>.py): the orchestration
+    in orch_file, the InCore kernels of code_dir where the host can build
+    them, and the runtime library for the platform. Raises BuildError.
+    """
+    compile_flags = ["-O2", "-std=c11"]
+    if binary_expansion:
+        compile_flags.append("-DPTO_BINARY_EXPANSION")
+    if task_dump:
+        compile_flags.append("-DPTO_TASK_DUMP")
+
+    # InCore kernels are C only on arm64 (the simulator parses its kernels)
+    # and use NEON, so they are built on ARM hosts only. The runtime is
+    # linked as a static library built for the platform
+    kernel_files = []
+    runtime_defines = []
+    if platform == "arm64" and os.uname().machine in ("aarch64", "arm64"):
+        kernel_files = sorted(os.path.join(code_dir, f) for f in os.listdir(code_dir)
+                              if f.endswith('.c') and os.path.join(code_dir, f) != orch_file)
+    elif platform == "ascend_a2a3_sim":
+        # The simulator orchestration defines A2A3_TARGET_SIMULATOR itself
+        runtime_defines = ["-DPTO_PLATFORM_A2A3", "-DA2A3_TARGET_SIMULATOR"]
+
+    include_dirs = [RUNTIME_DIR]
+    if platform in ("ascend_a2a3", "ascend_a2a3_sim"):
+        # InCore directories hold the InCore function headers
+        for sub in ("incore_aic", "incore_aiv"):
+            if os.path.exists(os.path.join(code_dir, sub)):
+                include_dirs.append(os.path.join(code_dir, sub))
+        include_dirs.append(code_dir)
+
+    builder = NativeBuilder(flags=compile_flags, include_dirs=include_dirs)
+    builder.build_executable(orch_file, kernel_files, exe_path, runtime_defines=runtime_defines)
+    return builder
+
+
+__all__ = [
+    'BuildError', 'BuildReport', 'BuildStep', 'NativeBuilder',
+    'RUNTIME_DIR', 'build_runner_executable', 'parse_depfile',
+]
@@ -2,6 +2,8 @@
 PTO Compiler - ARM64 Code Generation
 
 This module contains ARM64/NEON-specific code generation:
+- SIMD targets (NEON, SVE) and vector math helpers
+- Tile arenas (tiles aliased by live range)
 - Barrier operation code generation
 - Task scheduling code for orchestration functions
 - Fused loop code generation
@@ -16,6 +18,7 @@ from typing import Dict, List, Optional, Tuple, Union, Any
 from dataclasses import dataclass, field
 import os
 import sys
+import warnings
 
 # Add parent directories to path for imports
 _current_dir = os.path.dirname(os.path.abspath(__file__))
@@ -23,13 +26,17 @@ _src_dir = os.path.dirname(_current_dir)
 if _src_dir not in sys.path:
     sys.path.insert(0, _src_dir)
 
-from isa_definition.pto_isa_definition import ARM64_TYPE_MAP, arm64_generate_header, ElementType
+from isa_definition.pto_isa_definition import (
+    ARM64_TYPE_MAP, ARM64_TILE_ARENA_BUDGET, arm64_generate_header, ElementType,
+)
 
 from compile.pto_compile_common import (
     PTOProgram, PTOModule, MockTileInfo, MockInstruction,
-    FusedLoop, FusionBarrier, FusableOp, LoopFusionOptimizer,
+    FusedLoop, FusedRowLoop, RowSweep, FusionBarrier, FusableOp, LoopFusionOptimizer,
+    ROW_REDUCTION_OPS, ROW_BROADCAST_OPS,
     TileBufferAnalyzer, convert_program_to_mock_instructions,
     apply_binary_expansion, apply_loop_replay_optimization,
+    BINARY_EXPANSION_CODE_BUDGET, BINARY_EXPANSION_MODES,
 )
 
 
@@ -77,6 +84,320 @@ class OrchestrationContext:
         return (self.default_tile_rows, self.default_tile_cols)
 
 
+# =============================================================================
+# ARM64 SIMD Targets
+# =============================================================================
+
+class ARM64SimdTarget:
+    """
+    Intrinsic spellings for one ARM64 vector extension.
+
+    Vector code computes in f32; f16 tiles are widened to two f32 vectors on
+    load and narrowed on store (NEON only). Every method returns a C
+    expression. SVE expressions refer to the governing predicate `_pg`,
+    declared by the emitted loop or helper.
+    """
+    name = ""
+    vtype = ""              # f32 vector type
+    mtype = ""              # lane mask type
+    lanes = ""              # f32 lanes as a C expression
+    fixed_lanes = 0         # f32 lanes if known at compile time, else 0
+    predicated = False      # loops use a per-iteration predicate, no remainder
+    supports_f16 = False
+    helper_prefix = ""
+    helper_params = ""      # leading helper parameters
+    helper_args = ""        # leading helper arguments
+
+
+class NEONTarget(ARM64SimdTarget):
+    """Advanced SIMD: 128-bit float32x4_t, scalar remainder loops."""
+    name = "neon"
+    vtype = "float32x4_t"
+    mtype = "uint32x4_t"
+    lanes = "4"
+    fixed_lanes = 4
+    supports_f16 = True
+    helper_prefix = "pto_neon"
+
+    def dup(self, s): return f"vdupq_n_f32({s})"
+    def add(self, a, b): return f"vaddq_f32({a}, {b})"
+    def sub(self, a, b): return f"vsubq_f32({a}, {b})"
+    def mul(self, a, b): return f"vmulq_f32({a}, {b})"
+    def div(self, a, b): return f"vdivq_f32({a}, {b})"
+    def max(self, a, b): return f"vmaxq_f32({a}, {b})"
+    def min(self, a, b): return f"vminq_f32({a}, {b})"
+    def fma(self, a, b, c): return f"vfmaq_f32({a}, {b}, {c})"
+    def fms(self, a, b, c): return f"vfmsq_f32({a}, {b}, {c})"
+    def fma_n(self, a, b, s): return f"vfmaq_n_f32({a}, {b}, {s})"
+    def abs(self, a): return f"vabsq_f32({a})"
+    def neg(self, a): return f"vnegq_f32({a})"
+    def sqrt(self, a): return f"vsqrtq_f32({a})"
+    def floor(self, a): return f"vrndmq_f32({a})"
+    def ceil(self, a): return f"vrndpq_f32({a})"
+    def round(self, a): return f"vrndnq_f32({a})"
+    def lt(self, a, b): return f"vcltq_f32({a}, {b})"
+    def eq(self, a, b): return f"vceqq_f32({a}, {b})"
+    def select(self, m, a, b): return f"vbslq_f32({m}, {a}, {b})"
+    def load(self, p): return f"vld1q_f32({p})"
+    def store(self, p, v): return f"vst1q_f32({p}, {v});"
+    def acc_add(self, acc, v): return f"vaddq_f32({acc}, {v})"
+    def acc_max(self, acc, v): return f"vmaxq_f32({acc}, {v})"
+    def acc_min(self, acc, v): return f"vminq_f32({acc}, {v})"
+    def reduce_add(self, v): return f"vaddvq_f32({v})"
+    def reduce_max(self, v): return f"vmaxvq_f32({v})"
+    def reduce_min(self, v): return f"vminvq_f32({v})"
+
+    def scale_pow2(self, y, n):
+        # y * 2^(n/2) * 2^(n - n/2): each factor is a normal float for
+        # |n| <= 252, and the result may still round to a subnormal
+        pow2 = lambda e: f"vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32({e}, vdupq_n_s32(127)), 23))"
+        stmts = [f"const int32x4_t ni = vcvtq_s32_f32({n});",
+                 f"const int32x4_t nh = vshrq_n_s32(ni, 1);"]
+        return stmts, f"vmulq_f32(vmulq_f32({y}, {pow2('nh')}), {pow2('vsubq_s32(ni, nh)')})"
+
+    def exponent(self, x):
+        return (f"vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32("
+                f"vshrq_n_u32(vreinterpretq_u32_f32({x}), 23)), vdupq_n_s32(126)))")
+
+    def mantissa(self, x):
+        return (f"vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32({x}), "
+                f"vdupq_n_u32(0x807fffffu)), vdupq_n_u32(0x3f000000u)))")
+
+    def load_f16(self, p, lo, hi):
+        h = lo + "_h"
+        return [f"const float16x8_t {h} = vld1q_f16({p});",
+                f"const float32x4_t {lo} = vcvt_f32_f16(vget_low_f16({h}));",
+                f"const float32x4_t {hi} = vcvt_high_f32_f16({h});"]
+
+    def store_f16(self, p, lo, hi):
+        return f"vst1q_f16({p}, vcombine_f16(vcvt_f16_f32({lo}), vcvt_f16_f32({hi})));"
+
+
+class SVETarget(ARM64SimdTarget):
+    """Scalable Vector Extension: svfloat32_t, predicated loops."""
+    name = "sve"
+    vtype = "svfloat32_t"
+    mtype = "svbool_t"
+    lanes = "(int)svcntw()"
+    predicated = True
+    helper_prefix = "pto_sve"
+    helper_params = "svbool_t _pg, "
+    helper_args = "_pg, "
+
+    def dup(self, s): return f"svdup_n_f32({s})"
+    def add(self, a, b): return f"svadd_f32_x(_pg, {a}, {b})"
+    def sub(self, a, b): return f"svsub_f32_x(_pg, {a}, {b})"
+    def mul(self, a, b): return f"svmul_f32_x(_pg, {a}, {b})"
+    def div(self, a, b): return f"svdiv_f32_x(_pg, {a}, {b})"
+    def max(self, a, b): return f"svmax_f32_x(_pg, {a}, {b})"
+    def min(self, a, b): return f"svmin_f32_x(_pg, {a}, {b})"
+    def fma(self, a, b, c): return f"svmla_f32_x(_pg, {a}, {b}, {c})"
+    def fms(self, a, b, c): return f"svmls_f32_x(_pg, {a}, {b}, {c})"
+    def fma_n(self, a, b, s): return f"svmla_n_f32_x(_pg, {a}, {b}, {s})"
+    def abs(self, a): return f"svabs_f32_x(_pg, {a})"
+    def neg(self, a): return f"svneg_f32_x(_pg, {a})"
+    def sqrt(self, a): return f"svsqrt_f32_x(_pg, {a})"
+    def floor(self, a): return f"svrintm_f32_x(_pg, {a})"
+    def ceil(self, a): return f"svrintp_f32_x(_pg, {a})"
+    def round(self, a): return f"svrintn_f32_x(_pg, {a})"
+    def lt(self, a, b): return f"svcmplt_f32(_pg, {a}, {b})"
+    def eq(self, a, b): return f"svcmpeq_f32(_pg, {a}, {b})"
+    def select(self, m, a, b): return f"svsel_f32({m}, {a}, {b})"
+    def load(self, p): return f"svld1_f32(_pg, {p})"
+    def store(self, p, v): return f"svst1_f32(_pg, {p}, {v});"
+    # Accumulators keep their inactive lanes (_m forms) so the reduction
+    # over all lanes sees only loaded elements.
+    def acc_add(self, acc, v): return f"svadd_f32_m(_pg, {acc}, {v})"
+    def acc_max(self, acc, v): return f"svmax_f32_m(_pg, {acc}, {v})"
+    def acc_min(self, acc, v): return f"svmin_f32_m(_pg, {acc}, {v})"
+    def reduce_add(self, v): return f"svaddv_f32(svptrue_b32(), {v})"
+    def reduce_max(self, v): return f"svmaxv_f32(svptrue_b32(), {v})"
+    def reduce_min(self, v): return f"svminv_f32(svptrue_b32(), {v})"
+
+    def scale_pow2(self, y, n):
+        return [], f"svscale_f32_x(_pg, {y}, svcvt_s32_f32_x(_pg, {n}))"
+
+    def exponent(self, x):
+        return (f"svcvt_f32_s32_x(_pg, svsub_n_s32_x(_pg, svreinterpret_s32_u32("
+                f"svlsr_n_u32_x(_pg, svreinterpret_u32_f32({x}), 23)), 126))")
+
+    def mantissa(self, x):
+        return (f"svreinterpret_f32_u32(svorr_n_u32_x(_pg, svand_n_u32_x(_pg, "
+                f"svreinterpret_u32_f32({x}), 0x807fffffu), 0x3f000000u))")
+
+
+ARM64_SIMD_TARGETS = {"neon": NEONTarget, "sve": SVETarget}
+
+
+def arm64_simd_target(simd: Optional[str]) -> Optional[ARM64SimdTarget]:
+    """
+    Resolve an ARM64 SIMD flag: "neon" (default), "sve" or "scalar".
+
+    Returns None for scalar code generation.
+    """
+    if simd is None or simd == "scalar":
+        return None
+    if simd not in ARM64_SIMD_TARGETS:
+        raise ValueError(f"Unknown ARM64 SIMD target '{simd}' "
+                         f"(expected one of: scalar, {', '.join(ARM64_SIMD_TARGETS)})")
+    return ARM64_SIMD_TARGETS[simd]()
+
+
+# Vector math helpers: name -> helpers they call. Accuracy is a few f32 ulp
+# except erf/gelu (about 1e-7 absolute).
+ARM64_SIMD_HELPER_DEPS = {
+    "exp": [],
+    "log": [],
+    "sigmoid": ["exp"],
+    "silu": ["exp"],
+    "tanh": ["exp"],
+    "erf": ["exp"],
+    "gelu": ["erf"],
+    "map": [],
+}
+
+
+def _simd_helper_body(t: ARM64SimdTarget, name: str) -> List[str]:
+    """Statements of one vector math helper (argument `x`)."""
+    v = t.vtype
+    one = t.dup("1.0f")
+    zero = t.dup("0.0f")
+    call = lambda fn, arg: f"{t.helper_prefix}_{fn}_f32({t.helper_args}{arg})"
+
+    if name == "exp":
+        # Cephes expf: exp(x) = 2^n * exp(r), |r| <= ln2/2
+        scale_stmts, scaled = t.scale_pow2('y', 'n')
+        return [
+            f"const {v} xc = {t.max(t.min('x', t.dup('88.3762626647949f')), t.dup('-104.0f'))};",
+            f"const {v} n = {t.round(t.mul('xc', t.dup('1.44269504088896341f')))};",
+            f"{v} r = {t.fms('xc', 'n', t.dup('0.693359375f'))};",
+            f"r = {t.fms('r', 'n', t.dup('-2.12194440e-4f'))};",
+            f"{v} p = {t.dup('1.9875691500e-4f')};",
+            f"p = {t.fma(t.dup('1.3981999507e-3f'), 'p', 'r')};",
+            f"p = {t.fma(t.dup('8.3334519073e-3f'), 'p', 'r')};",
+            f"p = {t.fma(t.dup('4.1665795894e-2f'), 'p', 'r')};",
+            f"p = {t.fma(t.dup('1.6666665459e-1f'), 'p', 'r')};",
+            f"p = {t.fma(t.dup('5.0000001201e-1f'), 'p', 'r')};",
+            f"const {v} y = {t.fma(t.add('r', one), t.mul('p', 'r'), 'r')};",
+        ] + scale_stmts + [
+            f"return {t.select(t.lt(t.dup('88.3762626647949f'), 'x'), t.dup('INFINITY'), scaled)};",
+        ]
+    if name == "log":
+        # Cephes logf: x = m * 2^e, m in [sqrt(1/2), sqrt(2))
+        coeffs = ["-1.1514610310e-1f", "1.1676998740e-1f", "-1.2420140846e-1f",
+                  "1.4249322787e-1f", "-1.6668057665e-1f", "2.0000714765e-1f",
+                  "-2.4999993993e-1f", "3.3333331174e-1f"]
+        lines = [
+            f"const {v} xc = {t.max('x', t.dup('1.17549435e-38f'))};",
+            f"{v} e = {t.exponent('xc')};",
+            f"{v} m = {t.mantissa('xc')};",
+            f"const {t.mtype} small = {t.lt('m', t.dup('0.707106781186547524f'))};",
+            f"e = {t.sub('e', t.select('small', one, zero))};",
+            f"m = {t.add(t.sub('m', one), t.select('small', 'm', zero))};",
+            f"const {v} z = {t.mul('m', 'm')};",
+            f"{v} y = {t.dup('7.0376836292e-2f')};",
+        ]
+        lines += [f"y = {t.fma(t.dup(c), 'y', 'm')};" for c in coeffs]
+        lines += [
+            f"y = {t.mul(t.mul('y', 'm'), 'z')};",
+            f"y = {t.fma('y', 'e', t.dup('-2.12194440e-4f'))};",
+            f"y = {t.fms('y', 'z', t.dup('0.5f'))};",
+            f"{v} r = {t.fma(t.add('m', 'y'), 'e', t.dup('0.693359375f'))};",
+            f"r = {t.select(t.lt('x', zero), t.dup('NAN'), 'r')};",
+            f"return {t.select(t.eq('x', zero), t.dup('-INFINITY'), 'r')};",
+        ]
+        return lines
+    if name == "sigmoid":
+        return [f"return {t.div(one, t.add(one, call('exp', t.neg('x'))))};"]
+    if name == "silu":
+        return [f"return {t.div('x', t.add(one, call('exp', t.neg('x'))))};"]
+    if name == "tanh":
+        # |x| < 0.625: Cephes odd polynomial; otherwise 1 - 2 / (exp(2|x|) + 1)
+        return [
+            f"const {v} ax = {t.abs('x')};",
+            f"{v} big = {t.sub(one, t.div(t.dup('2.0f'), t.add(call('exp', t.add('ax', 'ax')), one)))};",
+            f"big = {t.select(t.lt('x', zero), t.neg('big'), 'big')};",
+            f"const {v} z = {t.mul('x', 'x')};",
+            f"{v} p = {t.dup('-5.70498872745e-3f')};",
+            f"p = {t.fma(t.dup('2.06390887954e-2f'), 'p', 'z')};",
+            f"p = {t.fma(t.dup('-5.37397155531e-2f'), 'p', 'z')};",
+            f"p = {t.fma(t.dup('1.33314422036e-1f'), 'p', 'z')};",
+            f"p = {t.fma(t.dup('-3.33332819422e-1f'), 'p', 'z')};",
+            f"const {v} small = {t.fma('x', t.mul('x', 'z'), 'p')};",
+            f"return {t.select(t.lt('ax', t.dup('0.625f')), 'small', 'big')};",
+        ]
+    if name == "erf":
+        # |x| >= 0.5: Abramowitz & Stegun 7.1.26; otherwise the Taylor series
+        return [
+            f"const {v} ax = {t.abs('x')};",
+            f"const {v} k = {t.div(one, t.fma(one, t.dup('0.3275911f'), 'ax'))};",
+            f"{v} p = {t.dup('1.061405429f')};",
+            f"p = {t.fma(t.dup('-1.453152027f'), 'p', 'k')};",
+            f"p = {t.fma(t.dup('1.421413741f'), 'p', 'k')};",
+            f"p = {t.fma(t.dup('-0.284496736f'), 'p', 'k')};",
+            f"p = {t.fma(t.dup('0.254829592f'), 'p', 'k')};",
+            f"p = {t.mul('p', 'k')};",
+            f"{v} big = {t.fms(one, 'p', call('exp', t.neg(t.mul('ax', 'ax'))))};",
+            f"big = {t.select(t.lt('x', zero), t.neg('big'), 'big')};",
+            f"const {v} z = {t.mul('x', 'x')};",
+            f"{v} s = {t.dup('-7.57575758e-4f')};",
+            f"s = {t.fma(t.dup('4.62962963e-3f'), 's', 'z')};",
+            f"s = {t.fma(t.dup('-2.38095238e-2f'), 's', 'z')};",
+            f"s = {t.fma(t.dup('1.0e-1f'), 's', 'z')};",
+            f"s = {t.fma(t.dup('-3.33333333e-1f'), 's', 'z')};",
+            f"s = {t.fma(one, 's', 'z')};",
+            f"const {v} small = {t.mul(t.mul('x', 's'), t.dup('1.12837916709551257f'))};",
+            f"return {t.select(t.lt('ax', t.dup('0.5f')), 'small', 'big')};",
+        ]
+    if name == "gelu":
+        return [f"return {t.mul(t.mul(t.dup('0.5f'), 'x'), t.add(one, call('erf', t.mul('x', t.dup('0.70710678118654752f')))))};"]
+    raise ValueError(f"Unknown SIMD helper '{name}'")
+
+
+def arm64_simd_helpers(t: ARM64SimdTarget, names: set) -> List[str]:
+    """
+    static inline definitions of the vector math helpers in `names` and the
+    helpers they depend on, in dependency order.
+    """
+    ordered: List[str] = []
+
+    def visit(name: str):
+        if name in ordered:
+            return
+        for dep in ARM64_SIMD_HELPER_DEPS[name]:
+            visit(dep)
+        ordered.append(name)
+
+    for name in sorted(names):
+        visit(name)
+    if not ordered:
+        return []
+
+    v = t.vtype
+    lines = [f"// Vector math helpers ({t.name})"]
+    for name in ordered:
+        if name == "map":
+            # Lane-wise fallback for functions without a vector version
+            lines.append(f"static inline {v} {t.helper_prefix}_map_f32({t.helper_params}{v} x, float (*fn)(float)) {{")
+            if t.predicated:
+                lines.append("    float _t[64];  /* SVE vectors hold at most 64 f32 lanes */")
+                lines.append("    svst1_f32(svptrue_b32(), _t, x);")
+                lines.append("    for (int _l = 0; _l < (int)svcntw(); _l++) _t[_l] = fn(_t[_l]);")
+                lines.append("    return svld1_f32(_pg, _t);")
+            else:
+                lines.append("    float _t[4];")
+                lines.append("    vst1q_f32(_t, x);")
+                lines.append("    for (int _l = 0; _l < 4; _l++) _t[_l] = fn(_t[_l]);")
+                lines.append("    return vld1q_f32(_t);")
+            lines.append("}")
+            continue
+        lines.append(f"static inline {v} {t.helper_prefix}_{name}_f32({t.helper_params}{v} x) {{")
+        lines.extend(f"    {stmt}" for stmt in _simd_helper_body(t, name))
+        lines.append("}")
+    lines.append("")
+    return lines
+
+
 # =============================================================================
 # ARM64 Barrier Operation Code Generation
 # =============================================================================
@@ -84,7 +405,8 @@ class OrchestrationContext:
 def gen_arm64_barrier_op(instr: MockInstruction, rows: int, cols: int, dtype: str, 
                          tile_info: Dict[str, MockTileInfo],
                          orch_ctx: Optional[OrchestrationContext] = None,
-                         scalar_declarations: Optional[Dict[str, Any]] = None) -> List[str]:
+                         scalar_declarations: Optional[Dict[str, Any]] = None,
+                         simd: Optional[str] = None) -> List[str]:
     """
     Generate ARM64 code for barrier operations (non-fusable).
     
@@ -94,10 +416,17 @@ def gen_arm64_barrier_op(instr: MockInstruction, rows: int, cols: int, dtype: st
         dtype: Data type
         tile_info: Tile metadata
         orch_ctx: Optional orchestration context for task scheduling
+        simd: "neon" or "sve" to vectorize reductions, broadcasts and matmul
     """
     lines = []
     c_type = ARM64_TYPE_MAP.get(dtype, "float")
     
+    target = arm64_simd_target(simd)
+    if target is not None and instr.opcode in ARM64_SIMD_BARRIER_OPS:
+        simd_lines = gen_arm64_simd_barrier_op(target, instr, rows, cols, tile_info)
+        if simd_lines is not None:
+            return simd_lines
+    
     if instr.opcode == "TLOAD":
         dst, src_mem = instr.dst, instr.operands[0]
         row_off = instr.operands[1] if len(instr.operands) > 1 else "0"
@@ -349,6 +678,199 @@ def gen_arm64_barrier_op(instr: MockInstruction, rows: int, cols: int, dtype: st
     return lines
 
 
+# =============================================================================
+# ARM64 SIMD Barrier Operations
+# =============================================================================
+
+ARM64_SIMD_BARRIER_OPS = ("TROWSUM", "TROWMAX", "TCOLSUM",
+                          "TROWEXPANDSUB", "TROWEXPANDDIV", "TROWEXPANDMUL", "TMATMUL")
+
+
+def _simd_col_loops(t: ARM64SimdTarget, n: int, step: int) -> Tuple[int, int]:
+    """Bounds (vector_end, single_vector_end) of unrolled and single-vector column loops."""
+    lanes = t.fixed_lanes
+    end = n - n % step
+    return end, end + (n - end) // lanes * lanes
+
+
+def gen_arm64_simd_barrier_op(t: ARM64SimdTarget, instr: MockInstruction, rows: int, cols: int,
+                              tile_info: Dict[str, MockTileInfo]) -> Optional[List[str]]:
+    """
+    Vector code for reductions, row broadcasts and matmul on f32 tiles.
+
+    Returns None when the operation has to stay scalar (other dtypes, or
+    rows narrower than one NEON vector).
+    """
+    names = [instr.dst] + [op for op in instr.operands[:2]]
+    if any(tile_info.get(n) is not None and tile_info[n].dtype != "f32" for n in names):
+        return None
+    v = t.vtype
+    lines = []
+
+    if instr.opcode in ("TROWSUM", "TROWMAX"):
+        dst, src = instr.dst, instr.operands[0]
+        src_info = tile_info.get(src)
+        n = src_info.cols if src_info else cols
+        is_sum = instr.opcode == "TROWSUM"
+        acc_op = t.acc_add if is_sum else t.acc_max
+        reduce = t.reduce_add if is_sum else t.reduce_max
+        init = "0.0f" if is_sum else "-INFINITY"
+        lines.append(f"// {instr.opcode}: {dst} = {'rowsum' if is_sum else 'rowmax'}({src})")
+        lines.append(f"for (int _row = 0; _row < {rows}; _row++) {{")
+        if t.predicated:
+            lines.append(f"    {v} _acc = {t.dup(init)};")
+            lines.append(f"    for (int _col = 0; _col < {n}; _col += {t.lanes}) {{")
+            lines.append(f"        const svbool_t _pg = svwhilelt_b32_s32(_col, {n});")
+            lines.append(f"        _acc = {acc_op('_acc', t.load(f'&{src}[_row][_col]'))};")
+            lines.append(f"    }}")
+            lines.append(f"    {dst}[_row][0] = {reduce('_acc')};}}")
+            return lines
+        if n < t.fixed_lanes:
+            return None
+        # Four independent accumulators hide the add latency on wide rows
+        accs = 4 if n >= 4 * t.fixed_lanes else 1
+        end, end1 = _simd_col_loops(t, n, accs * t.fixed_lanes)
+        for a in range(accs):
+            lines.append(f"    {v} _acc{a} = {t.dup(init)};")
+        lines.append(f"    for (int _col = 0; _col < {end}; _col += {accs * t.fixed_lanes}) {{")
+        for a in range(accs):
+            offset = f" + {a * t.fixed_lanes}" if a else ""
+            lines.append(f"        _acc{a} = {acc_op(f'_acc{a}', t.load(f'&{src}[_row][_col{offset}]'))};")
+        lines.append(f"    }}")
+        if end1 > end:
+            lines.append(f"    for (int _col = {end}; _col < {end1}; _col += {t.fixed_lanes}) {{")
+            lines.append(f"        _acc0 = {acc_op('_acc0', t.load(f'&{src}[_row][_col]'))};")
+            lines.append(f"    }}")
+        if accs == 4:
+            lines.append(f"    _acc0 = {acc_op(acc_op('_acc0', '_acc1'), acc_op('_acc2', '_acc3'))};")
+        result = "_sum" if is_sum else "_max"
+        lines.append(f"    float {result} = {reduce('_acc0')};")
+        if end1 < n:
+            lines.append(f"    for (int _col = {end1}; _col < {n}; _col++) {{")
+            if is_sum:
+                lines.append(f"        _sum += {src}[_row][_col];")
+            else:
+                lines.append(f"        if ({src}[_row][_col] > _max) _max = {src}[_row][_col];")
+            lines.append(f"    }}")
+        lines.append(f"    {dst}[_row][0] = {result};}}")
+        return lines
+
+    if instr.opcode == "TCOLSUM":
+        dst, src = instr.dst, instr.operands[0]
+        src_info = tile_info.get(src)
+        src_rows = src_info.rows if src_info else rows
+        lines.append(f"// TCOLSUM: {dst} = colsum({src})")
+        if t.predicated:
+            lines.append(f"for (int _col = 0; _col < {cols}; _col += {t.lanes}) {{")
+            lines.append(f"    const svbool_t _pg = svwhilelt_b32_s32(_col, {cols});")
+            lines.append(f"    {v} _acc = {t.dup('0.0f')};")
+            lines.append(f"    for (int _row = 0; _row < {src_rows}; _row++) {{")
+            lines.append(f"        _acc = {t.add('_acc', t.load(f'&{src}[_row][_col]'))};")
+            lines.append(f"    }}")
+            lines.append(f"    {t.store(f'&{dst}[0][_col]', '_acc')}}}")
+            return lines
+        if cols < t.fixed_lanes:
+            return None
+        _, end = _simd_col_loops(t, cols, t.fixed_lanes)
+        lines.append(f"for (int _col = 0; _col < {end}; _col += {t.fixed_lanes}) {{")
+        lines.append(f"    {v} _acc = {t.dup('0.0f')};")
+        lines.append(f"    for (int _row = 0; _row < {src_rows}; _row++) {{")
+        lines.append(f"        _acc = {t.add('_acc', t.load(f'&{src}[_row][_col]'))};")
+        lines.append(f"    }}")
+        lines.append(f"    {t.store(f'&{dst}[0][_col]', '_acc')}}}")
+        if end < cols:
+            lines.append(f"for (int _col = {end}; _col < {cols}; _col++) {{")
+            lines.append(f"    float _sum = 0.0f;")
+            lines.append(f"    for (int _row = 0; _row < {src_rows}; _row++) {{")
+            lines.append(f"        _sum += {src}[_row][_col];")
+            lines.append(f"    }}")
+            lines.append(f"    {dst}[0][_col] = _sum;}}")
+        return lines
+
+    if instr.opcode in ("TROWEXPANDSUB", "TROWEXPANDDIV", "TROWEXPANDMUL"):
+        dst, src0, src1 = instr.dst, instr.operands[0], instr.operands[1]
+        c_op, vec_op = {"TROWEXPANDSUB": ("-", t.sub), "TROWEXPANDDIV": ("/", t.div),
+                        "TROWEXPANDMUL": ("*", t.mul)}[instr.opcode]
+        lines.append(f"// {instr.opcode}: {dst} = {src0} {c_op} broadcast({src1})")
+        lines.append(f"for (int _row = 0; _row < {rows}; _row++) {{")
+        if t.predicated:
+            lines.append(f"    const {v} _bv = {t.dup(f'{src1}[_row][0]')};")
+            lines.append(f"    for (int _col = 0; _col < {cols}; _col += {t.lanes}) {{")
+            lines.append(f"        const svbool_t _pg = svwhilelt_b32_s32(_col, {cols});")
+            lines.append(f"        {t.store(f'&{dst}[_row][_col]', vec_op(t.load(f'&{src0}[_row][_col]'), '_bv'))}")
+            lines.append(f"    }}}}")
+            return lines
+        if cols < t.fixed_lanes:
+            return None
+        _, end = _simd_col_loops(t, cols, t.fixed_lanes)
+        lines.append(f"    const float _broadcast_val = {src1}[_row][0];")
+        lines.append(f"    const {v} _bv = {t.dup('_broadcast_val')};")
+        lines.append(f"    for (int _col = 0; _col < {end}; _col += {t.fixed_lanes}) {{")
+        lines.append(f"        {t.store(f'&{dst}[_row][_col]', vec_op(t.load(f'&{src0}[_row][_col]'), '_bv'))}")
+        lines.append(f"    }}")
+        if end < cols:
+            lines.append(f"    for (int _col = {end}; _col < {cols}; _col++) {{")
+            lines.append(f"        {dst}[_row][_col] = {src0}[_row][_col] {c_op} _broadcast_val;")
+            lines.append(f"    }}")
+        lines.append(f"}}")
+        return lines
+
+    if instr.opcode == "TMATMUL":
+        dst, a, b = instr.dst, instr.operands[0], instr.operands[1]
+        a_info = tile_info.get(a)
+        k = a_info.cols if a_info else 8
+        lines.append(f"// TMATMUL: {dst} = {a} @ {b}")
+        lines.append(f"for (int _i = 0; _i < {rows}; _i++) {{")
+        if t.predicated:
+            lines.append(f"    for (int _j = 0; _j < {cols}; _j += {t.lanes}) {{")
+            lines.append(f"        const svbool_t _pg = svwhilelt_b32_s32(_j, {cols});")
+            lines.append(f"        {v} _c = {t.dup('0.0f')};")
+            lines.append(f"        for (int _k = 0; _k < {k}; _k++) {{")
+            lines.append(f"            _c = {t.fma_n('_c', t.load(f'&{b}[_k][_j]'), f'{a}[_i][_k]')};")
+            lines.append(f"        }}")
+            lines.append(f"        {t.store(f'&{dst}[_i][_j]', '_c')}")
+            lines.append(f"    }}}}")
+            return lines
+        if cols < t.fixed_lanes:
+            return None
+        # Row of A times a 16-column panel of B: four accumulators per k step
+        block = 4 * t.fixed_lanes
+        end, end1 = _simd_col_loops(t, cols, block)
+        if end > 0:
+            lines.append(f"    for (int _j = 0; _j < {end}; _j += {block}) {{")
+            for c in range(4):
+                lines.append(f"        {v} _c{c} = {t.dup('0.0f')};")
+            lines.append(f"        for (int _k = 0; _k < {k}; _k++) {{")
+            lines.append(f"            const float _a = {a}[_i][_k];")
+            for c in range(4):
+                offset = f" + {c * t.fixed_lanes}" if c else ""
+                lines.append(f"            _c{c} = {t.fma_n(f'_c{c}', t.load(f'&{b}[_k][_j{offset}]'), '_a')};")
+            lines.append(f"        }}")
+            for c in range(4):
+                offset = f" + {c * t.fixed_lanes}" if c else ""
+                lines.append(f"        {t.store(f'&{dst}[_i][_j{offset}]', f'_c{c}')}")
+            lines.append(f"    }}")
+        if end1 > end:
+            lines.append(f"    for (int _j = {end}; _j < {end1}; _j += {t.fixed_lanes}) {{")
+            lines.append(f"        {v} _c = {t.dup('0.0f')};")
+            lines.append(f"        for (int _k = 0; _k < {k}; _k++) {{")
+            lines.append(f"            _c = {t.fma_n('_c', t.load(f'&{b}[_k][_j]'), f'{a}[_i][_k]')};")
+            lines.append(f"        }}")
+            lines.append(f"        {t.store(f'&{dst}[_i][_j]', '_c')}")
+            lines.append(f"    }}")
+        if end1 < cols:
+            lines.append(f"    for (int _j = {end1}; _j < {cols}; _j++) {{")
+            lines.append(f"        float _sum = 0.0f;")
+            lines.append(f"        for (int _k = 0; _k < {k}; _k++) {{")
+            lines.append(f"            _sum += {a}[_i][_k] * {b}[_k][_j];}}")
+            lines.append(f"        {dst}[_i][_j] = _sum;")
+            lines.append(f"    }}")
+        lines.append(f"}}")
+        return lines
+
+    return None
+
+
 # =============================================================================
 # Task Scheduling Code Generation (for Orchestration Functions)
 # =============================================================================
@@ -477,14 +999,53 @@ def gen_task_scheduling_code(callee: str, args: Union[List, Dict],
 # ARM64 Fused Loop Code Generation
 # =============================================================================
 
+# Fused element-wise ops with a vector lowering. Values are
+# (kind, spelling): "op" is a target method, "helper" a vector math helper,
+# "map" a lane-wise call of a scalar libm function.
+ARM64_SIMD_FUSED_OPS = {
+    "TADD": ("op", "add"), "TSUB": ("op", "sub"), "TMUL": ("op", "mul"), "TDIV": ("op", "div"),
+    "TMAX": ("op", "max"), "TMIN": ("op", "min"),
+    "TADDS": ("op", "add"), "TSUBS": ("op", "sub"), "TMULS": ("op", "mul"), "TDIVS": ("op", "div"),
+    "TABS": ("op", "abs"), "TNEG": ("op", "neg"), "TSQRT": ("op", "sqrt"),
+    "TFLOOR": ("op", "floor"), "TCEIL": ("op", "ceil"),
+    "TRECIP": ("recip", None), "TRSQRT": ("rsqrt", None), "TRELU": ("relu", None),
+    "TEXPANDS": ("expands", None),
+    "TEXP": ("helper", "exp"), "TLOG": ("helper", "log"), "TSIGMOID": ("helper", "sigmoid"),
+    "TSILU": ("helper", "silu"), "TTANH": ("helper", "tanh"), "TGELU": ("helper", "gelu"),
+    "TERF": ("helper", "erf"),
+    "TSIN": ("map", "sinf"), "TCOS": ("map", "cosf"),
+}
+
+
 class ARM64FusedCodeGenerator:
-    """Generate ARM64 code for fused loops."""
+    """
+    Generate ARM64 code for fused loops.
+    
+    With a SIMD target, f32 loops (and f16 loops on NEON) become one vector
+    loop over the whole tile when every operand has the loop's shape, or one
+    vector loop per row otherwise. Each operand tile is loaded once per
+    iteration, intermediates stay in registers, and each destination is
+    stored once. NEON loops end with a scalar remainder; SVE loops are
+    predicated. Loops the vectorizer cannot handle keep the scalar form.
+    """
     
-    def __init__(self):
+    def __init__(self, simd: Optional[str] = None,
+                 tile_info: Optional[Dict[str, MockTileInfo]] = None):
         self.dtype_map = ARM64_TYPE_MAP
+        self.target = arm64_simd_target(simd)
+        self.tile_info = tile_info or {}
+        self.helpers_used = set()
+        self.stats = {"vector_loops": 0, "scalar_loops": 0}
     
     def generate_fused_loop(self, fused_loop: FusedLoop) -> List[str]:
         """Generate code for a fused loop."""
+        if self.target is not None:
+            vector_lines = self._generate_vector_loop(fused_loop)
+            if vector_lines is not None:
+                self.stats["vector_loops"] += 1
+                return vector_lines
+        self.stats["scalar_loops"] += 1
+        
         lines = []
         rows = fused_loop.tile_shape.rows
         cols = fused_loop.tile_shape.cols
@@ -505,60 +1066,396 @@ class ARM64FusedCodeGenerator:
     def _generate_single_op(self, op: FusableOp, c_type: str) -> str:
         """Generate code for a single fusable operation."""
         dst = f"{op.dst}[_row][_col]"
-        src0 = f"{op.operands[0]}[_row][_col]" if op.operands else ""
-        src1 = ""
+        args = [f"{name}[_row][_col]" if is_tile else name for name, is_tile in self._split_operands(op)]
+        expr = self._scalar_expr(op, args)
+        if expr is None:
+            return f"// Unknown op: {op.opcode}"
+        return f"{dst} = {expr};"
+    
+    def _scalar_expr(self, op: FusableOp, args: List[str]) -> Optional[str]:
+        """C expression of a fusable operation on scalar operands (see _split_operands)."""
+        src0 = args[0] if args else ""
+        src1 = args[1] if len(args) > 1 else ""
         
-        # Check if this is a scalar operation (second operand is a scalar, not a tile)
-        is_scalar_op = op.opcode in ("TADDS", "TSUBS", "TMULS", "TDIVS")
+        # Binary operations
+        if op.opcode == "TADD": return f"{src0} + {src1}"
+        elif op.opcode == "TSUB": return f"{src0} - {src1}"
+        elif op.opcode == "TMUL": return f"{src0} * {src1}"
+        elif op.opcode == "TDIV": return f"{src0} / {src1}"
+        elif op.opcode == "TMAX": return f"({src0} > {src1}) ? {src0} : {src1}"
+        elif op.opcode == "TMIN": return f"({src0} < {src1}) ? {src0} : {src1}"
+        
+        # Unary operations
+        elif op.opcode == "TABS": return f"fabsf({src0})"
+        elif op.opcode == "TNEG": return f"-{src0}"
+        elif op.opcode == "TRECIP": return f"1.0f / {src0}"
+        elif op.opcode == "TEXP": return f"expf({src0})"
+        elif op.opcode == "TLOG": return f"logf({src0})"
+        elif op.opcode == "TSQRT": return f"sqrtf({src0})"
+        elif op.opcode == "TRSQRT": return f"1.0f / sqrtf({src0})"
+        elif op.opcode == "TRELU": return f"({src0} > 0) ? {src0} : 0"
+        elif op.opcode == "TSIGMOID": return f"1.0f / (1.0f + expf(-{src0}))"
+        elif op.opcode == "TTANH": return f"tanhf({src0})"
+        elif op.opcode == "TGELU": return f"0.5f * {src0} * (1.0f + erff({src0} / 1.41421356f))"
+        elif op.opcode == "TSILU": return f"{src0} / (1.0f + expf(-{src0}))"
+        elif op.opcode == "TFLOOR": return f"floorf({src0})"
+        elif op.opcode == "TCEIL": return f"ceilf({src0})"
+        elif op.opcode == "TSIN": return f"sinf({src0})"
+        elif op.opcode == "TCOS": return f"cosf({src0})"
+        elif op.opcode == "TERF": return f"erff({src0})"
+        
+        # Scalar operations
+        elif op.opcode == "TADDS": return f"{src0} + {src1}"
+        elif op.opcode == "TSUBS": return f"{src0} - {src1}"
+        elif op.opcode == "TMULS": return f"{src0} * {src1}"
+        elif op.opcode == "TDIVS": return f"{src0} / {src1}"
+        elif op.opcode == "TEXPANDS": return src0
         
+        # Row broadcasts: args are the element and the row's value
+        elif op.opcode == "TROWEXPAND": return args[-1]
+        elif op.opcode == "TROWEXPANDSUB": return f"{src0} - {src1}"
+        elif op.opcode == "TROWEXPANDDIV": return f"{src0} / {src1}"
+        elif op.opcode == "TROWEXPANDMUL": return f"{src0} * {src1}"
+        
+        return None
+    
+    def _split_operands(self, op: FusableOp) -> List[Tuple[str, bool]]:
+        """(operand, is_tile) pairs, classified as in _generate_single_op."""
+        if op.opcode == "TEXPANDS":
+            return [(str(op.operands[0]), False)]
+        result = [(op.operands[0], True)] if op.operands else []
         if len(op.operands) >= 2:
-            src1_val = op.operands[1]
-            if is_scalar_op:
-                # For scalar operations, second operand is a scalar variable or literal
-                # Use it directly without indexing
-                src1 = str(src1_val)
+            src1 = op.operands[1]
+            is_tile = (op.opcode not in ("TADDS", "TSUBS", "TMULS", "TDIVS")
+                       and isinstance(src1, str)
+                       and not src1.replace(".", "").replace("-", "").isdigit())
+            result.append((src1 if is_tile else str(src1), is_tile))
+        return result
+    
+    def _vector_expr(self, op: FusableOp, args: List[str]) -> str:
+        t = self.target
+        kind, spelling = ARM64_SIMD_FUSED_OPS[op.opcode]
+        if kind == "op":
+            return getattr(t, spelling)(*args)
+        if kind == "recip":
+            return t.div(t.dup("1.0f"), args[0])
+        if kind == "rsqrt":
+            return t.div(t.dup("1.0f"), t.sqrt(args[0]))
+        if kind == "relu":
+            return t.max(args[0], t.dup("0.0f"))
+        if kind == "expands":
+            return args[0]
+        if kind == "helper":
+            self.helpers_used.add(spelling)
+            return f"{t.helper_prefix}_{spelling}_f32({t.helper_args}{args[0]})"
+        self.helpers_used.add("map")
+        return f"{t.helper_prefix}_map_f32({t.helper_args}{args[0]}, {spelling})"
+    
+    def _generate_vector_loop(self, fused_loop: FusedLoop) -> Optional[List[str]]:
+        """Vector form of a fused loop, or None to keep the scalar loop."""
+        t = self.target
+        rows = fused_loop.tile_shape.rows
+        cols = fused_loop.tile_shape.cols
+        ops = fused_loop.operations
+        if not ops or any(op.opcode not in ARM64_SIMD_FUSED_OPS for op in ops):
+            return None
+        
+        tiles = []
+        for op in ops:
+            for name in [n for n, is_tile in self._split_operands(op) if is_tile] + [op.dst]:
+                if name not in tiles:
+                    tiles.append(name)
+        dtypes = {self.tile_info[n].dtype if n in self.tile_info else fused_loop.dtype for n in tiles}
+        if len(dtypes) != 1:
+            return None
+        dtype = dtypes.pop()
+        if dtype != "f32" and not (dtype == "f16" and t.supports_f16):
+            return None
+        parts = ["_lo", "_hi"] if dtype == "f16" else [""]
+        
+        # One loop over the flattened tile if every operand has the loop's
+        # shape, else a vector loop per row
+        flat = all(n not in self.tile_info or
+                   (self.tile_info[n].rows, self.tile_info[n].cols) == (rows, cols) for n in tiles)
+        length = rows * cols if flat else cols
+        step = (t.fixed_lanes or 1) * len(parts)
+        end = length - length % step
+        if not t.predicated and end == 0:
+            return None
+        
+        idx = "_i" if flat else "_col"
+        addr = (lambda n: f"&{n}[0][0] + _i") if flat else (lambda n: f"&{n}[_row][_col]")
+        c_type = self.dtype_map.get(dtype, "float")
+        width = f"{t.fixed_lanes} x f32" if not t.predicated else "svcntw() x f32"
+        if dtype == "f16":
+            width = f"{step} x f16 as 2 x f32x4"
+        
+        body = []
+        if t.predicated:
+            body.append(f"const svbool_t _pg = svwhilelt_b32_s32({idx}, {length});")
+        values: Dict[Tuple[str, str], str] = {}
+        stored: List[str] = []
+        counter = 0
+        for op in ops:
+            for part in parts:
+                args = []
+                for name, is_tile in self._split_operands(op):
+                    if not is_tile:
+                        args.append(t.dup(name))
+                        continue
+                    if (name, part) not in values:
+                        var = f"_in_{name}"
+                        if dtype == "f16":
+                            body.extend(t.load_f16(addr(name), var + "_lo", var + "_hi"))
+                            values[(name, "_lo")], values[(name, "_hi")] = var + "_lo", var + "_hi"
+                        else:
+                            body.append(f"const {t.vtype} {var} = {t.load(addr(name))};")
+                            values[(name, "")] = var
+                    args.append(values[(name, part)])
+                var = f"_v{counter}{part}"
+                body.append(f"const {t.vtype} {var} = {self._vector_expr(op, args)};")
+                values[(op.dst, part)] = var
+            counter += 1
+            if op.dst not in stored:
+                stored.append(op.dst)
+        for name in stored:
+            if dtype == "f16":
+                body.append(t.store_f16(addr(name), values[(name, "_lo")], values[(name, "_hi")]))
             else:
-                # For tile operations, check if it's a tile or literal
-                if isinstance(src1_val, str) and not src1_val.replace(".", "").replace("-", "").isdigit():
-                    src1 = f"{src1_val}[_row][_col]"
-                else:
-                    src1 = str(src1_val)
+                body.append(t.store(addr(name), values[(name, "")]))
         
-        # Binary operations
-        if op.opcode == "TADD": return f"{dst} = {src0} + {src1};"
-        elif op.opcode == "TSUB": return f"{dst} = {src0} - {src1};"
-        elif op.opcode == "TMUL": return f"{dst} = {src0} * {src1};"
-        elif op.opcode == "TDIV": return f"{dst} = {src0} / {src1};"
-        elif op.opcode == "TMAX": return f"{dst} = ({src0} > {src1}) ? {src0} : {src1};"
-        elif op.opcode == "TMIN": return f"{dst} = ({src0} < {src1}) ? {src0} : {src1};"
+        scalar_ops = [self._generate_single_op(op, c_type) for op in ops]
+        lines = [f"// Fused loop: {len(ops)} operations ({t.name}, {width})"]
+        indent = ""
+        if not flat:
+            lines.append(f"for (int _row = 0; _row < {rows}; _row++) {{")
+            indent = "    "
+        if t.predicated:
+            lines.append(f"{indent}for (int {idx} = 0; {idx} < {length}; {idx} += {t.lanes}) {{")
+        else:
+            lines.append(f"{indent}for (int {idx} = 0; {idx} < {end}; {idx} += {step}) {{")
+        lines.extend(f"{indent}    {stmt}" for stmt in body)
+        lines.append(f"{indent}}}")
+        if not t.predicated and end < length:
+            lines.append(f"{indent}for (int {idx} = {end}; {idx} < {length}; {idx}++) {{")
+            if flat:
+                lines.append(f"    const int _row = _i / {cols}, _col = _i % {cols};")
+            lines.extend(f"{indent}    {stmt}" for stmt in scalar_ops)
+            lines.append(f"{indent}}}")
+        if not flat:
+            lines.append("}")
+        return lines
+    
+    # -------------------------------------------------------------------------
+    # Row loops
+    # -------------------------------------------------------------------------
+    
+    ROW_REDUCE = {"TROWSUM": ("0.0f", "add"), "TROWMAX": ("-INFINITY", "max"),
+                  "TROWMIN": ("INFINITY", "min")}
+    
+    def generate_row_loop(self, row_loop: FusedRowLoop) -> List[str]:
+        """
+        Generate code for a row-fused loop: one loop over rows; per row, each
+        sweep is one column loop (vectorized when possible) that keeps
+        intermediates in registers and accumulates reductions, and per-row
+        ops run on scalars between sweeps.
+        """
+        rows, cols = row_loop.rows, row_loop.cols
+        c_type = self.dtype_map.get(row_loop.dtype, "float")
+        is_row_tile = lambda n: cols != 1 and n in self.tile_info and self.tile_info[n].cols == 1
         
-        # Unary operations
-        elif op.opcode == "TABS": return f"{dst} = fabsf({src0});"
-        elif op.opcode == "TNEG": return f"{dst} = -{src0};"
-        elif op.opcode == "TRECIP": return f"{dst} = 1.0f / {src0};"
-        elif op.opcode == "TEXP": return f"{dst} = expf({src0});"
-        elif op.opcode == "TLOG": return f"{dst} = logf({src0});"
-        elif op.opcode == "TSQRT": return f"{dst} = sqrtf({src0});"
-        elif op.opcode == "TRSQRT": return f"{dst} = 1.0f / sqrtf({src0});"
-        elif op.opcode == "TRELU": return f"{dst} = ({src0} > 0) ? {src0} : 0;"
-        elif op.opcode == "TSIGMOID": return f"{dst} = 1.0f / (1.0f + expf(-{src0}));"
-        elif op.opcode == "TTANH": return f"{dst} = tanhf({src0});"
-        elif op.opcode == "TGELU": return f"{dst} = 0.5f * {src0} * (1.0f + erff({src0} / 1.41421356f));"
-        elif op.opcode == "TSILU": return f"{dst} = {src0} / (1.0f + expf(-{src0}));"
-        elif op.opcode == "TFLOOR": return f"{dst} = floorf({src0});"
-        elif op.opcode == "TCEIL": return f"{dst} = ceilf({src0});"
-        elif op.opcode == "TSIN": return f"{dst} = sinf({src0});"
-        elif op.opcode == "TCOS": return f"{dst} = cosf({src0});"
-        elif op.opcode == "TERF": return f"{dst} = erff({src0});"
+        body: List[str] = []
+        row_values: Dict[str, str] = {}
         
-        # Scalar operations
-        elif op.opcode == "TADDS": return f"{dst} = {src0} + {src1};"
-        elif op.opcode == "TSUBS": return f"{dst} = {src0} - {src1};"
-        elif op.opcode == "TMULS": return f"{dst} = {src0} * {src1};"
-        elif op.opcode == "TDIVS": return f"{dst} = {src0} / {src1};"
-        elif op.opcode == "TEXPANDS": return f"{dst} = {op.operands[0]};"
+        def row_value(name: str) -> str:
+            if name not in row_values:
+                body.append(f"{c_type} _r_{name} = {name}[_row][0];")
+                row_values[name] = f"_r_{name}"
+            return row_values[name]
         
-        return f"// Unknown op: {op.opcode}"
+        def set_row_value(name: str, expr: str):
+            if name in row_values:
+                body.append(f"_r_{name} = {expr};")
+            else:
+                body.append(f"{c_type} _r_{name} = {expr};")
+                row_values[name] = f"_r_{name}"
+            if name in row_loop.materialized:
+                body.append(f"{name}[_row][0] = _r_{name};")
+        
+        vector_sweeps = 0
+        sweep_index = 0
+        for stage in row_loop.stages:
+            if isinstance(stage, RowSweep):
+                for op in stage.operations:
+                    if op.opcode in ROW_BROADCAST_OPS:
+                        row_value(op.operands[-1])
+                lines, vectorized = self._row_sweep(stage, sweep_index, row_loop, c_type,
+                                                    row_values, is_row_tile)
+                body.extend(lines)
+                vector_sweeps += vectorized
+                for k, op in enumerate(o for o in stage.operations if o.opcode in ROW_REDUCTION_OPS):
+                    set_row_value(op.dst, f"_s{sweep_index}_{k}")
+                sweep_index += 1
+            else:
+                args = [row_value(name) if is_tile else name for name, is_tile in self._split_operands(stage)]
+                set_row_value(stage.dst, self._scalar_expr(stage, args))
+        
+        ops = row_loop.operations
+        suffix = ""
+        if vector_sweeps:
+            suffix = f", {self.target.name}"
+        lines = [f"// Row-fused loop: {len(ops)} operations, {row_loop.sweeps} column sweeps per row{suffix}"]
+        lines.append(f"for (int _row = 0; _row < {rows}; _row++) {{")
+        lines.extend(f"    {stmt}" if stmt else "" for stmt in body)
+        lines.append("}")
+        return lines
+    
+    def _row_sweep_vectorizable(self, sweep: RowSweep, row_loop: FusedRowLoop) -> bool:
+        t = self.target
+        if t is None or row_loop.dtype != "f32":
+            return False
+        if not t.predicated and row_loop.cols < t.fixed_lanes:
+            return False
+        for op in sweep.operations:
+            if op.opcode not in ARM64_SIMD_FUSED_OPS and op.opcode not in ROW_REDUCTION_OPS \
+                    and op.opcode not in ROW_BROADCAST_OPS:
+                return False
+            names = [op.dst] + [o for o in op.operands if isinstance(o, str)]
+            if any(n in self.tile_info and self.tile_info[n].dtype != "f32" for n in names):
+                return False
+        return True
+    
+    def _row_sweep(self, sweep: RowSweep, si: int, row_loop: FusedRowLoop, c_type: str,
+                   row_values: Dict[str, str], is_row_tile) -> Tuple[List[str], bool]:
+        """Column loop(s) of sweep si; leaves its reduction k in _s<si>_<k>."""
+        cols = row_loop.cols
+        reductions = [op for op in sweep.operations if op.opcode in ROW_REDUCTION_OPS]
+        stored = []
+        for op in sweep.operations:
+            if op.dst in row_loop.materialized and not is_row_tile(op.dst) and op.dst not in stored:
+                stored.append(op.dst)
+        names = " ".join(f"{op.opcode.lower()}:{op.dst}" for op in sweep.operations)
+        lines = [f"// {names}"]
+        
+        def iteration(vector: bool) -> List[str]:
+            t = self.target
+            stmts = []
+            values: Dict[str, str] = {}
+            
+            def value(name: str) -> str:
+                if name not in values:
+                    var = f"_in_{name}"
+                    if vector:
+                        stmts.append(f"const {t.vtype} {var} = {t.load(f'&{name}[_row][_col]')};")
+                    else:
+                        stmts.append(f"const {c_type} {var} = {name}[_row][_col];")
+                    values[name] = var
+                return values[name]
+            
+            k = 0
+            for n, op in enumerate(sweep.operations):
+                if op.opcode in ROW_REDUCTION_OPS:
+                    init, kind = self.ROW_REDUCE[op.opcode]
+                    v = value(op.operands[0])
+                    acc, total = f"_acc{si}_{k}", f"_s{si}_{k}"
+                    if vector:
+                        stmts.append(f"{acc} = {getattr(t, 'acc_' + kind)(acc, v)};")
+                    elif kind == "add":
+                        stmts.append(f"{total} += {v};")
+                    else:
+                        cmp = ">" if kind == "max" else "<"
+                        stmts.append(f"{total} = ({v} {cmp} {total}) ? {v} : {total};")
+                    k += 1
+                    continue
+                if op.opcode in ROW_BROADCAST_OPS:
+                    bv = f"_bv{si}_{op.operands[-1]}" if vector else row_values[op.operands[-1]]
+                    args = ([value(op.operands[0])] if op.opcode != "TROWEXPAND" else []) + [bv]
+                    if vector:
+                        expr = bv if op.opcode == "TROWEXPAND" else \
+                            getattr(t, {"TROWEXPANDSUB": "sub", "TROWEXPANDDIV": "div",
+                                        "TROWEXPANDMUL": "mul"}[op.opcode])(*args)
+                    else:
+                        expr = self._scalar_expr(op, args)
+                else:
+                    args = []
+                    for name, is_tile in self._split_operands(op):
+                        if is_tile:
+                            args.append(value(name))
+                        else:
+                            args.append(t.dup(name) if vector else name)
+                    expr = self._vector_expr(op, args) if vector else self._scalar_expr(op, args)
+                var = f"_v{si}_{n}"
+                stmts.append(f"const {t.vtype if vector else c_type} {var} = {expr};")
+                values[op.dst] = var
+            for name in stored:
+                if vector:
+                    stmts.append(t.store(f"&{name}[_row][_col]", values[name]))
+                else:
+                    stmts.append(f"{name}[_row][_col] = {values[name]};")
+            return stmts
+        
+        if not self._row_sweep_vectorizable(sweep, row_loop):
+            for k, op in enumerate(reductions):
+                lines.append(f"{c_type} _s{si}_{k} = {self.ROW_REDUCE[op.opcode][0]};")
+            lines.append(f"for (int _col = 0; _col < {cols}; _col++) {{")
+            lines.extend(f"    {stmt}" for stmt in iteration(False))
+            lines.append("}")
+            return lines, False
+        
+        t = self.target
+        for k, op in enumerate(reductions):
+            lines.append(f"{t.vtype} _acc{si}_{k} = {t.dup(self.ROW_REDUCE[op.opcode][0])};")
+        broadcast = []
+        for op in sweep.operations:
+            if op.opcode in ROW_BROADCAST_OPS and op.operands[-1] not in broadcast:
+                broadcast.append(op.operands[-1])
+        for name in broadcast:
+            lines.append(f"const {t.vtype} _bv{si}_{name} = {t.dup(row_values[name])};")
+        if t.predicated:
+            lines.append(f"for (int _col = 0; _col < {cols}; _col += {t.lanes}) {{")
+            lines.append(f"    const svbool_t _pg = svwhilelt_b32_s32(_col, {cols});")
+            end = cols
+        else:
+            end = cols - cols % t.fixed_lanes
+            lines.append(f"for (int _col = 0; _col < {end}; _col += {t.fixed_lanes}) {{")
+        lines.extend(f"    {stmt}" for stmt in iteration(True))
+        lines.append("}")
+        for k, op in enumerate(reductions):
+            kind = self.ROW_REDUCE[op.opcode][1]
+            lines.append(f"{c_type} _s{si}_{k} = {getattr(t, 'reduce_' + kind)(f'_acc{si}_{k}')};")
+        if end < cols:
+            lines.append(f"for (int _col = {end}; _col < {cols}; _col++) {{")
+            lines.extend(f"    {stmt}" for stmt in iteration(False))
+            lines.append("}")
+        return lines, True
+
+
+# =============================================================================
+# ARM64 Tile Arenas
+# =============================================================================
+
+def arm64_tile_arena_declarations(arenas: Dict[str, int]) -> List[str]:
+    """
+    Declare one stack arena per element type (keyed by dtype, see
+    TileBufferAnalyzer). Tiles whose live ranges do not intersect share
+    bytes of the same arena.
+    """
+    lines = []
+    for dtype, size in arenas.items():
+        if size == 0:
+            continue  # only register tiles
+        c_type = ARM64_TYPE_MAP.get(dtype, "float")
+        elem_size = TileBufferAnalyzer.ELEMENT_SIZES.get(dtype, 4)
+        lines.append(f"    {c_type} _tile_arena_{dtype}[{max(size // elem_size, 1)}] "
+                     f"__attribute__((aligned({TileBufferAnalyzer.ARENA_ALIGNMENT})));")
+    return lines
+
+
+def arm64_tile_view(name: str, c_type: str, cols: int, buf) -> str:
+    """Declare a tile as a [rows][cols] view at its arena offset."""
+    elem_size = TileBufferAnalyzer.ELEMENT_SIZES.get(buf.dtype, 4)
+    return (f"    {c_type} (*{name})[{cols}] = ({c_type} (*)[{cols}])"
+            f"(_tile_arena_{buf.arena} + {buf.arena_offset // elem_size});")
 
 
 # =============================================================================
@@ -571,10 +1468,30 @@ class ARM64CodeGenerator:
     """
     
     def __init__(self, enable_fusion: bool = True, analyze_buffers: bool = True,
-                 module: Optional['PTOModule'] = None):
+                 module: Optional['PTOModule'] = None, simd: str = "neon",
+                 fuse_rows: bool = True, binary_expansion: str = "auto",
+                 code_budget: int = BINARY_EXPANSION_CODE_BUDGET):
+        """
+        Args:
+            simd: Vector extension for InCore code: "neon" (default), "sve"
+                  (compile with -march=armv8-a+sve) or "scalar"
+            fuse_rows: With enable_fusion, also fuse row reductions and row
+                       broadcasts with their element-wise neighbours
+            binary_expansion: Lowering of binary-expanded orchestration loops,
+                              "cascade", "dispatch" or "auto" (see
+                              apply_binary_expansion)
+            code_budget: Lines one binary-expanded loop may take
+        """
+        arm64_simd_target(simd)  # validate early
+        if binary_expansion not in BINARY_EXPANSION_MODES:
+            raise ValueError(f"Unknown binary expansion mode: {binary_expansion}")
         self.enable_fusion = enable_fusion
         self.analyze_buffers = analyze_buffers
         self.module = module
+        self.simd = simd
+        self.fuse_rows = fuse_rows
+        self.binary_expansion = binary_expansion
+        self.code_budget = code_budget
     
     def generate(self, program: PTOProgram) -> str:
         """Generate ARM64 code from a PTO program."""
@@ -594,11 +1511,15 @@ class ARM64CodeGenerator:
         ]
         
         # Add buffer analysis for InCore functions
+        analyzer = None
         if is_in_core and self.analyze_buffers:
-            analyzer = TileBufferAnalyzer(program)
+            analyzer = TileBufferAnalyzer(program, fuse_rows=self.enable_fusion and self.fuse_rows)
             analyzer.analyze()
-            report = analyzer.generate_report()
+            budgets = {arena: ARM64_TILE_ARENA_BUDGET for arena in analyzer.arenas}
+            report = analyzer.generate_report(budgets)
             lines.append(report)
+            for message in analyzer.over_budget(budgets):
+                warnings.warn(message)
             
             if self.module is not None:
                 self.module.set_buffer_analysis(program.name, analyzer.analysis_result)
@@ -612,7 +1533,8 @@ class ARM64CodeGenerator:
             lines.append('#include <time.h>    // For benchmark timing')
             lines.append('')
         
-        lines.append(arm64_generate_header())
+        lines.append(arm64_generate_header(self.simd))
+        helpers_index = len(lines)
         
         # Collect memory references for function parameters
         memref_params = []
@@ -649,10 +1571,30 @@ class ARM64CodeGenerator:
         else:
             lines.append(f"void {program.name}(void) {{")
         
-        # Declare tiles as local variables
+        if self.enable_fusion:
+            optimizer = LoopFusionOptimizer(tile_info, fuse_rows=self.fuse_rows)
+            fused_result = optimizer.optimize(mock_instructions)
+            accesses = [[name for name in [instr.dst, *instr.operands]
+                         if isinstance(name, str) and name in tile_info]
+                        for instr in mock_instructions]
+            register_tiles = optimizer.register_tiles(fused_result, accesses)
+        else:
+            register_tiles = set()
+        
+        # Declare tiles as local variables, aliased into the tile arenas
+        # when the buffer analysis placed them; row loops keep register
+        # tiles in registers only
+        arena_tiles = analyzer.tile_info if analyzer else {}
+        if arena_tiles:
+            lines.extend(arm64_tile_arena_declarations(analyzer.arenas))
         for name, info in tile_info.items():
             c_type = ARM64_TYPE_MAP.get(info.dtype, "float")
-            lines.append(f"    {c_type} {name}[{info.rows}][{info.cols}];")
+            if name in register_tiles:
+                continue
+            if name in arena_tiles:
+                lines.append(arm64_tile_view(name, c_type, info.cols, arena_tiles[name]))
+            else:
+                lines.append(f"    {c_type} {name}[{info.rows}][{info.cols}];")
         lines.append("")
         
         # Declare intermediate buffers for Mode B dynamic allocation (orchestration only)
@@ -670,11 +1612,13 @@ class ARM64CodeGenerator:
             lines.append("")
         
         if self.enable_fusion:
-            optimizer = LoopFusionOptimizer(tile_info)
-            fused_result = optimizer.optimize(mock_instructions)
-            lines.append(f"    // Loop fusion: {optimizer.stats['fusion_savings']} loop overheads saved\n")
+            summary = f"{optimizer.stats['fusion_savings']} loop overheads saved"
+            if optimizer.stats['row_loops']:
+                summary += (f" ({optimizer.stats['row_loops']} row loops, "
+                            f"{optimizer.stats['row_sweeps']} column sweeps per row)")
+            lines.append(f"    // Loop fusion: {summary}\n")
             
-            fused_codegen = ARM64FusedCodeGenerator()
+            fused_codegen = ARM64FusedCodeGenerator(self.simd, tile_info)
             indent_level = 1
             
             for item in fused_result:
@@ -685,6 +1629,10 @@ class ARM64CodeGenerator:
                     for fused_line in fused_lines:
                         lines.append(f"{indent}{fused_line}" if fused_line else "")
                     lines.append("")
+                elif isinstance(item, FusedRowLoop):
+                    for fused_line in fused_codegen.generate_row_loop(item):
+                        lines.append(f"{indent}{fused_line}" if fused_line else "")
+                    lines.append("")
                 elif isinstance(item, FusionBarrier):
                     instr = item.raw_instr
                     # For TSTORE, get dimensions from source tile (operands[0]), not destination memref (dst)
@@ -707,14 +1655,20 @@ class ARM64CodeGenerator:
                     elif instr.opcode == "ELSE":
                         indent = "    " * max(1, indent_level - 1)
                     
-                    barrier_lines = gen_arm64_barrier_op(instr, rows, cols, dtype, tile_info, orch_ctx, program.scalar_declarations)
+                    barrier_lines = gen_arm64_barrier_op(instr, rows, cols, dtype, tile_info, orch_ctx,
+                                                         program.scalar_declarations, simd=self.simd)
                     for barrier_line in barrier_lines:
                         lines.append(f"{indent}{barrier_line}" if barrier_line else "")
                     
-                    if instr.opcode in ("FOR", "IF", "ELSE"):
+                    if instr.opcode in ("FOR", "IF"):
                         indent_level += 1
                     
                     lines.append("")
+            
+            # Vector math helpers go between the includes and the function
+            if fused_codegen.target is not None:
+                lines[helpers_index:helpers_index] = arm64_simd_helpers(
+                    fused_codegen.target, fused_codegen.helpers_used)
         
         if not is_in_core:
             lines.append("    __pto_orch_epilogue:;")
@@ -725,7 +1679,7 @@ class ARM64CodeGenerator:
         code = "\n".join(lines)
         
         # Apply binary expansion if needed
-        code = apply_binary_expansion(code)
+        code = apply_binary_expansion(code, self.binary_expansion, self.code_budget)
         
         # Note: Loop replay optimization has been archived due to conflicts
         # with the sliding window task management scheme.
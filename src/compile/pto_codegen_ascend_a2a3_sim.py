@@ -21,7 +21,8 @@ but executes them through the core simulator for cycle-accurate timing.
 
 import os
 import sys
-from typing import Dict, List, Optional, Any, Tuple
+import warnings
+from typing import Any, Callable, Dict, List, Optional, Set, Tuple
 from dataclasses import dataclass
 
 # Add parent directories to path
@@ -33,12 +34,13 @@ if _src_dir not in sys.path:
 from compile.pto_compile_common import (
     PTOProgram, PTOModule,
     MockInstruction, MockTileInfo, convert_program_to_mock_instructions,
-    TileBufferAnalyzer,
+    TileBufferAnalyzer, assign_arena_offsets,
 )
 from isa_definition.pto_isa_definition import (
     ElementType, MemorySpace,
     ARM64_TYPE_MAP,  # Reuse for C types
     ASCEND_TYPE_MAP,
+    ASCEND_A2A3_BUFFER_SIZE,
     ascend_generate_header,
 )
 
@@ -49,6 +51,9 @@ from compile.pto_codegen_ascend import (
     gen_ascend_single_op,
     AscendFusedCodeGenerator,
 )
+from compile.pto_schedule import (
+    ScheduleResult, expand_trace, isa_pipe, schedule_incore, serialize_incore, simulate_pipes,
+)
 
 # =============================================================================
 # Cycle Cost Model for Ascend A2/A3
@@ -230,8 +235,8 @@ def generate_sim_header(target_mode: str = "sim") -> str:
 #define A2A3_TARGET_SIMULATOR
 
 // Include PTO runtime with simulation support
+// (linked as libpto_runtime built with -DPTO_PLATFORM_A2A3 -DA2A3_TARGET_SIMULATOR)
 #include "pto_runtime.h"
-#include "pto_runtime.c"
 
 // Include A2A3 Core Simulator (for cycle-accurate simulation)
 // Note: The core simulator is linked separately as liba2a3_core.a
@@ -543,8 +548,35 @@ class PTOISAIncoreGenerator:
     - PTO ISA instructions: TLOAD, TSTORE, TADD, TMUL, TMATMUL, etc.
     """
     
-    def __init__(self, module: Optional[PTOModule] = None):
+    # On-chip buffer holding each TileType
+    TILE_MEMORY = {"Vec": "UB", "Mat": "L1", "Left": "L0A", "Right": "L0B", "Acc": "L0C"}
+    
+    def __init__(self, module: Optional[PTOModule] = None, analyze_buffers: bool = True,
+                 schedule: bool = True):
+        """
+        Args:
+            module: PTO module containing all functions
+            analyze_buffers: Place tiles in UB/L1/L0 from their live ranges
+                             (TASSIGN); otherwise leave addressing to the toolchain
+            schedule: Reorder instructions across pipes and synchronize them
+                      with set_flag/wait_flag (see pto_schedule.py)
+        """
         self.module = module
+        self.analyze_buffers = analyze_buffers
+        self.schedule = schedule
+        self.schedule_results: Dict[str, ScheduleResult] = {}
+        self._simulation_inputs: Dict[str, Tuple[List[MockInstruction], bool, Callable]] = {}
+        self._tile_origins: Dict[str, str] = {}
+    
+    def simulate(self, program: PTOProgram, scalars: Dict[str, float]) -> int:
+        """
+        Simulated cycles of one call on the pipe model (pto_schedule), with
+        loops unrolled for the given scalar arguments. Without scheduling
+        the code runs in program order with a barrier per cross-pipe dependency.
+        """
+        self.generate(program)
+        instructions, is_cube, cost = self._simulation_inputs[program.name]
+        return simulate_pipes(expand_trace(instructions, scalars), is_cube, cost)
     
     def generate(self, program: PTOProgram) -> str:
         """Generate InCore function using PTO ISA APIs."""
@@ -563,6 +595,31 @@ class PTOISAIncoreGenerator:
         lines.append(f"// =============================================================================")
         lines.append("")
         
+        # Fused kernels (pto_kernel_fusion) rename tiles; roles follow the callee's names
+        self._tile_origins = program.metadata.get("tile_origins", {})
+        
+        # Place tiles in the on-chip buffers
+        placement = {}
+        if self.analyze_buffers:
+            placement = self._place_tiles(program, is_cube, lines)
+        
+        # Loads of Left/Right tiles go through their Mat staging tile
+        staged = {name for name in tile_info if self._tile_type(name, is_cube)[1]}
+        mock_instructions = self._stage_loads(mock_instructions, staged)
+        
+        shapes = dict(tile_info, **{f"{name}_mat": tile_info[name] for name in staged})
+        cost = self._cycle_cost(shapes)
+        if self.schedule:
+            result = schedule_incore(mock_instructions, is_cube, cost, self._aliases(placement))
+            mock_instructions = result.instructions
+            self.schedule_results[program.name] = result
+            self._simulation_inputs[program.name] = (mock_instructions, is_cube, cost)
+            lines.append(f"// {result.format()}")
+            lines.append("")
+        else:
+            self._simulation_inputs[program.name] = (
+                serialize_incore(mock_instructions, is_cube, self._aliases(placement)), is_cube, cost)
+        
         # Define CCE attributes if not already defined
         # This ensures compatibility with CCE compiler by providing proper [aicore] expansion
         lines.append("#ifndef __gm__")
@@ -601,6 +658,10 @@ class PTOISAIncoreGenerator:
         for decl in tile_decls:
             lines.append(f"    {decl}")
         lines.append("")
+        if placement:
+            for name, (memory, offset, size) in placement.items():
+                lines.append(f"    TASSIGN({name}, 0x{offset:x});  // {memory} [{offset}, {offset + size})")
+            lines.append("")
         
         # Generate GlobalTensor wrappers for memory references
         global_tensors = self._generate_global_tensors(program, tile_info)
@@ -646,31 +707,119 @@ class PTOISAIncoreGenerator:
             rows = info.rows
             cols = info.cols
             
-            # Determine TileType based on function type and tile usage
-            if is_cube:
-                # For matmul: A->Left, B->Right, C->Acc
-                # Need Mat tiles for TLOAD/TSTORE and Left/Right/Acc for matmul
-                name_lower = name.lower()
-                if 'a' == name_lower or 'left' in name_lower:
-                    # A matrix: Mat tile for loading, Left tile for matmul
-                    decls.append(f"Tile<TileType::Mat, {dtype}, {rows}, {cols}> {name}_mat;")
-                    decls.append(f"Tile<TileType::Left, {dtype}, {rows}, {cols}> {name};")
-                elif 'b' == name_lower or 'right' in name_lower:
-                    # B matrix: Mat tile for loading, Right tile for matmul
-                    decls.append(f"Tile<TileType::Mat, {dtype}, {rows}, {cols}> {name}_mat;")
-                    decls.append(f"Tile<TileType::Right, {dtype}, {rows}, {cols}> {name};")
-                elif 'c' == name_lower or 'acc' in name_lower or 'out' in name_lower:
-                    # C matrix: Acc tile for matmul, TSTORE directly supports Acc->GM
-                    decls.append(f"Tile<TileType::Acc, {dtype}, {rows}, {cols}> {name};")
-                else:
-                    # Other tiles use Vec
-                    decls.append(f"Tile<TileType::Vec, {dtype}, {rows}, {cols}> {name};")
-            else:
-                # Vector functions use TileType::Vec
-                decls.append(f"Tile<TileType::Vec, {dtype}, {rows}, {cols}> {name};")
+            tile_type, staged = self._tile_type(name, is_cube)
+            if staged:
+                decls.append(f"Tile<TileType::Mat, {dtype}, {rows}, {cols}> {name}_mat;")
+            decls.append(f"Tile<TileType::{tile_type}, {dtype}, {rows}, {cols}> {name};")
         
         return decls
     
+    def _tile_type(self, name: str, is_cube: bool) -> Tuple[str, bool]:
+        """
+        TileType of a tile, and whether TLOAD stages it through a `<name>_mat` Mat tile.
+        
+        Vector functions use Vec tiles only. For matmul: A->Left, B->Right
+        (both loaded through Mat), C->Acc (TSTORE supports Acc->GM directly).
+        """
+        if not is_cube:
+            return "Vec", False
+        name_lower = self._tile_origins.get(name, name).lower()
+        if 'a' == name_lower or 'left' in name_lower:
+            return "Left", True
+        if 'b' == name_lower or 'right' in name_lower:
+            return "Right", True
+        if 'c' == name_lower or 'acc' in name_lower or 'out' in name_lower:
+            return "Acc", False
+        return "Vec", False
+    
+    def _place_tiles(self, program: PTOProgram, is_cube: bool,
+                     lines: List[str]) -> Dict[str, Tuple[str, int, int]]:
+        """
+        Assign every tile an address in its on-chip buffer.
+        
+        Tiles whose live ranges do not intersect share addresses (see
+        TileBufferAnalyzer). A `_mat` staging tile lives in L1 for the
+        live range of the tile it feeds. Appends the analysis report to
+        lines and warns when a buffer overflows.
+        
+        Returns:
+            tile name -> (buffer, byte offset, size)
+        """
+        tile_types = {name: self._tile_type(name, is_cube) for name in program.tile_declarations}
+        analyzer = TileBufferAnalyzer(
+            program, arena_key=lambda t: self.TILE_MEMORY[tile_types[t.name][0]])
+        analyzer.analyze()
+        
+        staged = [t for t in analyzer.tile_info.values() if tile_types[t.name][1]]
+        mat_offsets, mat_size = assign_arena_offsets(
+            [(f"{t.name}_mat", t.total_bytes, t.live_start, t.live_end) for t in staged],
+            TileBufferAnalyzer.ARENA_ALIGNMENT)
+        usage = dict(analyzer.arenas)
+        usage["L1"] = usage.get("L1", 0) + mat_size
+        if "L1" in analyzer.arenas:
+            # Mat tiles of the program go after the staging tiles
+            for t in analyzer.tile_info.values():
+                if t.arena == "L1":
+                    t.arena_offset += mat_size
+        
+        lines.append(analyzer.generate_report(ASCEND_A2A3_BUFFER_SIZE))
+        if staged:
+            lines.append(f"// L1 staging (_mat tiles): {mat_size:,} bytes")
+            lines.append("")
+        for memory, size in usage.items():
+            if size > ASCEND_A2A3_BUFFER_SIZE.get(memory, size):
+                lines.append(f"// WARNING: {memory} needs {size:,} bytes, "
+                             f"capacity is {ASCEND_A2A3_BUFFER_SIZE[memory]:,}")
+                warnings.warn(f"{program.name}: {memory} needs {size:,} bytes, "
+                              f"capacity is {ASCEND_A2A3_BUFFER_SIZE[memory]:,}")
+        
+        placement = {}
+        for t in analyzer.tile_info.values():
+            if t.name in program.memref_declarations:
+                continue
+            if tile_types[t.name][1]:
+                placement[f"{t.name}_mat"] = ("L1", mat_offsets[f"{t.name}_mat"], t.total_bytes)
+            placement[t.name] = (t.arena, t.arena_offset, t.total_bytes)
+        return placement
+    
+    @staticmethod
+    def _stage_loads(instructions: List[MockInstruction],
+                     staged: Set[str]) -> List[MockInstruction]:
+        """Split each TLOAD of a staged tile into TLOAD to `<name>_mat` and TMOV."""
+        out = []
+        for instr in instructions:
+            if instr.opcode == "TLOAD" and instr.dst in staged:
+                mat = f"{instr.dst}_mat"
+                out.append(MockInstruction(opcode="TLOAD", dst=mat, operands=instr.operands))
+                out.append(MockInstruction(opcode="TMOV", dst=instr.dst, operands=[mat]))
+            else:
+                out.append(instr)
+        return out
+    
+    @staticmethod
+    def _aliases(placement: Dict[str, Tuple[str, int, int]]) -> Dict[str, Set[str]]:
+        """Tiles that share bytes with each tile, so the scheduler keeps their accesses ordered."""
+        aliases: Dict[str, Set[str]] = {}
+        entries = list(placement.items())
+        for i, (a, (mem_a, off_a, size_a)) in enumerate(entries):
+            for b, (mem_b, off_b, size_b) in entries[i + 1:]:
+                if mem_a == mem_b and off_a < off_b + size_b and off_b < off_a + size_a:
+                    aliases.setdefault(a, set()).add(b)
+                    aliases.setdefault(b, set()).add(a)
+        return aliases
+    
+    @staticmethod
+    def _cycle_cost(tile_info: Dict[str, MockTileInfo]):
+        """Cycles an instruction occupies its pipe, scaled by the tile it writes or stores."""
+        def cost(instr: MockInstruction) -> int:
+            if not instr.opcode.startswith("T"):
+                return ASCEND_A2A3_CYCLE_COSTS.get(instr.opcode, 1)
+            info = tile_info.get(instr.operands[0] if instr.opcode == "TSTORE" else instr.dst)
+            if info is None:
+                return get_cycle_cost(instr.opcode)
+            return get_cycle_cost(instr.opcode, info.rows, info.cols)
+        return cost
+    
     def _generate_global_tensors(self, program: PTOProgram,
                                   tile_info: Dict[str, MockTileInfo]) -> List[str]:
         """Generate GlobalTensor wrappers for memory references."""
@@ -691,6 +840,11 @@ class PTOISAIncoreGenerator:
         
         return tensors
     
+    def _param_scalars(self, program: PTOProgram) -> List[Tuple[str, ElementType]]:
+        """Scalars passed in by the caller (conditions and indices are computed inside)."""
+        return [(name, scalar_type) for name, scalar_type in program.scalar_declarations.items()
+                if scalar_type not in (ElementType.U1, ElementType.INDEX)]
+    
     def _generate_params(self, program: PTOProgram) -> str:
         """Generate function parameters."""
         params = []
@@ -699,7 +853,7 @@ class PTOISAIncoreGenerator:
             dtype = ARM64_TYPE_MAP.get(memref_type.element_type.value, "float")
             params.append(f"__gm__ {dtype}* {name}")
         
-        for name, scalar_type in program.scalar_declarations.items():
+        for name, scalar_type in self._param_scalars(program):
             dtype = ARM64_TYPE_MAP.get(scalar_type.value, "int32_t")
             params.append(f"{dtype} {name}")
         
@@ -715,7 +869,7 @@ class PTOISAIncoreGenerator:
             args.append(f"({dtype}*)args[{idx}]")
             idx += 1
         
-        for name, scalar_type in program.scalar_declarations.items():
+        for name, scalar_type in self._param_scalars(program):
             dtype = ARM64_TYPE_MAP.get(scalar_type.value, "int32_t")
             args.append(f"*({dtype}*)args[{idx}]")
             idx += 1
@@ -749,9 +903,21 @@ class PTOISAIncoreGenerator:
         elif op == "RETURN":
             lines.append("return;")
             
+        # Pipe synchronization (from the instruction scheduler)
+        elif op in ("SET_FLAG", "WAIT_FLAG"):
+            is_cube = getattr(self, '_current_is_cube', False)
+            src_pipe, dst_pipe, event = operands
+            lines.append(f"{op.lower()}({isa_pipe(src_pipe, is_cube)}, "
+                         f"{isa_pipe(dst_pipe, is_cube)}, EVENT_ID{event});")
+        elif op == "PIPE_BARRIER":
+            lines.append("pipe_barrier(PIPE_ALL);")
+            
         # Scalar operations
         elif op == "SLI":
             lines.append(f"int {dst} = {operands[0]};")
+        elif op == "SCMP":
+            cmp_ops = {"eq": "==", "ne": "!=", "gt": ">", "ge": ">=", "lt": "<", "le": "<="}
+            lines.append(f"int {dst} = ({operands[0]} {cmp_ops.get(operands[2], '>')} {operands[1]}) ? 1 : 0;")
         elif op in ("SADD", "SSUB", "SMUL", "SDIV"):
             op_map = {"SADD": "+", "SSUB": "-", "SMUL": "*", "SDIV": "/"}
             lines.append(f"int {dst} = {operands[0]} {op_map[op]} {operands[1]};")
@@ -761,23 +927,17 @@ class PTOISAIncoreGenerator:
         # Memory operations
         elif op == "TLOAD":
             src_mem = operands[0]
-            # For cube functions, load into _mat tile first
-            is_cube = getattr(self, '_current_is_cube', False)
-            dst_lower = dst.lower()
-            if is_cube and (dst_lower in ('a', 'b') or 'left' in dst_lower or 'right' in dst_lower):
-                # Load to Mat tile, then move to Left/Right
-                lines.append(f"// TLOAD: {dst}_mat = load({src_mem})")
-                lines.append(f"TLOAD({dst}_mat, g_{src_mem});")
-                lines.append(f"// TMOV: {dst}_mat -> {dst} (Mat -> Left/Right)")
-                lines.append(f"TMOV({dst}, {dst}_mat);")
-            else:
-                lines.append(f"// TLOAD: {dst} = load({src_mem})")
-                lines.append(f"TLOAD({dst}, g_{src_mem});")
+            lines.append(f"// TLOAD: {dst} = load({src_mem})")
+            lines.append(f"TLOAD({dst}, g_{src_mem});")
         elif op == "TSTORE":
             src = operands[0]
             # TSTORE supports Vec/Mat/Acc tiles directly to global memory
             lines.append(f"// TSTORE: store({src}) -> {dst}")
             lines.append(f"TSTORE(g_{dst}, {src});")
+        elif op == "TMOV":
+            # Tile move, also Mat -> Left/Right after a staged TLOAD
+            lines.append(f"// TMOV: {operands[0]} -> {dst}")
+            lines.append(f"TMOV({dst}, {operands[0]});")
         elif op == "TCOPY":
             lines.append(f"// TCOPY: {dst} = {operands[0]}")
             lines.append(f"TCOPY({dst}, {operands[0]});")
@@ -871,7 +1031,8 @@ class AscendA2A3SimCodeGenerator:
     """
     
     def __init__(self, enable_fusion: bool = True, analyze_buffers: bool = True,
-                 module: Optional[PTOModule] = None, target_mode: str = "sim"):
+                 module: Optional[PTOModule] = None, target_mode: str = "sim",
+                 schedule: bool = True):
         """
         Initialize the code generator.
         
@@ -880,12 +1041,13 @@ class AscendA2A3SimCodeGenerator:
             analyze_buffers: Analyze buffer usage
             module: PTO module containing all functions
             target_mode: "sim" for simulator, "hardware" for real A2A3 hardware
+            schedule: Schedule InCore instructions across pipes
         """
         self.enable_fusion = enable_fusion
         self.analyze_buffers = analyze_buffers
         self.module = module
         self.target_mode = target_mode
-        self.incore_gen = PTOISAIncoreGenerator(module)
+        self.incore_gen = PTOISAIncoreGenerator(module, analyze_buffers, schedule)
     
     def generate(self, program: PTOProgram) -> str:
         """Generate code for a program."""
@@ -0,0 +1,492 @@
+"""
+PTO Compiler - CPU Code Generation (pto::Tile templates)
+
+This module lowers InCore functions to C++ built on the tile templates in
+include/pto/cpu/, the same implementations the ptoas CPU simulator runs:
+- Every tile becomes a pto::Tile with compile-time rows and columns
+  (columns padded to 32 bytes, the valid shape keeps the PTO shape)
+- TLOAD/TSTORE go through GlobalTensor views of the memrefs
+- Tile instructions call the *_IMPL templates directly; TMATMUL stages its
+  operands through Left/Right/Acc tiles with TMOV
+- Instructions without a CPU template fall back to an element loop with
+  the ARM64 backend's scalar expressions
+- Control flow and scalar instructions are emitted as in the ARM64 backend
+
+Each InCore function yields a typed `<name>_impl(...)` and an
+`extern "C" void <name>(int64_t* args)` entry for the ref_runtime CPU
+runner, which compiles `<name>.cpp` and loads the symbol named after the
+file. Orchestration functions only build the task graph and are emitted
+by the ARM64 generator (scalar target).
+
+Dependencies:
+- pto_compile_common: Common infrastructure
+- pto_codegen_arm64: control flow, scalar instructions, element expressions
+"""
+
+from typing import Dict, List, Optional, Tuple
+import os
+import sys
+
+# Add parent directories to path for imports
+_current_dir = os.path.dirname(os.path.abspath(__file__))
+_src_dir = os.path.dirname(_current_dir)
+if _src_dir not in sys.path:
+    sys.path.insert(0, _src_dir)
+
+from isa_definition.pto_isa_definition import ElementType
+
+from compile.pto_compile_common import (
+    PTOProgram, PTOModule, MockTileInfo, MockInstruction,
+    TileBufferAnalyzer, convert_program_to_mock_instructions,
+)
+
+from compile.pto_codegen_arm64 import (
+    ARM64CodeGenerator, ARM64FusedCodeGenerator, gen_arm64_barrier_op,
+)
+
+
+# =============================================================================
+# CPU Types and Templates
+# =============================================================================
+
+# C++ element types under __CPU_SIM (half comes from pto/common/type.hpp)
+CPU_TYPE_MAP = {
+    "f32": "float",
+    "f16": "half",
+    "f64": "double",
+    "i8": "int8_t",
+    "i16": "int16_t",
+    "i32": "int32_t",
+    "i64": "int64_t",
+    "u8": "uint8_t",
+    "u16": "uint16_t",
+    "u32": "uint32_t",
+    "u64": "uint64_t",
+}
+
+CPU_TYPE_BYTES = {
+    "f32": 4, "f16": 2, "f64": 8,
+    "i8": 1, "i16": 2, "i32": 4, "i64": 8,
+    "u8": 1, "u16": 2, "u32": 4, "u64": 8,
+}
+
+# Unsigned integer of the same width, for passing floats as bit patterns
+CPU_FLOAT_BITS = {"float": "uint32_t", "double": "uint64_t", "half": "uint16_t"}
+
+# Row-major Vec tiles need rows of a multiple of 32 bytes
+CPU_TILE_ROW_ALIGN_BYTES = 32
+
+# Left/Right/Acc tiles are stored in 16-row/16-column fractal boxes
+CPU_CUBE_ALIGN = 16
+
+# Template -> header under include/pto/cpu
+CPU_IMPL_HEADERS = {
+    "TLOAD_IMPL": "TLoad", "TSTORE_IMPL": "TStore", "TMOV_IMPL": "TMov",
+    "TADD_IMPL": "TAdd", "TSUB_IMPL": "TSub", "TMUL_IMPL": "TMul",
+    "TDIV_IMPL": "TDiv", "TMAX_IMPL": "TMax",
+    "TABS_IMPL": "TAbs", "TEXP_IMPL": "TExp", "TSQRT_IMPL": "TSqrt", "TRSQRT_IMPL": "TRSqrt",
+    "TADDS_IMPL": "TBinSOps", "TMULS_IMPL": "TBinSOps", "TDIVS_IMPL": "TBinSOps",
+    "TEXPANDS_IMPL": "TExpands",
+    "TROWSUM_IMPL": "TRowSum", "TROWMAX_IMPL": "TRowMax", "TCOLSUM_IMPL": "TColSum",
+    "TROWEXPAND_IMPL": "TRowExpand", "TROWEXPANDSUB_IMPL": "TRowExpand",
+    "TROWEXPANDDIV_IMPL": "TRowExpand", "TROWEXPANDMUL_IMPL": "TRowExpand",
+    "TMATMUL_IMPL": "TMatmul", "TTRANS_IMPL": "TTrans",
+}
+
+# Element-wise instructions with a template of the same name
+CPU_BINARY_IMPLS = {"TADD", "TSUB", "TMUL", "TDIV", "TMAX"}
+CPU_UNARY_IMPLS = {"TABS", "TEXP", "TSQRT", "TRSQRT"}
+CPU_ROW_BROADCAST_IMPLS = {"TROWEXPANDSUB", "TROWEXPANDDIV", "TROWEXPANDMUL"}
+
+# Instructions lowered exactly as in the ARM64 backend
+CPU_PASSTHROUGH_OPS = {
+    "FOR", "ENDFOR", "IF", "IF_BIT", "ELSE", "ENDIF",
+    "SLI", "SCMP", "SADD", "SSUB", "SMUL", "SDIV", "SMOV",
+    "CALL", "RETURN",
+}
+
+
+def cpu_padded_cols(dtype: str, cols: int) -> int:
+    """Columns of the tile storage: cols rounded up to whole 32-byte rows."""
+    align = max(1, CPU_TILE_ROW_ALIGN_BYTES // CPU_TYPE_BYTES.get(dtype, 4))
+    return (cols + align - 1) // align * align
+
+
+def cpu_tile_type_name(dtype: str, rows: int, cols: int) -> str:
+    return f"Tile_{dtype}_{rows}x{cols}"
+
+
+def cpu_tile_type(dtype: str, rows: int, cols: int) -> str:
+    """pto::Tile type of a rows x cols Vec tile."""
+    c_type = CPU_TYPE_MAP.get(dtype, "float")
+    padded = cpu_padded_cols(dtype, cols)
+    if padded == cols:
+        return f"Tile<TileType::Vec, {c_type}, {rows}, {cols}>"
+    return f"Tile<TileType::Vec, {c_type}, {rows}, {padded}, BLayout::RowMajor, {rows}, {cols}>"
+
+
+def cpu_generate_header(headers: List[str]) -> str:
+    """Includes for the given include/pto/cpu headers."""
+    includes = "".join(f'#include "pto/cpu/{h}.hpp"\n' for h in headers)
+    return f"""// Auto-generated C++ code from PTO ISA Compiler (include/pto/cpu templates)
+#ifndef __CPU_SIM
+#define __CPU_SIM
+#endif
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <pto/common/cpu_stub.hpp>
+#include <pto/common/pto_tile.hpp>
+{includes}
+using namespace pto;
+
+// Row-major view of rows x cols elements, row_stride elements apart
+template <typename T, int Rows, int Cols, int RowStride>
+using GlobalTile = GlobalTensor<T, Shape<1, 1, 1, Rows, Cols>, Stride<1, 1, 1, RowStride, 1>>;
+"""
+
+
+def _round_up(n: int, align: int) -> int:
+    return (n + align - 1) // align * align
+
+
+# =============================================================================
+# CPU Code Generator
+# =============================================================================
+
+class CPUCodeGenerator:
+    """
+    Generates C++ on the include/pto/cpu tile templates from PTO programs.
+
+    The templates implement one instruction each, so there is no loop
+    fusion; the per-instruction kernels are what the CPU simulator is
+    tuned for.
+    """
+
+    def __init__(self, analyze_buffers: bool = True, module: Optional['PTOModule'] = None):
+        self.analyze_buffers = analyze_buffers
+        self.module = module
+        self.stats = {"template_ops": 0, "fallback_ops": 0}
+
+    def generate(self, program: PTOProgram) -> str:
+        """Generate C++ code from a PTO program."""
+        if not getattr(program, 'is_in_core', True):
+            # Task graph construction does not touch tiles
+            gen = ARM64CodeGenerator(analyze_buffers=self.analyze_buffers,
+                                     module=self.module, simd="scalar")
+            return gen.generate(program)
+
+        tile_info, mock_instructions = convert_program_to_mock_instructions(program)
+        self.tile_info = tile_info
+        self.program = program
+        self.headers: List[str] = []
+        self.tile_types: Dict[Tuple[str, int, int], str] = {}
+        self.scalar_gen = ARM64FusedCodeGenerator(None, tile_info)
+
+        lines = [
+            f"// PTO Program: {program.name}",
+            "// Function Type: InCore (tile-level computation)",
+            "// Target: CPU (pto::Tile + include/pto/cpu templates)",
+        ]
+
+        if self.analyze_buffers:
+            analyzer = TileBufferAnalyzer(program, fuse_rows=False)
+            analyzer.analyze()
+            lines.append(analyzer.generate_report(arenas=False))  # tiles are pto::Tile objects
+            if self.module is not None:
+                self.module.set_buffer_analysis(program.name, analyzer.analysis_result)
+
+        # Memrefs first, then scalars not initialized by SLI (ARM64 order)
+        sli_initialized_scalars = {instr.dst for instr in mock_instructions if instr.opcode == "SLI"}
+        memref_params = []
+        for name, memref_type in program.memref_declarations.items():
+            c_type = CPU_TYPE_MAP.get(memref_type.element_type.value, "float")
+            memref_params.append((f"__gm__ {c_type}*", name))
+        scalar_params = []
+        for name, scalar_type in program.scalar_declarations.items():
+            if scalar_type in (ElementType.U1, ElementType.INDEX):
+                continue
+            if name in sli_initialized_scalars:
+                continue
+            scalar_params.append((CPU_TYPE_MAP.get(scalar_type.value, "int"), name))
+        params = memref_params + scalar_params
+
+        # Body first: it decides which headers and tile types are needed
+        body = []
+        for name, info in tile_info.items():
+            body.append(f"    {self._tile_type(info.dtype, info.rows, info.cols)} {name};")
+        body.append("")
+
+        indent_level = 1
+        for instr in mock_instructions:
+            if instr.opcode in ("ENDFOR", "ENDIF"):
+                indent_level = max(1, indent_level - 1)
+                indent = "    " * indent_level
+            elif instr.opcode == "ELSE":
+                indent = "    " * max(1, indent_level - 1)
+            else:
+                indent = "    " * indent_level
+
+            for line in self._lower(instr):
+                body.append(f"{indent}{line}" if line else "")
+            body.append("")
+
+            if instr.opcode in ("FOR", "IF", "IF_BIT"):
+                indent_level += 1
+
+        lines.append(cpu_generate_header(self.headers))
+        for (dtype, rows, cols), alias in self.tile_types.items():
+            lines.append(f"using {alias} = {cpu_tile_type(dtype, rows, cols)};")
+        lines.append("")
+
+        signature = ", ".join(f"{ptype} {pname}" for ptype, pname in params)
+        lines.append(f"void {program.name}_impl({signature or 'void'}) {{")
+        lines.extend(body)
+        lines.append("}")
+        lines.append("")
+        lines.extend(self._generate_entry(program.name, params))
+
+        return "\n".join(lines)
+
+    # -------------------------------------------------------------------------
+    # Entry point
+    # -------------------------------------------------------------------------
+
+    def _generate_entry(self, name: str, params: List[Tuple[str, str]]) -> List[str]:
+        """extern "C" wrapper unpacking the ref_runtime int64_t argument array."""
+        lines = [
+            "/**",
+            f" * Runtime entry: args[i] holds parameter i of {name}_impl; pointers as",
+            " * addresses, integers by value, floats as their bit pattern.",
+            " */",
+            f'extern "C" __aicore__ void {name}(__gm__ int64_t* args)',
+            "{",
+        ]
+        call_args = []
+        for i, (ptype, pname) in enumerate(params):
+            if ptype.endswith("*"):
+                lines.append(f"    {ptype} {pname} = reinterpret_cast<{ptype}>(args[{i}]);")
+            elif ptype in CPU_FLOAT_BITS:
+                bits = CPU_FLOAT_BITS[ptype]
+                lines.append(f"    const {bits} {pname}_bits = static_cast<{bits}>(args[{i}]);")
+                lines.append(f"    {ptype} {pname};")
+                lines.append(f"    std::memcpy(&{pname}, &{pname}_bits, sizeof({pname}));")
+            else:
+                lines.append(f"    {ptype} {pname} = static_cast<{ptype}>(args[{i}]);")
+            call_args.append(pname)
+        if not params:
+            lines.append("    (void)args;")
+        lines.append(f"    {name}_impl({', '.join(call_args)});")
+        lines.append("}")
+        return lines
+
+    # -------------------------------------------------------------------------
+    # Instruction lowering
+    # -------------------------------------------------------------------------
+
+    def _use(self, impl: str) -> str:
+        header = CPU_IMPL_HEADERS[impl]
+        if header not in self.headers:
+            self.headers.append(header)
+        return impl
+
+    def _tile_type(self, dtype: str, rows: int, cols: int) -> str:
+        key = (dtype, rows, cols)
+        if key not in self.tile_types:
+            self.tile_types[key] = cpu_tile_type_name(dtype, rows, cols)
+        return self.tile_types[key]
+
+    def _info(self, name) -> Optional[MockTileInfo]:
+        return self.tile_info.get(name) if isinstance(name, str) else None
+
+    def _same_tile_type(self, *names) -> bool:
+        infos = [self._info(n) for n in names]
+        if any(info is None for info in infos):
+            return False
+        return len({(i.dtype, i.rows, i.cols) for i in infos}) == 1
+
+    def _lower(self, instr: MockInstruction) -> List[str]:
+        op = instr.opcode
+        dst = instr.dst
+        ops = instr.operands
+
+        if op in CPU_PASSTHROUGH_OPS:
+            info = self._info(dst)
+            return gen_arm64_barrier_op(instr, info.rows if info else 1, info.cols if info else 1,
+                                        info.dtype if info else "f32", self.tile_info,
+                                        scalar_declarations=self.program.scalar_declarations,
+                                        simd="scalar")
+
+        if op == "TLOAD":
+            return self._lower_load(dst, ops)
+        if op == "TSTORE":
+            return self._lower_store(dst, ops)
+        if op == "TMATMUL":
+            return self._lower_matmul(dst, ops[0], ops[1])
+
+        lines = self._template_call(op, dst, ops)
+        if lines is not None:
+            self.stats["template_ops"] += 1
+            return lines
+
+        # No template for this instruction or these operand types
+        if self._info(dst) is not None:
+            lines = self._element_loop(instr)
+            if lines is not None:
+                self.stats["fallback_ops"] += 1
+                return lines
+        return [f"// {op}: Not implemented"]
+
+    def _template_call(self, op: str, dst: str, ops: list) -> Optional[List[str]]:
+        """Single *_IMPL call for a tile instruction, None if none applies."""
+        if op in CPU_BINARY_IMPLS and self._same_tile_type(dst, ops[0], ops[1]):
+            return [f"{self._use(op + '_IMPL')}({dst}, {ops[0]}, {ops[1]});"]
+        if op in CPU_UNARY_IMPLS and self._same_tile_type(dst, ops[0]):
+            return [f"{self._use(op + '_IMPL')}({dst}, {ops[0]});"]
+        if op in ("TADDS", "TMULS", "TDIVS") and self._same_tile_type(dst, ops[0]):
+            return [f"{self._use(op + '_IMPL')}({dst}, {ops[0]}, {ops[1]});"]
+        if op == "TSUBS" and self._same_tile_type(dst, ops[0]):
+            return [f"{self._use('TADDS_IMPL')}({dst}, {ops[0]}, -({ops[1]}));"]
+        if op == "TNEG" and self._same_tile_type(dst, ops[0]):
+            return [f"{self._use('TMULS_IMPL')}({dst}, {ops[0]}, -1);"]
+        if op == "TRECIP" and self._same_tile_type(dst, ops[0]):
+            return [f"{self._use('TDIVS_IMPL')}({dst}, 1, {ops[0]});"]
+        if op == "TEXPANDS" and self._info(dst):
+            c_type = CPU_TYPE_MAP.get(self._info(dst).dtype, "float")
+            return [f"{{ {c_type} _s = {ops[0]}; {self._use('TEXPANDS_IMPL')}({dst}, _s); }}"]
+        if op in ("TROWSUM", "TROWMAX") and self._info(dst) and self._info(ops[0]):
+            return [f"{self._use(op + '_IMPL')}({dst}, {ops[0]}, {dst});  // tmp unused on CPU"]
+        if op == "TCOLSUM" and self._info(dst) and self._info(ops[0]):
+            return [f"{self._use('TCOLSUM_IMPL')}({dst}, {ops[0]});"]
+        if op == "TROWEXPAND" and self._info(dst) and self._info(ops[0]):
+            return [f"{self._use('TROWEXPAND_IMPL')}({dst}, {ops[0]});"]
+        if op in CPU_ROW_BROADCAST_IMPLS and self._same_tile_type(dst, ops[0]) and self._info(ops[1]):
+            return [f"{self._use(op + '_IMPL')}({dst}, {ops[0]}, {ops[1]});"]
+        if op == "TTRANS" and self._info(dst) and self._info(ops[0]):
+            return [f"{self._use('TTRANS_IMPL')}({dst}, {ops[0]}, {ops[0]});  // tmp unused on CPU"]
+        return None
+
+    def _lower_load(self, dst: str, ops: list) -> List[str]:
+        # Same addressing as the ARM64 backend: tile-sized row blocks with
+        # the tile's column count as row stride
+        info = self._info(dst)
+        src_mem = ops[0]
+        row_off = ops[1] if len(ops) > 1 else "0"
+        col_off = ops[2] if len(ops) > 2 else "0"
+        c_type = CPU_TYPE_MAP.get(info.dtype, "float")
+        base = self._offset(row_off, col_off, info.rows * info.cols)
+        return [
+            f"// TLOAD: {dst} = load({src_mem}[{row_off}, {col_off}])",
+            f"{{ GlobalTile<{c_type}, {info.rows}, {info.cols}, {info.cols}> _g({src_mem}{base}); "
+            f"{self._use('TLOAD_IMPL')}({dst}, _g); }}",
+        ]
+
+    def _lower_store(self, dst_mem: str, ops: list) -> List[str]:
+        info = self._info(ops[0])
+        src = ops[0]
+        row_off = ops[1] if len(ops) > 1 else "0"
+        col_off = ops[2] if len(ops) > 2 else "0"
+        c_type = CPU_TYPE_MAP.get(info.dtype, "float")
+        base = self._offset(row_off, col_off, info.rows * info.cols)
+        return [
+            f"// TSTORE: store({src}) -> {dst_mem}[{row_off}, {col_off}]",
+            f"{{ GlobalTile<{c_type}, {info.rows}, {info.cols}, {info.cols}> _g({dst_mem}{base}); "
+            f"{self._use('TSTORE_IMPL')}(_g, {src}); }}",
+        ]
+
+    @staticmethod
+    def _offset(row_off, col_off, row_block: int) -> str:
+        terms = []
+        if str(row_off) != "0":
+            terms.append(f"({row_off}) * {row_block}")
+        if str(col_off) != "0":
+            terms.append(f"({col_off})")
+        return "".join(f" + {t}" for t in terms)
+
+    def _lower_matmul(self, dst: str, a: str, b: str) -> List[str]:
+        d_info, a_info, b_info = self._info(dst), self._info(a), self._info(b)
+        supported = (d_info is not None and a_info is not None and b_info is not None
+                     and d_info.dtype == "f32" and a_info.dtype == b_info.dtype
+                     and a_info.dtype in ("f32", "f16")
+                     and a_info.cols == b_info.rows
+                     and (d_info.rows, d_info.cols) == (a_info.rows, b_info.cols))
+        if not supported:
+            self.stats["fallback_ops"] += 1
+            return self._matmul_loop(dst, a, b)
+        self.stats["template_ops"] += 1
+        m, k, n = a_info.rows, a_info.cols, b_info.cols
+        mp, kp, np_ = (_round_up(x, CPU_CUBE_ALIGN) for x in (m, k, n))
+        in_type = CPU_TYPE_MAP[a_info.dtype]
+        return [
+            f"// TMATMUL: {dst} = {a} @ {b}",
+            "{",
+            f"    TileLeft<{in_type}, {mp}, {kp}, {m}, {k}> _a;",
+            f"    TileRight<{in_type}, {kp}, {np_}, {k}, {n}> _b;",
+            f"    TileAcc<float, {mp}, {np_}, {m}, {n}> _c;",
+            f"    {self._use('TMOV_IMPL')}(_a, {a});",
+            f"    TMOV_IMPL(_b, {b});",
+            f"    {self._use('TMATMUL_IMPL')}(_c, _a, _b);",
+            f"    TMOV_IMPL({dst}, _c);",
+            "}",
+        ]
+
+    def _element(self, name: str) -> str:
+        info = self._info(name)
+        return f"{name}.data()[_row * {cpu_padded_cols(info.dtype, info.cols)} + _col]"
+
+    def _matmul_loop(self, dst: str, a: str, b: str) -> List[str]:
+        # Only dtypes the templates reject end up here; the shapes must agree
+        d_info, a_info, b_info = self._info(dst), self._info(a), self._info(b)
+        shapes = {name: (info.rows, info.cols) if info else None
+                  for name, info in ((dst, d_info), (a, a_info), (b, b_info))}
+        if (d_info is None or a_info is None or b_info is None
+                or a_info.cols != b_info.rows
+                or (d_info.rows, d_info.cols) != (a_info.rows, b_info.cols)):
+            raise ValueError(
+                f"{self.program.name}: TMATMUL {dst} = {a} @ {b} has mismatched tile shapes "
+                + ", ".join(f"{name} {shape}" for name, shape in shapes.items()))
+        c_type = CPU_TYPE_MAP.get(d_info.dtype, "float")
+        rows, cols, k = d_info.rows, d_info.cols, a_info.cols
+        a_cols = cpu_padded_cols(a_info.dtype, a_info.cols)
+        b_cols = cpu_padded_cols(b_info.dtype, b_info.cols)
+        return [
+            f"// TMATMUL: {dst} = {a} @ {b}",
+            f"for (int _row = 0; _row < {rows}; _row++) {{",
+            f"    for (int _col = 0; _col < {cols}; _col++) {{",
+            f"        {c_type} _sum = 0;",
+            f"        for (int _k = 0; _k < {k}; _k++) {{",
+            f"            _sum += {a}.data()[_row * {a_cols} + _k] * {b}.data()[_k * {b_cols} + _col];}}",
+            f"        {self._element(dst)} = _sum;}}}}",
+        ]
+
+    def _element_loop(self, instr: MockInstruction) -> Optional[List[str]]:
+        """Element loop for instructions without a template (ARM64 scalar expressions)."""
+        operands = self.scalar_gen._split_operands(instr)
+        if any(is_tile and self._info(name) is None for name, is_tile in operands):
+            return None
+        args = [self._element(name) if is_tile else name for name, is_tile in operands]
+        expr = self.scalar_gen._scalar_expr(instr, args)
+        if expr is None:
+            return None
+        info = self._info(instr.dst)
+        return [
+            f"// {instr.opcode}: no CPU template, element loop",
+            f"for (int _row = 0; _row < {info.rows}; _row++) {{",
+            f"    for (int _col = 0; _col < {info.cols}; _col++) {{",
+            f"        {self._element(instr.dst)} = {expr};",
+            "    }}",
+        ]
+
+
+# =============================================================================
+# Export
+# =============================================================================
+
+__all__ = [
+    'CPU_TYPE_MAP',
+    'CPU_IMPL_HEADERS',
+    'cpu_padded_cols',
+    'cpu_tile_type',
+    'cpu_generate_header',
+    'CPUCodeGenerator',
+]
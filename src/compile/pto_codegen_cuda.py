@@ -5,7 +5,7 @@ This module contains CUDA-specific code generation:
 - CUDA barrier operation code generation
 - CUDA single operation code generation
 - CUDA fused loop code generation
-- CUDA kernel generation
+- CUDA kernel generation (tiles aliased in shared-memory arenas)
 
 Dependencies:
 - pto_isa_definition: CUDA_TYPE_MAP, cuda_generate_header
@@ -15,6 +15,7 @@ Dependencies:
 from typing import Dict, List, Optional, Tuple
 import os
 import sys
+import warnings
 
 # Add parent directories to path for imports
 _current_dir = os.path.dirname(os.path.abspath(__file__))
@@ -22,7 +23,9 @@ _src_dir = os.path.dirname(_current_dir)
 if _src_dir not in sys.path:
     sys.path.insert(0, _src_dir)
 
-from isa_definition.pto_isa_definition import CUDA_TYPE_MAP, cuda_generate_header, ElementType
+from isa_definition.pto_isa_definition import (
+    CUDA_TYPE_MAP, CUDA_SHARED_MEMORY_BUDGET, cuda_generate_header, ElementType,
+)
 
 from compile.pto_compile_common import (
     PTOProgram, PTOModule, MockTileInfo, MockInstruction,
@@ -342,11 +345,19 @@ class CUDACodeGenerator:
         ]
         
         # Add buffer analysis for InCore functions
+        analyzer = None
         if is_in_core and self.analyze_buffers:
             analyzer = TileBufferAnalyzer(program)
             analyzer.analyze()
+            # All arenas share the block's static shared memory
+            total = sum(analyzer.arenas.values())
             report = analyzer.generate_report()
             lines.append(report)
+            if total > CUDA_SHARED_MEMORY_BUDGET:
+                message = (f"{program.name}: tile arenas need {total:,} bytes of shared memory, "
+                           f"budget is {CUDA_SHARED_MEMORY_BUDGET:,}")
+                lines.append(f"// WARNING: {message}")
+                warnings.warn(message)
         
         lines.append(cuda_generate_header())
         
@@ -386,11 +397,25 @@ class CUDACodeGenerator:
         lines.append("    int _col = blockIdx.x * blockDim.x + threadIdx.x;")
         lines.append("")
         
-        # Declare tiles as shared memory
+        # Declare tiles as shared memory, aliased into the tile arenas when
+        # the buffer analysis placed them
+        arena_tiles = analyzer.tile_info if analyzer else {}
+        for dtype, size in (analyzer.arenas.items() if arena_tiles else ()):
+            c_type = CUDA_TYPE_MAP.get(dtype, "float")
+            elem_size = TileBufferAnalyzer.ELEMENT_SIZES.get(dtype, 4)
+            lines.append(f"    __shared__ __align__(16) {c_type} _tile_arena_{dtype}[{max(size // elem_size, 1)}];")
         for name, info in tile_info.items():
             c_type = CUDA_TYPE_MAP.get(info.dtype, "float")
-            lines.append(f"    __shared__ {c_type} {name}[{info.rows}][{info.cols}];")
+            if name in arena_tiles:
+                buf = arena_tiles[name]
+                offset = buf.arena_offset // buf.element_size
+                lines.append(f"    {c_type} (*{name})[{info.cols}] = "
+                             f"({c_type} (*)[{info.cols}])(_tile_arena_{buf.arena} + {offset});")
+            else:
+                lines.append(f"    __shared__ {c_type} {name}[{info.rows}][{info.cols}];")
         lines.append("")
+        # Threads must be done with a tile before its storage is handed over
+        sync_positions = set(analyzer.reuse_positions()) if arena_tiles else set()
         
         if self.enable_fusion:
             optimizer = LoopFusionOptimizer(tile_info)
@@ -400,9 +425,12 @@ class CUDACodeGenerator:
             fused_codegen = CUDAFusedCodeGenerator()
             indent_level = 1
             
-            for item in fused_result:
+            for position, item in enumerate(fused_result):
                 indent = "    " * indent_level
                 
+                if position in sync_positions:
+                    lines.append(f"{indent}__syncthreads();  // tile storage reused")
+                
                 if isinstance(item, FusedLoop):
                     fused_lines = fused_codegen.generate_fused_loop(item)
                     for fused_line in fused_lines:
@@ -114,6 +114,18 @@ from compile.pto_codegen_ascend_a2a3_sim import (
     is_cube_op,
 )
 
+from compile.pto_codegen_cpu import (
+    CPUCodeGenerator,
+    CPU_TYPE_MAP,
+    cpu_generate_header,
+)
+
+from compile.pto_build import NativeBuilder, BuildError
+
+from compile.pto_double_buffer import DoubleBufferResult, double_buffer_loops
+
+from compile.pto_kernel_fusion import KernelFusionResult, fuse_incore_calls
+
 # =============================================================================
 # Import ISA Definitions (for backward compatibility)
 # =============================================================================
@@ -644,6 +656,13 @@ BACKENDS = {
         "header_func": lambda: "// Ascend A2/A3 Cycle Simulator\n",
         "type_map": ARM64_TYPE_MAP,
     },
+    "cpu": {
+        "name": "CPU (pto::Tile templates)",
+        "suffix": "_cpu",
+        "extension": ".cpp",
+        "header_func": lambda: cpu_generate_header([]),
+        "type_map": CPU_TYPE_MAP,
+    },
 }
 
 
@@ -764,19 +783,50 @@ class MultiBackendCodeGenerator:
     """
     
     def __init__(self, enable_fusion: bool = True, analyze_buffers: bool = True,
-                 module: Optional['PTOModule'] = None):
+                 module: Optional['PTOModule'] = None, arm64_simd: str = "neon",
+                 binary_expansion: str = "auto", schedule: bool = True,
+                 double_buffer: bool = False,
+                 double_buffer_budget: Optional[int] = _pto_isa.ASCEND_A2A3_BUFFER_SIZE["UB"],
+                 kernel_fusion: bool = False):
         self.enable_fusion = enable_fusion
         self.analyze_buffers = analyze_buffers
+        # Merge consecutive InCore calls of the orchestration functions
+        # (pto_kernel_fusion.py). self.module is then the fused module: iterate
+        # its functions to emit the fused kernels as well.
+        self.kernel_fusion_result: Optional[KernelFusionResult] = None
+        if kernel_fusion and module is not None:
+            self.kernel_fusion_result = fuse_incore_calls(module)
+            module = self.kernel_fusion_result.module
         self.module = module
-    
-    def generate_arm64(self, program: PTOProgram) -> str:
-        """Generate ARM64 code."""
+        self.arm64_simd = arm64_simd
+        self.binary_expansion = binary_expansion
+        self.schedule = schedule  # A2/A3 InCore instruction scheduling
+        # Ping-pong buffers for tiled loops (pto_double_buffer.py), on every backend
+        self.double_buffer = double_buffer
+        self.double_buffer_budget = double_buffer_budget
+        self.double_buffer_results: Dict[str, DoubleBufferResult] = {}
+    
+    def _prepare(self, program: PTOProgram) -> PTOProgram:
+        """The program the backends compile: fused and double-buffered when enabled."""
+        if self.kernel_fusion_result is not None:
+            # An orchestration function of the input module calls the fused kernels
+            program = self.module.functions.get(program.name, program)
+        if not self.double_buffer:
+            return program
+        result = double_buffer_loops(program, self.double_buffer_budget)
+        self.double_buffer_results[program.name] = result
+        return result.program
+    
+    def generate_arm64(self, program: PTOProgram, simd: Optional[str] = None) -> str:
+        """Generate ARM64 code (simd: "neon", "sve" or "scalar"; default arm64_simd)."""
         gen = ARM64CodeGenerator(
             enable_fusion=self.enable_fusion,
             analyze_buffers=self.analyze_buffers,
-            module=self.module
+            module=self.module,
+            simd=simd or self.arm64_simd,
+            binary_expansion=self.binary_expansion
         )
-        return gen.generate(program)
+        return gen.generate(self._prepare(program))
     
     def generate_cuda(self, program: PTOProgram) -> str:
         """Generate CUDA code."""
@@ -785,7 +835,7 @@ class MultiBackendCodeGenerator:
             analyze_buffers=self.analyze_buffers,
             module=self.module
         )
-        return gen.generate(program)
+        return gen.generate(self._prepare(program))
     
     def generate_ascend(self, program: PTOProgram, target: str = "a2a3") -> str:
         """Generate Ascend code."""
@@ -795,7 +845,15 @@ class MultiBackendCodeGenerator:
             module=self.module,
             target=target
         )
-        return gen.generate(program)
+        return gen.generate(self._prepare(program))
+
+    def generate_cpu(self, program: PTOProgram) -> str:
+        """Generate C++ on the include/pto/cpu tile templates (ref_runtime CPU runner)."""
+        gen = CPUCodeGenerator(
+            analyze_buffers=self.analyze_buffers,
+            module=self.module
+        )
+        return gen.generate(self._prepare(program))
 
     def generate_ptoas(self, program: PTOProgram, *, block_dim: int = 1, kernel_name: str = "pto_kernel") -> str:
         """
@@ -814,9 +872,10 @@ class MultiBackendCodeGenerator:
             enable_fusion=self.enable_fusion,
             analyze_buffers=self.analyze_buffers,
             module=self.module,
-            target_mode="hardware"
+            target_mode="hardware",
+            schedule=self.schedule
         )
-        return gen.generate(program)
+        return gen.generate(self._prepare(program))
     
     def generate_ascend_a5(self, program: PTOProgram) -> str:
         """Generate Ascend A5 code (convenience method)."""
@@ -827,9 +886,10 @@ class MultiBackendCodeGenerator:
         gen = AscendA2A3SimCodeGenerator(
             enable_fusion=self.enable_fusion,
             analyze_buffers=self.analyze_buffers,
-            module=self.module
+            module=self.module,
+            schedule=self.schedule
         )
-        return gen.generate(program)
+        return gen.generate(self._prepare(program))
     
     def compile_and_run_orchestration(self, program: PTOProgram, output_dir: str,
                                        extra_args: Optional[Dict[str, Any]] = None,
@@ -859,30 +919,17 @@ class MultiBackendCodeGenerator:
         with open(orch_file, 'w') as f:
             f.write(orch_code)
         
-        # Compile
+        # Compile and link against the cached runtime library
         exe_file = os.path.join(output_dir, f"{program.name}_orchestration")
         
-        # Get runtime directory
-        _current_dir = os.path.dirname(os.path.abspath(__file__))
-        _src_dir = os.path.dirname(_current_dir)
-        runtime_dir = os.path.join(_src_dir, "runtime")
-        
         compile_flags = ["-O2", "-std=c11", "-DPTO_BINARY_EXPANSION", 
                          "-DPTO_TASK_DUMP"]
         
-        compile_cmd = [
-            compiler,
-            *compile_flags,
-            f"-I{runtime_dir}",
-            "-o", exe_file,
-            orch_file,
-            "-lpthread"
-        ]
-        
+        builder = NativeBuilder(flags=compile_flags, compiler=compiler)
         try:
-            subprocess.run(compile_cmd, check=True, capture_output=True)
-        except subprocess.CalledProcessError as e:
-            print(f"  Compilation failed: {e.stderr.decode() if e.stderr else str(e)}")
+            builder.build_executable(orch_file, [], exe_file)
+        except BuildError as e:
+            print(f"  Compilation failed: {e}")
             return None
         
         # Run and capture output
@@ -1067,6 +1114,7 @@ __all__ = [
     'ARM64CodeGenerator', 'ARM64FusedCodeGenerator',
     'CUDACodeGenerator', 'CUDAFusedCodeGenerator',
     'AscendCodeGenerator', 'AscendFusedCodeGenerator',
+    'CPUCodeGenerator',
     
     # Multi-backend
     'MultiBackendCodeGenerator', 'PTOModuleCompiler', 'BACKENDS',
@@ -355,6 +355,14 @@ SCALAR_OPS = {"SLI", "SADD", "SSUB", "SMUL", "SDIV", "SMOV", "SCMP"}
 
 FUNCTION_OPS = {"CALL", "RETURN"}
 
+# Row fusion (LoopFusionOptimizer(fuse_rows=True))
+ROW_REDUCTION_OPS = {"TROWSUM", "TROWMAX", "TROWMIN"}
+
+ROW_BROADCAST_OPS = {"TROWEXPAND", "TROWEXPANDSUB", "TROWEXPANDDIV", "TROWEXPANDMUL"}
+
+# Scalar instructions that touch no tile; a row loop may be moved past them
+TILE_FREE_SCALAR_OPS = SCALAR_OPS | {"LI", "MOV", "ADD", "SUB", "MUL", "DIV", "CMP"}
+
 
 def get_category(opcode: str) -> OpCategory:
     """Get the category of an operation."""
@@ -431,6 +439,46 @@ class FusedLoop:
         self.operations.append(op)
 
 
+@dataclass
+class RowSweep:
+    """One pass over the columns of the current row of a FusedRowLoop."""
+    operations: List[FusableOp]     # element-wise ops, row broadcasts, row reductions
+
+
+@dataclass
+class FusedRowLoop:
+    """
+    Operations on [rows, cols] tiles and their [rows, 1] row tiles, run row
+    by row in one loop.
+    
+    Per row, stages run in order: a RowSweep computes element-wise ops and
+    row broadcasts column by column and accumulates row reductions on the
+    fly; a FusableOp stage is an element-wise op on [rows, 1] tiles, i.e.
+    one value per row. A sweep ends where a later op needs one of its
+    reductions.
+    
+    Values are passed between ops of a row in registers. Only destinations
+    in `materialized` (read outside the loop, or from memory in a later
+    sweep) are written back to their tiles.
+    """
+    rows: int
+    cols: int
+    stages: List[Union[RowSweep, FusableOp]]
+    materialized: set
+    dtype: str = "f32"
+    
+    @property
+    def operations(self) -> List[FusableOp]:
+        ops = []
+        for stage in self.stages:
+            ops.extend(stage.operations if isinstance(stage, RowSweep) else [stage])
+        return ops
+    
+    @property
+    def sweeps(self) -> int:
+        return sum(isinstance(stage, RowSweep) for stage in self.stages)
+
+
 @dataclass
 class FusionBarrier:
     """A fusion barrier (non-fusable operation)."""
@@ -516,7 +564,19 @@ def convert_program_to_mock_instructions(program: PTOProgram) -> Tuple[Dict[str,
             ]
         elif opcode == "IF":
             dst = ""
-            operands = [getattr(instr, 'condition', 'true')]
+            operands = [_get_operand_str(instr.cond)]
+        elif isinstance(instr, ScalarInstruction) and f"S{opcode}" in SCALAR_OPS - {"SLI"}:
+            # Scalar ops print as ADD/CMP/...; the backends lower SADD/SCMP/...
+            # LI stays as is: entry points take SLI-initialized scalars as
+            # parameters, and runners pass them positionally.
+            opcode = f"S{opcode}"
+            if opcode == "SMOV":
+                operands = [_get_operand_str(instr.src)]
+            elif opcode == "SCMP":
+                operands = [_get_operand_str(instr.src0), _get_operand_str(instr.src1),
+                            instr.cmp_mode.value.lower()]
+            else:
+                operands = [_get_operand_str(instr.src0), _get_operand_str(instr.src1)]
         elif opcode == "CALL":
             dst = instr.callee
             operands = instr.args if instr.args else []
@@ -570,27 +630,91 @@ class TileBufferInfo:
     first_write: int
     last_read: int
     can_reuse_from: Optional[str] = None
+    live_start: int = -1        # first position that touches the tile
+    live_end: int = -1          # last one, extended over enclosing loops
+    arena: str = ""             # arena the tile is placed in
+    arena_offset: int = -1      # byte offset within that arena
+    in_registers: bool = False  # only ever held in registers by row loops; takes no space
+
+
+def assign_arena_offsets(buffers: List[Tuple[str, int, int, int]],
+                         alignment: int = 64) -> Tuple[Dict[str, int], int]:
+    """
+    Lay out buffers in one arena so that buffers with intersecting live
+    ranges never share bytes (interval-graph colouring with sizes).
+    
+    Greedy by size: the largest buffer is placed first, each one at the
+    lowest aligned offset that does not collide with an already placed
+    buffer whose live range intersects its own.
+    
+    Args:
+        buffers: (name, size_bytes, live_start, live_end) tuples, inclusive ranges
+        alignment: Offset alignment in bytes
+    
+    Returns:
+        (offset of each buffer, arena size in bytes)
+    """
+    def align(n: int) -> int:
+        return (n + alignment - 1) // alignment * alignment
+    
+    placed = []  # (offset, end, live_start, live_end)
+    offsets = {}
+    for name, size, start, end in sorted(buffers, key=lambda b: (-b[1], b[2], b[0])):
+        size = align(size)
+        conflicts = sorted((p[0], p[1]) for p in placed if p[2] <= end and start <= p[3])
+        offset = 0
+        for lo, hi in conflicts:
+            if offset + size <= lo:
+                break
+            offset = max(offset, hi)
+        placed.append((offset, offset + size, start, end))
+        offsets[name] = offset
+    return offsets, max((p[1] for p in placed), default=0)
 
 
 class TileBufferAnalyzer:
     """
     Analyzes tile buffer usage in InCore functions.
+    
+    Live ranges are measured in positions, the items LoopFusionOptimizer
+    produces: all ops of a fused loop share a position, so a tile written
+    in a fused loop never aliases a tile read in it. A tile touched inside
+    a FOR body stays live for the whole loop. With fuse_rows, tiles that
+    row loops keep in registers take no space.
+    
+    Tiles are then placed in arenas (one per element type by default, so
+    every arena stays single-typed in C) with assign_arena_offsets().
+    Generators declare the arenas and alias each tile into them.
     """
     
     ELEMENT_SIZES = {
         'f32': 4, 'f16': 2, 'bf16': 2, 'i32': 4, 'i16': 2, 'i8': 1, 'u8': 1
     }
     
-    def __init__(self, program: PTOProgram):
+    ARENA_ALIGNMENT = 64  # bytes: one cache line, and a multiple of the 32B UB block
+    
+    def __init__(self, program: PTOProgram,
+                 arena_key: Optional[Callable[[TileBufferInfo], str]] = None,
+                 fuse_rows: bool = False):
+        """
+        Args:
+            program: InCore program to analyze
+            arena_key: Arena of a tile (default: its element type)
+            fuse_rows: The generator fuses with LoopFusionOptimizer(fuse_rows=True)
+        """
         self.program = program
+        self.arena_key = arena_key or (lambda info: info.dtype)
+        self.fuse_rows = fuse_rows
         self.tile_info: Dict[str, TileBufferInfo] = {}
         self.instructions = []
         self.analysis_result = {}
+        self.arenas: Dict[str, int] = {}
     
     def analyze(self) -> Dict:
         """Run complete buffer analysis."""
         self._collect_tiles()
         self._analyze_liveness()
+        self._assign_arenas()
         self._find_reuse_opportunities()
         self._compute_totals()
         return self.analysis_result
@@ -614,54 +738,103 @@ class TileBufferAnalyzer:
                 last_read=-1
             )
     
+    def _tile_accesses(self, instr) -> Tuple[List[str], List[str]]:
+        """(written, read) tile names of one instruction."""
+        written, read = [], []
+        dst = getattr(instr, 'dst', None)
+        if hasattr(dst, 'name') and dst.name in self.tile_info:
+            written.append(dst.name)
+        fields = vars(instr) if hasattr(instr, '__dict__') else {}
+        for attr, value in fields.items():
+            if attr == 'dst':
+                continue
+            if isinstance(value, dict):
+                values = list(value.values())
+            elif isinstance(value, (list, tuple)):
+                values = list(value)
+            else:
+                values = [value]
+            for v in values:
+                if isinstance(v, tuple) and v:
+                    v = v[0]  # CALL argument with offsets
+                name = v.name if hasattr(v, 'name') else v if isinstance(v, str) else None
+                if name in self.tile_info:
+                    read.append(name)
+        return written, read
+    
     def _analyze_liveness(self):
-        """Analyze when each tile is written and last read."""
+        """Analyze when each tile is written, last read, and live."""
+        mock_tiles, mock_instructions = convert_program_to_mock_instructions(self.program)
+        optimizer = LoopFusionOptimizer(mock_tiles, self.fuse_rows)
+        items = optimizer.optimize(mock_instructions)
+        positions = optimizer.positions
+        
+        accesses: List[List[str]] = []
+        loops: List[Tuple[int, set]] = []
         for idx, instr in enumerate(self.program.instructions):
-            opcode = getattr(instr, 'opcode', '')
+            opcode = getattr(instr, 'opcode', instr.__class__.__name__)
+            written, read = self._tile_accesses(instr)
+            accesses.append(written + read)
+            pos = positions[idx]
             
-            # Track writes (destination)
-            dst_name = None
-            if hasattr(instr, 'dst') and hasattr(instr.dst, 'name'):
-                dst_name = instr.dst.name
-            
-            if dst_name and dst_name in self.tile_info:
-                if self.tile_info[dst_name].first_write < 0:
-                    self.tile_info[dst_name].first_write = idx
-            
-            # Track reads (sources)
-            read_names = []
-            for attr in ['src', 'src0', 'src1', 'a', 'b', 'acc']:
-                if hasattr(instr, attr):
-                    src = getattr(instr, attr)
-                    if hasattr(src, 'name'):
-                        read_names.append(src.name)
+            for name in written:
+                if self.tile_info[name].first_write < 0:
+                    self.tile_info[name].first_write = idx
+            for name in read:
+                self.tile_info[name].last_read = idx
+            for name in written + read:
+                info = self.tile_info[name]
+                info.live_start = pos if info.live_start < 0 else min(info.live_start, pos)
+                info.live_end = max(info.live_end, pos)
+                for _, touched in loops:
+                    touched.add(name)
             
-            for name in read_names:
-                if name in self.tile_info:
-                    self.tile_info[name].last_read = idx
+            if opcode == "FOR":
+                loops.append((pos, set()))
+            elif opcode == "ENDFOR" and loops:
+                start, touched = loops.pop()
+                for name in touched:
+                    info = self.tile_info[name]
+                    info.live_start = min(info.live_start, start)
+                    info.live_end = max(info.live_end, pos)
+        
+        # Tiles with no visible access are kept live throughout
+        in_registers = optimizer.register_tiles(items, accesses)
+        last = max(positions, default=0)
+        for info in self.tile_info.values():
+            info.in_registers = info.name in in_registers
+            if info.live_start < 0:
+                info.live_start, info.live_end = 0, last
+    
+    def _assign_arenas(self):
+        """Place every tile in its arena."""
+        groups: Dict[str, List[TileBufferInfo]] = {}
+        for info in self.tile_info.values():
+            info.arena = self.arena_key(info)
+            groups.setdefault(info.arena, []).append(info)
+        self.arenas = {}
+        for arena, infos in groups.items():
+            offsets, size = assign_arena_offsets(
+                [(t.name, 0 if t.in_registers else t.total_bytes, t.live_start, t.live_end)
+                 for t in infos],
+                self.ARENA_ALIGNMENT)
+            for t in infos:
+                t.arena_offset = offsets[t.name]
+            self.arenas[arena] = size
     
     def _find_reuse_opportunities(self):
-        """Find tiles that can reuse buffers from dead tiles."""
-        sorted_tiles = sorted(
-            self.tile_info.values(),
-            key=lambda t: t.first_write if t.first_write >= 0 else 9999
-        )
-        
-        for tile in sorted_tiles:
-            if tile.first_write < 0:
-                continue
-            
-            for candidate in self.tile_info.values():
-                if candidate.name == tile.name:
-                    continue
-                if candidate.can_reuse_from is not None:
-                    continue
-                if candidate.last_read < 0:
+        """Record, for each tile, the earlier tile whose storage it takes over."""
+        for tile in self.tile_info.values():
+            best = None
+            for other in self.tile_info.values():
+                if (other is tile or other.arena != tile.arena or other.live_end >= tile.live_start
+                        or tile.in_registers or other.in_registers):
                     continue
-                if candidate.last_read < tile.first_write:
-                    if candidate.total_bytes >= tile.total_bytes:
-                        tile.can_reuse_from = candidate.name
-                        break
+                if (other.arena_offset < tile.arena_offset + tile.total_bytes and
+                        tile.arena_offset < other.arena_offset + other.total_bytes):
+                    if best is None or other.live_end > best.live_end:
+                        best = other
+            tile.can_reuse_from = best.name if best else None
     
     def _compute_totals(self):
         """Compute total buffer sizes."""
@@ -672,10 +845,7 @@ class TileBufferAnalyzer:
             if tile.can_reuse_from:
                 reuse_map[tile.name] = tile.can_reuse_from
         
-        total_with_reuse = 0
-        for tile in self.tile_info.values():
-            if tile.name not in reuse_map:
-                total_with_reuse += tile.total_bytes
+        total_with_reuse = sum(self.arenas.values())
         
         self.analysis_result = {
             'total_tiles': len(self.tile_info),
@@ -685,10 +855,30 @@ class TileBufferAnalyzer:
             'reuse_savings_percent': (1 - total_with_reuse / total_without_reuse) * 100 if total_without_reuse > 0 else 0,
             'tiles': self.tile_info,
             'reuse_map': reuse_map,
+            'arenas': dict(self.arenas),
         }
     
-    def generate_report(self) -> str:
-        """Generate a human-readable analysis report."""
+    def reuse_positions(self) -> List[int]:
+        """
+        Positions (fused loops / barrier instructions, in program order) at
+        which a tile takes over storage from a tile that is no longer live.
+        Targets that run tile ops concurrently must synchronize there.
+        """
+        if not self.analysis_result:
+            self.analyze()
+        return sorted({t.live_start for t in self.tile_info.values() if t.can_reuse_from})
+    
+    def over_budget(self, budgets: Dict[str, int]) -> List[str]:
+        """Messages for the arenas that exceed their budget (bytes per arena)."""
+        if not self.analysis_result:
+            self.analyze()
+        return [f"{self.program.name}: tile arena '{arena}' needs {size:,} bytes, "
+                f"budget is {budgets[arena]:,}"
+                for arena, size in self.arenas.items()
+                if arena in budgets and size > budgets[arena]]
+    
+    def generate_report(self, budgets: Optional[Dict[str, int]] = None, arenas: bool = True) -> str:
+        """Generate a human-readable analysis report; arenas=False omits the arena layout."""
         if not self.analysis_result:
             self.analyze()
         
@@ -704,6 +894,23 @@ class TileBufferAnalyzer:
         lines.append(f"//   Total capacity (no reuse): {r['total_without_reuse_bytes']:,} bytes ({r['total_without_reuse_bytes']/1024:.1f} KB)")
         lines.append(f"//   Total capacity (w/ reuse): {r['total_with_reuse_bytes']:,} bytes ({r['total_with_reuse_bytes']/1024:.1f} KB)")
         lines.append(f"//   Reuse savings:            {r['reuse_savings_bytes']:,} bytes ({r['reuse_savings_percent']:.1f}%)")
+        if arenas and r.get('arenas'):
+            lines.append("//")
+            lines.append("// ARENA LAYOUT:")
+            for arena, size in r['arenas'].items():
+                limit = ""
+                if budgets and arena in budgets:
+                    status = "OVER BUDGET" if size > budgets[arena] else "ok"
+                    limit = f" / budget {budgets[arena]:,} ({status})"
+                lines.append(f"//   {arena}: {size:,} bytes{limit}")
+                tiles = sorted((t for t in r['tiles'].values() if t.arena == arena),
+                               key=lambda t: (t.arena_offset, t.live_start))
+                for t in tiles:
+                    if t.in_registers:
+                        lines.append(f"//     {'-':<9} {t.name:<24} {'registers only':>20}")
+                        continue
+                    lines.append(f"//     +{t.arena_offset:<8} {t.name:<24} {t.total_bytes:>8} bytes"
+                                 f"  live [{t.live_start}, {t.live_end}]")
         lines.append("//")
         lines.append("// " + "=" * 70)
         lines.append("")
@@ -718,23 +925,83 @@ class TileBufferAnalyzer:
 class LoopFusionOptimizer:
     """
     Fuses consecutive fusable operations into single loops.
+    
+    With fuse_rows, a run of element-wise ops, row reductions (TROWSUM/
+    TROWMAX/TROWMIN) and row broadcasts (TROWEXPAND*) over tiles with the
+    same row count becomes one FusedRowLoop: reductions consume their
+    producers on the fly and broadcasts run in the same row loop. Tile-free
+    scalar instructions inside the run are moved in front of it. Runs
+    without a reduction or broadcast are fused as before.
+    
+    After optimize(), positions[i] is the index in the result of the item
+    that executes instruction i.
     """
     
-    def __init__(self, tile_info: Dict[str, MockTileInfo]):
+    def __init__(self, tile_info: Dict[str, MockTileInfo], fuse_rows: bool = False):
         self.tile_info = tile_info
+        self.fuse_rows = fuse_rows
+        self.positions: List[int] = []
         self.stats = {
             'fusable_ops': 0,
             'fused_loops': 0,
             'barriers': 0,
             'fusion_savings': 0,
+            'row_loops': 0,
+            'row_sweeps': 0,
         }
     
-    def optimize(self, instructions: List[MockInstruction]) -> List[Union[FusedLoop, FusionBarrier]]:
+    def optimize(self, instructions: List[MockInstruction]) -> List[Union[FusedLoop, FusedRowLoop, FusionBarrier]]:
         """Optimize instructions by fusing consecutive fusable operations."""
+        self.positions = [0] * len(instructions)
+        if not self.fuse_rows:
+            return self._fuse_elementwise(instructions, list(range(len(instructions))), [])
+        
         result = []
+        pending: List[int] = []
+        i = 0
+        while i < len(instructions):
+            end = self._row_run_end(instructions, i)
+            row_loop = self._create_row_loop(instructions, i, end) if end > i else None
+            if row_loop is None:
+                pending.extend(range(i, max(end, i + 1)))
+                i = max(end, i + 1)
+                continue
+            self._fuse_elementwise(instructions, pending, result)
+            pending = []
+            for idx in range(i, end):
+                if instructions[idx].opcode in TILE_FREE_SCALAR_OPS:
+                    self.stats['barriers'] += 1
+                    self.positions[idx] = len(result)
+                    result.append(FusionBarrier(opcode=instructions[idx].opcode, raw_instr=instructions[idx]))
+            for idx in range(i, end):
+                if instructions[idx].opcode not in TILE_FREE_SCALAR_OPS:
+                    self.positions[idx] = len(result)
+            result.append(row_loop)
+            i = end
+        return self._fuse_elementwise(instructions, pending, result)
+    
+    def register_tiles(self, items: List, accesses: List[List[str]]) -> set:
+        """
+        Tiles only row loops touch and none of them writes back; they live in
+        registers and need no storage. items is the optimize() result and
+        accesses[i] the tiles instruction i reads or writes.
+        """
+        in_registers = set()
+        for item in items:
+            if isinstance(item, FusedRowLoop):
+                in_registers |= {op.dst for op in item.operations} - item.materialized
+        for idx, names in enumerate(accesses):
+            if not isinstance(items[self.positions[idx]], FusedRowLoop):
+                in_registers -= set(names)
+        return in_registers
+    
+    def _fuse_elementwise(self, instructions: List[MockInstruction], indices: List[int],
+                          result: List) -> List[Union[FusedLoop, FusedRowLoop, FusionBarrier]]:
+        """Fuse consecutive element-wise ops of instructions[indices] into loops, appending to result."""
         current_fusable = []
         
-        for instr in instructions:
+        for idx in indices:
+            instr = instructions[idx]
             if is_fusable(instr.opcode):
                 self.stats['fusable_ops'] += 1
                 
@@ -761,6 +1028,7 @@ class LoopFusionOptimizer:
                     if current_fusable:
                         result.append(self._create_fused_loop(current_fusable, dtype))
                     current_fusable = [fusable_op]
+                self.positions[idx] = len(result)
             else:
                 # Barrier - flush current fusable group
                 if current_fusable:
@@ -768,6 +1036,7 @@ class LoopFusionOptimizer:
                     current_fusable = []
                 
                 self.stats['barriers'] += 1
+                self.positions[idx] = len(result)
                 result.append(FusionBarrier(opcode=instr.opcode, raw_instr=instr))
         
         # Flush remaining fusable ops
@@ -776,6 +1045,155 @@ class LoopFusionOptimizer:
         
         return result
     
+    # -------------------------------------------------------------------------
+    # Row fusion
+    # -------------------------------------------------------------------------
+    
+    def _tile_shape(self, name) -> Optional[Tuple[int, int, str]]:
+        info = self.tile_info.get(name) if isinstance(name, str) else None
+        return (info.rows, info.cols, info.dtype) if info else None
+    
+    def _row_role(self, instr: MockInstruction) -> Optional[Tuple[str, int, int, str]]:
+        """
+        (kind, rows, cols, dtype) of an instruction that can join a row loop,
+        else None. kind is "elem", "row" (element-wise on [rows, 1] tiles),
+        "reduce", "bcast" or "scalar" (tile-free; rows/cols 0).
+        """
+        op = instr.opcode
+        if op in TILE_FREE_SCALAR_OPS:
+            return ("scalar", 0, 0, "")
+        dst = self._tile_shape(instr.dst)
+        if dst is None:
+            return None
+        rows, cols, dtype = dst
+        if is_fusable(op):
+            tiles = [o for o in instr.operands if isinstance(o, str) and o in self.tile_info]
+            if op in FUSABLE_SCALAR_OPS:
+                tiles = tiles[:1] if op != "TEXPANDS" else []
+            if any(self._tile_shape(t) != dst for t in tiles):
+                return None
+            return ("row" if cols == 1 else "elem", rows, cols, dtype)
+        if op in ROW_REDUCTION_OPS:
+            src = self._tile_shape(instr.operands[0]) if instr.operands else None
+            if cols != 1 or src is None or src[0] != rows or src[2] != dtype:
+                return None
+            return ("reduce", rows, src[1], dtype)
+        if op in ROW_BROADCAST_OPS:
+            srcs = [self._tile_shape(o) for o in instr.operands[:2]]
+            row_src = srcs[-1] if srcs else None
+            if row_src != (rows, 1, dtype) or (op != "TROWEXPAND" and (len(srcs) != 2 or srcs[0] != dst)):
+                return None
+            return ("bcast", rows, cols, dtype)
+        return None
+    
+    def _row_run_end(self, instructions: List[MockInstruction], start: int) -> int:
+        """End (exclusive) of the longest run from start that can form one row loop."""
+        rows = cols = None
+        dtype = None
+        reads = set()
+        end = start
+        for idx in range(start, len(instructions)):
+            instr = instructions[idx]
+            role = self._row_role(instr)
+            if role is None:
+                break
+            kind, r, c, dt = role
+            if kind == "scalar":
+                # Moving it in front of the run must not change what earlier ops read
+                if instr.dst in reads:
+                    break
+                end = idx + 1
+                continue
+            if rows is None:
+                rows, dtype = r, dt
+            if r != rows or dt != dtype:
+                break
+            if kind != "row":
+                if cols is not None and c != cols:
+                    break
+                cols = c
+            reads.update(o for o in instr.operands if isinstance(o, str))
+            end = idx + 1
+        # Trailing scalar instructions stay outside
+        while end > start and instructions[end - 1].opcode in TILE_FREE_SCALAR_OPS:
+            end -= 1
+        return end
+    
+    def _create_row_loop(self, instructions: List[MockInstruction],
+                         start: int, end: int) -> Optional[FusedRowLoop]:
+        """Build the row loop for instructions[start:end], or None if row fusion gains nothing."""
+        ops = []
+        kinds = []
+        for instr in instructions[start:end]:
+            role = self._row_role(instr)
+            if role[0] == "scalar":
+                continue
+            rows = role[1]
+            ops.append(FusableOp(opcode=instr.opcode, dst=instr.dst, operands=instr.operands,
+                                 tile_shape=FusionTileShape(*self._tile_shape(instr.dst)[:2])))
+            kinds.append(role[0])
+        if len(ops) < 2 or not any(k in ("reduce", "bcast") for k in kinds):
+            return None
+        cols = max(op.tile_shape.cols for op in ops)
+        for instr in instructions[start:end]:
+            if instr.opcode in ROW_REDUCTION_OPS:
+                cols = self._tile_shape(instr.operands[0])[1]
+        
+        # Split into stages
+        stages: List[Union[RowSweep, FusableOp]] = []
+        sweep = None
+        reduced = set()
+        for op, kind in zip(ops, kinds):
+            reads = [o for o in op.operands if isinstance(o, str) and o in self.tile_info]
+            if kind == "row":
+                sweep, reduced = None, set()
+                stages.append(op)
+                continue
+            if sweep is None or any(r in reduced for r in reads):
+                sweep, reduced = RowSweep([]), set()
+                stages.append(sweep)
+            sweep.operations.append(op)
+            if kind == "reduce":
+                reduced.add(op.dst)
+        
+        # Destinations that must reach memory: read outside the loop, or read
+        # in the loop where no register holds the value
+        written = {op.dst for op in ops}
+        inside = set(range(start, end))
+        materialized = set()
+        for idx, instr in enumerate(instructions):
+            if idx in inside:
+                continue
+            operands = instr.operands.values() if isinstance(instr.operands, dict) else instr.operands
+            for o in operands:
+                name = o[0] if isinstance(o, tuple) and o else o
+                if isinstance(name, str) and name in written:
+                    materialized.add(name)
+        row_values = set()
+        for stage in stages:
+            sweep_values = set()
+            for op in (stage.operations if isinstance(stage, RowSweep) else [stage]):
+                for o in op.operands:
+                    if not (isinstance(o, str) and o in written):
+                        continue
+                    if self.tile_info[o].cols == 1 and cols != 1:
+                        held = o in row_values
+                    else:
+                        held = o in sweep_values
+                    if not held:
+                        materialized.add(o)
+                if self.tile_info[op.dst].cols == 1 and cols != 1:
+                    row_values.add(op.dst)
+                else:
+                    sweep_values.add(op.dst)
+        
+        self.stats['row_loops'] += 1
+        self.stats['row_sweeps'] += sum(isinstance(st, RowSweep) for st in stages)
+        self.stats['fusable_ops'] += len(ops)
+        self.stats['fusion_savings'] += len(ops) - 1
+        return FusedRowLoop(rows=rows, cols=cols, stages=stages,
+                            materialized=materialized, dtype=self.tile_info[ops[0].dst].dtype)
+    
     def _create_fused_loop(self, ops: List[FusableOp], dtype: str) -> FusedLoop:
         """Create a fused loop from a list of fusable operations."""
         self.stats['fused_loops'] += 1
@@ -923,14 +1341,36 @@ class PTOCompiler:
 # Binary Expansion Utility
 # =============================================================================
 
-def apply_binary_expansion(code: str) -> str:
+# Largest binary-expanded loop (in lines) apply_binary_expansion(mode="auto")
+# lowers to a cascade; bigger loops share one body through a dispatch loop
+BINARY_EXPANSION_CODE_BUDGET = 256
+
+BINARY_EXPANSION_MODES = ("cascade", "dispatch", "auto")
+
+
+def apply_binary_expansion(code: str, mode: str = "cascade",
+                           code_budget: int = BINARY_EXPANSION_CODE_BUDGET) -> str:
     """
-    Transform FOR loops with @BINARY_EXPAND markers into cascaded if-statements.
+    Lower FOR loops with @BINARY_EXPAND markers.
+    
+    Iterations always run in order; the lowerings differ in code size:
+    - "cascade": one if-block per power of 2, each with its own copy of the
+      loop body, then a residual loop (levels + 1 copies)
+    - "dispatch": one loop over a table of levels sharing a generic body.
+      While the lowered loop stays within code_budget lines, the largest
+      levels also get a copy with a constant trip count, selected by a
+      switch on the level
+    - "auto": cascade if it fits code_budget, dispatch otherwise
+    
+    Only the outermost marked loop is lowered; nested markers stay in place
+    and the inner loop runs as a plain loop.
     """
+    if mode not in BINARY_EXPANSION_MODES:
+        raise ValueError(f"Unknown binary expansion mode: {mode}")
     lines = code.split('\n')
     result = []
-    i = 0
     loop_counter = 0  # Unique ID for each expanded loop
+    i = 0
     
     while i < len(lines):
         line = lines[i]
@@ -941,13 +1381,6 @@ def apply_binary_expansion(code: str) -> str:
             max_range = int(marker_match.group(1))
             min_range = int(marker_match.group(2)) if marker_match.group(2) else 1
             
-            # Parse tile_levels if present
-            tile_levels = {}
-            if marker_match.group(4):
-                for pair in marker_match.group(4).split(','):
-                    k, v = pair.split(':')
-                    tile_levels[int(k)] = int(v)
-            
             # Next line should be the FOR loop
             i += 1
             if i >= len(lines):
@@ -980,36 +1413,23 @@ def apply_binary_expansion(code: str) -> str:
                     body_lines.append(body_line)
                 i += 1
             
-            # Generate binary-expanded code with unique variable names
-            # Use loop_counter suffix to avoid redefinition when same iterator name used in multiple loops
-            rem_var = f"{iv}_remaining_{loop_counter}"
-            base_var = f"{iv}_base_{loop_counter}"
-            loop_counter += 1
-            
-            result.append(f"{indent}// Binary-expanded loop: {iv} in [{lb}, {ub}), max_range={max_range}")
-            result.append(f"{indent}int {rem_var} = {ub} - {lb};")
-            result.append(f"{indent}int {base_var} = {lb};")
-            
-            # Generate cascading if-blocks for each power of 2
+            levels = []
             p = max_range
             while p >= min_range:
-                result.append(f"{indent}if ({rem_var} >= {p}) {{")
-                result.append(f"{indent}    for (int {iv} = {base_var}; {iv} < {base_var} + {p}; {iv} += {step}) {{")
-                for body_line in body_lines:
-                    result.append(f"    {body_line}")
-                result.append(f"{indent}    }}")
-                result.append(f"{indent}    {base_var} += {p};")
-                result.append(f"{indent}    {rem_var} -= {p};")
-                result.append(f"{indent}}}")
+                levels.append(p)
                 p //= 2
             
-            # Handle residual iterations (remaining < min_range)
-            result.append(f"{indent}// Residual loop for remaining < {min_range}")
-            result.append(f"{indent}for (int {iv} = {base_var}; {iv} < {base_var} + {rem_var}; {iv} += {step}) {{")
-            for body_line in body_lines:
-                result.append(f"    {body_line}")
-            result.append(f"{indent}}}")
+            # Use loop_counter suffix to avoid redefinition when same iterator name used in multiple loops
+            loop_id = loop_counter
+            loop_counter += 1
             
+            cascade_size = (len(levels) + 1) * (len(body_lines) + 2) + 4 * len(levels) + 4
+            if mode == "cascade" or (mode == "auto" and cascade_size <= code_budget):
+                result.extend(_binary_cascade(indent, iv, lb, ub, step, max_range, min_range,
+                                              levels, body_lines, loop_id))
+            else:
+                result.extend(_binary_dispatch(indent, iv, lb, ub, step, max_range,
+                                               levels, body_lines, loop_id, code_budget))
             continue
         
         result.append(line)
@@ -1018,6 +1438,92 @@ def apply_binary_expansion(code: str) -> str:
     return '\n'.join(result)
 
 
+def _binary_cascade(indent: str, iv: str, lb: str, ub: str, step: int, max_range: int,
+                    min_range: int, levels: List[int], body_lines: List[str],
+                    loop_id: int) -> List[str]:
+    """Cascaded if-blocks, one body copy per level plus the residual loop."""
+    rem_var = f"{iv}_remaining_{loop_id}"
+    base_var = f"{iv}_base_{loop_id}"
+    result = []
+    result.append(f"{indent}// Binary-expanded loop: {iv} in [{lb}, {ub}), max_range={max_range}")
+    result.append(f"{indent}int {rem_var} = {ub} - {lb};")
+    result.append(f"{indent}int {base_var} = {lb};")
+    
+    # Generate cascading if-blocks for each power of 2
+    for p in levels:
+        result.append(f"{indent}if ({rem_var} >= {p}) {{")
+        result.append(f"{indent}    for (int {iv} = {base_var}; {iv} < {base_var} + {p}; {iv} += {step}) {{")
+        for body_line in body_lines:
+            result.append(f"    {body_line}")
+        result.append(f"{indent}    }}")
+        result.append(f"{indent}    {base_var} += {p};")
+        result.append(f"{indent}    {rem_var} -= {p};")
+        result.append(f"{indent}}}")
+    
+    # Handle residual iterations (remaining < min_range)
+    result.append(f"{indent}// Residual loop for remaining < {min_range}")
+    result.append(f"{indent}for (int {iv} = {base_var}; {iv} < {base_var} + {rem_var}; {iv} += {step}) {{")
+    for body_line in body_lines:
+        result.append(f"    {body_line}")
+    result.append(f"{indent}}}")
+    return result
+
+
+def _binary_dispatch(indent: str, iv: str, lb: str, ub: str, step: int, max_range: int,
+                     levels: List[int], body_lines: List[str], loop_id: int,
+                     code_budget: int) -> List[str]:
+    """
+    One loop over the level table. Level k runs levels[k] iterations if that
+    many remain; the last level is the residual. The generic body serves every
+    level; the largest levels get a constant-trip-count copy while the whole
+    loop fits code_budget lines.
+    """
+    rem_var = f"{iv}_remaining_{loop_id}"
+    base_var = f"{iv}_base_{loop_id}"
+    level_var = f"{iv}_level_{loop_id}"
+    count_var = f"{iv}_count_{loop_id}"
+    table = f"{iv}_levels_{loop_id}"
+    num_levels = len(levels)
+    
+    generic_size = len(body_lines) + 14
+    copy_size = len(body_lines) + 4
+    specialized = max(0, min(num_levels, (code_budget - generic_size) // copy_size))
+    
+    result = []
+    result.append(f"{indent}// Binary-expanded loop (dispatch): {iv} in [{lb}, {ub}), max_range={max_range}, "
+                  f"{specialized} of {num_levels} levels specialized")
+    result.append(f"{indent}static const int {table}[{num_levels}] = {{{', '.join(str(p) for p in levels)}}};")
+    result.append(f"{indent}int {rem_var} = {ub} - {lb};")
+    result.append(f"{indent}int {base_var} = {lb};")
+    result.append(f"{indent}for (int {level_var} = 0; {level_var} <= {num_levels}; {level_var}++) {{")
+    result.append(f"{indent}    // Level {num_levels} is the residual")
+    result.append(f"{indent}    int {count_var} = {level_var} < {num_levels} ? {table}[{level_var}] : {rem_var};")
+    result.append(f"{indent}    if ({count_var} > {rem_var}) continue;")
+    
+    def loop(extra: str, trip: str) -> List[str]:
+        lines = [f"{indent}{extra}    for (int {iv} = {base_var}; {iv} < {base_var} + {trip}; {iv} += {step}) {{"]
+        lines.extend(f"    {extra}{body_line}" if body_line else "" for body_line in body_lines)
+        lines.append(f"{indent}{extra}    }}")
+        return lines
+    
+    if specialized:
+        result.append(f"{indent}    switch ({level_var}) {{")
+        for k in range(specialized):
+            result.append(f"{indent}    case {k}:")
+            result.extend(loop("    ", str(levels[k])))
+            result.append(f"{indent}        break;")
+        result.append(f"{indent}    default:")
+        result.extend(loop("    ", count_var))
+        result.append(f"{indent}        break;")
+        result.append(f"{indent}    }}")
+    else:
+        result.extend(loop("", count_var))
+    result.append(f"{indent}    {base_var} += {count_var};")
+    result.append(f"{indent}    {rem_var} -= {count_var};")
+    result.append(f"{indent}}}")
+    return result
+
+
 # =============================================================================
 # Loop Replay Optimization Utilities
 # =============================================================================
@@ -1108,17 +1614,19 @@ __all__ = [
     
     # Loop fusion
     'OpCategory', 'FusionTileShape', 'FusableOp', 'FusedLoop', 'FusionBarrier',
+    'RowSweep', 'FusedRowLoop',
     'LoopFusionOptimizer', 'get_category', 'is_fusable', 'is_fusion_barrier',
     
     # Mock instructions
     'MockTileInfo', 'MockInstruction', 'convert_program_to_mock_instructions',
     
     # Buffer analysis
-    'TileBufferInfo', 'TileBufferAnalyzer',
+    'TileBufferInfo', 'TileBufferAnalyzer', 'assign_arena_offsets',
     
     # Type checker and optimizer
     'TypeChecker', 'Optimizer', 'CodeGenerator', 'PTOCompiler',
     
     # Utilities
     'apply_binary_expansion', 'apply_loop_replay_optimization', 'get_loop_replay_header',
+    'BINARY_EXPANSION_CODE_BUDGET', 'BINARY_EXPANSION_MODES',
 ]
@@ -0,0 +1,403 @@
+"""
+PTO Compiler - Double Buffering of Tiled Loops
+
+A loop built with PTOFunctionBuilder.for_loop runs load -> compute -> store
+on one set of tiles, so every TLOAD of iteration i+1 has to wait for the
+compute of iteration i that still reads the same tile. double_buffer_loops()
+gives the tiles a second ("pong") copy and software-pipelines the loop:
+
+    prologue:       load ping(lb)
+    steady state:   for i in [lb, steady_end) step 2*step:
+                        load pong(i + step)
+                        compute/store ping(i)
+                        load ping(i + 2*step)
+                        compute/store pong(i + step)
+    epilogue:       the last one or two iterations (trip count parity)
+
+The trip count may be dynamic: the bounds are computed with scalar ops and
+the prologue/epilogue are guarded by IFs. Each steady-state iteration is one
+straight-line region, so the A2/A3 scheduler (pto_schedule) overlaps the
+loads of one buffer with the compute of the other and synchronizes them
+with SET_FLAG/WAIT_FLAG.
+
+A loop is transformed when:
+- Its body is straight-line tile code (no control flow or scalar ops)
+- The step is a constant and the loop is not binary-expanded (max_range)
+- No tile written by the body is read before that write in an iteration
+  (no loop-carried tiles), and no loaded or stored tile is read after the loop
+- No global tensor is both loaded and stored by the body
+- At least one TLOAD can move to the top of the body
+- The tiles still fit buffer_budget (TileBufferAnalyzer, with reuse)
+
+Loaded and stored tiles get pong copies; compute temporaries stay shared,
+since both halves run on the same pipe in order. Cube functions are left
+alone: the A2/A3 backend derives Left/Right/Acc roles from tile names.
+"""
+
+import copy
+from dataclasses import dataclass, field
+from typing import Dict, List, Optional, Set, Tuple, Union
+
+from compile.pto_compile_common import (
+    PTOProgram, TileBufferAnalyzer,
+    CONTROL_FLOW_OPS, FUNCTION_OPS,
+)
+from isa_definition.pto_isa_definition import (
+    ElementType, TileInstruction, TileOperand, ScalarOperand,
+    IndexOperand, ImmediateOperand, CompareMode,
+    FOR, ENDFOR, IF, ELSE, ENDIF,
+    SADD, SSUB, SMUL, SDIV, SCMP,
+)
+
+__all__ = [
+    'PONG_SUFFIX', 'DoubleBufferedLoop', 'DoubleBufferResult', 'double_buffer_loops',
+]
+
+PONG_SUFFIX = "_pong"
+
+_Value = Union[ScalarOperand, ImmediateOperand]
+
+
+@dataclass
+class DoubleBufferedLoop:
+    """A loop rewritten to ping-pong buffers."""
+    iv: str
+    pong_tiles: Dict[str, str]  # ping tile -> pong tile
+    hoisted_loads: int
+    extra_bytes: int
+
+
+@dataclass
+class DoubleBufferResult:
+    """Transformed program and what happened to each innermost loop."""
+    program: PTOProgram
+    loops: List[DoubleBufferedLoop] = field(default_factory=list)
+    skipped: List[Tuple[str, str]] = field(default_factory=list)  # (iv, reason)
+
+    def format(self) -> str:
+        lines = [f"Double buffering: {len(self.loops)} loop(s) transformed, "
+                 f"{len(self.skipped)} skipped"]
+        for loop in self.loops:
+            tiles = ", ".join(loop.pong_tiles)
+            lines.append(f"  {loop.iv}: pong copies of {tiles} (+{loop.extra_bytes:,} bytes), "
+                         f"{loop.hoisted_loads} loads prefetched")
+        for iv, reason in self.skipped:
+            lines.append(f"  {iv}: skipped, {reason}")
+        return "\n".join(lines)
+
+
+# =============================================================================
+# Instruction helpers
+# =============================================================================
+
+def _fields(instr) -> Dict[str, object]:
+    return vars(instr) if hasattr(instr, '__dict__') else {}
+
+
+def _tile_accesses(instr) -> Tuple[Set[str], Set[str]]:
+    """(read, written) tile names of an instruction."""
+    written = {instr.dst.name} if isinstance(getattr(instr, 'dst', None), TileOperand) else set()
+    read = {v.name for k, v in _fields(instr).items() if k != 'dst' and isinstance(v, TileOperand)}
+    return read, written
+
+
+def _rename(instr, tiles: Dict[str, str], iv: str, index: _Value):
+    """Copy of instr with tiles renamed and the induction variable replaced."""
+    out = copy.copy(instr)
+    for name, value in _fields(instr).items():
+        if isinstance(value, TileOperand) and value.name in tiles:
+            setattr(out, name, TileOperand(tiles[value.name], value.tile_type))
+        elif isinstance(value, (IndexOperand, ScalarOperand)) and value.name == iv:
+            if isinstance(index, ImmediateOperand):
+                setattr(out, name, ImmediateOperand(index.value))
+            elif isinstance(value, IndexOperand):
+                setattr(out, name, IndexOperand(index.name))
+            else:
+                setattr(out, name, ScalarOperand(index.name, value.element_type))
+    return out
+
+
+def _loop_spans(instructions: List) -> List[Tuple[int, int, List[int]]]:
+    """(FOR index, matching ENDFOR index, enclosing FOR indices) of every loop."""
+    spans, stack = [], []
+    for i, instr in enumerate(instructions):
+        if instr.opcode == "FOR":
+            stack.append(i)
+        elif instr.opcode == "ENDFOR" and stack:
+            start = stack.pop()
+            spans.append((start, i, list(stack)))
+    return sorted(spans)
+
+
+def _read_before_written(instructions: List, tiles: Set[str]) -> Set[str]:
+    """Tiles of `tiles` that the sequence reads before overwriting them."""
+    found, dead = set(), set()
+    for instr in instructions:
+        read, written = _tile_accesses(instr)
+        found |= (read & tiles) - dead
+        dead |= written
+    return found
+
+
+# =============================================================================
+# Legality
+# =============================================================================
+
+def _check_loop(program: PTOProgram, instructions: List, start: int, end: int,
+                outer: List[int]) -> Tuple[Optional[str], List[int], Set[str]]:
+    """
+    Reason the loop cannot be double-buffered, or None with the body
+    positions of the TLOADs that move to the top and the tiles to copy.
+    """
+    loop, body = instructions[start], instructions[start + 1:end]
+    if getattr(loop, 'max_range', None) is not None:
+        return "binary-expanded loop", [], set()
+    if not isinstance(loop.step, ImmediateOperand) or int(loop.step.value) <= 0:
+        return "step is not a positive constant", [], set()
+    for instr in body:
+        if (not isinstance(instr, TileInstruction) or instr.opcode == "TSYNC"
+                or instr.opcode in CONTROL_FLOW_OPS | FUNCTION_OPS):
+            return f"body is not straight-line tile code ({instr.opcode})", [], set()
+
+    written: Set[str] = set()
+    loaded_mem, stored_mem = set(), set()
+    for instr in body:
+        read, writes = _tile_accesses(instr)
+        carried = (read & program.tile_declarations.keys()) - written
+        carried = {t for t in carried if any(t in _tile_accesses(j)[1] for j in body)}
+        if carried:
+            return f"tile {sorted(carried)[0]} is carried across iterations", [], set()
+        written |= writes
+        if instr.opcode == "TLOAD":
+            loaded_mem.add(instr.src_mem.name)
+        elif instr.opcode == "TSTORE":
+            stored_mem.add(instr.dst_mem.name)
+    if loaded_mem & stored_mem:
+        return f"{sorted(loaded_mem & stored_mem)[0]} is loaded and stored in the loop", [], set()
+
+    # Loads that no earlier body instruction touches move to the top
+    hoisted, touched = [], set()
+    for pos, instr in enumerate(body):
+        read, writes = _tile_accesses(instr)
+        if instr.opcode == "TLOAD" and instr.dst.name not in touched:
+            hoisted.append(pos)
+        touched |= read | writes
+    if not hoisted:
+        return "no load can be prefetched", [], set()
+
+    pong = {body[pos].dst.name for pos in hoisted}
+    pong |= {i.src.name for i in body if i.opcode == "TSTORE" and i.src.name in written}
+    pong |= {i.dst.name for i in body if i.opcode == "TLOAD"}
+    # After the loop the last iteration's values may sit in the pong copies
+    after = instructions[end + 1:]
+    if outer:
+        after = after + instructions[outer[0] + 1:start]
+    live_out = _read_before_written(after, pong)
+    if live_out:
+        return f"tile {sorted(live_out)[0]} is read after the loop", [], set()
+    return None, hoisted, pong
+
+
+# =============================================================================
+# Rewriting
+# =============================================================================
+
+class _LoopRewriter:
+    """Emits the pipelined form of one loop; folds bounds known at compile time."""
+
+    def __init__(self, program: PTOProgram, taken: Set[str]):
+        self.program = program
+        self.taken = taken
+        self.out: List = []
+
+    def name(self, base: str) -> str:
+        name, n = base, 1
+        while name in self.taken:
+            name, n = f"{base}{n}", n + 1
+        self.taken.add(name)
+        return name
+
+    def value(self, operand) -> _Value:
+        if isinstance(operand, ImmediateOperand):
+            return ImmediateOperand(int(operand.value))
+        return ScalarOperand(operand.name,
+                             self.program.scalar_declarations.get(operand.name, ElementType.INDEX))
+
+    @staticmethod
+    def operand(v: _Value) -> ScalarOperand:
+        # Constants go in as named scalars, like PTOFunctionBuilder._make_scalar_operand
+        return ScalarOperand(str(v.value), ElementType.INDEX) if isinstance(v, ImmediateOperand) else v
+
+    def arith(self, cls, base: str, a: _Value, b: _Value, fold) -> _Value:
+        if isinstance(a, ImmediateOperand) and isinstance(b, ImmediateOperand):
+            return ImmediateOperand(fold(a.value, b.value))
+        dst = ScalarOperand(self.name(base), ElementType.INDEX)
+        self.program.add_scalar(dst.name, ElementType.INDEX)
+        self.out.append(cls(dst=dst, src0=self.operand(a), src1=self.operand(b)))
+        return dst
+
+    def less(self, base: str, a: _Value, b: _Value) -> Union[bool, ScalarOperand]:
+        if isinstance(a, ImmediateOperand) and isinstance(b, ImmediateOperand):
+            return a.value < b.value
+        dst = ScalarOperand(self.name(base), ElementType.U1)
+        self.program.add_scalar(dst.name, ElementType.U1)
+        self.out.append(SCMP(dst=dst, src0=self.operand(a), src1=self.operand(b),
+                             cmp_mode=CompareMode.LT))
+        return dst
+
+    def guarded(self, cond, then: List, otherwise: Optional[List] = None) -> None:
+        if cond is True:
+            self.out.extend(then)
+        elif cond is False:
+            self.out.extend(otherwise or [])
+        else:
+            self.out.append(IF(cond=cond))
+            self.out.extend(then)
+            if otherwise:
+                self.out.append(ELSE())
+                self.out.extend(otherwise)
+            self.out.append(ENDIF())
+
+
+def _trunc_div(a: int, b: int) -> int:
+    """C integer division (rounds toward zero)."""
+    q = abs(a) // abs(b)
+    return q if (a < 0) == (b < 0) else -q
+
+
+def _pipeline(program: PTOProgram, loop: FOR, body: List, hoisted: List[int],
+              pong: Dict[str, str], taken: Set[str]) -> List:
+    iv = loop.iv.name
+    step = int(loop.step.value)
+    ping: Dict[str, str] = {}
+    loads = [body[pos] for pos in hoisted]
+    rest = [instr for pos, instr in enumerate(body) if pos not in hoisted]
+
+    def half(instrs: List, tiles: Dict[str, str], index: _Value) -> List:
+        return [_rename(instr, tiles, iv, index) for instr in instrs]
+
+    r = _LoopRewriter(program, taken)
+    lb, ub = r.value(loop.lb), r.value(loop.ub)
+    # trips = ceil((ub - lb) / step); pairs = (trips - 1) / 2 steady iterations
+    span = r.arith(SSUB, f"{iv}_span", ub, lb, lambda a, b: a - b)
+    trips = span
+    if step != 1:
+        trips = r.arith(SADD, f"{iv}_span_up", span, ImmediateOperand(step - 1), lambda a, b: a + b)
+        trips = r.arith(SDIV, f"{iv}_trips", trips, ImmediateOperand(step), _trunc_div)
+    pairs = r.arith(SSUB, f"{iv}_trips_m1", trips, ImmediateOperand(1), lambda a, b: a - b)
+    pairs = r.arith(SDIV, f"{iv}_pairs", pairs, ImmediateOperand(2), _trunc_div)
+    steady = r.arith(SMUL, f"{iv}_pairs_span", pairs, ImmediateOperand(2 * step), lambda a, b: a * b)
+    steady_end = r.arith(SADD, f"{iv}_steady_end", lb, steady, lambda a, b: a + b)
+    tail_next = r.arith(SADD, f"{iv}_tail_next", steady_end, ImmediateOperand(step),
+                        lambda a, b: a + b)
+    any_trip = r.less(f"{iv}_has_trips", ImmediateOperand(0), trips)
+    two_left = r.less(f"{iv}_has_two_left", tail_next, ub)
+
+    # Prologue: the first iteration's loads
+    r.guarded(any_trip, half(loads, ping, lb))
+
+    # Steady state: prefetch one buffer while the other is computed
+    if not (isinstance(steady_end, ImmediateOperand) and isinstance(lb, ImmediateOperand)
+            and steady_end.value <= lb.value):
+        inner = _LoopRewriter(program, taken)
+        index = ScalarOperand(iv, ElementType.INDEX)
+        nxt = inner.arith(SADD, f"{iv}_next", index, ImmediateOperand(step), lambda a, b: a + b)
+        nxt2 = inner.arith(SADD, f"{iv}_next2", index, ImmediateOperand(2 * step),
+                           lambda a, b: a + b)
+        r.out.append(FOR(iv=IndexOperand(iv), lb=loop.lb,
+                         ub=steady_end if isinstance(steady_end, ImmediateOperand)
+                         else IndexOperand(steady_end.name),
+                         step=ImmediateOperand(2 * step)))
+        r.out.extend(inner.out)
+        r.out.extend(half(loads, pong, nxt))
+        r.out.extend(half(rest, ping, index))
+        r.out.extend(half(loads, ping, nxt2))
+        r.out.extend(half(rest, pong, nxt))
+        r.out.append(ENDFOR())
+
+    # Epilogue: one or two iterations, the first already loaded into ping
+    if any_trip is not False:
+        two = half(loads, pong, tail_next) + half(rest, ping, steady_end) + half(rest, pong, tail_next)
+        one = half(rest, ping, steady_end)
+        if two_left is True or two_left is False:
+            r.guarded(any_trip, two if two_left else one)
+        else:
+            one_guarded = _LoopRewriter(program, taken)
+            one_guarded.guarded(any_trip, one)
+            r.guarded(two_left, two, one_guarded.out)
+    return r.out
+
+
+def _rewrite(program: PTOProgram, loops: Dict[int, Tuple[int, List[int], Set[str]]]):
+    """Copy of program with the given loops (FOR index -> plan) pipelined."""
+    new = copy.copy(program)
+    new.tile_declarations = dict(program.tile_declarations)
+    new.scalar_declarations = dict(program.scalar_declarations)
+    taken = set(new.tile_declarations) | set(new.scalar_declarations) | set(new.memref_declarations)
+    instructions = program.instructions
+    out, pos, pongs = [], 0, {}
+    for start in sorted(loops):
+        end, hoisted, tiles = loops[start]
+        pong: Dict[str, str] = {}
+        for tile in sorted(tiles):
+            name, n = f"{tile}{PONG_SUFFIX}", 1
+            while name in taken:
+                name, n = f"{tile}{PONG_SUFFIX}{n}", n + 1
+            taken.add(name)
+            pong[tile] = name
+            new.tile_declarations[name] = program.tile_declarations[tile]
+        out.extend(instructions[pos:start])
+        out.extend(_pipeline(new, instructions[start], instructions[start + 1:end],
+                             hoisted, pong, taken))
+        pos = end + 1
+        pongs[start] = pong
+    out.extend(instructions[pos:])
+    new.instructions = out
+    return new, pongs
+
+
+def double_buffer_loops(program: PTOProgram,
+                        buffer_budget: Optional[int] = None) -> DoubleBufferResult:
+    """
+    Rewrite the innermost loops of an InCore program to ping-pong buffers.
+
+    Args:
+        program: InCore program; it is not modified
+        buffer_budget: Bytes the tiles may take after the rewrite (with
+            buffer reuse); None for no limit
+
+    Returns:
+        DoubleBufferResult with a new program (the input itself when no loop
+        qualified)
+    """
+    result = DoubleBufferResult(program=program)
+    if not program.is_in_core or program.is_cube:
+        return result
+
+    instructions = program.instructions
+    accepted: Dict[int, Tuple[int, List[int], Set[str]]] = {}
+    for start, end, outer in _loop_spans(instructions):
+        iv = instructions[start].iv.name
+        if any(instructions[k].opcode == "FOR" for k in range(start + 1, end)):
+            continue  # only innermost loops
+        reason, hoisted, tiles = _check_loop(program, instructions, start, end, outer)
+        if reason is None and buffer_budget is not None:
+            trial, _ = _rewrite(program, {**accepted, start: (end, hoisted, tiles)})
+            needed = TileBufferAnalyzer(trial).analyze()['total_with_reuse_bytes']
+            if needed > buffer_budget:
+                reason = f"tiles would need {needed:,} bytes, budget is {buffer_budget:,}"
+        if reason is not None:
+            result.skipped.append((iv, reason))
+            continue
+        accepted[start] = (end, hoisted, tiles)
+
+    if accepted:
+        result.program, pongs = _rewrite(program, accepted)
+        for start, (end, hoisted, tiles) in sorted(accepted.items()):
+            extra = sum(TileBufferAnalyzer.ELEMENT_SIZES.get(t.element_type.value, 4)
+                        * t.shape.rows * t.shape.cols
+                        for t in (program.tile_declarations[p] for p in tiles))
+            result.loops.append(DoubleBufferedLoop(iv=instructions[start].iv.name,
+                                                   pong_tiles=pongs[start],
+                                                   hoisted_loads=len(hoisted), extra_bytes=extra))
+    return result
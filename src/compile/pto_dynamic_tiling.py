@@ -10,11 +10,17 @@ Tile Shape Computation Rules:
 
 The module provides:
 - compute_tile_shape(): Calculate optimal tile shape for given dtype and ISA
+  (or the tuned shape of a kernel, see pto_autotune.py)
+- candidate_tile_shapes(): Tile shapes the auto-tuner searches
+- TuningDatabase: Persisted best tile shape per (kernel, ISA, dtype, shape bucket)
 - DynamicTiledProgram: Helper class to build programs with dynamic tiling
 """
 
+import json
 import os
 import sys
+import tempfile
+from typing import Dict, List, Optional, Tuple
 
 # Ensure src directory is in path for relative imports
 _current_dir = os.path.dirname(os.path.abspath(__file__))
@@ -33,6 +39,7 @@ from isa_definition.pto_isa_definition import (
 # Re-export ISA constants for convenience
 __all__ = [
     'compute_tile_shape', 'get_tile_info', 'DynamicTiledProgram',
+    'candidate_tile_shapes', 'shape_bucket', 'TuningDatabase',
     'build_unary_op', 'build_binary_op', 'build_scalar_op',
     'print_tile_shapes',
     'MAX_TILE_BYTES', 'ELEMENT_BYTES', 'DEFAULT_DTYPE',
@@ -69,8 +76,24 @@ DEFAULT_DTYPE = ElementType.F32
 # Tile Shape Computation
 # =============================================================================
 
+def _isa_tile_params(dtype: ElementType, target_isa: str) -> Tuple[int, int]:
+    """Return (vector_lanes, physical_row_size) of a target ISA."""
+    dtype_str = dtype.value
+    if target_isa == "arm64":
+        return ARM64_VECTOR_LANES.get(dtype_str, 4), ARM64_PHYSICAL_ROW_SIZE
+    elif target_isa == "cuda":
+        return CUDA_VECTOR_LANES.get(dtype_str, 4), CUDA_PHYSICAL_ROW_SIZE
+    elif target_isa in ("ascend_a2a3", "ascend_a5", "ascend910b"):
+        return ASCEND_VECTOR_LANES.get(dtype_str, 8), ASCEND_PHYSICAL_ROW_SIZE
+    # Default to ARM64
+    return ARM64_VECTOR_LANES.get(dtype_str, 4), ARM64_PHYSICAL_ROW_SIZE
+
+
 def compute_tile_shape(dtype: ElementType = ElementType.F32, 
-                       target_isa: str = "arm64") -> tuple:
+                       target_isa: str = "arm64",
+                       kernel: Optional[str] = None,
+                       problem_rows: int = 0,
+                       tuning_db: Optional["TuningDatabase"] = None) -> tuple:
     """
     Compute optimal tile shape based on data type and target ISA.
     
@@ -79,29 +102,26 @@ def compute_tile_shape(dtype: ElementType = ElementType.F32,
     2) row should be multiple of PHYSICAL_ROW_SIZE
     3) byte size of the TILE should be no greater than 16KB
     
+    If kernel is given and the tuning database has an entry for it (see
+    pto_autotune.py), the tuned shape is returned instead.
+    
     Args:
         dtype: Element data type
         target_isa: Target ISA ("arm64", "cuda", "ascend_a2a3", "ascend_a5")
+        kernel: InCore function name to look up in the tuning database
+        problem_rows: Rows of the tensor the kernel is applied to (0 = any)
+        tuning_db: Database to consult (default: TuningDatabase.default())
     
     Returns:
         (rows, cols) tuple
     """
-    dtype_str = dtype.value
+    if kernel is not None:
+        db = tuning_db if tuning_db is not None else TuningDatabase.default()
+        tuned = db.lookup(kernel, target_isa, dtype, problem_rows)
+        if tuned is not None:
+            return tuned
     
-    # Get ISA-specific parameters
-    if target_isa == "arm64":
-        vector_lanes = ARM64_VECTOR_LANES.get(dtype_str, 4)
-        physical_row_size = ARM64_PHYSICAL_ROW_SIZE
-    elif target_isa == "cuda":
-        vector_lanes = CUDA_VECTOR_LANES.get(dtype_str, 4)
-        physical_row_size = CUDA_PHYSICAL_ROW_SIZE
-    elif target_isa in ("ascend_a2a3", "ascend_a5", "ascend910b"):
-        vector_lanes = ASCEND_VECTOR_LANES.get(dtype_str, 8)
-        physical_row_size = ASCEND_PHYSICAL_ROW_SIZE
-    else:
-        # Default to ARM64
-        vector_lanes = ARM64_VECTOR_LANES.get(dtype_str, 4)
-        physical_row_size = ARM64_PHYSICAL_ROW_SIZE
+    vector_lanes, physical_row_size = _isa_tile_params(dtype, target_isa)
     
     element_bytes = ELEMENT_BYTES.get(dtype, 4)
     
@@ -134,6 +154,141 @@ def compute_tile_shape(dtype: ElementType = ElementType.F32,
     return best_rows, best_cols
 
 
+def candidate_tile_shapes(dtype: ElementType = ElementType.F32,
+                          target_isa: str = "arm64",
+                          max_tile_bytes: int = MAX_TILE_BYTES,
+                          rows: Optional[int] = None,
+                          cols: Optional[int] = None,
+                          max_rows: int = 0) -> List[Tuple[int, int]]:
+    """
+    Enumerate the tile shapes the auto-tuner scores.
+    
+    Rows are power-of-2 multiples of PHYSICAL_ROW_SIZE and cols power-of-2
+    multiples of VECTOR_LANES; shapes smaller than 1/16 of max_tile_bytes
+    are skipped since per-call overhead dominates them.
+    
+    Args:
+        rows / cols: Fix one dimension (e.g. cols to the hidden size)
+        max_rows: Upper bound on rows (e.g. the problem size), 0 = none
+    
+    Returns:
+        List of (rows, cols), smallest tiles first
+    """
+    vector_lanes, physical_row_size = _isa_tile_params(dtype, target_isa)
+    element_bytes = ELEMENT_BYTES.get(dtype, 4)
+    min_tile_bytes = max_tile_bytes // 16
+    
+    def powers(base):
+        value = base
+        while value * element_bytes <= max_tile_bytes:
+            yield value
+            value *= 2
+    
+    row_options = [rows] if rows else list(powers(physical_row_size))
+    col_options = [cols] if cols else list(powers(vector_lanes))
+    shapes = []
+    for r in row_options:
+        if max_rows and r > max_rows:
+            continue
+        for c in col_options:
+            tile_bytes = r * c * element_bytes
+            if tile_bytes > max_tile_bytes:
+                continue
+            if tile_bytes < min_tile_bytes and not (rows and cols):
+                continue
+            shapes.append((r, c))
+    return sorted(shapes, key=lambda shape: (shape[0] * shape[1], shape[0]))
+
+
+def shape_bucket(problem_rows: int) -> int:
+    """
+    Bucket a problem size for the tuning database: the next power of 2
+    (0 for "any size").
+    """
+    if problem_rows <= 0:
+        return 0
+    bucket = 1
+    while bucket < problem_rows:
+        bucket *= 2
+    return bucket
+
+
+class TuningDatabase:
+    """
+    Best tile shape per (kernel, target ISA, dtype, shape bucket).
+    
+    Stored as JSON, rewritten atomically on every record(). Lookups fall
+    back from the problem's bucket to the "any size" bucket 0.
+    
+    Environment:
+    - PTO_TUNING_DB=<path>  database file (default
+                            $XDG_CACHE_HOME/pto-isa/tuning.json or
+                            ~/.cache/pto-isa/tuning.json)
+    - PTO_TUNING_DB=0       do not consult or record tuned shapes
+    """
+    
+    VERSION = 1
+    _default: Optional["TuningDatabase"] = None
+    
+    def __init__(self, path: Optional[str]):
+        self.path = path
+        self.entries: Dict[str, dict] = {}
+        if path and os.path.exists(path):
+            try:
+                with open(path) as f:
+                    data = json.load(f)
+                if data.get("version") == self.VERSION:
+                    self.entries = data.get("entries", {})
+            except (OSError, ValueError):
+                self.entries = {}
+    
+    @classmethod
+    def default(cls) -> "TuningDatabase":
+        """Process-wide database configured from the environment."""
+        if cls._default is None:
+            path = os.getenv("PTO_TUNING_DB", "").strip()
+            if path.lower() in ("0", "off"):
+                path = None
+            elif not path:
+                xdg = os.getenv("XDG_CACHE_HOME", "").strip()
+                base = xdg if xdg else os.path.join(os.path.expanduser("~"), ".cache")
+                path = os.path.join(base, "pto-isa", "tuning.json")
+            cls._default = cls(path)
+        return cls._default
+    
+    @staticmethod
+    def key(kernel: str, target_isa: str, dtype: ElementType, bucket: int) -> str:
+        return f"{kernel}|{target_isa}|{dtype.value}|{bucket}"
+    
+    def lookup(self, kernel: str, target_isa: str, dtype: ElementType,
+               problem_rows: int = 0) -> Optional[Tuple[int, int]]:
+        """Return the tuned (rows, cols), or None if the kernel was not tuned."""
+        for bucket in (shape_bucket(problem_rows), 0):
+            entry = self.entries.get(self.key(kernel, target_isa, dtype, bucket))
+            if entry is not None:
+                return entry["rows"], entry["cols"]
+        return None
+    
+    def record(self, kernel: str, target_isa: str, dtype: ElementType, bucket: int,
+               rows: int, cols: int, **details) -> None:
+        """Store the best shape for a kernel and persist the database."""
+        entry = {"rows": rows, "cols": cols}
+        entry.update(details)
+        self.entries[self.key(kernel, target_isa, dtype, bucket)] = entry
+        self.save()
+    
+    def save(self) -> None:
+        if not self.path:
+            return
+        directory = os.path.dirname(os.path.abspath(self.path))
+        os.makedirs(directory, exist_ok=True)
+        fd, tmp = tempfile.mkstemp(dir=directory, prefix=".tuning-")
+        with os.fdopen(fd, "w") as f:
+            json.dump({"version": self.VERSION, "entries": self.entries}, f,
+                      indent=1, sort_keys=True)
+        os.replace(tmp, self.path)
+
+
 def get_tile_info(dtype: ElementType = ElementType.F32,
                   target_isa: str = "arm64") -> dict:
     """
@@ -187,7 +342,7 @@ class DynamicTiledProgram:
         self.name = name
         self.dtype = dtype
         self.target_isa = target_isa
-        self.rows, self.cols = compute_tile_shape(dtype, target_isa)
+        self.rows, self.cols = compute_tile_shape(dtype, target_isa, kernel=name)
         self.tile_elements = self.rows * self.cols
         
         self.inputs = []  # List of input memref names
@@ -286,7 +441,7 @@ def build_unary_op(name: str, op_method: str, dtype: ElementType = ElementType.F
     Returns:
         PTOProgram
     """
-    rows, cols = compute_tile_shape(dtype, target_isa)
+    rows, cols = compute_tile_shape(dtype, target_isa, kernel=name)
     tile_elements = rows * cols
     
     builder = (PTOFunctionBuilder(name)
@@ -337,7 +492,7 @@ def build_binary_op(name: str, op_method: str, dtype: ElementType = ElementType.
     Returns:
         PTOProgram
     """
-    rows, cols = compute_tile_shape(dtype, target_isa)
+    rows, cols = compute_tile_shape(dtype, target_isa, kernel=name)
     tile_elements = rows * cols
     
     builder = (PTOFunctionBuilder(name)
@@ -393,7 +548,7 @@ def build_scalar_op(name: str, op_method: str, scalar_value: float,
     Returns:
         PTOProgram
     """
-    rows, cols = compute_tile_shape(dtype, target_isa)
+    rows, cols = compute_tile_shape(dtype, target_isa, kernel=name)
     tile_elements = rows * cols
     
     builder = (PTOFunctionBuilder(name)
@@ -0,0 +1,552 @@
+"""
+PTO Compiler - InCore Kernel Fusion
+
+An orchestration function submits one runtime task per InCore CALL, and
+each task pays submit, TensorMap and dispatch costs. Calls on one tile that
+run back to back (residual add -> rmsnorm, the Q/K/V matmuls of a tile,
+...) also make every intermediate round-trip through a GM buffer.
+fuse_incore_calls() merges runs of consecutive calls into one InCore
+function per run:
+
+- Tiles and scalars of each call are renamed apart. The tensors the calls
+  are passed become the parameters of the fused function
+- A TLOAD of data an earlier call of the run stored or loaded (same tensor,
+  offsets and tile shape) reuses that tile instead of reading GM
+- A TSTORE to an intermediate buffer (Mode B) is dropped when no other
+  task can read it before it is overwritten
+
+Calls are merged when:
+- Each callee is a straight-line InCore function of the module, and every
+  argument is a memref
+- They run on the same core type (cube and vector tasks go to different cores)
+- Each tensor is passed at one offset throughout the run
+- Data one call stores and a later call loads can be forwarded, and no call
+  overwrites a tensor an earlier call read from GM
+- The fused tiles fit the UB (vector) or L1 (cube) budget per TileBufferAnalyzer
+
+Cube runs only share loads between tiles of the same name, since the A2/A3
+backend derives Left/Right/Acc roles from tile names.
+
+A run is kept when the cost model says it pays off: its simulated cycles on
+the A2/A3 pipe model (PTOISAIncoreGenerator.simulate) plus one task
+overhead, against the cycles of its calls plus one overhead each.
+
+Usage:
+    python3 src/compile/pto_kernel_fusion.py examples/llama/pto_llama7B_dynamic.py \\
+        --scalar num_tiles=16
+"""
+
+import contextlib
+import copy
+import importlib.util
+import io
+import os
+import sys
+import warnings
+from dataclasses import dataclass, field
+from typing import Any, Dict, List, Optional, Set, Tuple
+
+# Add parent directories to path for imports
+_current_dir = os.path.dirname(os.path.abspath(__file__))
+_src_dir = os.path.dirname(_current_dir)
+if _src_dir not in sys.path:
+    sys.path.insert(0, _src_dir)
+
+from compile.pto_compile_common import (
+    PTOModule, PTOProgram, TileBufferAnalyzer,
+    CONTROL_FLOW_OPS, FUNCTION_OPS, MEMORY_OPS,
+    convert_program_to_mock_instructions,
+)
+from compile.pto_codegen_ascend_a2a3_sim import PTOISAIncoreGenerator
+from compile.pto_schedule import expand_trace
+from isa_definition.pto_isa_definition import (
+    ASCEND_A2A3_BUFFER_SIZE,
+    TileInstruction, ScalarInstruction, TileOperand, ScalarOperand, MemRefOperand,
+    IndexOperand, ImmediateOperand, CALL,
+)
+
+__all__ = [
+    'TASK_OVERHEAD_CYCLES', 'FusedKernel', 'KernelFusionResult', 'fuse_incore_calls',
+]
+
+# Assumed cost of one task outside its kernel: submit, TensorMap lookups and
+# dispatch. The core model does not simulate the scheduler, so this is a parameter.
+TASK_OVERHEAD_CYCLES = 1000
+
+FUSED_PREFIX = "fused_"
+
+# Parameter names the orchestration code generators treat as outputs
+_OUTPUT_MARKERS = ("output", "result", "dst")
+
+
+@dataclass
+class FusedKernel:
+    """A run of calls merged into one InCore function."""
+    name: str
+    caller: str
+    callees: List[str]
+    forwarded_loads: int
+    elided_stores: int
+    buffer_bytes: int
+    kernel_cycles_before: int  # sum over the calls
+    kernel_cycles_after: int
+
+
+@dataclass
+class KernelFusionResult:
+    """Fused module, the runs that were merged and why the others were not."""
+    module: PTOModule
+    original: PTOModule
+    kernels: List[FusedKernel] = field(default_factory=list)
+    skipped: List[Tuple[str, str]] = field(default_factory=list)  # (calls, reason)
+    task_cycles: Dict[str, int] = field(default_factory=dict)  # simulated cycles per InCore function
+    task_overhead: int = TASK_OVERHEAD_CYCLES
+
+    def totals(self, caller: str, scalars: Dict[str, float]) -> Tuple[int, int, int, int]:
+        """(tasks before, tasks after, cycles before, cycles after) of one call of an orchestration function."""
+        before = self._trace_cost(self.original.functions[caller], scalars)
+        after = self._trace_cost(self.module.functions[caller], scalars)
+        return before[0], after[0], before[1], after[1]
+
+    def _trace_cost(self, program: PTOProgram, scalars: Dict[str, float]) -> Tuple[int, int]:
+        _, instructions = convert_program_to_mock_instructions(program)
+        tasks = cycles = 0
+        for instr in expand_trace(instructions, scalars):
+            if instr.opcode == "CALL" and instr.dst in self.task_cycles:
+                tasks += 1
+                cycles += self.task_cycles[instr.dst] + self.task_overhead
+        return tasks, cycles
+
+    def format(self, scalars: Optional[Dict[str, float]] = None) -> str:
+        lines = [f"InCore kernel fusion: {len(self.kernels)} kernel(s) fused, "
+                 f"{len(self.skipped)} run(s) left alone"]
+        for k in self.kernels:
+            before = k.kernel_cycles_before + len(k.callees) * self.task_overhead
+            after = k.kernel_cycles_after + self.task_overhead
+            lines.append(f"  {k.name} ({k.caller}): {' + '.join(k.callees)}")
+            lines.append(f"    tasks {len(k.callees)} -> 1, kernel cycles {k.kernel_cycles_before} -> "
+                         f"{k.kernel_cycles_after}, with task overhead {before} -> {after} "
+                         f"({before / after:.2f}x)")
+            lines.append(f"    {k.forwarded_loads} load(s) forwarded, {k.elided_stores} store(s) elided, "
+                         f"{k.buffer_bytes:,} bytes of tiles")
+        for calls, reason in self.skipped:
+            lines.append(f"  {calls}: {reason}")
+        if scalars is not None:
+            for caller in sorted({k.caller for k in self.kernels}):
+                tasks_before, tasks_after, before, after = self.totals(caller, scalars)
+                values = ", ".join(f"{k}={v:g}" for k, v in sorted(scalars.items()))
+                lines.append(f"  {caller} ({values}): tasks {tasks_before} -> {tasks_after}, "
+                             f"cycles {before} -> {after} ({before / max(after, 1):.2f}x)")
+        return "\n".join(lines)
+
+
+# =============================================================================
+# Call analysis
+# =============================================================================
+
+def _arg_key(arg: Any) -> Tuple[str, str, str]:
+    """(tensor, row offset, col offset) a CALL argument refers to."""
+    if isinstance(arg, tuple):
+        tensor, row, col = (list(arg) + [0, 0])[:3]
+        return str(tensor), str(row), str(col)
+    return str(arg), "0", "0"
+
+
+def _fields(instr) -> Dict[str, object]:
+    return vars(instr) if hasattr(instr, '__dict__') else {}
+
+
+def _offset(value) -> Optional[str]:
+    return str(value.value) if isinstance(value, ImmediateOperand) else None
+
+
+def _shape(tile: TileOperand) -> Tuple[int, int, str]:
+    t = tile.tile_type
+    return t.shape.rows, t.shape.cols, t.element_type.value
+
+
+def _callee_reason(module: PTOModule, call: CALL) -> Optional[str]:
+    """Reason a call cannot be part of a fused kernel, or None."""
+    callee = module.functions.get(call.callee)
+    if callee is None or not callee.is_in_core:
+        return f"{call.callee} is not an InCore function of the module"
+    if set(call.args) != set(callee.memref_declarations):
+        return f"{call.callee} takes arguments other than memrefs"
+    for instr in callee.instructions:
+        if not isinstance(instr, (TileInstruction, ScalarInstruction)) \
+                or instr.opcode in CONTROL_FLOW_OPS | FUNCTION_OPS:
+            return f"{call.callee} has control flow"
+        if instr.opcode not in MEMORY_OPS and any(
+                isinstance(v, MemRefOperand) for v in _fields(instr).values()):
+            return f"{call.callee} accesses GM with {instr.opcode}"
+    return None
+
+
+def _accesses(module: PTOModule, call: CALL) -> Tuple[Dict[str, List], Dict[str, List]]:
+    """
+    (reads, writes) of a call: tensor -> [(arg key, row, col, tile shape)].
+    Calls the module cannot see into read and write every argument, at an
+    unknown extent (shape None).
+    """
+    reads: Dict[str, List] = {}
+    writes: Dict[str, List] = {}
+    callee = module.functions.get(call.callee)
+    keys = {param: _arg_key(arg) for param, arg in (call.args or {}).items()}
+    if callee is None or not callee.is_in_core:
+        for key in keys.values():
+            reads.setdefault(key[0], []).append((key, None, None, None))
+            writes.setdefault(key[0], []).append((key, None, None, None))
+        return reads, writes
+    for instr in callee.instructions:
+        if instr.opcode == "TLOAD" and instr.src_mem.name in keys:
+            key = keys[instr.src_mem.name]
+            reads.setdefault(key[0], []).append(
+                (key, _offset(instr.row_offset), _offset(instr.col_offset), _shape(instr.dst)))
+        elif instr.opcode == "TSTORE" and instr.dst_mem.name in keys:
+            key = keys[instr.dst_mem.name]
+            writes.setdefault(key[0], []).append(
+                (key, _offset(instr.row_offset), _offset(instr.col_offset), _shape(instr.src)))
+    return reads, writes
+
+
+class _Orchestration:
+    """Straight-line regions and per-call accesses of an orchestration function."""
+
+    def __init__(self, module: PTOModule, program: PTOProgram):
+        self.module = module
+        self.program = program
+        self.region: List[int] = []
+        region = 0
+        for instr in program.instructions:
+            if instr.opcode in CONTROL_FLOW_OPS:
+                region += 1
+            self.region.append(region)
+        self._accesses: Dict[int, Tuple[Dict[str, List], Dict[str, List]]] = {}
+
+    def accesses(self, i: int) -> Tuple[Dict[str, List], Dict[str, List]]:
+        if i not in self._accesses:
+            self._accesses[i] = _accesses(self.module, self.program.instructions[i])
+        return self._accesses[i]
+
+    def dead_after(self, tensor: str, group: List[int]) -> bool:
+        """
+        Whether no task outside the group can read what the group stores to
+        tensor: each read elsewhere follows, in its own straight-line region
+        and after the group, a call that overwrites the same tile.
+        """
+        if tensor not in self.program.intermediate_buffers:
+            return False
+        for i, instr in enumerate(self.program.instructions):
+            if i in group:
+                continue
+            if instr.opcode != "CALL":
+                if any(isinstance(v, MemRefOperand) and v.name == tensor
+                       for v in _fields(instr).values()):
+                    return False
+                continue
+            for access in self.accesses(i)[0].get(tensor, []):
+                if not self._overwritten_before(i, tensor, access, group):
+                    return False
+        return True
+
+    def _overwritten_before(self, i: int, tensor: str, access, group: List[int]) -> bool:
+        if access[3] is None or access[1] is None:
+            return False
+        j = i - 1
+        while j >= 0 and self.region[j] == self.region[i]:
+            if j in group:
+                return False
+            if self.program.instructions[j].opcode == "CALL" and access in self.accesses(j)[1].get(tensor, []):
+                return True
+            j -= 1
+        return False
+
+
+# =============================================================================
+# Fusion
+# =============================================================================
+
+@dataclass
+class _Fused:
+    program: PTOProgram
+    args: Dict[str, Any]
+    forwarded_loads: int
+    elided_stores: int
+
+
+def _param_name(kind: str, tensor: str, index: int, used: Set[str]) -> str:
+    name = f"{kind}_{tensor}"
+    if kind == "input" and any(m in tensor.lower() for m in _OUTPUT_MARKERS):
+        name = f"{kind}_{index}"
+    while name in used:
+        name += "_"
+    used.add(name)
+    return name
+
+
+def _fuse(orch: _Orchestration, group: List[int], name: str) -> Tuple[Optional[str], Optional[_Fused]]:
+    """Fused function of the calls at the group positions, or the reason there is none."""
+    module = orch.module
+    calls = [orch.program.instructions[i] for i in group]
+    callees = [module.functions[c.callee] for c in calls]
+    is_cube = callees[0].is_cube
+    if any(c.is_cube != is_cube for c in callees):
+        return "mixes cube and vector calls", None
+
+    # Each tensor at one offset
+    tensor_args: Dict[str, Any] = {}
+    for call in calls:
+        for arg in call.args.values():
+            tensor = _arg_key(arg)[0]
+            if tensor in tensor_args and _arg_key(tensor_args[tensor]) != _arg_key(arg):
+                return f"passes {tensor} at two offsets", None
+            tensor_args.setdefault(tensor, arg)
+
+    fused = PTOProgram(name=name, is_in_core=True, is_cube=is_cube)
+    origins: Dict[str, str] = {}  # fused tile -> tile name in its callee
+    used: Set[str] = set()
+    memref_types: Dict[str, Any] = {}
+    available: Dict[Tuple, Tuple[TileOperand, str]] = {}  # (tensor, row, col) -> (tile, source)
+    gm_reads: Dict[str, List[Tuple[int, int]]] = {}  # tensor -> [(call, TLOAD index)]
+    behind: Dict[str, Set[int]] = {}  # tile -> TLOADs its value depends on
+    stores: List[Tuple[int, str]] = []  # (instruction index, tensor)
+    forwarded = 0
+
+    def unique(base: str) -> str:
+        candidate = base
+        while candidate in used:
+            candidate += "_"
+        used.add(candidate)
+        return candidate
+
+    for k, (call, callee) in enumerate(zip(calls, callees)):
+        tensors = {param: _arg_key(arg)[0] for param, arg in call.args.items()}
+        for param, tensor in tensors.items():
+            memref_types.setdefault(tensor, callee.memref_declarations[param])
+        tiles: Dict[str, TileOperand] = {}
+        scalars: Dict[str, str] = {}
+
+        def tile(operand: TileOperand) -> TileOperand:
+            if operand.name not in tiles:
+                new = unique(f"{operand.name}_{k}")
+                fused.tile_declarations[new] = operand.tile_type
+                origins[new] = operand.name
+                tiles[operand.name] = TileOperand(new, operand.tile_type)
+            return tiles[operand.name]
+
+        def scalar(name: str, dtype) -> str:
+            if name not in scalars:
+                scalars[name] = unique(f"{name}_{k}")
+                fused.scalar_declarations[scalars[name]] = dtype
+            return scalars[name]
+
+        for name, dtype in callee.scalar_declarations.items():
+            scalar(name, dtype)
+        for instr in callee.instructions:
+            if instr.opcode == "TLOAD":
+                tensor = tensors[instr.src_mem.name]
+                row, col = _offset(instr.row_offset), _offset(instr.col_offset)
+                hit = available.get((tensor, row, col)) if row is not None and col is not None else None
+                if hit and _shape(hit[0]) == _shape(instr.dst) and \
+                        (not is_cube or (hit[1] == "load" and origins[hit[0].name] == instr.dst.name)):
+                    tiles[instr.dst.name] = hit[0]
+                    forwarded += 1
+                    continue
+                if any(t == tensor for _, t in stores):
+                    return f"{call.callee} reloads {tensor}, which an earlier call stores", None
+                gm_reads.setdefault(tensor, []).append((k, len(fused.instructions)))
+
+            out = copy.copy(instr)
+            for field_name, value in _fields(instr).items():
+                if isinstance(value, TileOperand):
+                    setattr(out, field_name, tile(value))
+                elif isinstance(value, ScalarOperand):
+                    setattr(out, field_name, ScalarOperand(scalar(value.name, value.element_type), value.element_type))
+                elif isinstance(value, IndexOperand) and value.name in callee.scalar_declarations:
+                    setattr(out, field_name, IndexOperand(scalar(value.name, callee.scalar_declarations[value.name])))
+                elif isinstance(value, MemRefOperand):
+                    setattr(out, field_name, MemRefOperand(tensors[value.name], value.memref_type))
+
+            # Overwriting a tensor an earlier call read is ordered after that
+            # read only if the stored value depends on it
+            read = set().union(*(behind.get(v.name, set()) for f, v in _fields(out).items()
+                                 if f != 'dst' and isinstance(v, TileOperand)))
+            if instr.opcode == "TSTORE":
+                tensor = tensors[instr.dst_mem.name]
+                if any(j != k and load not in read for j, load in gm_reads.get(tensor, [])):
+                    return f"{call.callee} overwrites {tensor}, which an earlier call reads", None
+
+            # A tile written here no longer holds what it forwarded
+            dst = getattr(out, 'dst', None)
+            if isinstance(dst, TileOperand):
+                available = {key: hit for key, hit in available.items() if hit[0].name != dst.name}
+                behind[dst.name] = read | ({len(fused.instructions)} if instr.opcode == "TLOAD" else set())
+            if instr.opcode == "TLOAD":
+                row, col = _offset(instr.row_offset), _offset(instr.col_offset)
+                if row is not None and col is not None:
+                    available[(tensors[instr.src_mem.name], row, col)] = (out.dst, "load")
+            elif instr.opcode == "TSTORE":
+                tensor = tensors[instr.dst_mem.name]
+                available = {key: hit for key, hit in available.items() if key[0] != tensor}
+                row, col = _offset(instr.row_offset), _offset(instr.col_offset)
+                if row is not None and col is not None:
+                    available[(tensor, row, col)] = (out.src, "store")
+                stores.append((len(fused.instructions), tensor))
+            fused.instructions.append(out)
+
+    # Drop stores no other task reads, then name the parameters: inputs first,
+    # then outputs, as the orchestration code generators register them
+    dead = {t for _, t in stores if orch.dead_after(t, group)}
+    dropped = {i for i, t in stores if t in dead}
+    fused.instructions = [instr for i, instr in enumerate(fused.instructions) if i not in dropped]
+    params = set(used)
+    inputs = {t: _param_name("input", t, n, params)
+              for n, t in enumerate(t for t in tensor_args if t in gm_reads)}
+    outputs = {t: _param_name("output", t, n, params)
+               for n, t in enumerate(t for t in tensor_args
+                                     if any(s == t for _, s in stores) and t not in dead)}
+    for tensor, param in list(inputs.items()) + list(outputs.items()):
+        fused.memref_declarations[param] = memref_types[tensor]
+    for instr in fused.instructions:
+        if instr.opcode == "TLOAD":
+            instr.src_mem = MemRefOperand(inputs[instr.src_mem.name], instr.src_mem.memref_type)
+        elif instr.opcode == "TSTORE":
+            instr.dst_mem = MemRefOperand(outputs[instr.dst_mem.name], instr.dst_mem.memref_type)
+    fused.metadata["tile_origins"] = origins
+    args = {param: tensor_args[t] for t, param in list(inputs.items()) + list(outputs.items())}
+    return None, _Fused(fused, args, forwarded, len(dropped))
+
+
+def _fused_name(callees: List[str], taken) -> str:
+    parts = []
+    for callee in callees:
+        if parts and parts[-1][0] == callee:
+            parts[-1][1] += 1
+        else:
+            parts.append([callee, 1])
+    base = FUSED_PREFIX + "_".join(c if n == 1 else f"{c}_x{n}" for c, n in parts)
+    name, suffix = base, 1
+    while name in taken:
+        name, suffix = f"{base}_{suffix}", suffix + 1
+    return name
+
+
+def fuse_incore_calls(module: PTOModule,
+                      vector_budget: Optional[int] = ASCEND_A2A3_BUFFER_SIZE["UB"],
+                      cube_budget: Optional[int] = ASCEND_A2A3_BUFFER_SIZE["L1"],
+                      task_overhead: int = TASK_OVERHEAD_CYCLES) -> KernelFusionResult:
+    """
+    Merge runs of consecutive InCore calls in the orchestration functions of
+    a module. Returns a new module with the fused functions added and the
+    orchestration functions calling them; the input module is not modified.
+    """
+    result = KernelFusionResult(module=copy.copy(module), original=module,
+                                task_overhead=task_overhead)
+    result.module.functions = dict(module.functions)
+    generator = PTOISAIncoreGenerator(module)
+
+    def cycles(program: PTOProgram) -> int:
+        if program.name not in result.task_cycles:
+            with warnings.catch_warnings():
+                warnings.simplefilter("ignore")
+                result.task_cycles[program.name] = generator.simulate(program, {})
+        return result.task_cycles[program.name]
+
+    for caller in list(module.functions.values()):
+        if caller.is_in_core:
+            continue
+        orch = _Orchestration(module, caller)
+        instructions = caller.instructions
+        for instr in instructions:
+            callee = module.functions.get(instr.callee) if instr.opcode == "CALL" else None
+            if callee is not None and callee.is_in_core:
+                cycles(callee)
+
+        # Runs of consecutive fusable calls, grown greedily
+        groups: List[Tuple[List[int], _Fused]] = []
+        i = 0
+        while i < len(instructions):
+            if instructions[i].opcode != "CALL" or _callee_reason(module, instructions[i]):
+                i += 1
+                continue
+            group, best = [i], None
+            j = i + 1
+            while j < len(instructions) and instructions[j].opcode == "CALL":
+                label = f"{instructions[j - 1].callee} -> {instructions[j].callee}"
+                reason = _callee_reason(module, instructions[j])
+                fused = None
+                if reason is None:
+                    name = _fused_name([instructions[p].callee for p in group + [j]],
+                                       result.module.functions)
+                    reason, fused = _fuse(orch, group + [j], name)
+                if reason is None:
+                    budget = cube_budget if fused.program.is_cube else vector_budget
+                    needed = TileBufferAnalyzer(fused.program).analyze()['total_with_reuse_bytes']
+                    if budget is not None and needed > budget:
+                        reason = f"tiles would need {needed:,} bytes, budget is {budget:,}"
+                if reason is not None:
+                    result.skipped.append((label, reason))
+                    break
+                group, best = group + [j], fused
+                j += 1
+            if best is not None:
+                before = sum(cycles(module.functions[instructions[p].callee]) for p in group)
+                after = cycles(best.program)
+                if after + task_overhead < before + len(group) * task_overhead:
+                    groups.append((group, best))
+                    result.module.functions[best.program.name] = best.program
+                    result.kernels.append(FusedKernel(
+                        name=best.program.name, caller=caller.name,
+                        callees=[instructions[p].callee for p in group],
+                        forwarded_loads=best.forwarded_loads, elided_stores=best.elided_stores,
+                        buffer_bytes=TileBufferAnalyzer(best.program).analyze()['total_with_reuse_bytes'],
+                        kernel_cycles_before=before, kernel_cycles_after=after))
+                else:
+                    result.skipped.append((" -> ".join(instructions[p].callee for p in group),
+                                           f"not profitable ({after} cycles fused, {before} unfused)"))
+            i = group[-1] + 1
+
+        if groups:
+            rewritten = copy.copy(caller)
+            rewritten.instructions = list(instructions)
+            for group, fused in reversed(groups):
+                rewritten.instructions[group[0]:group[-1] + 1] = [
+                    CALL(callee=fused.program.name, args=fused.args)]
+            result.module.functions[caller.name] = rewritten
+    return result
+
+
+def main():
+    import argparse
+
+    parser = argparse.ArgumentParser(description="Fuse InCore calls of PTO orchestration functions")
+    parser.add_argument("example", help="Python file defining a create_<name>_module() function")
+    parser.add_argument("--scalar", action="append", default=[], metavar="NAME=VALUE",
+                        help="Orchestration scalar argument for the task and cycle totals")
+    parser.add_argument("--task-overhead", type=int, default=TASK_OVERHEAD_CYCLES,
+                        help="Cycles charged per task for submit, TensorMap and dispatch")
+    args = parser.parse_args()
+
+    example_dir = os.path.dirname(os.path.abspath(args.example))
+    if example_dir not in sys.path:
+        sys.path.insert(0, example_dir)
+    spec = importlib.util.spec_from_file_location("pto_fused_example", args.example)
+    example = importlib.util.module_from_spec(spec)
+    with contextlib.redirect_stdout(io.StringIO()):
+        spec.loader.exec_module(example)
+        builders = [getattr(example, a) for a in sorted(dir(example))
+                    if a.startswith("create_") and a.endswith("_module")]
+        if not builders:
+            parser.error(f"{args.example} has no create_<name>_module() function")
+        module = builders[0]()
+
+    scalars = {}
+    for item in args.scalar:
+        name, _, value = item.partition("=")
+        scalars[name] = float(value) if "." in value else int(value)
+    result = fuse_incore_calls(module, task_overhead=args.task_overhead)
+    print(result.format(scalars if scalars else None))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,500 @@
+"""
+PTO Compiler - InCore Instruction Scheduling
+
+InCore functions are emitted in program order: every TLOAD, then the
+compute, then every TSTORE. On the A2/A3 cores each of these goes to its
+own pipe (a2a3_get_target_pipe in the core model), and the pipes only
+overlap when the code says which instruction waits for which.
+
+schedule_incore() list-schedules a MockInstruction sequence for those pipes:
+- Straight-line regions between control flow (FOR, IF, CALL, ...) are
+  scheduled independently; a region boundary is a full pipe barrier
+- Within a region, instructions keep their data dependencies on tiles,
+  scalars and global memory (RAW, WAR and WAW), including tiles that share
+  on-chip bytes (aliases)
+- Ready instructions are picked by earliest start on their pipe, then by
+  critical path, so loads of later tiles are hoisted over the compute of
+  earlier ones. A region keeps program order if that simulates faster
+- Every cross-pipe dependency gets a SET_FLAG after the producer and a
+  WAIT_FLAG before the consumer, unless the consumer's pipe has already
+  waited for the producer (directly or through another pipe's flags).
+  Event ids rotate per pipe pair
+
+simulate_pipes() replays a sequence on a pipe model of the core (in-order
+issue, one in-order queue per pipe, flags and barriers), and the result
+reports the cycles of program order with a pipe barrier at each
+cross-pipe dependency against the scheduled order with flags.
+Loop bodies are counted once; expand_trace() unrolls loops and resolves
+branches for given scalar arguments, to simulate a whole call.
+
+Global memory tensors are assumed not to alias each other.
+"""
+
+import re
+from collections import defaultdict, deque
+from dataclasses import dataclass
+from typing import Callable, Dict, List, Optional, Set, Tuple
+
+from compile.pto_compile_common import MockInstruction
+
+__all__ = [
+    'VECTOR_CORE_PIPES', 'CUBE_CORE_PIPES', 'PIPE_SCALAR', 'EVENT_IDS',
+    'SYNC_OPS', 'ScheduleResult', 'target_pipe', 'isa_pipe',
+    'schedule_incore', 'serialize_incore', 'simulate_pipes', 'expand_trace',
+]
+
+# Pipes of the A2A3 core model (VecPipeId / CubePipeId in a2a3_core_model.h)
+VECTOR_CORE_PIPES = ("SCALAR", "MTE_GM2UB", "MTE_UB2GM", "VECTOR")
+CUBE_CORE_PIPES = ("SCALAR", "MTE_GM2L1", "MTE_L12GM", "MTE_L0C", "CUBE")
+PIPE_SCALAR = 0
+
+# pipe_t of each model pipe, for set_flag/wait_flag
+_VECTOR_ISA_PIPES = ("PIPE_S", "PIPE_MTE2", "PIPE_MTE3", "PIPE_V")
+_CUBE_ISA_PIPES = ("PIPE_S", "PIPE_MTE2", "PIPE_MTE3", "PIPE_MTE1", "PIPE_M")
+
+# Events per (src, dst) pipe pair (EVENT_ID0..EVENT_ID7)
+EVENT_IDS = 8
+
+# Pseudo-instructions added by the scheduler; operands are
+# [src_pipe, dst_pipe, event] for the flags
+SYNC_OPS = ("SET_FLAG", "WAIT_FLAG", "PIPE_BARRIER")
+
+# Instructions that end a straight-line region
+_REGION_BOUNDARY_OPS = {
+    "FOR", "ENDFOR", "WHILE", "ENDWHILE", "DO", "IF", "ELSE", "ENDIF",
+    "BREAK", "CONTINUE", "CALL", "RETURN", "YIELD", "TSYNC",
+    # Scalar unit accesses to tiles or memory
+    "GETVAL", "SETVAL", "LOAD", "STORE",
+}
+
+_CUBE_OPS = {"TMATMUL", "TMATMUL_ACC", "TMATMUL_BIAS", "TMATMUL_MX"}
+_CUBE_MOVE_OPS = {"TMOV", "TEXTRACT"}
+
+_IDENTIFIER = re.compile(r"^[A-Za-z_]\w*$")
+
+
+def target_pipe(opcode: str, is_cube: bool) -> int:
+    """Pipe an instruction executes on; follows a2a3_get_target_pipe()."""
+    if opcode == "TLOAD":
+        return 1  # MTE_GM2UB / MTE_GM2L1
+    if opcode == "TSTORE":
+        return 2  # MTE_UB2GM / MTE_L12GM
+    if not opcode.startswith("T") or opcode in _REGION_BOUNDARY_OPS:
+        return PIPE_SCALAR
+    if is_cube:
+        if opcode in _CUBE_OPS:
+            return 4  # CUBE
+        if opcode in _CUBE_MOVE_OPS:
+            return 3  # MTE_L0C
+        # Vector ops on a cube core run on the scalar unit
+        return PIPE_SCALAR
+    return 3  # VECTOR
+
+
+def isa_pipe(pipe: int, is_cube: bool) -> str:
+    """pipe_t name of a model pipe."""
+    return (_CUBE_ISA_PIPES if is_cube else _VECTOR_ISA_PIPES)[pipe]
+
+
+def _accesses(instr: MockInstruction) -> Tuple[Set[str], Set[str]]:
+    """(reads, writes) of an instruction; global memory is prefixed with '@'."""
+    names = [o for o in instr.operands if isinstance(o, str) and _IDENTIFIER.match(o)]
+    if instr.opcode == "TLOAD":
+        return {f"@{instr.operands[0]}"} | set(names[1:]), {instr.dst}
+    if instr.opcode == "TSTORE":
+        return set(names), {f"@{instr.dst}"}
+    return set(names), {instr.dst} if instr.dst else set()
+
+
+def _dependencies(region: List[MockInstruction],
+                  aliases: Dict[str, Set[str]]) -> List[Set[int]]:
+    """Predecessors of each instruction of a region (RAW, WAR, WAW)."""
+    last_write: Dict[str, int] = {}
+    reads_since: Dict[str, List[int]] = defaultdict(list)
+    preds: List[Set[int]] = []
+    for i, instr in enumerate(region):
+        reads, writes = _accesses(instr)
+        deps: Set[int] = set()
+        for name in reads | writes:
+            for key in {name} | aliases.get(name, set()):
+                if key in last_write:
+                    deps.add(last_write[key])
+                if name in writes:
+                    deps.update(reads_since[key])
+        for name in reads:
+            reads_since[name].append(i)
+        for name in writes:
+            # The write is ordered after every earlier access of the bytes it
+            # overwrites, so it stands in for them
+            for key in {name} | aliases.get(name, set()):
+                last_write[key] = i
+                reads_since[key] = []
+        deps.discard(i)
+        preds.append(deps)
+    return preds
+
+
+def _regions(instructions: List[MockInstruction]):
+    """Yield (straight-line region, boundary instruction or None)."""
+    region: List[MockInstruction] = []
+    for instr in instructions:
+        if instr.opcode in _REGION_BOUNDARY_OPS:
+            yield region, instr
+            region = []
+        else:
+            region.append(instr)
+    yield region, None
+
+
+def _barrier() -> MockInstruction:
+    return MockInstruction(opcode="PIPE_BARRIER", dst="", operands=[])
+
+
+def _needs_barrier(region: List[MockInstruction], is_cube: bool) -> bool:
+    return any(target_pipe(i.opcode, is_cube) != PIPE_SCALAR for i in region)
+
+
+def serialize_incore(instructions: List[MockInstruction], is_cube: bool,
+                     aliases: Optional[Dict[str, Set[str]]] = None) -> List[MockInstruction]:
+    """
+    Program order, made safe with a PIPE_BARRIER before every instruction
+    that depends on an unsynchronized instruction of another pipe.
+    The baseline the scheduled order is measured against.
+    """
+    aliases = aliases or {}
+    out: List[MockInstruction] = []
+    for region, boundary in _regions(instructions):
+        preds = _dependencies(region, aliases)
+        synced = 0  # instructions before this index have completed
+        for i, instr in enumerate(region):
+            pipe = target_pipe(instr.opcode, is_cube)
+            if any(j >= synced and target_pipe(region[j].opcode, is_cube) not in (pipe, PIPE_SCALAR)
+                   for j in preds[i]):
+                out.append(_barrier())
+                synced = i
+            out.append(instr)
+        if boundary is not None:
+            if _needs_barrier(region, is_cube):
+                out.append(_barrier())
+            out.append(boundary)
+    return out
+
+
+def _list_schedule(region: List[MockInstruction], preds: List[Set[int]],
+                   pipes: List[int], costs: List[int]) -> List[int]:
+    """Order of a region: earliest start on its pipe first, then longest critical path."""
+    n = len(region)
+    succs: List[List[int]] = [[] for _ in range(n)]
+    for i, deps in enumerate(preds):
+        for j in deps:
+            succs[j].append(i)
+    priority = [0] * n
+    for i in reversed(range(n)):
+        priority[i] = costs[i] + max((priority[s] for s in succs[i]), default=0)
+
+    waiting = [len(deps) for deps in preds]
+    ready = [i for i in range(n) if waiting[i] == 0]
+    finish = [0] * n
+    pipe_free: Dict[int, int] = defaultdict(int)
+    issue = 0
+    order: List[int] = []
+
+    def start(i: int) -> int:
+        return max([pipe_free[pipes[i]], issue] + [finish[j] for j in preds[i]])
+
+    while ready:
+        best = min(ready, key=lambda i: (start(i), -priority[i], i))
+        ready.remove(best)
+        begin = start(best)
+        finish[best] = begin + costs[best]
+        pipe_free[pipes[best]] = finish[best]
+        if pipes[best] == PIPE_SCALAR:
+            issue = finish[best]
+        order.append(best)
+        for s in succs[best]:
+            waiting[s] -= 1
+            if waiting[s] == 0:
+                ready.append(s)
+    return order
+
+
+def _insert_flags(region: List[MockInstruction], preds: List[Set[int]],
+                  pipes: List[int], order: List[int]) -> List[Tuple[str, object]]:
+    """
+    Scheduled region with symbolic flags: ("instr", MockInstruction),
+    ("set", (src, dst)) and ("wait", (src, dst)).
+    """
+    queue_pos: Dict[int, int] = {}
+    queue_len: Dict[int, int] = defaultdict(int)
+    # known[p][q]: last queue position of pipe q that pipe p has synchronized
+    # with, directly or through the flags of another pipe
+    known: Dict[int, Dict[int, int]] = defaultdict(dict)
+    known_after: Dict[int, Dict[int, int]] = {}
+    sets_after: Dict[int, List[int]] = defaultdict(list)
+    waits_before: Dict[int, List[Tuple[int, int]]] = defaultdict(list)
+
+    for i in order:
+        dst = pipes[i]
+        latest: Dict[int, int] = {}  # src pipe -> producer with the latest queue position
+        for j in preds[i]:
+            src = pipes[j]
+            if src in (dst, PIPE_SCALAR):
+                continue  # in-order pipe, or visible before the scalar unit issues i
+            if src not in latest or queue_pos[j] > queue_pos[latest[src]]:
+                latest[src] = j
+        for src, j in sorted(latest.items()):
+            if known[dst].get(src, -1) < queue_pos[j]:
+                sets_after[j].append(dst)
+                waits_before[i].append((src, dst))
+                for pipe, pos in known_after[j].items():
+                    known[dst][pipe] = max(known[dst].get(pipe, -1), pos)
+        queue_pos[i] = queue_len[dst]
+        queue_len[dst] += 1
+        known_after[i] = {**known[dst], dst: queue_pos[i]}
+
+    items: List[Tuple[str, object]] = []
+    for i in order:
+        items.extend(("wait", pair) for pair in waits_before[i])
+        items.append(("instr", region[i]))
+        items.extend(("set", (pipes[i], dst)) for dst in sets_after[i])
+    return items
+
+
+def _assign_events(items: List[Tuple[str, object]], out: List[MockInstruction],
+                   counters: Dict[Tuple[int, int], List[int]]) -> None:
+    """
+    Give flags event ids round-robin per pipe pair. A set that would reuse
+    an event still in flight is deferred until that event has been waited.
+    """
+    deferred: Dict[Tuple[int, int], deque] = defaultdict(deque)
+
+    def emit_set(pair):
+        sets, _ = counters[pair]
+        out.append(MockInstruction(opcode="SET_FLAG", dst="",
+                                   operands=[pair[0], pair[1], sets % EVENT_IDS]))
+        counters[pair][0] += 1
+
+    for kind, payload in items:
+        if kind == "instr":
+            out.append(payload)
+        elif kind == "set":
+            sets, waits = counters[payload]
+            if sets - waits >= EVENT_IDS or deferred[payload]:
+                deferred[payload].append(payload)
+            else:
+                emit_set(payload)
+        else:
+            _, waits = counters[payload]
+            out.append(MockInstruction(opcode="WAIT_FLAG", dst="",
+                                       operands=[payload[0], payload[1], waits % EVENT_IDS]))
+            counters[payload][1] += 1
+            if deferred[payload]:
+                emit_set(deferred[payload].popleft())
+
+
+def simulate_pipes(instructions: List[MockInstruction], is_cube: bool,
+                   cost: Callable[[MockInstruction], int]) -> int:
+    """
+    Cycles of a sequence on the pipe model: the scalar unit issues in
+    order, each pipe runs its queue in order, WAIT_FLAG holds its pipe
+    until the matching SET_FLAG has passed the source pipe, and
+    PIPE_BARRIER or control flow waits for every pipe.
+    """
+    num_pipes = len(CUBE_CORE_PIPES if is_cube else VECTOR_CORE_PIPES)
+    pipe_free = [0] * num_pipes
+    issue = 0
+    flags: Dict[Tuple[int, int, int], deque] = defaultdict(deque)
+    for instr in instructions:
+        op = instr.opcode
+        if op == "SET_FLAG":
+            src, dst, event = instr.operands
+            pipe_free[src] = max(pipe_free[src], issue)
+            flags[(src, dst, event)].append(pipe_free[src])
+        elif op == "WAIT_FLAG":
+            src, dst, event = instr.operands
+            if not flags[(src, dst, event)]:
+                raise ValueError(f"WAIT_FLAG({isa_pipe(src, is_cube)}, "
+                                 f"{isa_pipe(dst, is_cube)}, {event}) without SET_FLAG")
+            pipe_free[dst] = max(pipe_free[dst], issue, flags[(src, dst, event)].popleft())
+            if dst == PIPE_SCALAR:
+                issue = pipe_free[dst]
+        elif op == "PIPE_BARRIER" or op in _REGION_BOUNDARY_OPS:
+            issue = max(pipe_free + [issue]) + (cost(instr) if op != "PIPE_BARRIER" else 0)
+            pipe_free = [issue] * num_pipes
+        else:
+            pipe = target_pipe(op, is_cube)
+            pipe_free[pipe] = max(pipe_free[pipe], issue) + cost(instr)
+            if pipe == PIPE_SCALAR:
+                issue = pipe_free[pipe]
+    return max(pipe_free + [issue])
+
+
+_SCALAR_EVAL = {
+    "SADD": lambda a, b: a + b,
+    "SSUB": lambda a, b: a - b,
+    "SMUL": lambda a, b: a * b,
+    "SDIV": lambda a, b: int(a / b) if isinstance(a, int) and isinstance(b, int) else a / b,
+}
+
+_COMPARE_EVAL = {
+    "eq": lambda a, b: a == b, "ne": lambda a, b: a != b,
+    "lt": lambda a, b: a < b, "le": lambda a, b: a <= b,
+    "gt": lambda a, b: a > b, "ge": lambda a, b: a >= b,
+}
+
+
+def expand_trace(instructions: List[MockInstruction], scalars: Dict[str, float],
+                 max_length: int = 1_000_000) -> List[MockInstruction]:
+    """
+    The instructions one call executes: FOR bodies repeated per iteration,
+    IF/ELSE resolved and scalar ops evaluated, starting from the scalar
+    arguments. FOR, ENDFOR (once per iteration), IF and ENDIF stay in the
+    trace, so simulate_pipes() charges their barriers.
+    """
+    match: Dict[int, Tuple[Optional[int], int]] = {}
+    stack: List[int] = []
+    for i, instr in enumerate(instructions):
+        if instr.opcode in ("FOR", "IF", "IF_BIT"):
+            stack.append(i)
+        elif instr.opcode == "ELSE":
+            match[stack[-1]] = (i, -1)
+        elif instr.opcode in ("ENDFOR", "ENDIF"):
+            start = stack.pop()
+            match[start] = (match.get(start, (None, -1))[0], i)
+
+    env = dict(scalars)
+
+    def value(operand):
+        try:
+            return int(operand)
+        except ValueError:
+            try:
+                return float(operand)
+            except ValueError:
+                if operand not in env:
+                    raise ValueError(f"Scalar {operand} has no value") from None
+                return env[operand]
+
+    trace: List[MockInstruction] = []
+
+    def emit(instr: MockInstruction) -> None:
+        trace.append(instr)
+        if len(trace) > max_length:
+            raise ValueError(f"Trace longer than {max_length} instructions")
+
+    def run(lo: int, hi: int) -> None:
+        i = lo
+        while i < hi:
+            instr = instructions[i]
+            op = instr.opcode
+            if op == "FOR":
+                end = match[i][1]
+                lb, ub = value(instr.operands[0]), value(instr.operands[1])
+                step = value(instr.operands[2]) if len(instr.operands) > 2 else 1
+                emit(instr)
+                iv = lb
+                while iv < ub:
+                    env[instr.dst] = iv
+                    run(i + 1, end)
+                    emit(instructions[end])
+                    iv += step
+                i = end + 1
+            elif op in ("IF", "IF_BIT"):
+                other, end = match[i]
+                taken = value(instr.operands[0])
+                if op == "IF_BIT":
+                    taken = int(taken) & value(instr.operands[1])
+                emit(instr)
+                if taken:
+                    run(i + 1, other if other is not None else end)
+                elif other is not None:
+                    run(other + 1, end)
+                emit(instructions[end])
+                i = end + 1
+            else:
+                if op in ("SLI", "SMOV"):
+                    env[instr.dst] = value(instr.operands[0])
+                elif op in _SCALAR_EVAL:
+                    env[instr.dst] = _SCALAR_EVAL[op](value(instr.operands[0]),
+                                                      value(instr.operands[1]))
+                elif op == "SCMP":
+                    mode = instr.operands[2] if len(instr.operands) > 2 else "eq"
+                    env[instr.dst] = int(_COMPARE_EVAL[mode](value(instr.operands[0]),
+                                                             value(instr.operands[1])))
+                emit(instr)
+                i += 1
+
+    run(0, len(instructions))
+    return trace
+
+
+@dataclass
+class ScheduleResult:
+    """Scheduled instructions (with flags) and the simulated gain."""
+    instructions: List[MockInstruction]
+    cycles_before: int
+    cycles_after: int
+    hoisted_loads: int = 0
+    flag_pairs: int = 0
+    barriers: int = 0
+
+    @property
+    def speedup(self) -> float:
+        return self.cycles_before / self.cycles_after if self.cycles_after else 1.0
+
+    def format(self) -> str:
+        return (f"Instruction schedule: {self.cycles_before} -> {self.cycles_after} "
+                f"simulated cycles ({self.speedup:.2f}x), {self.hoisted_loads} loads hoisted, "
+                f"{self.flag_pairs} SET_FLAG/WAIT_FLAG pairs")
+
+
+def schedule_incore(instructions: List[MockInstruction], is_cube: bool,
+                    cost: Callable[[MockInstruction], int],
+                    aliases: Optional[Dict[str, Set[str]]] = None) -> ScheduleResult:
+    """
+    List-schedule an InCore function and synchronize its pipes with flags.
+
+    Args:
+        instructions: InCore function in program order
+        is_cube: Cube core function (otherwise vector core)
+        cost: Cycles an instruction occupies its pipe
+        aliases: Tiles that share on-chip bytes with a tile
+    """
+    aliases = aliases or {}
+    out: List[MockInstruction] = []
+    hoisted = flag_pairs = 0
+    for region, boundary in _regions(instructions):
+        preds = _dependencies(region, aliases)
+        pipes = [target_pipe(i.opcode, is_cube) for i in region]
+        # The list schedule is a heuristic; keep program order (with flags)
+        # where that simulates faster
+        best = None
+        for order in (_list_schedule(region, preds, pipes, [cost(i) for i in region]),
+                      list(range(len(region)))):
+            # Every flag of a region is waited within it, so event ids restart
+            counters: Dict[Tuple[int, int], List[int]] = defaultdict(lambda: [0, 0])
+            synced: List[MockInstruction] = []
+            _assign_events(_insert_flags(region, preds, pipes, order), synced, counters)
+            cycles = simulate_pipes(synced, is_cube, cost)
+            if best is None or cycles < best[0]:
+                best = (cycles, order, synced, counters)
+        _, order, synced, counters = best
+        rank = {i: r for r, i in enumerate(order)}
+        hoisted += sum(1 for i, instr in enumerate(region) if instr.opcode == "TLOAD" and
+                       any(rank[j] > rank[i] for j in range(i) if region[j].opcode != "TLOAD"))
+        out.extend(synced)
+        flag_pairs += sum(waits for _, waits in counters.values())
+        if boundary is not None:
+            if _needs_barrier(region, is_cube):
+                out.append(_barrier())
+            out.append(boundary)
+
+    before = serialize_incore(instructions, is_cube, aliases)
+    return ScheduleResult(
+        instructions=out,
+        cycles_before=simulate_pipes(before, is_cube, cost),
+        cycles_after=simulate_pipes(out, is_cube, cost),
+        hoisted_loads=hoisted,
+        flag_pairs=flag_pairs,
+        barriers=sum(1 for i in out if i.opcode == "PIPE_BARRIER"),
+    )
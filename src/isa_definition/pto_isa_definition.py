@@ -71,6 +71,9 @@ ARM64_VECTOR_LANES = {
 # Physical_Row_Size: Optimal repeat count for vector pipeline performance
 ARM64_PHYSICAL_ROW_SIZE = 1          # Optimal repeat count for ARM64
 
+# Budget for the tile arenas of one InCore function (stack memory, bytes)
+ARM64_TILE_ARENA_BUDGET = 512 * 1024
+
 # NEON intrinsic suffix mappings
 ARM64_NEON_SUFFIX = {
     "f32": "f32",
@@ -133,11 +136,20 @@ def arm64_get_neon_suffix(dtype: str) -> str:
     return ARM64_NEON_SUFFIX.get(dtype, "f32")
 
 
-def arm64_generate_header() -> str:
-    """Generate standard ARM64 NEON header includes."""
-    return """// Auto-generated ARM64 NEON code from PTO ISA Compiler
-#include <arm_neon.h>
-#include <math.h>
+def arm64_generate_header(simd: str = "neon") -> str:
+    """Generate standard ARM64 NEON header includes (plus arm_sve.h for simd="sve").
+    
+    simd="scalar" code uses no intrinsics and includes neither, so it also
+    builds on other hosts (e.g. for the auto-tuner's CPU benchmark).
+    """
+    if simd == "scalar":
+        simd_includes = ""
+    elif simd == "sve":
+        simd_includes = "#include <arm_neon.h>\n#include <arm_sve.h>\n"
+    else:
+        simd_includes = "#include <arm_neon.h>\n"
+    return f"""// Auto-generated ARM64 NEON code from PTO ISA Compiler
+{simd_includes}#include <math.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -205,6 +217,9 @@ CUDA_INTRINSICS = {
 # Physical_Row_Size: Optimal repeat count for vector pipeline performance
 CUDA_PHYSICAL_ROW_SIZE = 1           # Optimal repeat count for CUDA
 
+# Budget for the tile arenas of one InCore kernel (static shared memory, bytes)
+CUDA_SHARED_MEMORY_BUDGET = 48 * 1024
+
 
 @dataclass
 class CUDACodeGenContext:
@@ -345,6 +360,16 @@ ASCEND_VECTOR_OPS = {
 # Physical_Row_Size: Optimal repeat count for vector pipeline performance
 ASCEND_PHYSICAL_ROW_SIZE = 32         # Optimal repeat count for Ascend A2/A3 pipeline
 
+# On-chip buffer capacity per AI Core (bytes). UB excludes the 8KB at
+# TMP_UB_OFFSET that the pto library reserves for temporaries.
+ASCEND_A2A3_BUFFER_SIZE = {
+    "UB": 184 * 1024,
+    "L1": 512 * 1024,
+    "L0A": 64 * 1024,
+    "L0B": 64 * 1024,
+    "L0C": 128 * 1024,
+}
+
 
 @dataclass
 class AscendCodeGenContext:
@@ -66,6 +66,8 @@
  * 
  *   // ARM64: Single-queue multi-threaded execution
  *   runtime_entry_arm64(orch_func, user_data, num_workers, threshold);
+ *   // ARM64: dispatch tasks as soon as they are ready (lock-free ready ring)
+ *   runtime_entry_arm64(orch_func, user_data, num_workers, PTO_EXECUTION_STREAMING);
  *   
  *   // A2A3: Dual-queue heterogeneous execution
  *   runtime_entry_a2a3(orch_func, user_data, num_vector_workers, num_cube_workers, threshold);
@@ -16,13 +16,13 @@
 // =============================================================================
 
 static void ready_queue_push(PTORuntime* rt, int32_t task_id) {
-    if (rt->ready_count >= PTO_MAX_READY_QUEUE) {
+    if (rt->ready_count >= rt->ready_queue_size) {
         fprintf(stderr, "[PTO Runtime ARM64] ERROR: Ready queue overflow\n");
         return;
     }
     
     rt->ready_queue[rt->ready_tail] = task_id;
-    rt->ready_tail = (rt->ready_tail + 1) % PTO_MAX_READY_QUEUE;
+    rt->ready_tail = (rt->ready_tail + 1) & rt->ready_queue_mask;
     rt->ready_count++;
 }
 
@@ -32,13 +32,120 @@ static int32_t ready_queue_pop(PTORuntime* rt) {
     }
     
     int32_t task_id = rt->ready_queue[rt->ready_head];
-    rt->ready_head = (rt->ready_head + 1) % PTO_MAX_READY_QUEUE;
+    rt->ready_head = (rt->ready_head + 1) & rt->ready_queue_mask;
     rt->ready_count--;
     return task_id;
 }
 
+// =============================================================================
+// ARM64 Streaming Ready Ring (lock-free bounded MPMC)
+// =============================================================================
+// Cell i is free for the producer at position p when its sequence is p and
+// holds a task for the consumer at position p when its sequence is p + 1.
+// ready_seq[i] stores sequence - i, so a zeroed table is the empty ring.
+
+static bool ready_ring_push(PTORuntime* rt, int32_t task_id) {
+    uint32_t pos = __atomic_load_n(&rt->ready_enqueue_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        uint32_t idx = pos & (uint32_t)rt->ready_queue_mask;
+        uint32_t seq = __atomic_load_n(&rt->ready_seq[idx], __ATOMIC_ACQUIRE) + idx;
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&rt->ready_enqueue_pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                rt->ready_queue[idx] = task_id;
+                __atomic_store_n(&rt->ready_seq[idx], pos + 1 - idx, __ATOMIC_RELEASE);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // Full
+        } else {
+            pos = __atomic_load_n(&rt->ready_enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static int32_t ready_ring_pop(PTORuntime* rt) {
+    uint32_t pos = __atomic_load_n(&rt->ready_dequeue_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        uint32_t idx = pos & (uint32_t)rt->ready_queue_mask;
+        uint32_t seq = __atomic_load_n(&rt->ready_seq[idx], __ATOMIC_ACQUIRE) + idx;
+        int32_t diff = (int32_t)(seq - (pos + 1));
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&rt->ready_dequeue_pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                int32_t task_id = rt->ready_queue[idx];
+                __atomic_store_n(&rt->ready_seq[idx], pos + (uint32_t)rt->ready_queue_size - idx,
+                                 __ATOMIC_RELEASE);
+                return task_id;
+            }
+        } else if (diff < 0) {
+            return -1;  // Empty
+        } else {
+            pos = __atomic_load_n(&rt->ready_dequeue_pos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void ready_ring_push_and_wake(PTORuntime* rt, int32_t task_id) {
+    if (!ready_ring_push(rt, task_id)) {
+        fprintf(stderr, "[PTO Runtime ARM64] ERROR: Ready queue overflow\n");
+        return;
+    }
+    // Pairs with the fence in streaming_get_ready_task(): either the parking
+    // worker sees this task, or we see it parked and wake exactly one worker.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&rt->idle_workers, __ATOMIC_RELAXED) > 0) {
+        pthread_mutex_lock(&rt->queue_mutex);
+        pthread_cond_signal(&rt->queue_not_empty);
+        pthread_mutex_unlock(&rt->queue_mutex);
+    }
+}
+
+// total_tasks_scheduled is final once execution_started is published.
+static bool streaming_all_done(PTORuntime* rt) {
+    return __atomic_load_n(&rt->execution_started, __ATOMIC_ACQUIRE) &&
+           __atomic_load_n(&rt->total_tasks_completed, __ATOMIC_ACQUIRE) >= rt->total_tasks_scheduled;
+}
+
+static inline void streaming_cpu_relax(void) {
+#if defined(__aarch64__)
+    __asm__ __volatile__("yield" ::: "memory");
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static int32_t streaming_get_ready_task(PTORuntime* rt) {
+    for (int spin = 0; spin < PTO_STREAMING_SPIN_POLLS; spin++) {
+        int32_t task_id = ready_ring_pop(rt);
+        if (task_id >= 0) return task_id;
+        if (rt->shutdown_requested || streaming_all_done(rt)) return -1;
+        streaming_cpu_relax();
+    }
+
+    // Park. Completion and shutdown broadcast queue_not_empty under queue_mutex,
+    // so the exit conditions are re-checked here without a timeout.
+    pthread_mutex_lock(&rt->queue_mutex);
+    __atomic_add_fetch(&rt->idle_workers, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int32_t task_id = ready_ring_pop(rt);
+    while (task_id < 0 && !rt->shutdown_requested && !streaming_all_done(rt)) {
+        pthread_cond_wait(&rt->queue_not_empty, &rt->queue_mutex);
+        task_id = ready_ring_pop(rt);
+    }
+    __atomic_sub_fetch(&rt->idle_workers, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&rt->queue_mutex);
+    return task_id;
+}
+
 // Thread-safe ready queue push
 static void ready_queue_push_threadsafe(PTORuntime* rt, int32_t task_id) {
+    if (rt->streaming_mode) {
+        ready_ring_push_and_wake(rt, task_id);
+        return;
+    }
+
     DEBUG_PRINT("[Queue] push_threadsafe: trying to lock for task %d\n", task_id);
     fflush(stdout);
     
@@ -47,14 +154,14 @@ static void ready_queue_push_threadsafe(PTORuntime* rt, int32_t task_id) {
     DEBUG_PRINT("[Queue] push_threadsafe: got lock for task %d, ready_count=%d\n", task_id, rt->ready_count);
     fflush(stdout);
     
-    if (rt->ready_count >= PTO_MAX_READY_QUEUE) {
+    if (rt->ready_count >= rt->ready_queue_size) {
         fprintf(stderr, "[PTO Runtime ARM64] ERROR: Ready queue overflow\n");
         pthread_mutex_unlock(&rt->queue_mutex);
         return;
     }
     
     rt->ready_queue[rt->ready_tail] = task_id;
-    rt->ready_tail = (rt->ready_tail + 1) % PTO_MAX_READY_QUEUE;
+    rt->ready_tail = (rt->ready_tail + 1) & rt->ready_queue_mask;
     rt->ready_count++;
     
     // Broadcast to wake up all waiting workers
@@ -79,10 +186,17 @@ void pto_runtime_enable_simulation(PTORuntime* rt, int32_t num_workers) {
 }
 
 int32_t pto_get_ready_task(PTORuntime* rt) {
+    if (rt->streaming_mode) {
+        return ready_ring_pop(rt);
+    }
     return ready_queue_pop(rt);
 }
 
 int32_t pto_get_ready_task_blocking(PTORuntime* rt) {
+    if (rt->streaming_mode) {
+        return streaming_get_ready_task(rt);
+    }
+
     DEBUG_PRINT("[Queue] get_blocking: trying to lock\n");
     fflush(stdout);
     
@@ -137,7 +251,7 @@ int32_t pto_get_ready_task_blocking(PTORuntime* rt) {
     }
     
     int32_t task_id = rt->ready_queue[rt->ready_head];
-    rt->ready_head = (rt->ready_head + 1) % PTO_MAX_READY_QUEUE;
+    rt->ready_head = (rt->ready_head + 1) & rt->ready_queue_mask;
     rt->ready_count--;
     
     pthread_mutex_unlock(&rt->queue_mutex);
@@ -154,10 +268,10 @@ void pto_task_submit(PTORuntime* rt, int32_t task_id) {
         return;
     }
     
-    PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(task_id)];
+    PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(rt, task_id)];
     
     bool ready = pto_task_prepare_submit(rt, task_id);
-    int32_t slot = PTO_TASK_SLOT(task_id);
+    int32_t slot = PTO_TASK_SLOT(rt, task_id);
     int32_t remaining = task->fanin_count - rt->fanin_refcount[slot];
     DEBUG_PRINT("[PTO Runtime ARM64] Submitted task %d: %s (fanin_rem=%d, fanout_cons=%d)\n",
            task_id, task->func_name, remaining, task->fanout_consumer_count);
@@ -185,7 +299,7 @@ void pto_task_complete_threadsafe(PTORuntime* rt, int32_t task_id) {
     
     pthread_mutex_lock(&rt->task_mutex);
     
-    int32_t slot = PTO_TASK_SLOT(task_id);
+    int32_t slot = PTO_TASK_SLOT(rt, task_id);
     PendingTask* task = &rt->pend_task[slot];
 
     // Skip stale or already-complete slots (can happen in pipelined mode)
@@ -197,14 +311,15 @@ void pto_task_complete_threadsafe(PTORuntime* rt, int32_t task_id) {
     task->is_complete = true;
     rt->task_state[slot] = PTO_TASK_COMPLETED;
     rt->active_task_count--;
-    rt->total_tasks_completed++;
+    // Atomic so streaming workers can check for completion without task_mutex.
+    __atomic_add_fetch(&rt->total_tasks_completed, 1, __ATOMIC_RELEASE);
 
     // Notify dependents: increment fanin_refcount, enqueue when ready.
     int32_t off = task->fanout_head;
     int32_t seen = 0;
     while (off != 0 && seen < task->fanout_consumer_count) {
         int32_t consumer_id = rt->dep_list_pool[off].task_id;
-        int32_t cslot = PTO_TASK_SLOT(consumer_id);
+        int32_t cslot = PTO_TASK_SLOT(rt, consumer_id);
         PendingTask* consumer = &rt->pend_task[cslot];
 
         if (consumer->is_active && consumer->task_id == consumer_id) {
@@ -229,7 +344,7 @@ void pto_task_complete_threadsafe(PTORuntime* rt, int32_t task_id) {
     off = task->fanin_head;
     while (off != 0) {
         int32_t producer_id = rt->dep_list_pool[off].task_id;
-        int32_t pslot = PTO_TASK_SLOT(producer_id);
+        int32_t pslot = PTO_TASK_SLOT(rt, producer_id);
         PendingTask* producer = &rt->pend_task[pslot];
 
         if (producer->is_active && producer->task_id == producer_id) {
@@ -272,21 +387,14 @@ void pto_task_complete_threadsafe(PTORuntime* rt, int32_t task_id) {
 typedef void (*InCoreFuncPtr)(void);
 
 static void execute_task_internal(PTORuntime* rt, int32_t task_id, int32_t worker_id) {
-    int32_t slot = PTO_TASK_SLOT(task_id);
+    int32_t slot = PTO_TASK_SLOT(rt, task_id);
     PendingTask* task = &rt->pend_task[slot];
     
     DEBUG_PRINT("[Worker ARM64] Executing task %d: %s\n", task_id, task->func_name);
     
-    // Build argument array from task arguments
-    void* args[PTO_MAX_ARGS * 2];
-    int arg_idx = 0;
-    
-    for (int i = 0; i < task->num_args; i++) {
-        TaskArg* arg = &task->args[i];
-        float* base_ptr = (float*)arg->region.raw_tensor;
-        int64_t offset = arg->region.row_offset * arg->region.cols + arg->region.col_offset;
-        args[arg_idx++] = (void*)(base_ptr + offset);
-    }
+    // Argument pointers were resolved at submit (pto_task_prepare_submit)
+    void* args[PTO_MAX_ARGS];
+    pto_task_load_args(task, args);
     
     // Simulation mode: call cycle function and record trace
     if (rt->simulation_mode && task->cycle_func) {
@@ -336,7 +444,7 @@ void pto_execute_all(PTORuntime* rt) {
             continue;
         }
         
-        PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(task_id)];
+        PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(rt, task_id)];
         
         DEBUG_PRINT("[PTO Runtime ARM64] Executing task %d: %s\n", task_id, task->func_name);
         
@@ -419,12 +527,15 @@ int runtime_entry_arm64(PTOOrchFunc orch_func, void* user_data, int num_workers,
     
     if (num_workers < 1) num_workers = 1;
     if (num_workers > PTO_MAX_WORKERS) num_workers = PTO_MAX_WORKERS;
+    bool streaming = (execution_task_threshold == PTO_EXECUTION_STREAMING);
     if (execution_task_threshold < 0) execution_task_threshold = 0;
     
     printf("[PTO Runtime ARM64] ========================================\n");
     printf("[PTO Runtime ARM64] Multi-threaded Execution\n");
     printf("[PTO Runtime ARM64] Workers: %d\n", num_workers);
-    if (execution_task_threshold > 0) {
+    if (streaming) {
+        printf("[PTO Runtime ARM64] Execution mode: streaming (dispatch on ready)\n");
+    } else if (execution_task_threshold > 0) {
         printf("[PTO Runtime ARM64] Execution threshold: %d tasks (pipelined)\n", execution_task_threshold);
     } else {
         printf("[PTO Runtime ARM64] Execution mode: wait for orchestration\n");
@@ -438,12 +549,18 @@ int runtime_entry_arm64(PTOOrchFunc orch_func, void* user_data, int num_workers,
         return -1;
     }
     
-    // Initialize runtime
+    // Initialize runtime (capacities from PTO_RUNTIME_PRESET, default large)
     pto_runtime_init(rt);
+    if (!rt->table_mem) {
+        fprintf(stderr, "[PTO Runtime ARM64] ERROR: Failed to initialize runtime\n");
+        free(rt);
+        return -1;
+    }
     rt->num_workers = num_workers;
     rt->shutdown_requested = false;
     rt->execution_started = false;
     rt->execution_task_threshold = execution_task_threshold;
+    rt->streaming_mode = streaming;
     
     // Spawn worker threads
     printf("[PTO Runtime ARM64] Spawning %d worker threads...\n", num_workers);
@@ -479,9 +596,11 @@ int runtime_entry_arm64(PTOOrchFunc orch_func, void* user_data, int num_workers,
         fflush(stdout);
     }
     
-    // Give workers a moment to start
-    struct timespec start_delay = {0, 10000000};  // 10ms
-    nanosleep(&start_delay, NULL);
+    // Give workers a moment to start (streaming workers pick up tasks whenever they arrive)
+    if (!streaming) {
+        struct timespec start_delay = {0, 10000000};  // 10ms
+        nanosleep(&start_delay, NULL);
+    }
     printf("[PTO Runtime ARM64] Workers started, now building task graph...\n");
     fflush(stdout);
     
@@ -492,7 +611,7 @@ int runtime_entry_arm64(PTOOrchFunc orch_func, void* user_data, int num_workers,
     
     // Mark that orchestration is complete
     pthread_mutex_lock(&rt->task_mutex);
-    rt->execution_started = true;
+    __atomic_store_n(&rt->execution_started, true, __ATOMIC_RELEASE);
     int64_t total_tasks = rt->total_tasks_scheduled;
     pthread_mutex_unlock(&rt->task_mutex);
     
@@ -505,8 +624,17 @@ int runtime_entry_arm64(PTOOrchFunc orch_func, void* user_data, int num_workers,
     pthread_mutex_unlock(&rt->queue_mutex);
     
     // Wait for all tasks to complete
+    if (streaming) {
+        // The last completion broadcasts all_done under queue_mutex.
+        pthread_mutex_lock(&rt->queue_mutex);
+        while (!streaming_all_done(rt)) {
+            pthread_cond_wait(&rt->all_done, &rt->queue_mutex);
+        }
+        pthread_mutex_unlock(&rt->queue_mutex);
+        printf("[PTO Runtime ARM64] All %lld tasks completed!\n", (long long)rt->total_tasks_completed);
+    }
     struct timespec poll_interval = {0, 1000000};  // 1ms
-    while (1) {
+    while (!streaming) {
         pthread_mutex_lock(&rt->task_mutex);
         bool all_done = (rt->total_tasks_completed >= rt->total_tasks_scheduled);
         int64_t completed = rt->total_tasks_completed;
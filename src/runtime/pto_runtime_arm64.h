@@ -20,6 +20,17 @@
 // ARM64 uses a single unified ready queue (no cube/vector separation)
 // All workers pull from the same queue
 
+// Pass as execution_task_threshold to runtime_entry_arm64() to stream:
+// tasks are dispatched the moment they become ready, overlapping orchestration
+// and execution. The ready queue is then a lock-free ring, and an idle worker
+// is woken only when a task is pushed (no timed polling).
+#define PTO_EXECUTION_STREAMING (-1)
+
+// Empty-queue polls a streaming worker makes before parking on queue_not_empty.
+#ifndef PTO_STREAMING_SPIN_POLLS
+#define PTO_STREAMING_SPIN_POLLS 256
+#endif
+
 // =============================================================================
 // ARM64-Specific API
 // =============================================================================
@@ -45,6 +56,9 @@
  *                                  This enables pipelining task graph building with execution.
  * @return 0 on success, -1 on failure
  */
+// execution_task_threshold: 0 = start after orchestration completes,
+// N > 0 = start once more than N tasks are scheduled,
+// PTO_EXECUTION_STREAMING = dispatch each task as soon as it is ready.
 int runtime_entry_arm64(PTOOrchFunc orch_func, void* user_data, int num_workers, 
                         int execution_task_threshold);
 
@@ -67,6 +81,7 @@ void pto_runtime_enable_simulation(PTORuntime* rt, int32_t num_workers);
 // - pto_task_complete_threadsafe(): Thread-safe version
 // - pto_get_ready_task()        : Pop from single queue
 // - pto_get_ready_task_blocking(): Blocking pop with condition variable
+//                                  (lock-free ring + targeted wakeup when streaming)
 // - pto_loop_replay()           : Replay using single ready queue
 // - pto_execute_all()           : Single-threaded execution
 // - pto_execute_task_with_worker(): Execute task with trace recording
@@ -12,6 +12,15 @@
 
 #include "pto_runtime_common.h"
 #include <time.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
 
 // =============================================================================
 // Global Variables
@@ -19,16 +28,198 @@
 
 CycleTrace* pto_global_trace = NULL;
 
+// =============================================================================
+// Runtime Tables (one lazily touched anonymous mapping)
+// =============================================================================
+
+static size_t pto_page_size(void) {
+    static size_t page = 0;
+    if (page == 0) {
+        long p = sysconf(_SC_PAGESIZE);
+        page = p > 0 ? (size_t)p : 4096;
+    }
+    return page;
+}
+
+static size_t pto_page_align(size_t bytes) {
+    size_t page = pto_page_size();
+    return (bytes + page - 1) & ~(page - 1);
+}
+
+// Returns base + *off (NULL while sizing) and advances *off by whole pages,
+// so every table starts on a page boundary and can be dropped independently.
+static uint8_t* pto_table_carve(uint8_t* base, size_t* off, size_t bytes) {
+    uint8_t* p = base ? base + *off : NULL;
+    *off += pto_page_align(bytes);
+    return p;
+}
+
+// Points every table of rt into base; returns the total mapping size.
+static size_t pto_layout_tables(PTORuntime* rt, uint8_t* base) {
+    size_t off = 0;
+    size_t window = (size_t)rt->task_window_size;
+    size_t queue = (size_t)rt->ready_queue_size;
+
+    rt->pend_task = (PendingTask*)pto_table_carve(base, &off, window * sizeof(PendingTask));
+    rt->dep_list_pool = (DepListEntry*)pto_table_carve(base, &off,
+        (size_t)rt->dep_list_pool_size * sizeof(DepListEntry));
+    rt->tensor_map.buckets = (int32_t*)pto_table_carve(base, &off, (size_t)rt->tensormap_size * sizeof(int32_t));
+    rt->tensor_map.entry_pool = (TensorMapEntry*)pto_table_carve(base, &off,
+        (size_t)rt->tensormap_pool_size * sizeof(TensorMapEntry));
+    rt->tensor_map.task_entry_head = (int32_t*)pto_table_carve(base, &off, window * sizeof(int32_t));
+    rt->fanin_refcount = (int32_t*)pto_table_carve(base, &off, window * sizeof(int32_t));
+    rt->fanout_refcount = (int32_t*)pto_table_carve(base, &off, window * sizeof(int32_t));
+    rt->task_state = (uint8_t*)pto_table_carve(base, &off, window * sizeof(uint8_t));
+    rt->ready_queue = (int32_t*)pto_table_carve(base, &off, queue * sizeof(int32_t));
+    rt->ready_seq = (uint32_t*)pto_table_carve(base, &off, queue * sizeof(uint32_t));
+    rt->vector_ready_queue = (int32_t*)pto_table_carve(base, &off, queue * sizeof(int32_t));
+    rt->cube_ready_queue = (int32_t*)pto_table_carve(base, &off, queue * sizeof(int32_t));
+    rt->scope_stack = (int32_t*)pto_table_carve(base, &off, (size_t)rt->max_scope_depth * sizeof(int32_t));
+    rt->func_registry = (void**)pto_table_carve(base, &off, (size_t)rt->max_incore_funcs * sizeof(void*));
+    rt->heap_base = rt->heap_size > 0 ? pto_table_carve(base, &off, (size_t)rt->heap_size) : NULL;
+    return off;
+}
+
+// Zeroes a table. Whole pages of the private anonymous mapping are dropped
+// instead of written, so reset does not touch (or keep resident) unused pages.
+static void pto_table_zero(void* ptr, size_t bytes) {
+#if defined(__linux__) && defined(MADV_DONTNEED)
+    uintptr_t begin = (uintptr_t)ptr;
+    uintptr_t end = begin + bytes;
+    uintptr_t page_begin = (uintptr_t)pto_page_align((size_t)begin);
+    uintptr_t page_end = end & ~(uintptr_t)(pto_page_size() - 1);
+    if (page_end > page_begin &&
+        madvise((void*)page_begin, page_end - page_begin, MADV_DONTNEED) == 0) {
+        memset(ptr, 0, page_begin - begin);
+        memset((void*)page_end, 0, end - page_end);
+        return;
+    }
+#endif
+    memset(ptr, 0, bytes);
+}
+
+// Restores every table to its initial state. A fresh mapping is already zero,
+// so only the tables whose empty value is -1 are written.
+static void pto_clear_tables(PTORuntime* rt, bool fresh) {
+    size_t window = (size_t)rt->task_window_size;
+    if (!fresh) {
+        pto_table_zero(rt->pend_task, window * sizeof(PendingTask));
+        pto_table_zero(rt->dep_list_pool, (size_t)rt->dep_list_pool_size * sizeof(DepListEntry));
+        pto_table_zero(rt->tensor_map.entry_pool, (size_t)rt->tensormap_pool_size * sizeof(TensorMapEntry));
+        pto_table_zero(rt->fanin_refcount, window * sizeof(int32_t));
+        pto_table_zero(rt->fanout_refcount, window * sizeof(int32_t));
+        pto_table_zero(rt->task_state, window * sizeof(uint8_t));  // PTO_TASK_PENDING
+        pto_table_zero(rt->ready_seq, (size_t)rt->ready_queue_size * sizeof(uint32_t));
+    }
+    memset(rt->tensor_map.buckets, 0xff, (size_t)rt->tensormap_size * sizeof(int32_t));  // -1
+    memset(rt->tensor_map.task_entry_head, 0xff, window * sizeof(int32_t));               // -1
+    rt->tensor_map.pool_head = 0;
+    rt->tensor_map.last_task_alive = 0;
+
+    rt->ready_enqueue_pos = 0;
+    rt->ready_dequeue_pos = 0;
+    rt->idle_workers = 0;
+}
+
+static bool pto_is_pow2(int32_t v) {
+    return v > 0 && (v & (v - 1)) == 0;
+}
+
+PTORuntimeConfig pto_runtime_config_preset(PTORuntimePreset preset) {
+    PTORuntimeConfig cfg;
+    int32_t window;
+    switch (preset) {
+        case PTO_RUNTIME_PRESET_SMALL:
+            window = 1024;
+            cfg.heap_size_bytes = 64 * 1024 * 1024;
+            cfg.ready_queue_size = 4096;
+            break;
+        case PTO_RUNTIME_PRESET_MEDIUM:
+            window = 4096;
+            cfg.heap_size_bytes = 256 * 1024 * 1024;
+            cfg.ready_queue_size = 16384;
+            break;
+        case PTO_RUNTIME_PRESET_LARGE:
+        default:
+            window = PTO_TASK_WINDOW_SIZE;
+            cfg.heap_size_bytes = PTO_HEAP_SIZE_BYTES;
+            cfg.ready_queue_size = PTO_MAX_READY_QUEUE;
+            break;
+    }
+    cfg.task_window_size = window;
+    cfg.tensormap_size = window;
+    cfg.tensormap_pool_size = window * (PTO_TENSORMAP_POOL_SIZE / PTO_TASK_WINDOW_SIZE);
+    cfg.dep_list_pool_size = window * (PTO_DEP_LIST_POOL_SIZE / PTO_TASK_WINDOW_SIZE);
+    cfg.max_scope_depth = PTO_MAX_SCOPE_DEPTH;
+    cfg.max_incore_funcs = PTO_MAX_INCORE_FUNCS;
+    return cfg;
+}
+
+static PTORuntimePreset pto_preset_from_env(void) {
+    const char* name = getenv("PTO_RUNTIME_PRESET");
+    if (!name || !*name) return PTO_RUNTIME_PRESET_LARGE;
+    if (strcmp(name, "small") == 0) return PTO_RUNTIME_PRESET_SMALL;
+    if (strcmp(name, "medium") == 0) return PTO_RUNTIME_PRESET_MEDIUM;
+    if (strcmp(name, "large") != 0) {
+        fprintf(stderr, "[PTO Runtime] WARNING: unknown PTO_RUNTIME_PRESET '%s', using large\n", name);
+    }
+    return PTO_RUNTIME_PRESET_LARGE;
+}
+
 // =============================================================================
 // Runtime Initialization (Platform Independent Parts)
 // =============================================================================
 
 void pto_runtime_init(PTORuntime* rt) {
     if (!rt) return;
+    PTORuntimeConfig cfg = pto_runtime_config_preset(pto_preset_from_env());
+    // Callers of pto_runtime_init() have no error path; do not let them
+    // continue on unmapped tables.
+    if (!pto_runtime_init_with_config(rt, &cfg)) {
+        fprintf(stderr, "[PTO Runtime] FATAL: runtime initialization failed\n");
+        abort();
+    }
+}
+
+bool pto_runtime_init_with_config(PTORuntime* rt, const PTORuntimeConfig* config) {
+    if (!rt || !config) return false;
+    memset(rt, 0, sizeof(*rt));
+
+    if (!pto_is_pow2(config->task_window_size) || !pto_is_pow2(config->tensormap_size) ||
+        !pto_is_pow2(config->ready_queue_size) || config->tensormap_pool_size < 1 ||
+        config->dep_list_pool_size < 2 || config->heap_size_bytes < 0 ||
+        config->max_scope_depth < 1 || config->max_incore_funcs < 1) {
+        fprintf(stderr, "[PTO Runtime] ERROR: invalid runtime config (window=%d, tensormap=%d, ready_queue=%d "
+                "must be powers of 2; dep_list_pool=%d must be >= 2)\n",
+                config->task_window_size, config->tensormap_size, config->ready_queue_size,
+                config->dep_list_pool_size);
+        return false;
+    }
+    rt->task_window_size = config->task_window_size;
+    rt->task_window_mask = config->task_window_size - 1;
+    rt->tensormap_size = config->tensormap_size;
+    rt->tensormap_pool_size = config->tensormap_pool_size;
+    rt->dep_list_pool_size = config->dep_list_pool_size;
+    rt->ready_queue_size = config->ready_queue_size;
+    rt->ready_queue_mask = config->ready_queue_size - 1;
+    rt->max_scope_depth = config->max_scope_depth;
+    rt->max_incore_funcs = config->max_incore_funcs;
+    rt->heap_size = config->heap_size_bytes;
+
+    // Reserve the tables; pages are zero-filled by the kernel on first touch.
+    size_t bytes = pto_layout_tables(rt, NULL);
+    void* mem = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mem == MAP_FAILED) {
+        fprintf(stderr, "[PTO Runtime] ERROR: Failed to map %zu bytes of runtime tables\n", bytes);
+        pto_layout_tables(rt, NULL);
+        return false;
+    }
+    rt->table_mem = (uint8_t*)mem;
+    rt->table_mem_bytes = bytes;
+    pto_layout_tables(rt, rt->table_mem);
+    pto_clear_tables(rt, true);
     
     // Initialize task table (sliding window)
-    memset(rt->pend_task, 0, sizeof(rt->pend_task));
-    
     rt->next_task_id = 0;
     rt->active_task_count = 0;
     
@@ -38,54 +229,20 @@ void pto_runtime_init(PTORuntime* rt) {
     rt->runtime_mode = PTO_MODE_BENCHMARK_ONLY;  // Default: no window check
     
     // Initialize dependency list pool
-    memset(rt->dep_list_pool, 0, sizeof(rt->dep_list_pool));
     rt->dep_list_top = 1;   // 0 reserved as NULL
     rt->dep_list_tail = 1;
 
-    // Initialize TensorMap
-    for (int i = 0; i < PTO_TENSORMAP_SIZE; i++) {
-        rt->tensor_map.buckets[i] = -1;
-    }
-    for (int i = 0; i < PTO_TASK_WINDOW_SIZE; i++) {
-        rt->tensor_map.task_entry_head[i] = -1;
-        rt->fanin_refcount[i] = 0;
-        rt->fanout_refcount[i] = 0;
-        rt->task_state[i] = PTO_TASK_PENDING;
-    }
-    for (int i = 0; i < PTO_TENSORMAP_POOL_SIZE; i++) {
-        rt->tensor_map.entry_pool[i].in_bucket = false;
-        rt->tensor_map.entry_pool[i].next_in_bucket = -1;
-        rt->tensor_map.entry_pool[i].next_in_task = -1;
-        rt->tensor_map.entry_pool[i].producer_task_id = -1;
-        memset(&rt->tensor_map.entry_pool[i].region, 0, sizeof(TensorRegion));
-    }
-    rt->tensor_map.pool_head = 0;
-    rt->tensor_map.last_task_alive = 0;
-
     // Initialize packed output heap ring (host/sim)
-    rt->heap_size = PTO_HEAP_SIZE_BYTES;
     rt->heap_top = 0;
     rt->heap_tail = 0;
-    rt->heap_base = (uint8_t*)aligned_alloc(64, (size_t)rt->heap_size);
-    if (rt->heap_base) {
-        memset(rt->heap_base, 0, (size_t)rt->heap_size);
-    } else {
-        rt->heap_base = (uint8_t*)calloc(1, (size_t)rt->heap_size);
-    }
     
-    // Initialize legacy ready queue
-    memset(rt->ready_queue, 0, sizeof(rt->ready_queue));
+    // Initialize ready queues
     rt->ready_head = 0;
     rt->ready_tail = 0;
     rt->ready_count = 0;
-    
-    // Initialize dual ready queues (for a2a3_sim mode)
-    memset(rt->vector_ready_queue, 0, sizeof(rt->vector_ready_queue));
     rt->vector_ready_head = 0;
     rt->vector_ready_tail = 0;
     rt->vector_ready_count = 0;
-    
-    memset(rt->cube_ready_queue, 0, sizeof(rt->cube_ready_queue));
     rt->cube_ready_head = 0;
     rt->cube_ready_tail = 0;
     rt->cube_ready_count = 0;
@@ -94,9 +251,6 @@ void pto_runtime_init(PTORuntime* rt) {
     rt->total_tasks_scheduled = 0;
     rt->total_tasks_completed = 0;
     
-    // Initialize flow control statistics
-    memset(&rt->flow_stats, 0, sizeof(rt->flow_stats));
-    
     // Initialize thread synchronization primitives
     pthread_mutex_init(&rt->queue_mutex, NULL);
     pthread_mutex_init(&rt->task_mutex, NULL);
@@ -121,14 +275,14 @@ void pto_runtime_init(PTORuntime* rt) {
     rt->execution_task_threshold = 0;
     rt->simulation_mode = false;
     rt->dual_queue_mode = false;
-    memset(rt->workers, 0, sizeof(rt->workers));
-    memset(rt->func_registry, 0, sizeof(rt->func_registry));
+    rt->streaming_mode = false;
 
     // Initialize scope stack
     rt->scope_stack_top = -1;
     
-    DEBUG_PRINT("[PTO Runtime] Initialized (window_size=%d, tensormap_size=%d)\n",
-           PTO_TASK_WINDOW_SIZE, PTO_TENSORMAP_SIZE);
+    DEBUG_PRINT("[PTO Runtime] Initialized (window_size=%d, tensormap_size=%d, tables=%zu MB reserved)\n",
+           rt->task_window_size, rt->tensormap_size, bytes >> 20);
+    return true;
 }
 
 void pto_runtime_shutdown(PTORuntime* rt) {
@@ -137,10 +291,12 @@ void pto_runtime_shutdown(PTORuntime* rt) {
     // Cleanup core simulator (if used)
     pto_cleanup_core_sim();
     
-    // Free packed output heap
-    if (rt->heap_base) {
-        free(rt->heap_base);
-        rt->heap_base = NULL;
+    // Unmap all tables, including the packed output heap
+    if (rt->table_mem) {
+        munmap(rt->table_mem, rt->table_mem_bytes);
+        rt->table_mem = NULL;
+        rt->table_mem_bytes = 0;
+        pto_layout_tables(rt, NULL);
     }
     
     // Destroy thread synchronization primitives
@@ -175,41 +331,19 @@ bool pto_runtime_was_aborted(PTORuntime* rt) {
 }
 
 void pto_runtime_reset(PTORuntime* rt) {
-    if (!rt) return;
+    if (!rt || !rt->table_mem) return;
     
-    // Clear task table
-    memset(rt->pend_task, 0, sizeof(rt->pend_task));
+    // Clear task table, dependency list pool, tensor map and scheduler state
+    pto_clear_tables(rt, false);
     
     rt->next_task_id = 0;
     rt->active_task_count = 0;
     rt->last_task_alive = 0;
     rt->window_aborted = false;
     
-    // Clear dependency list pool
-    memset(rt->dep_list_pool, 0, sizeof(rt->dep_list_pool));
     rt->dep_list_top = 1;
     rt->dep_list_tail = 1;
 
-    // Clear tensor map
-    for (int i = 0; i < PTO_TENSORMAP_SIZE; i++) {
-        rt->tensor_map.buckets[i] = -1;
-    }
-    for (int i = 0; i < PTO_TENSORMAP_POOL_SIZE; i++) {
-        rt->tensor_map.entry_pool[i].in_bucket = false;
-        rt->tensor_map.entry_pool[i].next_in_bucket = -1;
-        rt->tensor_map.entry_pool[i].next_in_task = -1;
-        rt->tensor_map.entry_pool[i].producer_task_id = -1;
-        memset(&rt->tensor_map.entry_pool[i].region, 0, sizeof(TensorRegion));
-    }
-    rt->tensor_map.pool_head = 0;
-    rt->tensor_map.last_task_alive = 0;
-    for (int i = 0; i < PTO_TASK_WINDOW_SIZE; i++) {
-        rt->tensor_map.task_entry_head[i] = -1;
-        rt->fanin_refcount[i] = 0;
-        rt->fanout_refcount[i] = 0;
-        rt->task_state[i] = PTO_TASK_PENDING;
-    }
-
     // Reset heap ring pointers
     rt->heap_top = 0;
     rt->heap_tail = 0;
@@ -238,6 +372,95 @@ void pto_runtime_reset(PTORuntime* rt) {
     DEBUG_PRINT("[PTO Runtime] Reset complete\n");
 }
 
+// =============================================================================
+// Runtime Footprint Report
+// =============================================================================
+
+// Bytes of [ptr, ptr + bytes) currently resident (-1 if unknown).
+static int64_t pto_resident_bytes(const void* ptr, size_t bytes) {
+    if (!ptr || bytes == 0) return 0;
+#if defined(__linux__) || defined(__APPLE__)
+    size_t page = pto_page_size();
+    size_t pages = pto_page_align(bytes) / page;
+#if defined(__APPLE__)
+    char* vec = (char*)malloc(pages);
+#else
+    unsigned char* vec = (unsigned char*)malloc(pages);
+#endif
+    if (!vec) return -1;
+    int64_t resident = -1;
+    if (mincore((void*)ptr, pages * page, vec) == 0) {
+        resident = 0;
+        for (size_t i = 0; i < pages; i++) {
+            if (vec[i] & 1) resident += (int64_t)page;
+        }
+    }
+    free(vec);
+    return resident;
+#else
+    (void)ptr;
+    (void)bytes;
+    return -1;
+#endif
+}
+
+void pto_runtime_print_footprint(PTORuntime* rt) {
+    if (!rt || !rt->table_mem) return;
+    size_t window = (size_t)rt->task_window_size;
+    size_t queue = (size_t)rt->ready_queue_size;
+    struct {
+        const char* name;
+        const void* base;
+        size_t bytes;
+        int64_t entries;
+    } tables[] = {
+        {"Task window",        rt->pend_task,                  window * sizeof(PendingTask),  rt->task_window_size},
+        {"DepList pool",       rt->dep_list_pool,
+            (size_t)rt->dep_list_pool_size * sizeof(DepListEntry), rt->dep_list_pool_size},
+        {"TensorMap buckets",  rt->tensor_map.buckets,
+            (size_t)rt->tensormap_size * sizeof(int32_t), rt->tensormap_size},
+        {"TensorMap pool",     rt->tensor_map.entry_pool,
+            (size_t)rt->tensormap_pool_size * sizeof(TensorMapEntry), rt->tensormap_pool_size},
+        {"TensorMap task heads", rt->tensor_map.task_entry_head, window * sizeof(int32_t), rt->task_window_size},
+        {"Fanin refcounts",    rt->fanin_refcount,             window * sizeof(int32_t),      rt->task_window_size},
+        {"Fanout refcounts",   rt->fanout_refcount,            window * sizeof(int32_t),      rt->task_window_size},
+        {"Task states",        rt->task_state,                 window * sizeof(uint8_t),      rt->task_window_size},
+        {"Ready queue",        rt->ready_queue,                queue * sizeof(int32_t),       rt->ready_queue_size},
+        {"Ready ring seq",     rt->ready_seq,                  queue * sizeof(uint32_t),      rt->ready_queue_size},
+        {"Vector ready queue", rt->vector_ready_queue,         queue * sizeof(int32_t),       rt->ready_queue_size},
+        {"Cube ready queue",   rt->cube_ready_queue,           queue * sizeof(int32_t),       rt->ready_queue_size},
+        {"Scope stack",        rt->scope_stack,
+            (size_t)rt->max_scope_depth * sizeof(int32_t), rt->max_scope_depth},
+        {"Function registry",  rt->func_registry,
+            (size_t)rt->max_incore_funcs * sizeof(void*), rt->max_incore_funcs},
+        {"Packed output heap", rt->heap_base,                  (size_t)rt->heap_size,         rt->heap_size},
+    };
+
+    printf("\n[PTO Runtime Footprint]\n");
+    printf("  %-22s %12s %14s %14s\n", "Table", "Entries", "Reserved KB", "Resident KB");
+    int64_t total_resident = 0;
+    bool resident_known = true;
+    for (size_t i = 0; i < sizeof(tables) / sizeof(tables[0]); i++) {
+        int64_t resident = pto_resident_bytes(tables[i].base, tables[i].bytes);
+        if (resident < 0) {
+            resident_known = false;
+            printf("  %-22s %12lld %14zu %14s\n", tables[i].name, (long long)tables[i].entries,
+                   pto_page_align(tables[i].bytes) >> 10, "n/a");
+        } else {
+            total_resident += resident;
+            printf("  %-22s %12lld %14zu %14lld\n", tables[i].name, (long long)tables[i].entries,
+                   pto_page_align(tables[i].bytes) >> 10, (long long)(resident >> 10));
+        }
+    }
+    if (resident_known) {
+        printf("  %-22s %12s %14zu %14lld\n", "Total", "", rt->table_mem_bytes >> 10,
+               (long long)(total_resident >> 10));
+    } else {
+        printf("  %-22s %12s %14zu %14s\n", "Total", "", rt->table_mem_bytes >> 10, "n/a");
+    }
+    printf("  struct PTORuntime:     %zu KB\n\n", sizeof(PTORuntime) >> 10);
+}
+
 void pto_runtime_stats(PTORuntime* rt) {
     printf("\n[PTO Runtime Statistics]\n");
     printf("  Total tasks scheduled: %lld\n", (long long)rt->total_tasks_scheduled);
@@ -259,7 +482,7 @@ void pto_runtime_stats(PTORuntime* rt) {
 //   overwriting to avoid corrupting chains.
 // =============================================================================
 
-uint32_t pto_tensormap_hash(TensorRegion* region) {
+uint32_t pto_tensormap_hash(PTORuntime* rt, TensorRegion* region) {
     uint64_t ptr_val = (uint64_t)region->raw_tensor;
     uint64_t h = ptr_val;
     h ^= (uint64_t)region->row_offset * 0x9E3779B97F4A7C15ULL;
@@ -268,7 +491,7 @@ uint32_t pto_tensormap_hash(TensorRegion* region) {
     h ^= h >> 33;
     h *= 0xFF51AFD7ED558CCDULL;
     h ^= h >> 33;
-    return (uint32_t)h & (PTO_TENSORMAP_SIZE - 1);
+    return (uint32_t)h & (uint32_t)(rt->tensormap_size - 1);
 }
 
 bool pto_region_match(TensorRegion* a, TensorRegion* b) {
@@ -286,7 +509,7 @@ static inline bool pto_tensormap_entry_valid(PTORuntime* rt, TensorMapEntry* ent
 static void pto_tensormap_remove_from_bucket(PTORuntime* rt, int32_t entry_offset) {
     TensorMap* tm = &rt->tensor_map;
     TensorMapEntry* entry = &tm->entry_pool[entry_offset];
-    uint32_t bucket = pto_tensormap_hash(&entry->region);
+    uint32_t bucket = pto_tensormap_hash(rt, &entry->region);
 
     int32_t* prev_ptr = &tm->buckets[bucket];
     int32_t cur = *prev_ptr;
@@ -308,7 +531,7 @@ static void pto_tensormap_remove_from_bucket(PTORuntime* rt, int32_t entry_offse
 int32_t pto_tensormap_lookup(PTORuntime* rt, TensorRegion* region) {
     TensorMap* tm = &rt->tensor_map;
     tm->last_task_alive = rt->last_task_alive;
-    uint32_t bucket = pto_tensormap_hash(region);
+    uint32_t bucket = pto_tensormap_hash(rt, region);
 
     int32_t* prev_ptr = &tm->buckets[bucket];
     int32_t offset = *prev_ptr;
@@ -378,7 +601,7 @@ void pto_tensormap_insert(PTORuntime* rt, TensorRegion* region, int32_t task_id)
         }
     }
     
-    tm->pool_head = (tm->pool_head + 1) % PTO_TENSORMAP_POOL_SIZE;
+    tm->pool_head = (tm->pool_head + 1) % rt->tensormap_pool_size;
 
     if (entry->in_bucket) {
         pto_tensormap_remove_from_bucket(rt, entry_offset);
@@ -387,12 +610,12 @@ void pto_tensormap_insert(PTORuntime* rt, TensorRegion* region, int32_t task_id)
     entry->region = *region;
     entry->producer_task_id = task_id;
 
-    uint32_t bucket = pto_tensormap_hash(region);
+    uint32_t bucket = pto_tensormap_hash(rt, region);
     entry->next_in_bucket = tm->buckets[bucket];
     tm->buckets[bucket] = entry_offset;
     entry->in_bucket = true;
 
-    int32_t task_slot = PTO_TASK_SLOT(task_id);
+    int32_t task_slot = PTO_TASK_SLOT(rt, task_id);
     entry->next_in_task = tm->task_entry_head[task_slot];
     tm->task_entry_head[task_slot] = entry_offset;
     
@@ -405,19 +628,9 @@ void pto_tensormap_insert(PTORuntime* rt, TensorRegion* region, int32_t task_id)
 
 void pto_tensormap_clear(PTORuntime* rt) {
     TensorMap* tm = &rt->tensor_map;
-    for (int i = 0; i < PTO_TENSORMAP_SIZE; i++) {
-        tm->buckets[i] = -1;
-    }
-    for (int i = 0; i < PTO_TASK_WINDOW_SIZE; i++) {
-        tm->task_entry_head[i] = -1;
-    }
-    for (int i = 0; i < PTO_TENSORMAP_POOL_SIZE; i++) {
-        tm->entry_pool[i].in_bucket = false;
-        tm->entry_pool[i].next_in_bucket = -1;
-        tm->entry_pool[i].next_in_task = -1;
-        tm->entry_pool[i].producer_task_id = -1;
-        memset(&tm->entry_pool[i].region, 0, sizeof(TensorRegion));
-    }
+    memset(tm->buckets, 0xff, (size_t)rt->tensormap_size * sizeof(int32_t));             // -1
+    memset(tm->task_entry_head, 0xff, (size_t)rt->task_window_size * sizeof(int32_t));   // -1
+    pto_table_zero(tm->entry_pool, (size_t)rt->tensormap_pool_size * sizeof(TensorMapEntry));
     tm->pool_head = 0;
     tm->last_task_alive = rt->last_task_alive;
 }
@@ -445,14 +658,14 @@ static inline void pto_task_fanout_unlock(PendingTask* task) {
     __atomic_store_n(&task->fanout_lock, 0, __ATOMIC_RELEASE);
 }
 
-static inline int32_t pto_dep_list_next(int32_t off) {
+static inline int32_t pto_dep_list_next(PTORuntime* rt, int32_t off) {
     off++;
-    if (off >= PTO_DEP_LIST_POOL_SIZE) return 1;
+    if (off >= rt->dep_list_pool_size) return 1;
     return off;
 }
 
 static int32_t pto_dep_list_alloc_one_locked(PTORuntime* rt) {
-    int32_t next = pto_dep_list_next(rt->dep_list_top);
+    int32_t next = pto_dep_list_next(rt, rt->dep_list_top);
     if (next == rt->dep_list_tail) {
         // Pool full: stall in execute/simulate; abort in dump/benchmark.
         if (rt->runtime_mode == PTO_MODE_EXECUTE || rt->runtime_mode == PTO_MODE_SIMULATE) {
@@ -465,7 +678,7 @@ static int32_t pto_dep_list_alloc_one_locked(PTORuntime* rt) {
             
             while (next == rt->dep_list_tail) {
                 pthread_cond_wait(&rt->deplist_not_full, &rt->task_mutex);
-                next = pto_dep_list_next(rt->dep_list_top);
+                next = pto_dep_list_next(rt, rt->dep_list_top);
             }
             
             rt->flow_stats.deplist_pool_stall_ns += pto_get_time_ns() - stall_start;
@@ -484,7 +697,7 @@ static int32_t pto_dep_list_alloc_one_locked(PTORuntime* rt) {
     // Update high water mark
     int32_t current_usage = (rt->dep_list_top >= rt->dep_list_tail) 
         ? (rt->dep_list_top - rt->dep_list_tail)
-        : (PTO_DEP_LIST_POOL_SIZE - rt->dep_list_tail + rt->dep_list_top);
+        : (rt->dep_list_pool_size - rt->dep_list_tail + rt->dep_list_top);
     if (current_usage > rt->flow_stats.deplist_pool_hwm) {
         rt->flow_stats.deplist_pool_hwm = current_usage;
     }
@@ -583,7 +796,7 @@ static void* pto_heap_alloc_locked(PTORuntime* rt, int32_t size_bytes) {
 }
 
 bool pto_try_mark_consumed_locked(PTORuntime* rt, int32_t task_id) {
-    int32_t slot = PTO_TASK_SLOT(task_id);
+    int32_t slot = PTO_TASK_SLOT(rt, task_id);
     PendingTask* task = &rt->pend_task[slot];
     if (!task->is_active || task->task_id != task_id) return false;
     if (task->is_consumed) return false;
@@ -604,7 +817,7 @@ bool pto_advance_last_task_alive_locked(PTORuntime* rt) {
     bool advanced = false;
     while (rt->last_task_alive < rt->next_task_id) {
         int32_t tid = rt->last_task_alive;
-        int32_t slot = PTO_TASK_SLOT(tid);
+        int32_t slot = PTO_TASK_SLOT(rt, tid);
         PendingTask* task = &rt->pend_task[slot];
         if (!task->is_active || task->task_id != tid || !task->is_consumed) {
             break;
@@ -635,7 +848,7 @@ bool pto_advance_last_task_alive_locked(PTORuntime* rt) {
 
 void pto_scope_begin(PTORuntime* rt) {
     if (!rt) return;
-    if (rt->scope_stack_top >= (int32_t)(sizeof(rt->scope_stack) / sizeof(rt->scope_stack[0])) - 1) {
+    if (rt->scope_stack_top >= rt->max_scope_depth - 1) {
         fprintf(stderr, "[PTO Runtime] ERROR: scope stack overflow\n");
         return;
     }
@@ -660,7 +873,7 @@ void pto_scope_end(PTORuntime* rt) {
     int32_t end = rt->next_task_id;
 
     for (int32_t task_id = begin; task_id < end; task_id++) {
-        int32_t slot = PTO_TASK_SLOT(task_id);
+        int32_t slot = PTO_TASK_SLOT(rt, task_id);
         PendingTask* task = &rt->pend_task[slot];
         if (!task->is_active || task->task_id != task_id) continue;
 
@@ -685,7 +898,7 @@ int32_t pto_task_alloc_impl(PTORuntime* rt, const char* func_name, void* func_pt
     // Check if window is full
     int32_t tasks_in_flight = rt->next_task_id - rt->last_task_alive;
     
-    if (tasks_in_flight >= PTO_TASK_WINDOW_SIZE) {
+    if (tasks_in_flight >= rt->task_window_size) {
         // Window is full - behavior depends on runtime mode
         switch (rt->runtime_mode) {
             case PTO_MODE_BENCHMARK_ONLY:
@@ -693,7 +906,7 @@ int32_t pto_task_alloc_impl(PTORuntime* rt, const char* func_name, void* func_pt
                 // Since no tasks actually complete, last_task_alive stays at 0,
                 // causing TensorMap to grow unboundedly. By advancing it here, we allow
                 // stale entries to be reclaimed, keeping TensorMap size bounded.
-                rt->last_task_alive = rt->next_task_id - (PTO_TASK_WINDOW_SIZE / 2);
+                rt->last_task_alive = rt->next_task_id - (rt->task_window_size / 2);
                 rt->tensor_map.last_task_alive = rt->last_task_alive;
                 break;
                 
@@ -702,7 +915,7 @@ int32_t pto_task_alloc_impl(PTORuntime* rt, const char* func_name, void* func_pt
                 if (!rt->window_aborted) {
                     rt->window_aborted = true;
                     fprintf(stderr, "[PTO Runtime] Window full (size=%d), aborting orchestration for dump/graph\n",
-                            PTO_TASK_WINDOW_SIZE);
+                            rt->task_window_size);
                 }
                 return -1;
                 
@@ -717,7 +930,7 @@ int32_t pto_task_alloc_impl(PTORuntime* rt, const char* func_name, void* func_pt
                        rt->last_task_alive, rt->next_task_id);
                 
                 pthread_mutex_lock(&rt->task_mutex);
-                while ((rt->next_task_id - rt->last_task_alive) >= PTO_TASK_WINDOW_SIZE) {
+                while ((rt->next_task_id - rt->last_task_alive) >= rt->task_window_size) {
                     pthread_cond_wait(&rt->window_not_full, &rt->task_mutex);
                 }
                 pthread_mutex_unlock(&rt->task_mutex);
@@ -736,13 +949,14 @@ int32_t pto_task_alloc_impl(PTORuntime* rt, const char* func_name, void* func_pt
     
     // Allocate task ID and get slot in window
     int32_t task_id = rt->next_task_id++;
-    int32_t slot = PTO_TASK_SLOT(task_id);
+    int32_t slot = PTO_TASK_SLOT(rt, task_id);
     PendingTask* task = &rt->pend_task[slot];
     
     // Initialize task
     task->task_id = task_id;
     task->func_name = func_name;
     task->func_ptr = func_ptr;
+    task->func_id = -1;
     task->cycle_func = NULL;  // Set via pto_task_set_cycle_func if needed
     task->num_args = 0;
     task->num_outputs = 0;
@@ -787,18 +1001,26 @@ int32_t pto_task_alloc_impl(PTORuntime* rt, const char* func_name, void* func_pt
 
 void pto_task_set_cycle_func(PTORuntime* rt, int32_t task_id, CycleCostFunc cycle_func) {
     if (!rt || task_id < 0 || task_id >= rt->next_task_id) return;
-    rt->pend_task[PTO_TASK_SLOT(task_id)].cycle_func = cycle_func;
+    rt->pend_task[PTO_TASK_SLOT(rt, task_id)].cycle_func = cycle_func;
 }
 
 void pto_task_add_input(PTORuntime* rt, int32_t task_id,
                         void* tensor, int64_t row_off, int64_t col_off,
                         int64_t rows, int64_t cols) {
+    pto_task_add_input_ex(rt, task_id, tensor, row_off, col_off, rows, cols,
+                          (int32_t)sizeof(float), 0);
+}
+
+void pto_task_add_input_ex(PTORuntime* rt, int32_t task_id,
+                           void* tensor, int64_t row_off, int64_t col_off,
+                           int64_t rows, int64_t cols,
+                           int32_t elem_size, int64_t row_stride) {
     if (task_id < 0 || task_id >= rt->next_task_id) {
         fprintf(stderr, "[PTO Runtime] ERROR: Invalid task_id %d\n", task_id);
         return;
     }
     
-    PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(task_id)];
+    PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(rt, task_id)];
     
     if (task->num_args >= PTO_MAX_ARGS) {
         fprintf(stderr, "[PTO Runtime] ERROR: Too many arguments for task %d\n", task_id);
@@ -811,7 +1033,9 @@ void pto_task_add_input(PTORuntime* rt, int32_t task_id,
         .row_offset = row_off,
         .col_offset = col_off,
         .rows = rows,
-        .cols = cols
+        .cols = cols,
+        .row_stride = row_stride,
+        .elem_size = elem_size
     };
     
     // Add argument
@@ -825,7 +1049,7 @@ void pto_task_add_input(PTORuntime* rt, int32_t task_id,
     int32_t producer_id = pto_tensormap_lookup(rt, &region);
 
     if (producer_id >= 0 && producer_id != task_id) {
-        PendingTask* producer = &rt->pend_task[PTO_TASK_SLOT(producer_id)];
+        PendingTask* producer = &rt->pend_task[PTO_TASK_SLOT(rt, producer_id)];
         if (!producer->is_active || producer->task_id != producer_id || producer->is_consumed) {
             // Should be filtered by TensorMap validity, but guard anyway.
             producer_id = -1;
@@ -843,7 +1067,7 @@ void pto_task_add_input(PTORuntime* rt, int32_t task_id,
         }
 
         // Add this task to producer's fanout list and increment total refcount
-        PendingTask* producer = &rt->pend_task[PTO_TASK_SLOT(producer_id)];
+        PendingTask* producer = &rt->pend_task[PTO_TASK_SLOT(rt, producer_id)];
         int32_t fanout_node = pto_dep_list_alloc_one_locked(rt);
         if (fanout_node != 0) {
             rt->dep_list_pool[fanout_node].task_id = task_id;
@@ -856,7 +1080,7 @@ void pto_task_add_input(PTORuntime* rt, int32_t task_id,
         }
 
         // If producer already complete, dependency is immediately satisfied.
-        int32_t task_slot = PTO_TASK_SLOT(task_id);
+        int32_t task_slot = PTO_TASK_SLOT(rt, task_id);
         if (producer->is_complete) {
             rt->fanin_refcount[task_slot]++;
         }
@@ -874,12 +1098,20 @@ void pto_task_add_input(PTORuntime* rt, int32_t task_id,
 void pto_task_add_output(PTORuntime* rt, int32_t task_id,
                          void* tensor, int64_t row_off, int64_t col_off,
                          int64_t rows, int64_t cols) {
+    pto_task_add_output_ex(rt, task_id, tensor, row_off, col_off, rows, cols,
+                           (int32_t)sizeof(float), 0);
+}
+
+void pto_task_add_output_ex(PTORuntime* rt, int32_t task_id,
+                            void* tensor, int64_t row_off, int64_t col_off,
+                            int64_t rows, int64_t cols,
+                            int32_t elem_size, int64_t row_stride) {
     if (task_id < 0 || task_id >= rt->next_task_id) {
         fprintf(stderr, "[PTO Runtime] ERROR: Invalid task_id %d\n", task_id);
         return;
     }
     
-    PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(task_id)];
+    PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(rt, task_id)];
     
     if (task->num_args >= PTO_MAX_ARGS) {
         fprintf(stderr, "[PTO Runtime] ERROR: Too many arguments for task %d\n", task_id);
@@ -892,7 +1124,9 @@ void pto_task_add_output(PTORuntime* rt, int32_t task_id,
         .row_offset = row_off,
         .col_offset = col_off,
         .rows = rows,
-        .cols = cols
+        .cols = cols,
+        .row_stride = row_stride,
+        .elem_size = elem_size
     };
     
     // Add argument
@@ -914,6 +1148,13 @@ void pto_task_add_output(PTORuntime* rt, int32_t task_id,
 void pto_task_add_output_ref(PTORuntime* rt, int32_t task_id,
                              void** tensor_ref, int64_t row_off, int64_t col_off,
                              int64_t rows, int64_t cols) {
+    pto_task_add_output_ref_ex(rt, task_id, tensor_ref, row_off, col_off, rows, cols,
+                               (int32_t)sizeof(float));
+}
+
+void pto_task_add_output_ref_ex(PTORuntime* rt, int32_t task_id,
+                                void** tensor_ref, int64_t row_off, int64_t col_off,
+                                int64_t rows, int64_t cols, int32_t elem_size) {
     if (task_id < 0 || task_id >= rt->next_task_id) {
         fprintf(stderr, "[PTO Runtime] ERROR: Invalid task_id %d\n", task_id);
         return;
@@ -924,7 +1165,7 @@ void pto_task_add_output_ref(PTORuntime* rt, int32_t task_id,
         return;
     }
     
-    PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(task_id)];
+    PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(rt, task_id)];
     
     if (task->num_args >= PTO_MAX_ARGS) {
         fprintf(stderr, "[PTO Runtime] ERROR: Too many arguments for task %d\n", task_id);
@@ -938,7 +1179,9 @@ void pto_task_add_output_ref(PTORuntime* rt, int32_t task_id,
         .row_offset = row_off,
         .col_offset = col_off,
         .rows = rows,
-        .cols = cols
+        .cols = cols,
+        .row_stride = 0,        // Packed allocation is dense
+        .elem_size = elem_size
     };
     
     // Add argument
@@ -964,7 +1207,7 @@ bool pto_task_prepare_submit(PTORuntime* rt, int32_t task_id) {
     if (!rt || task_id < 0 || task_id >= rt->next_task_id) return false;
 
     pthread_mutex_lock(&rt->task_mutex);
-    int32_t slot = PTO_TASK_SLOT(task_id);
+    int32_t slot = PTO_TASK_SLOT(rt, task_id);
     PendingTask* task = &rt->pend_task[slot];
     if (!task->is_active || task->task_id != task_id) {
         pthread_mutex_unlock(&rt->task_mutex);
@@ -989,7 +1232,7 @@ bool pto_task_prepare_submit(PTORuntime* rt, int32_t task_id) {
                 pthread_mutex_unlock(&rt->task_mutex);
                 return false;
             }
-            int64_t bytes = arg->region.rows * arg->region.cols * (int64_t)sizeof(float);
+            int64_t bytes = arg->region.rows * arg->region.cols * pto_region_elem_size(&arg->region);
             bytes = pto_align_up_i32((int32_t)bytes, 64);
             total_bytes += bytes;
             needs_alloc++;
@@ -1012,7 +1255,7 @@ bool pto_task_prepare_submit(PTORuntime* rt, int32_t task_id) {
             int arg_idx = task->output_arg_index[i];
             TaskArg* arg = &task->args[arg_idx];
             if (arg->region.raw_tensor == NULL) {
-                int32_t bytes = (int32_t)(arg->region.rows * arg->region.cols * (int64_t)sizeof(float));
+                int32_t bytes = (int32_t)(arg->region.rows * arg->region.cols * pto_region_elem_size(&arg->region));
                 bytes = pto_align_up_i32(bytes, 64);
                 void* allocated_addr = (uint8_t*)base + off;
                 arg->region.raw_tensor = allocated_addr;
@@ -1031,6 +1274,11 @@ bool pto_task_prepare_submit(PTORuntime* rt, int32_t task_id) {
         }
     }
 
+    // Resolve kernel argument pointers once so workers only copy them out.
+    for (int i = 0; i < task->num_args; i++) {
+        task->arg_ptrs[i] = pto_region_address(&task->args[i].region);
+    }
+
     // Register outputs in TensorMap
     for (int i = 0; i < task->num_outputs; i++) {
         int arg_idx = task->output_arg_index[i];
@@ -1060,23 +1308,33 @@ bool pto_task_prepare_submit(PTORuntime* rt, int32_t task_id) {
 // Cycle Trace Recording Implementation (Platform Independent)
 // =============================================================================
 
-void pto_trace_init(int32_t num_workers) {
-    if (pto_global_trace) {
-        free(pto_global_trace);
+static void pto_trace_free_chunks(CycleTrace* trace) {
+    for (int w = 0; w < PTO_MAX_WORKERS; w++) {
+        CycleTraceChunk* chunk = trace->workers[w].head;
+        while (chunk) {
+            CycleTraceChunk* next = chunk->next;
+            free(chunk);
+            chunk = next;
+        }
     }
+}
+
+void pto_trace_init(int32_t num_workers) {
+    pto_trace_cleanup();
     pto_global_trace = (CycleTrace*)calloc(1, sizeof(CycleTrace));
     if (!pto_global_trace) return;
     
-    pto_global_trace->count = 0;
+    pthread_mutex_init(&pto_global_trace->func_mutex, NULL);
+    PTONameIndex* index = &pto_global_trace->func_index;
+    index->slots = pto_global_trace->func_slots;
+    index->size = PTO_TRACE_MAX_FUNCS;
+    index->names = pto_global_trace->func_names[0];
+    index->name_stride = PTO_MAX_FUNC_NAME_LEN;
+    index->name_len = PTO_MAX_FUNC_NAME_LEN - 1;
     pto_global_trace->num_workers = num_workers > 0 ? num_workers : 1;
     pto_global_trace->num_vector_workers = 0;
     pto_global_trace->num_cube_workers = 0;
     pto_global_trace->enabled = true;
-    
-    // Initialize per-worker cycle counters
-    for (int i = 0; i < PTO_MAX_WORKERS; i++) {
-        pto_global_trace->per_worker_cycle[i] = 0;
-    }
 }
 
 void pto_trace_init_dual(int32_t num_vector_workers, int32_t num_cube_workers) {
@@ -1088,71 +1346,184 @@ void pto_trace_init_dual(int32_t num_vector_workers, int32_t num_cube_workers) {
     }
 }
 
+/**
+ * Map a function name to a small id. Lookups of known names are lock-free;
+ * only the first occurrence of a name takes func_mutex.
+ * Returns -1 when the table is full.
+ */
+static int32_t pto_trace_intern(CycleTrace* trace, const char* name) {
+    PTONameIndex* index = &trace->func_index;
+    uint32_t hash = pto_name_hash(name, index->name_len);
+    int32_t id = pto_name_index_find(index, name, hash, NULL);
+    if (id >= 0) return id;
+
+    pthread_mutex_lock(&trace->func_mutex);
+    uint32_t slot = index->size;
+    id = pto_name_index_find(index, name, hash, &slot);  // Another worker may have won
+    if (id < 0 && slot < index->size) {
+        id = trace->num_funcs++;
+        strncpy(trace->func_names[id], name, PTO_MAX_FUNC_NAME_LEN - 1);
+        trace->func_names[id][PTO_MAX_FUNC_NAME_LEN - 1] = '\0';
+        pto_name_index_publish(index, slot, hash, id);
+    }
+    pthread_mutex_unlock(&trace->func_mutex);
+    return id;
+}
+
+const char* pto_trace_func_name(int32_t func_id) {
+    if (!pto_global_trace || func_id < 0 || func_id >= pto_global_trace->num_funcs) {
+        return "unknown";
+    }
+    return pto_global_trace->func_names[func_id];
+}
+
+/**
+ * func_id of a name recorded by worker w. Call sites pass the same literal
+ * every time, so the name pointer is cached per worker and the hash lookup
+ * runs once per call site; the string compare keeps a reused buffer correct.
+ */
+static int32_t pto_trace_func_id(CycleTraceWorker* w, const char* name) {
+    uintptr_t p = (uintptr_t)name;
+    CycleTraceNameCache* c = &w->name_cache[(p ^ (p >> 4)) & (PTO_TRACE_NAME_CACHE - 1)];
+    if (c->name == name && c->func_id >= 0 &&
+        strncmp(pto_global_trace->func_names[c->func_id], name, PTO_MAX_FUNC_NAME_LEN - 1) == 0) {
+        return c->func_id;
+    }
+    c->name = name;
+    c->func_id = pto_trace_intern(pto_global_trace, name);
+    return c->func_id;
+}
+
+static void pto_trace_append(int32_t worker_id, const char* func_name,
+                             int64_t start_cycle, int64_t end_cycle) {
+    CycleTraceWorker* w = &pto_global_trace->workers[worker_id];
+    CycleTraceChunk* chunk = w->tail;
+    if (!chunk || chunk->count == PTO_TRACE_CHUNK_ENTRIES) {
+        chunk = (CycleTraceChunk*)malloc(sizeof(CycleTraceChunk));
+        if (!chunk) return;
+        chunk->next = NULL;
+        chunk->count = 0;
+        if (w->tail) {
+            w->tail->next = chunk;
+        } else {
+            w->head = chunk;
+        }
+        w->tail = chunk;
+    }
+
+    CycleTraceEntry* entry = &chunk->entries[chunk->count++];
+    entry->func_id = pto_trace_func_id(w, func_name ? func_name : "unknown");
+    entry->worker_id = worker_id;
+    entry->start_cycle = start_cycle;
+    entry->end_cycle = end_cycle;
+    w->count++;
+
+    // Update worker cycle counter to the end of this task
+    w->cycle = end_cycle;
+}
+
 void pto_trace_record(int32_t worker_id, const char* func_name, int64_t cycle_cost) {
     if (!pto_global_trace || !pto_global_trace->enabled) return;
-    if (pto_global_trace->count >= PTO_MAX_TRACE_ENTRIES) return;
     if (worker_id < 0 || worker_id >= PTO_MAX_WORKERS) return;
     
-    int idx = pto_global_trace->count++;
-    CycleTraceEntry* entry = &pto_global_trace->entries[idx];
-    
-    // Copy function name
-    strncpy(entry->func_name, func_name ? func_name : "unknown", PTO_MAX_FUNC_NAME_LEN - 1);
-    entry->func_name[PTO_MAX_FUNC_NAME_LEN - 1] = '\0';
-    
-    entry->worker_id = worker_id;
-    entry->start_cycle = pto_global_trace->per_worker_cycle[worker_id];
-    entry->end_cycle = entry->start_cycle + cycle_cost;
-    
-    // Update worker cycle counter
-    pto_global_trace->per_worker_cycle[worker_id] = entry->end_cycle;
+    int64_t start = pto_global_trace->workers[worker_id].cycle;
+    pto_trace_append(worker_id, func_name, start, start + cycle_cost);
 }
 
 void pto_trace_record_with_time(int32_t worker_id, const char* func_name, 
                                  int64_t start_cycle, int64_t end_cycle) {
     if (!pto_global_trace || !pto_global_trace->enabled) return;
-    if (pto_global_trace->count >= PTO_MAX_TRACE_ENTRIES) return;
     if (worker_id < 0 || worker_id >= PTO_MAX_WORKERS) return;
     
-    int idx = pto_global_trace->count++;
-    CycleTraceEntry* entry = &pto_global_trace->entries[idx];
-    
-    // Copy function name
-    strncpy(entry->func_name, func_name ? func_name : "unknown", PTO_MAX_FUNC_NAME_LEN - 1);
-    entry->func_name[PTO_MAX_FUNC_NAME_LEN - 1] = '\0';
-    
-    entry->worker_id = worker_id;
-    entry->start_cycle = start_cycle;
-    entry->end_cycle = end_cycle;
-    
-    // Update worker cycle counter to the end of this task
-    pto_global_trace->per_worker_cycle[worker_id] = end_cycle;
+    pto_trace_append(worker_id, func_name, start_cycle, end_cycle);
 }
 
 int64_t pto_trace_get_cycle(int32_t worker_id) {
     if (!pto_global_trace) return 0;
     if (worker_id < 0 || worker_id >= PTO_MAX_WORKERS) return 0;
-    return pto_global_trace->per_worker_cycle[worker_id];
+    return pto_global_trace->workers[worker_id].cycle;
+}
+
+int64_t pto_trace_entry_count(void) {
+    if (!pto_global_trace) return 0;
+    int64_t total = 0;
+    for (int w = 0; w < PTO_MAX_WORKERS; w++) {
+        total += pto_global_trace->workers[w].count;
+    }
+    return total;
 }
 
 void pto_trace_cleanup(void) {
     if (pto_global_trace) {
+        pto_trace_free_chunks(pto_global_trace);
+        pthread_mutex_destroy(&pto_global_trace->func_mutex);
         free(pto_global_trace);
         pto_global_trace = NULL;
     }
 }
 
+/**
+ * Read cursor over one worker's chunk list (for merging)
+ */
+typedef struct {
+    CycleTraceChunk* chunk;
+    int32_t index;
+} PTOTraceCursor;
+
+static CycleTraceEntry* pto_trace_cursor_peek(PTOTraceCursor* c) {
+    while (c->chunk && c->index >= c->chunk->count) {
+        c->chunk = c->chunk->next;
+        c->index = 0;
+    }
+    return c->chunk ? &c->chunk->entries[c->index] : NULL;
+}
+
+/**
+ * Min-heap of cursors keyed by (start_cycle, worker_id) of their next entry.
+ */
+typedef struct {
+    PTOTraceCursor* cursor;
+    CycleTraceEntry* head;
+} PTOTraceHeapItem;
+
+static bool pto_trace_heap_less(const PTOTraceHeapItem* a, const PTOTraceHeapItem* b) {
+    if (a->head->start_cycle != b->head->start_cycle) {
+        return a->head->start_cycle < b->head->start_cycle;
+    }
+    return a->head->worker_id < b->head->worker_id;
+}
+
+static void pto_trace_heap_sift_down(PTOTraceHeapItem* heap, int n, int i) {
+    for (;;) {
+        int smallest = i;
+        int l = 2 * i + 1;
+        int r = l + 1;
+        if (l < n && pto_trace_heap_less(&heap[l], &heap[smallest])) smallest = l;
+        if (r < n && pto_trace_heap_less(&heap[r], &heap[smallest])) smallest = r;
+        if (smallest == i) return;
+        PTOTraceHeapItem tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
 char* pto_trace_to_chrome_json(void) {
     if (!pto_global_trace) return NULL;
     
     int32_t num_vec = pto_global_trace->num_vector_workers;
     int32_t num_cube = pto_global_trace->num_cube_workers;
     bool dual_mode = (num_vec > 0 && num_cube > 0);
+    int64_t total = pto_trace_entry_count();
     
-    // Estimate output size (generous allocation)
-    // Add extra space for thread name metadata if dual mode
+    // Size the buffer from the longest interned name
+    size_t max_name = 16;
+    for (int32_t i = 0; i < pto_global_trace->num_funcs; i++) {
+        size_t len = strlen(pto_trace_func_name(i));
+        if (len > max_name) max_name = len;
+    }
     size_t metadata_size = dual_mode ? (num_vec + num_cube) * 128 : 0;
-    size_t buf_size = 2048 + pto_global_trace->count * 256 + metadata_size;
+    size_t buf_size = 2048 + (size_t)total * (160 + max_name) + metadata_size;
     char* buf = (char*)malloc(buf_size);
     if (!buf) return NULL;
     
@@ -1178,8 +1549,35 @@ char* pto_trace_to_chrome_json(void) {
                        "\"args\": {\"name\": \"Cube Workers (%d)\"}},\n", num_cube);
     }
     
-    for (int i = 0; i < pto_global_trace->count; i++) {
-        CycleTraceEntry* e = &pto_global_trace->entries[i];
+    // Merge the per-worker buffers in start-cycle order: each worker's own
+    // entries are already in the order it executed them, so a k-way merge
+    // over a heap of worker cursors takes O(entries * log(workers)).
+    PTOTraceCursor cursors[PTO_MAX_WORKERS];
+    PTOTraceHeapItem heap[PTO_MAX_WORKERS];
+    int heap_size = 0;
+    for (int w = 0; w < PTO_MAX_WORKERS; w++) {
+        if (pto_global_trace->workers[w].count > 0) {
+            PTOTraceCursor* c = &cursors[heap_size];
+            c->chunk = pto_global_trace->workers[w].head;
+            c->index = 0;
+            heap[heap_size].cursor = c;
+            heap[heap_size].head = pto_trace_cursor_peek(c);
+            if (heap[heap_size].head) heap_size++;
+        }
+    }
+    for (int i = heap_size / 2 - 1; i >= 0; i--) {
+        pto_trace_heap_sift_down(heap, heap_size, i);
+    }
+    
+    for (int64_t i = 0; i < total && heap_size > 0; i++) {
+        CycleTraceEntry* e = heap[0].head;
+        heap[0].cursor->index++;
+        heap[0].head = pto_trace_cursor_peek(heap[0].cursor);
+        if (!heap[0].head) {
+            heap[0] = heap[--heap_size];  // Worker exhausted
+        }
+        pto_trace_heap_sift_down(heap, heap_size, 0);
+        
         int64_t duration = e->end_cycle - e->start_cycle;
         
         // Determine pid and tid based on worker type
@@ -1195,11 +1593,11 @@ char* pto_trace_to_chrome_json(void) {
         // Chrome Tracing format (duration event)
         ptr += sprintf(ptr, "    {\"name\": \"%s\", \"cat\": \"task\", \"ph\": \"X\", "
                        "\"ts\": %lld, \"dur\": %lld, \"pid\": %d, \"tid\": %d}%s\n",
-                       e->func_name,
+                       pto_trace_func_name(e->func_id),
                        (long long)(e->start_cycle),     // timestamp in microseconds (we use cycles)
                        (long long)duration,              // duration
                        pid, tid,
-                       (i < pto_global_trace->count - 1) ? "," : "");
+                       (i < total - 1) ? "," : "");
     }
     
     ptr += sprintf(ptr, "  ],\n");
@@ -1210,7 +1608,7 @@ char* pto_trace_to_chrome_json(void) {
         ptr += sprintf(ptr, "    \"num_vector_workers\": %d,\n", num_vec);
         ptr += sprintf(ptr, "    \"num_cube_workers\": %d,\n", num_cube);
     }
-    ptr += sprintf(ptr, "    \"total_entries\": %d\n", pto_global_trace->count);
+    ptr += sprintf(ptr, "    \"total_entries\": %lld\n", (long long)total);
     ptr += sprintf(ptr, "  }\n");
     ptr += sprintf(ptr, "}\n");
     
@@ -1246,54 +1644,48 @@ void pto_trace_print_summary(void) {
     }
     
     printf("\n=== Cycle Trace Summary ===\n");
-    printf("Total entries: %d\n", pto_global_trace->count);
+    printf("Total entries: %lld\n", (long long)pto_trace_entry_count());
     printf("Num workers: %d\n", pto_global_trace->num_workers);
     
     // Per-worker statistics
     int64_t max_cycle = 0;
     for (int w = 0; w < pto_global_trace->num_workers; w++) {
-        int64_t cycle = pto_global_trace->per_worker_cycle[w];
+        int64_t cycle = pto_global_trace->workers[w].cycle;
         printf("  Worker %d: %lld cycles\n", w, (long long)cycle);
         if (cycle > max_cycle) max_cycle = cycle;
     }
     printf("Max cycle (makespan): %lld\n", (long long)max_cycle);
     
-    // Function breakdown
+    // Function breakdown (indexed by interned func_id)
     printf("\nFunction breakdown:\n");
     
-    // Simple aggregation (could be made more efficient with hash table)
-    typedef struct { char name[PTO_MAX_FUNC_NAME_LEN]; int64_t total_cycles; int count; } FuncStats;
-    FuncStats stats[100];
-    int num_stats = 0;
+    int32_t num_funcs = pto_global_trace->num_funcs;
+    int64_t* total_cycles = (int64_t*)calloc((size_t)num_funcs + 1, sizeof(int64_t));
+    int64_t* calls = (int64_t*)calloc((size_t)num_funcs + 1, sizeof(int64_t));
+    if (!total_cycles || !calls) {
+        free(total_cycles);
+        free(calls);
+        return;
+    }
     
-    for (int i = 0; i < pto_global_trace->count; i++) {
-        CycleTraceEntry* e = &pto_global_trace->entries[i];
-        int64_t dur = e->end_cycle - e->start_cycle;
-        
-        // Find or create entry
-        int found = -1;
-        for (int s = 0; s < num_stats; s++) {
-            if (strcmp(stats[s].name, e->func_name) == 0) {
-                found = s;
-                break;
+    for (int w = 0; w < PTO_MAX_WORKERS; w++) {
+        for (CycleTraceChunk* c = pto_global_trace->workers[w].head; c; c = c->next) {
+            for (int32_t i = 0; i < c->count; i++) {
+                CycleTraceEntry* e = &c->entries[i];
+                int32_t id = e->func_id >= 0 ? e->func_id : num_funcs;  // Overflow bucket
+                total_cycles[id] += e->end_cycle - e->start_cycle;
+                calls[id]++;
             }
         }
-        
-        if (found >= 0) {
-            stats[found].total_cycles += dur;
-            stats[found].count++;
-        } else if (num_stats < 100) {
-            strncpy(stats[num_stats].name, e->func_name, PTO_MAX_FUNC_NAME_LEN - 1);
-            stats[num_stats].total_cycles = dur;
-            stats[num_stats].count = 1;
-            num_stats++;
-        }
     }
     
-    for (int s = 0; s < num_stats; s++) {
-        printf("  %s: %lld cycles (%d calls)\n", 
-               stats[s].name, (long long)stats[s].total_cycles, stats[s].count);
+    for (int32_t f = 0; f <= num_funcs; f++) {
+        if (calls[f] == 0) continue;
+        printf("  %s: %lld cycles (%lld calls)\n", pto_trace_func_name(f),
+               (long long)total_cycles[f], (long long)calls[f]);
     }
+    free(total_cycles);
+    free(calls);
     printf("===========================\n\n");
 }
 
@@ -1327,26 +1719,26 @@ int pto_runtime_dump(PTORuntime* rt, const char* filename) {
     
     // Task Table - only dump tasks within current window
     fprintf(fp, "================================================================================\n");
-    fprintf(fp, "TASK TABLE (sliding window, size=%d)\n", PTO_TASK_WINDOW_SIZE);
+    fprintf(fp, "TASK TABLE (sliding window, size=%d)\n", rt->task_window_size);
     fprintf(fp, "================================================================================\n\n");
     
     // Determine dump range (limited by window)
     int32_t dump_start = rt->last_task_alive;
     int32_t dump_end = rt->next_task_id;
     int32_t dump_count = dump_end - dump_start;
-    if (dump_count > PTO_TASK_WINDOW_SIZE) {
-        dump_count = PTO_TASK_WINDOW_SIZE;
-        dump_start = dump_end - PTO_TASK_WINDOW_SIZE;
+    if (dump_count > rt->task_window_size) {
+        dump_count = rt->task_window_size;
+        dump_start = dump_end - rt->task_window_size;
     }
     
     fprintf(fp, "  Window: tasks %d to %d (%d tasks)\n\n", dump_start, dump_end - 1, dump_count);
     
     for (int32_t i = dump_start; i < dump_end; i++) {
-        PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(i)];
+        PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(rt, i)];
         if (!task->is_active || task->task_id != i) continue;
         
         fprintf(fp, "--------------------------------------------------------------------------------\n");
-        fprintf(fp, "TASK %d (slot %d)\n", task->task_id, PTO_TASK_SLOT(i));
+        fprintf(fp, "TASK %d (slot %d)\n", task->task_id, PTO_TASK_SLOT(rt, i));
         fprintf(fp, "--------------------------------------------------------------------------------\n");
         fprintf(fp, "  Function:     %s\n", task->func_name ? task->func_name : "(null)");
         fprintf(fp, "  Func Ptr:     %p\n", task->func_ptr);
@@ -1375,7 +1767,7 @@ int pto_runtime_dump(PTORuntime* rt, const char* filename) {
         fprintf(fp, "  FANIN COUNTER\n");
         fprintf(fp, "  -------------\n");
         {
-            int32_t slot = PTO_TASK_SLOT(i);
+            int32_t slot = PTO_TASK_SLOT(rt, i);
             fprintf(fp, "    fanin_count     = %d\n", task->fanin_count);
             fprintf(fp, "    fanin_refcount  = %d\n", rt->fanin_refcount[slot]);
             fprintf(fp, "    fanin_remaining = %d\n", task->fanin_count - rt->fanin_refcount[slot]);
@@ -1386,7 +1778,7 @@ int pto_runtime_dump(PTORuntime* rt, const char* filename) {
         fprintf(fp, "  FANOUT LIST (consumers that depend on this task)\n");
         fprintf(fp, "  ------------------------------------------------\n");
         {
-            int32_t slot = PTO_TASK_SLOT(i);
+            int32_t slot = PTO_TASK_SLOT(rt, i);
             fprintf(fp, "    fanout_total      = %d\n", task->fanout_count);
             fprintf(fp, "    fanout_consumers  = %d\n", task->fanout_consumer_count);
             fprintf(fp, "    fanout_refcount   = %d\n", rt->fanout_refcount[slot]);
@@ -1395,7 +1787,7 @@ int pto_runtime_dump(PTORuntime* rt, const char* filename) {
             int32_t shown = 0;
             while (off != 0 && shown < task->fanout_consumer_count) {
                 int32_t consumer_id = rt->dep_list_pool[off].task_id;
-                PendingTask* consumer = &rt->pend_task[PTO_TASK_SLOT(consumer_id)];
+                PendingTask* consumer = &rt->pend_task[PTO_TASK_SLOT(rt, consumer_id)];
                 fprintf(fp, "      -> Task %d (%s)\n", consumer_id,
                         (consumer->is_active && consumer->func_name) ? consumer->func_name : "(null)");
                 off = rt->dep_list_pool[off].next_offset;
@@ -1435,7 +1827,7 @@ int pto_runtime_dump(PTORuntime* rt, const char* filename) {
         for (int i = 0; i < rt->ready_count; i++) {
             fprintf(fp, "%d", rt->ready_queue[idx]);
             if (i < rt->ready_count - 1) fprintf(fp, ", ");
-            idx = (idx + 1) % PTO_MAX_READY_QUEUE;
+            idx = (idx + 1) % rt->ready_queue_size;
         }
         fprintf(fp, "]\n");
     } else {
@@ -1448,7 +1840,7 @@ int pto_runtime_dump(PTORuntime* rt, const char* filename) {
     fprintf(fp, "TENSOR MAP (non-empty buckets)\n");
     fprintf(fp, "================================================================================\n\n");
     int tensor_count = 0;
-    for (int i = 0; i < PTO_TENSORMAP_SIZE; i++) {
+    for (int i = 0; i < rt->tensormap_size; i++) {
         int32_t off = rt->tensor_map.buckets[i];
         while (off >= 0) {
             TensorMapEntry* entry = &rt->tensor_map.entry_pool[off];
@@ -1477,11 +1869,11 @@ int pto_runtime_dump(PTORuntime* rt, const char* filename) {
     fprintf(fp, "DEPENDENCY GRAPH (Producer -> Consumer)\n");
     fprintf(fp, "================================================================================\n\n");
     for (int32_t i = dump_start; i < dump_end; i++) {
-        PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(i)];
+        PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(rt, i)];
         if (!task->is_active || task->task_id != i) continue;
         
         // Status indicator
-        int32_t slot = PTO_TASK_SLOT(i);
+        int32_t slot = PTO_TASK_SLOT(rt, i);
         const char* status = (rt->task_state[slot] == PTO_TASK_CONSUMED) ? "[CONSUMED]" :
                              (rt->task_state[slot] == PTO_TASK_COMPLETED) ? "[DONE]" :
                              (rt->task_state[slot] == PTO_TASK_READY) ? "[READY]" :
@@ -1494,7 +1886,7 @@ int pto_runtime_dump(PTORuntime* rt, const char* filename) {
         int32_t shown = 0;
         while (off != 0 && shown < task->fanout_consumer_count) {
             int32_t consumer_id = rt->dep_list_pool[off].task_id;
-            PendingTask* consumer = &rt->pend_task[PTO_TASK_SLOT(consumer_id)];
+            PendingTask* consumer = &rt->pend_task[PTO_TASK_SLOT(rt, consumer_id)];
             fprintf(fp, "    └──> Task %d (%s)\n", consumer_id,
                     (consumer->is_active && consumer->func_name) ? consumer->func_name : "?");
             off = rt->dep_list_pool[off].next_offset;
@@ -1533,17 +1925,17 @@ int pto_runtime_dump_stdout(PTORuntime* rt) {
     int32_t dump_start = rt->last_task_alive;
     int32_t dump_end = rt->next_task_id;
     int32_t dump_count = dump_end - dump_start;
-    if (dump_count > PTO_TASK_WINDOW_SIZE) {
-        dump_count = PTO_TASK_WINDOW_SIZE;
-        dump_start = dump_end - PTO_TASK_WINDOW_SIZE;
+    if (dump_count > rt->task_window_size) {
+        dump_count = rt->task_window_size;
+        dump_start = dump_end - rt->task_window_size;
     }
     
     printf("TASK TABLE (window: %d to %d, %d tasks)\n", dump_start, dump_end - 1, dump_count);
     printf("--------------------------------------------------------------------------------\n");
     for (int32_t i = dump_start; i < dump_end; i++) {
-        PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(i)];
+        PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(rt, i)];
         if (!task->is_active || task->task_id != i) continue;
-        int32_t slot = PTO_TASK_SLOT(i);
+        int32_t slot = PTO_TASK_SLOT(rt, i);
         const char* status = (rt->task_state[slot] == PTO_TASK_CONSUMED) ? "CONSUMED" :
                              (rt->task_state[slot] == PTO_TASK_COMPLETED) ? "DONE" :
                              (rt->task_state[slot] == PTO_TASK_READY) ? "READY" :
@@ -1718,11 +2110,11 @@ void pto_simulate_all(PTORuntime* rt) {
     int32_t sim_end = rt->next_task_id;
     int32_t total_to_simulate = sim_end - sim_start;
     
-    if (total_to_simulate > PTO_TASK_WINDOW_SIZE) {
+    if (total_to_simulate > rt->task_window_size) {
         fprintf(stderr, "[PTO Simulator] WARNING: %d tasks exceed window size %d, simulating last %d\n",
-                total_to_simulate, PTO_TASK_WINDOW_SIZE, PTO_TASK_WINDOW_SIZE);
-        sim_start = sim_end - PTO_TASK_WINDOW_SIZE;
-        total_to_simulate = PTO_TASK_WINDOW_SIZE;
+                total_to_simulate, rt->task_window_size, rt->task_window_size);
+        sim_start = sim_end - rt->task_window_size;
+        total_to_simulate = rt->task_window_size;
     }
 
     // Local dependency state for simulation
@@ -1732,7 +2124,7 @@ void pto_simulate_all(PTORuntime* rt) {
         return;
     }
     for (int32_t task_id = sim_start; task_id < sim_end; task_id++) {
-        PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(task_id)];
+        PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(rt, task_id)];
         if (!task->is_active || task->task_id != task_id) continue;
         remaining[task_id - sim_start] = task->fanin_count;
         task->is_complete = false;
@@ -1750,7 +2142,7 @@ void pto_simulate_all(PTORuntime* rt) {
         
         // Find a ready task (remaining deps == 0 and not complete)
         for (int32_t task_id = sim_start; task_id < sim_end; task_id++) {
-            PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(task_id)];
+            PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(rt, task_id)];
             
             if (!task->is_active || task->task_id != task_id) continue;
             if (task->is_complete) continue;
@@ -1823,7 +2215,7 @@ void pto_simulate_all(PTORuntime* rt) {
             while (off != 0 && seen < task->fanout_consumer_count) {
                 int32_t dep_id = rt->dep_list_pool[off].task_id;
                 if (dep_id >= sim_start && dep_id < sim_end) {
-                    PendingTask* dep_task = &rt->pend_task[PTO_TASK_SLOT(dep_id)];
+                    PendingTask* dep_task = &rt->pend_task[PTO_TASK_SLOT(rt, dep_id)];
                     if (dep_task->is_active && dep_task->task_id == dep_id) {
                         int32_t idx = dep_id - sim_start;
                         if (remaining[idx] > 0) remaining[idx]--;
@@ -1845,7 +2237,7 @@ void pto_simulate_all(PTORuntime* rt) {
             // Check if there are incomplete tasks with non-zero fanin (deadlock)
             int waiting_tasks = 0;
             for (int32_t i = sim_start; i < sim_end; i++) {
-                if (!rt->pend_task[PTO_TASK_SLOT(i)].is_complete) {
+                if (!rt->pend_task[PTO_TASK_SLOT(rt, i)].is_complete) {
                     waiting_tasks++;
                 }
             }
@@ -1990,20 +2382,20 @@ void pto_print_flow_stats(PTORuntime* rt) {
     // High water marks
     printf("High Water Marks (peak usage):\n");
     printf("  Task Ring:      %10d / %d  (%.1f%%)\n", 
-           stats->task_ring_hwm, PTO_TASK_WINDOW_SIZE,
-           100.0 * stats->task_ring_hwm / PTO_TASK_WINDOW_SIZE);
+           stats->task_ring_hwm, rt->task_window_size,
+           100.0 * stats->task_ring_hwm / rt->task_window_size);
     printf("  TensorMap Pool: %10d / %d  (%.1f%%)\n",
-           stats->tensormap_pool_hwm, PTO_TENSORMAP_POOL_SIZE,
-           100.0 * stats->tensormap_pool_hwm / PTO_TENSORMAP_POOL_SIZE);
+           stats->tensormap_pool_hwm, rt->tensormap_pool_size,
+           100.0 * stats->tensormap_pool_hwm / rt->tensormap_pool_size);
     printf("  DepList Pool:   %10d / %d  (%.1f%%)\n",
-           stats->deplist_pool_hwm, PTO_DEP_LIST_POOL_SIZE,
-           100.0 * stats->deplist_pool_hwm / PTO_DEP_LIST_POOL_SIZE);
+           stats->deplist_pool_hwm, rt->dep_list_pool_size,
+           100.0 * stats->deplist_pool_hwm / rt->dep_list_pool_size);
     printf("  Heap Ring:      %10d / %d bytes  (%.1f%%)\n",
-           stats->heap_hwm, PTO_HEAP_SIZE_BYTES,
-           100.0 * stats->heap_hwm / (double)PTO_HEAP_SIZE_BYTES);
+           stats->heap_hwm, rt->heap_size,
+           100.0 * stats->heap_hwm / (double)rt->heap_size);
     printf("  Ready Queue:    %10d / %d  (%.1f%%)\n",
-           stats->ready_queue_hwm, PTO_MAX_READY_QUEUE,
-           100.0 * stats->ready_queue_hwm / PTO_MAX_READY_QUEUE);
+           stats->ready_queue_hwm, rt->ready_queue_size,
+           100.0 * stats->ready_queue_hwm / rt->ready_queue_size);
     printf("\n");
     
     // Sizing recommendations
@@ -2012,54 +2404,54 @@ void pto_print_flow_stats(PTORuntime* rt) {
     
     if (stats->task_ring_stalls > 0) {
         printf("  [!] Task Ring was exhausted %lld times.\n", (long long)stats->task_ring_stalls);
-        printf("      Consider increasing PTO_TASK_WINDOW_SIZE (current: %d)\n", PTO_TASK_WINDOW_SIZE);
+        printf("      Consider increasing task_window_size (current: %d)\n", rt->task_window_size);
         any_recommendation = true;
     }
     
     if (stats->tensormap_pool_stalls > 0) {
         printf("  [!] TensorMap Pool was exhausted %lld times.\n", (long long)stats->tensormap_pool_stalls);
-        printf("      Consider increasing PTO_TENSORMAP_POOL_SIZE (current: %d)\n", PTO_TENSORMAP_POOL_SIZE);
+        printf("      Consider increasing tensormap_pool_size (current: %d)\n", rt->tensormap_pool_size);
         any_recommendation = true;
     }
     
     if (stats->deplist_pool_stalls > 0) {
         printf("  [!] DepList Pool was exhausted %lld times.\n", (long long)stats->deplist_pool_stalls);
-        printf("      Consider increasing PTO_DEP_LIST_POOL_SIZE (current: %d)\n", PTO_DEP_LIST_POOL_SIZE);
+        printf("      Consider increasing dep_list_pool_size (current: %d)\n", rt->dep_list_pool_size);
         any_recommendation = true;
     }
     
     if (stats->heap_ring_stalls > 0) {
         printf("  [!] Heap Ring was exhausted %lld times.\n", (long long)stats->heap_ring_stalls);
-        printf("      Consider increasing PTO_HEAP_SIZE_BYTES (current: %d MB)\n", 
-               PTO_HEAP_SIZE_BYTES / (1024 * 1024));
+        printf("      Consider increasing heap_size_bytes (current: %d MB)\n", 
+               rt->heap_size / (1024 * 1024));
         any_recommendation = true;
     }
     
     if (stats->ready_queue_stalls > 0) {
         printf("  [!] Ready Queue was exhausted %lld times.\n", (long long)stats->ready_queue_stalls);
-        printf("      Consider increasing PTO_MAX_READY_QUEUE (current: %d)\n", PTO_MAX_READY_QUEUE);
+        printf("      Consider increasing ready_queue_size (current: %d)\n", rt->ready_queue_size);
         any_recommendation = true;
     }
     
     // High water mark warnings
-    if (stats->task_ring_hwm > PTO_TASK_WINDOW_SIZE * 0.9) {
+    if (stats->task_ring_hwm > rt->task_window_size * 0.9) {
         printf("  [WARN] Task Ring usage reached %.1f%% - consider increasing size\n",
-               100.0 * stats->task_ring_hwm / PTO_TASK_WINDOW_SIZE);
+               100.0 * stats->task_ring_hwm / rt->task_window_size);
         any_recommendation = true;
     }
-    if (stats->tensormap_pool_hwm > PTO_TENSORMAP_POOL_SIZE * 0.9) {
+    if (stats->tensormap_pool_hwm > rt->tensormap_pool_size * 0.9) {
         printf("  [WARN] TensorMap Pool usage reached %.1f%% - consider increasing size\n",
-               100.0 * stats->tensormap_pool_hwm / PTO_TENSORMAP_POOL_SIZE);
+               100.0 * stats->tensormap_pool_hwm / rt->tensormap_pool_size);
         any_recommendation = true;
     }
-    if (stats->deplist_pool_hwm > PTO_DEP_LIST_POOL_SIZE * 0.9) {
+    if (stats->deplist_pool_hwm > rt->dep_list_pool_size * 0.9) {
         printf("  [WARN] DepList Pool usage reached %.1f%% - consider increasing size\n",
-               100.0 * stats->deplist_pool_hwm / PTO_DEP_LIST_POOL_SIZE);
+               100.0 * stats->deplist_pool_hwm / rt->dep_list_pool_size);
         any_recommendation = true;
     }
-    if (stats->heap_hwm > PTO_HEAP_SIZE_BYTES * 0.9) {
+    if (stats->heap_hwm > rt->heap_size * 0.9) {
         printf("  [WARN] Heap Ring usage reached %.1f%% - consider increasing size\n",
-               100.0 * stats->heap_hwm / (double)PTO_HEAP_SIZE_BYTES);
+               100.0 * stats->heap_hwm / (double)rt->heap_size);
         any_recommendation = true;
     }
     
@@ -22,10 +22,18 @@
 #ifndef PTO_RUNTIME_COMMON_H
 #define PTO_RUNTIME_COMMON_H
 
-// POSIX definitions must come FIRST, before ANY system includes
-// This enables clock_gettime, nanosleep, pthread_cond_timedwait, etc.
+// Feature-test macros must come FIRST, before ANY system includes.
+// _POSIX_C_SOURCE enables clock_gettime, nanosleep, pthread_cond_timedwait, etc.;
+// _DEFAULT_SOURCE (_DARWIN_C_SOURCE on macOS) adds MAP_ANONYMOUS, madvise and
+// mincore for the table arena in pto_runtime_common.c.
 #ifndef _POSIX_C_SOURCE
-#define _POSIX_C_SOURCE 199309L
+#define _POSIX_C_SOURCE 200809L
+#endif
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+#ifndef _DARWIN_C_SOURCE
+#define _DARWIN_C_SOURCE
 #endif
 
 #include <stdint.h>
@@ -40,17 +48,22 @@
 // Configuration Constants (Platform Independent)
 // =============================================================================
 
-// Sliding window for task management - limits memory usage
+// Default capacities (PTO_RUNTIME_PRESET_LARGE). Each runtime takes its actual
+// capacities from a PTORuntimeConfig at init; see pto_runtime_init_with_config().
 #define PTO_TASK_WINDOW_SIZE   8192    // Sliding window size (8K tasks in flight)
 #define PTO_MAX_TASKS          PTO_TASK_WINDOW_SIZE  // Alias for backward compatibility
-#define PTO_TASK_SLOT(task_id) ((task_id) & (PTO_TASK_WINDOW_SIZE - 1))  // Fast modulo (window must be power of 2)
-
-#define PTO_MAX_ARGS           16      // Maximum arguments per task
 #define PTO_TENSORMAP_SIZE     PTO_TASK_WINDOW_SIZE        // Hash bucket count (power of 2)
 #define PTO_TENSORMAP_POOL_SIZE (PTO_TASK_WINDOW_SIZE * 32) // Ring pool entries (large for orchestration-only mode)
 #define PTO_DEP_LIST_POOL_SIZE (PTO_TASK_WINDOW_SIZE * 16) // Dep list nodes (fanin+fanout headroom)
 #define PTO_HEAP_SIZE_BYTES    (1024 * 1024 * 1024)       // Packed output heap (1GB for large orchestration-only)
 #define PTO_MAX_READY_QUEUE    65536   // Ready queue size (64K, 2x window for safety)
+#define PTO_MAX_SCOPE_DEPTH    1024    // Orchestrator scope stack depth
+#define PTO_MAX_INCORE_FUNCS   1024    // InCore function registry entries
+
+// Window slot of a task (fast modulo; the window size is a power of 2)
+#define PTO_TASK_SLOT(rt, task_id) ((task_id) & (rt)->task_window_mask)
+
+#define PTO_MAX_ARGS           16      // Maximum arguments per task
 #define PTO_MAX_WORKERS        128     // Maximum worker threads (A2A3: 48 vector + 24 cube = 72)
 
 // Debug output control
@@ -133,6 +146,9 @@ typedef struct {
     int64_t  col_offset;     // Column offset within tensor
     int64_t  rows;           // Number of rows in this region
     int64_t  cols;           // Number of columns in this region
+    // Layout of raw_tensor (not part of the region identity used by TensorMap)
+    int64_t  row_stride;     // Elements between consecutive rows (0 = cols)
+    int32_t  elem_size;      // Bytes per element (0 = sizeof(float))
 } TensorRegion;
 
 /**
@@ -166,11 +182,11 @@ typedef struct {
 } TensorMapEntry;
 
 typedef struct {
-    int32_t buckets[PTO_TENSORMAP_SIZE];                 // Offsets into entry_pool (-1 empty)
-    TensorMapEntry entry_pool[PTO_TENSORMAP_POOL_SIZE];  // Ring pool
-    int32_t pool_head;                                  // Next allocation slot (wraps)
-    int32_t task_entry_head[PTO_TASK_WINDOW_SIZE];       // Per-task entry head (task_id % window)
-    int32_t last_task_alive;                             // Cached validity threshold
+    int32_t* buckets;                 // [tensormap_size] Offsets into entry_pool (-1 empty)
+    TensorMapEntry* entry_pool;       // [tensormap_pool_size] Ring pool
+    int32_t pool_head;                // Next allocation slot (wraps)
+    int32_t* task_entry_head;         // [task_window_size] Per-task entry head (task_id % window)
+    int32_t last_task_alive;          // Cached validity threshold
 } TensorMap;
 
 /**
@@ -187,11 +203,13 @@ typedef struct {
     int32_t      task_id;                    // Unique task identifier
     const char*  func_name;                  // InCore function to call
     void*        func_ptr;                   // Function pointer
+    int32_t      func_id;                    // Platform function id (resolved at submit, -1 = none)
     CycleCostFunc cycle_func;                // Cycle cost function (for simulation mode)
     
     // Arguments
     TaskArg      args[PTO_MAX_ARGS];         // Input/output arguments
     int32_t      num_args;                   // Number of arguments
+    void*        arg_ptrs[PTO_MAX_ARGS];     // Kernel argument pointers (resolved at submit)
 
     // Outputs (subset of args[] where is_output==true)
     int32_t      output_arg_index[PTO_MAX_ARGS];  // Indices into args[]
@@ -230,33 +248,137 @@ typedef struct {
     int64_t      end_cycle;                  // Time when this task finished
 } PendingTask;
 
+// =============================================================================
+// Name Index (FNV-1a + Linear Probing)
+// =============================================================================
+
+/**
+ * Open-addressing index from names to dense ids, shared by the trace function
+ * table and the A2A3 InCore loaders. The owner keeps the names itself, the
+ * name of id i at names + i * name_stride, and stores at most name_len bytes
+ * of each; hashing and comparison look at the same prefix.
+ *
+ * Lookups are lock-free: a slot's hash is written before its id_plus_one is
+ * published with release order. Inserts must be serialized by the owner.
+ */
+typedef struct {
+    uint32_t hash;
+    int32_t  id_plus_one;        // 0 = empty slot
+} PTONameIndexSlot;
+
+typedef struct {
+    PTONameIndexSlot* slots;
+    uint32_t    size;            // Power of 2
+    const char* names;
+    size_t      name_stride;
+    size_t      name_len;
+} PTONameIndex;
+
+static inline uint32_t pto_name_hash(const char* name, size_t name_len) {
+    uint32_t h = 2166136261u;  // FNV-1a
+    for (size_t i = 0; i < name_len && name[i]; i++) {
+        h = (h ^ (uint8_t)name[i]) * 16777619u;
+    }
+    return h;
+}
+
+/**
+ * Find the id of a name. Returns -1 if it is not indexed; *empty_slot (if not
+ * NULL) then receives the slot an insert should take, or index->size if the
+ * index is full.
+ */
+static inline int32_t pto_name_index_find(const PTONameIndex* index, const char* name,
+                                          uint32_t hash, uint32_t* empty_slot) {
+    const uint32_t mask = index->size - 1;
+    uint32_t idx = hash & mask;
+    for (uint32_t probe = 0; probe < index->size; probe++, idx = (idx + 1) & mask) {
+        const PTONameIndexSlot* slot = &index->slots[idx];
+        int32_t id_plus_one = __atomic_load_n(&slot->id_plus_one, __ATOMIC_ACQUIRE);
+        if (id_plus_one == 0) {
+            if (empty_slot) *empty_slot = idx;
+            return -1;
+        }
+        if (slot->hash == hash &&
+            strncmp(index->names + (size_t)(id_plus_one - 1) * index->name_stride, name,
+                    index->name_len) == 0) {
+            return id_plus_one - 1;
+        }
+    }
+    if (empty_slot) *empty_slot = index->size;
+    return -1;
+}
+
+/**
+ * Publish id in an empty slot returned by pto_name_index_find(). The name of
+ * id must already be stored.
+ */
+static inline void pto_name_index_publish(PTONameIndex* index, uint32_t slot, uint32_t hash,
+                                          int32_t id) {
+    index->slots[slot].hash = hash;
+    __atomic_store_n(&index->slots[slot].id_plus_one, id + 1, __ATOMIC_RELEASE);
+}
+
 // =============================================================================
 // Cycle Trace Data Structures
 // =============================================================================
 
-#define PTO_MAX_TRACE_ENTRIES 65536    // 64K trace entries (limited by window)
+#define PTO_TRACE_CHUNK_ENTRIES 4096   // Entries per per-worker trace chunk
+#define PTO_TRACE_MAX_FUNCS     1024   // Distinct function names (power of 2)
 #define PTO_MAX_FUNC_NAME_LEN 64
+#define PTO_TRACE_NAME_CACHE    16     // Per-worker call-site cache entries (power of 2)
 
 /**
  * Single trace entry recording one task execution
  */
 typedef struct {
-    char func_name[PTO_MAX_FUNC_NAME_LEN];
+    int32_t func_id;             // Interned name (pto_trace_func_name)
     int32_t worker_id;
     int64_t start_cycle;
     int64_t end_cycle;
 } CycleTraceEntry;
 
 /**
- * Cycle trace buffer for recording task execution timing
+ * Fixed-size block of entries; a worker's trace is a linked list of chunks
  */
-typedef struct {
-    CycleTraceEntry entries[PTO_MAX_TRACE_ENTRIES];
+typedef struct CycleTraceChunk {
+    struct CycleTraceChunk* next;
     int32_t count;
+    CycleTraceEntry entries[PTO_TRACE_CHUNK_ENTRIES];
+} CycleTraceChunk;
+
+/**
+ * Call-site cache entry: func_id of a recently recorded name pointer
+ */
+typedef struct {
+    const char* name;
+    int32_t func_id;
+} CycleTraceNameCache;
+
+/**
+ * Append-only trace of one worker. Only the owning worker thread writes it,
+ * so recording needs no locks or atomics.
+ */
+typedef struct {
+    CycleTraceChunk* head;
+    CycleTraceChunk* tail;
+    int64_t count;
+    int64_t cycle;               // Current cycle of this worker
+    CycleTraceNameCache name_cache[PTO_TRACE_NAME_CACHE];
+} __attribute__((aligned(64))) CycleTraceWorker;
+
+/**
+ * Cycle trace for recording task execution timing
+ */
+typedef struct {
+    CycleTraceWorker workers[PTO_MAX_WORKERS];
+    char             func_names[PTO_TRACE_MAX_FUNCS][PTO_MAX_FUNC_NAME_LEN];  // By func_id
+    PTONameIndexSlot func_slots[PTO_TRACE_MAX_FUNCS];
+    PTONameIndex     func_index;     // Name -> func_id over func_names
+    int32_t          num_funcs;
+    pthread_mutex_t  func_mutex;     // Serializes name insertion only
     int32_t num_workers;
     int32_t num_vector_workers;  // Number of vector workers (for A2A3)
     int32_t num_cube_workers;    // Number of cube workers (for A2A3)
-    int64_t per_worker_cycle[PTO_MAX_WORKERS];  // Current cycle per worker
     bool enabled;
 } CycleTrace;
 
@@ -274,6 +396,30 @@ typedef enum {
     PTO_MODE_SIMULATE             // Stall when window full (cycle-accurate simulation)
 } PTORuntimeMode;
 
+/**
+ * Runtime capacities, fixed at init.
+ *
+ * All tables are carved out of one anonymous mapping that is only reserved at
+ * init: pages are touched (and count towards RSS) when a task first uses them,
+ * so a large capacity costs address space, not startup time.
+ */
+typedef struct {
+    int32_t task_window_size;     // Tasks in flight (power of 2)
+    int32_t tensormap_size;       // TensorMap hash buckets (power of 2)
+    int32_t tensormap_pool_size;  // TensorMap ring pool entries
+    int32_t dep_list_pool_size;   // DepList nodes
+    int32_t heap_size_bytes;      // Packed output heap
+    int32_t ready_queue_size;     // Entries per ready queue (power of 2)
+    int32_t max_scope_depth;      // Orchestrator scope stack depth
+    int32_t max_incore_funcs;     // InCore function registry entries
+} PTORuntimeConfig;
+
+typedef enum {
+    PTO_RUNTIME_PRESET_SMALL = 0,  // Unit tests and small graphs: 1K window, 64MB heap
+    PTO_RUNTIME_PRESET_MEDIUM,     // 4K window, 256MB heap
+    PTO_RUNTIME_PRESET_LARGE,      // 8K window, 1GB heap (the compile-time defaults above)
+} PTORuntimePreset;
+
 typedef enum {
     PTO_TASK_PENDING = 0,
     PTO_TASK_READY = 1,
@@ -293,7 +439,20 @@ typedef struct PTORuntime {
     // Platform-Independent: Task Management with Sliding Window
     // =========================================================================
     
-    PendingTask  pend_task[PTO_TASK_WINDOW_SIZE];    // Sliding window task table
+    // Capacities (from PTORuntimeConfig) and the mapping backing all tables
+    int32_t      task_window_size;
+    int32_t      task_window_mask;            // task_window_size - 1 (see PTO_TASK_SLOT)
+    int32_t      tensormap_size;
+    int32_t      tensormap_pool_size;
+    int32_t      dep_list_pool_size;
+    int32_t      ready_queue_size;
+    int32_t      ready_queue_mask;            // ready_queue_size - 1
+    int32_t      max_scope_depth;
+    int32_t      max_incore_funcs;
+    uint8_t*     table_mem;                   // Lazily touched anonymous mapping
+    size_t       table_mem_bytes;
+
+    PendingTask* pend_task;                   // [task_window_size] Sliding window task table
     int32_t      next_task_id;                // Next task ID to allocate (absolute, not wrapped)
     int32_t      active_task_count;           // Number of active tasks in window
     
@@ -303,7 +462,7 @@ typedef struct PTORuntime {
     PTORuntimeMode runtime_mode;              // Current execution mode
     
     // Dependency list pool (ring buffer)
-    DepListEntry dep_list_pool[PTO_DEP_LIST_POOL_SIZE];
+    DepListEntry* dep_list_pool;              // [dep_list_pool_size]
     int32_t      dep_list_top;            // Next allocation offset (0 reserved for NULL)
     int32_t      dep_list_tail;           // Oldest live offset (tracks last_task_alive)
 
@@ -316,10 +475,10 @@ typedef struct PTORuntime {
     int32_t       heap_top;               // Allocation pointer (bytes, wraps)
     int32_t       heap_tail;              // Free pointer (bytes, tracks last_task_alive)
 
-    // Scheduler-owned dynamic state arrays (indexed by PTO_TASK_SLOT(task_id))
-    int32_t       fanin_refcount[PTO_TASK_WINDOW_SIZE];
-    int32_t       fanout_refcount[PTO_TASK_WINDOW_SIZE];
-    uint8_t       task_state[PTO_TASK_WINDOW_SIZE];
+    // Scheduler-owned dynamic state arrays (indexed by PTO_TASK_SLOT(rt, task_id))
+    int32_t*      fanin_refcount;         // [task_window_size]
+    int32_t*      fanout_refcount;        // [task_window_size]
+    uint8_t*      task_state;             // [task_window_size]
     
     // Statistics (absolute counts, not affected by window wrap)
     int64_t      total_tasks_scheduled;
@@ -333,18 +492,26 @@ typedef struct PTORuntime {
     // =========================================================================
     
     // Single ready queue (for single-queue platforms like ARM64)
-    int32_t      ready_queue[PTO_MAX_READY_QUEUE];
+    int32_t*     ready_queue;                 // [ready_queue_size]
     int32_t      ready_head;
     int32_t      ready_tail;
     int32_t      ready_count;
+
+    // Streaming mode (ARM64): ready_queue becomes a lock-free bounded MPMC ring.
+    // ready_seq[i] is the sequence number of cell i minus i (so all-zero is the
+    // empty ring); the positions are free-running.
+    uint32_t*    ready_seq;                   // [ready_queue_size]
+    uint32_t     ready_enqueue_pos __attribute__((aligned(64)));
+    uint32_t     ready_dequeue_pos __attribute__((aligned(64)));
+    int32_t      idle_workers __attribute__((aligned(64)));  // Workers parked on queue_not_empty
     
     // Dual ready queues (for A2A3: separate vector and cube queues)
-    int32_t      vector_ready_queue[PTO_MAX_READY_QUEUE];  // is_cube=0 tasks
+    int32_t*     vector_ready_queue;          // [ready_queue_size] is_cube=0 tasks
     int32_t      vector_ready_head;
     int32_t      vector_ready_tail;
     int32_t      vector_ready_count;
     
-    int32_t      cube_ready_queue[PTO_MAX_READY_QUEUE];    // is_cube=1 tasks
+    int32_t*     cube_ready_queue;            // [ready_queue_size] is_cube=1 tasks
     int32_t      cube_ready_head;
     int32_t      cube_ready_tail;
     int32_t      cube_ready_count;
@@ -385,7 +552,7 @@ typedef struct PTORuntime {
     pthread_t         orch_thread;           // Orchestration thread handle
 
     // Scope stack (orchestrator only)
-    int32_t           scope_stack[1024];
+    int32_t*          scope_stack;           // [max_scope_depth]
     int32_t           scope_stack_top;
     
     // =========================================================================
@@ -394,9 +561,10 @@ typedef struct PTORuntime {
     
     bool              simulation_mode;       // If true, call cycle_func and record traces
     bool              dual_queue_mode;       // If true, use separate cube/vector queues
+    bool              streaming_mode;        // If true, dispatch tasks as soon as they are ready (ARM64)
     
     // InCore function registry (maps func_name to actual function pointer)
-    void*             func_registry[1024];  // Function pointer cache (limited number of unique funcs)
+    void**            func_registry;         // [max_incore_funcs] Function pointer cache
 } PTORuntime;
 
 // =============================================================================
@@ -421,9 +589,30 @@ typedef void (*PTOOrchFunc)(PTORuntime* rt, void* user_data);
 
 /**
  * Initialize the PTO runtime (platform-independent parts)
+ *
+ * Uses the preset named by the PTO_RUNTIME_PRESET environment variable
+ * (small, medium or large), PTO_RUNTIME_PRESET_LARGE if unset. Aborts if
+ * the runtime tables cannot be mapped; use pto_runtime_init_with_config()
+ * to handle that failure.
  */
 void pto_runtime_init(PTORuntime* rt);
 
+/**
+ * Capacities of a preset
+ */
+PTORuntimeConfig pto_runtime_config_preset(PTORuntimePreset preset);
+
+/**
+ * Initialize the PTO runtime with explicit capacities
+ * @return false if the config is invalid or the tables cannot be mapped
+ */
+bool pto_runtime_init_with_config(PTORuntime* rt, const PTORuntimeConfig* config);
+
+/**
+ * Print reserved vs. resident memory of each runtime table
+ */
+void pto_runtime_print_footprint(PTORuntime* rt);
+
 /**
  * Shutdown the PTO runtime and free resources
  */
@@ -517,6 +706,17 @@ void pto_task_add_input(PTORuntime* rt, int32_t task_id,
                         void* tensor, int64_t row_off, int64_t col_off,
                         int64_t rows, int64_t cols);
 
+/**
+ * Add an input argument with explicit layout
+ *
+ * @param elem_size   Bytes per element (e.g. 2 for f16/bf16, 1 for int8)
+ * @param row_stride  Elements between rows of tensor (0 = cols, i.e. dense)
+ */
+void pto_task_add_input_ex(PTORuntime* rt, int32_t task_id,
+                           void* tensor, int64_t row_off, int64_t col_off,
+                           int64_t rows, int64_t cols,
+                           int32_t elem_size, int64_t row_stride);
+
 /**
  * Add an output argument to a task (Mode A: pre-allocated buffer)
  * Output regions are registered in TensorMap on task submit.
@@ -525,6 +725,14 @@ void pto_task_add_output(PTORuntime* rt, int32_t task_id,
                          void* tensor, int64_t row_off, int64_t col_off,
                          int64_t rows, int64_t cols);
 
+/**
+ * Add an output argument with explicit layout (see pto_task_add_input_ex)
+ */
+void pto_task_add_output_ex(PTORuntime* rt, int32_t task_id,
+                            void* tensor, int64_t row_off, int64_t col_off,
+                            int64_t rows, int64_t cols,
+                            int32_t elem_size, int64_t row_stride);
+
 /**
  * Add an output argument with reference for runtime allocation (Mode B)
  * 
@@ -543,15 +751,50 @@ void pto_task_add_output_ref(PTORuntime* rt, int32_t task_id,
                              void** tensor_ref, int64_t row_off, int64_t col_off,
                              int64_t rows, int64_t cols);
 
+/**
+ * Mode B output with explicit element size; the runtime allocates
+ * rows * cols * elem_size bytes (dense rows).
+ */
+void pto_task_add_output_ref_ex(PTORuntime* rt, int32_t task_id,
+                                void** tensor_ref, int64_t row_off, int64_t col_off,
+                                int64_t rows, int64_t cols, int32_t elem_size);
+
 /**
  * Finalize a task for submission:
  * - Allocates packed outputs for output args with NULL base pointer
+ * - Resolves the kernel argument pointers (arg_ptrs)
  * - Registers outputs in TensorMap
  * - Marks task as submitted
  * @return true if task is ready (all deps satisfied)
  */
 bool pto_task_prepare_submit(PTORuntime* rt, int32_t task_id);
 
+/**
+ * Bytes per element of a region (defaults to sizeof(float))
+ */
+static inline int64_t pto_region_elem_size(const TensorRegion* region) {
+    return region->elem_size > 0 ? region->elem_size : (int64_t)sizeof(float);
+}
+
+/**
+ * Address of the first element of a region:
+ * raw_tensor + (row_offset * row_stride + col_offset) * elem_size
+ */
+static inline void* pto_region_address(const TensorRegion* region) {
+    int64_t stride = region->row_stride > 0 ? region->row_stride : region->cols;
+    return (uint8_t*)region->raw_tensor +
+           (region->row_offset * stride + region->col_offset) * pto_region_elem_size(region);
+}
+
+/**
+ * Copy a submitted task's kernel arguments into args (at least PTO_MAX_ARGS entries)
+ * @return number of arguments
+ */
+static inline int32_t pto_task_load_args(const PendingTask* task, void** args) {
+    memcpy(args, task->arg_ptrs, (size_t)task->num_args * sizeof(void*));
+    return task->num_args;
+}
+
 // =============================================================================
 // Internal Helpers (callers must hold rt->task_mutex)
 // =============================================================================
@@ -564,9 +807,9 @@ bool pto_advance_last_task_alive_locked(PTORuntime* rt);
 // =============================================================================
 
 /**
- * Compute hash for tensor region
+ * Compute hash bucket for tensor region
  */
-uint32_t pto_tensormap_hash(TensorRegion* region);
+uint32_t pto_tensormap_hash(PTORuntime* rt, TensorRegion* region);
 
 /**
  * Check if two tensor regions match
@@ -619,6 +862,9 @@ void pto_trace_init_dual(int32_t num_vector_workers, int32_t num_cube_workers);
 
 /**
  * Record a task execution (simple version - no dependency tracking)
+ *
+ * Each worker_id must be recorded from a single thread at a time; entries go
+ * to that worker's own buffer and are merged by pto_trace_to_chrome_json.
  */
 void pto_trace_record(int32_t worker_id, const char* func_name, int64_t cycle_cost);
 
@@ -633,6 +879,16 @@ void pto_trace_record_with_time(int32_t worker_id, const char* func_name,
  */
 int64_t pto_trace_get_cycle(int32_t worker_id);
 
+/**
+ * Total number of recorded entries across all workers
+ */
+int64_t pto_trace_entry_count(void);
+
+/**
+ * Name of an interned function id (from CycleTraceEntry.func_id)
+ */
+const char* pto_trace_func_name(int32_t func_id);
+
 /**
  * Cleanup trace resources
  */
@@ -222,6 +222,9 @@ int a2a3_runtime_init(A2A3RuntimeConfig* config) {
     }
 #endif
     
+    // Publish device addresses to the function-id dispatch table
+    a2a3_refresh_incore_dispatch();
+    
     memset(&g_stats, 0, sizeof(g_stats));
     g_stats.num_incore_funcs_loaded = a2a3_get_incore_count();
     
@@ -149,6 +149,18 @@ int a2a3_runtime_copy_from_device(void* dst_host, const void* src_device, size_t
 
 typedef void (*A2A3InCoreFunc)(void** args, int32_t num_args);
 
+/**
+ * Dispatch record of one InCore function, indexed by its integer function id.
+ * Ids are assigned when functions are loaded; the orchestrator resolves each
+ * task's name to an id once, so workers never compare strings.
+ */
+typedef struct {
+    A2A3InCoreFunc func_ptr;   // Host-callable function (.so or registered), or NULL
+    uint64_t device_addr;      // Device GM address of the .o binary, or 0
+    bool has_binary;           // A .o binary is loaded for this function
+    bool is_cube;              // True if AIC (Cube), false if AIV (Vector)
+} A2A3InCoreDispatch;
+
 int a2a3_runtime_register_incore(const char* func_name, A2A3InCoreFunc func_ptr, bool is_cube);
 A2A3InCoreFunc a2a3_runtime_lookup_incore(const char* func_name);
 
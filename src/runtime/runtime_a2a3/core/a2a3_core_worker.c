@@ -8,6 +8,7 @@
 #define _POSIX_C_SOURCE 199309L
 #include "a2a3_core_worker.h"
 #include "../orchestration/a2a3_orchestration.h"
+#include "../a2a3_runtime_api.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <time.h>
@@ -35,11 +36,17 @@
 // Task Execution (Hardware Implementation)
 // =============================================================================
 
-// Forward declarations for binary loader (to avoid include dependency)
-// These are defined in a2a3_binary_loader.c and will be linked at runtime
-typedef struct A2A3InCoreBinaryEntry A2A3InCoreBinaryEntry;
-extern uint64_t a2a3_get_incore_device_addr(const char* func_name) __attribute__((weak));
-extern A2A3InCoreBinaryEntry* a2a3_lookup_incore_binary(const char* func_name) __attribute__((weak));
+// InCore dispatch table (defined in a2a3_so_loader.c, linked at runtime).
+// task->func_id was resolved by the orchestrator at submit, so lookups here
+// are a single array index.
+extern const A2A3InCoreDispatch* a2a3_get_incore_dispatch_table(void) __attribute__((weak));
+
+static inline const A2A3InCoreDispatch* a2a3_core_task_dispatch(const PendingTask* task) {
+    if (task->func_id < 0 || !a2a3_get_incore_dispatch_table) {
+        return NULL;
+    }
+    return &a2a3_get_incore_dispatch_table()[task->func_id];
+}
 
 #ifdef CANN_SDK_AVAILABLE
 #include <acl/acl.h>
@@ -48,22 +55,15 @@ extern A2A3InCoreBinaryEntry* a2a3_lookup_incore_binary(const char* func_name) _
 static int s_npu_warning_shown = 0;
 
 void a2a3_core_execute_task(PTORuntime* rt, int32_t task_id, int32_t worker_id) {
-    int32_t slot = PTO_TASK_SLOT(task_id);
+    int32_t slot = PTO_TASK_SLOT(rt, task_id);
     PendingTask* task = &rt->pend_task[slot];
     
     DEBUG_PRINT("[A2A3 Core HW] Worker %d executing task %d: %s\n", 
                 worker_id, task_id, task->func_name);
     
-    // Build argument array
-    void* args[PTO_MAX_ARGS * 2];
-    int arg_idx = 0;
-    
-    for (int i = 0; i < task->num_args; i++) {
-        TaskArg* arg = &task->args[i];
-        float* base_ptr = (float*)arg->region.raw_tensor;
-        int64_t offset = arg->region.row_offset * arg->region.cols + arg->region.col_offset;
-        args[arg_idx++] = (void*)(base_ptr + offset);
-    }
+    // Argument pointers were resolved at submit (pto_task_prepare_submit)
+    void* args[PTO_MAX_ARGS];
+    pto_task_load_args(task, args);
     
     // Priority 1: Use function pointer if available (from .so loading)
     if (task->func_ptr) {
@@ -74,11 +74,8 @@ void a2a3_core_execute_task(PTORuntime* rt, int32_t task_id, int32_t worker_id)
     
     // Priority 2: Check if binary is loaded (from .o file)
     // For real NPU execution, we need to use the NPU launcher
-    // Note: a2a3_get_incore_device_addr is a weak symbol - check if it's available
-    uint64_t device_addr = 0;
-    if (a2a3_get_incore_device_addr) {
-        device_addr = a2a3_get_incore_device_addr(task->func_name);
-    }
+    const A2A3InCoreDispatch* dispatch = a2a3_core_task_dispatch(task);
+    uint64_t device_addr = dispatch ? dispatch->device_addr : 0;
     if (device_addr != 0) {
         // Binary is loaded but we can't execute it in CPU worker threads
         // Real execution requires launching AICore kernel via CANN API
@@ -111,22 +108,15 @@ void a2a3_core_execute_task(PTORuntime* rt, int32_t task_id, int32_t worker_id)
 static int s_stub_warning_shown = 0;
 
 void a2a3_core_execute_task(PTORuntime* rt, int32_t task_id, int32_t worker_id) {
-    int32_t slot = PTO_TASK_SLOT(task_id);
+    int32_t slot = PTO_TASK_SLOT(rt, task_id);
     PendingTask* task = &rt->pend_task[slot];
     
     DEBUG_PRINT("[A2A3 Core STUB] Worker %d executing task %d: %s\n", 
                 worker_id, task_id, task->func_name);
     
-    // Build argument array
-    void* args[PTO_MAX_ARGS * 2];
-    int arg_idx = 0;
-    
-    for (int i = 0; i < task->num_args; i++) {
-        TaskArg* arg = &task->args[i];
-        float* base_ptr = (float*)arg->region.raw_tensor;
-        int64_t offset = arg->region.row_offset * arg->region.cols + arg->region.col_offset;
-        args[arg_idx++] = (void*)(base_ptr + offset);
-    }
+    // Argument pointers were resolved at submit (pto_task_prepare_submit)
+    void* args[PTO_MAX_ARGS];
+    pto_task_load_args(task, args);
     
     // Priority 1: Use function pointer if available (from .so loading)
     if (task->func_ptr) {
@@ -137,13 +127,8 @@ void a2a3_core_execute_task(PTORuntime* rt, int32_t task_id, int32_t worker_id)
     
     // Priority 2: Check if binary is loaded
     // In stub mode without CANN SDK, we cannot execute .o files
-    // Note: a2a3_lookup_incore_binary is a weak symbol - check if it's available
-    int binary_loaded = 0;
-    if (a2a3_lookup_incore_binary) {
-        A2A3InCoreBinaryEntry* entry = a2a3_lookup_incore_binary(task->func_name);
-        binary_loaded = (entry && entry->is_loaded);
-    }
-    if (binary_loaded) {
+    const A2A3InCoreDispatch* dispatch = a2a3_core_task_dispatch(task);
+    if (dispatch && dispatch->has_binary) {
         if (!s_stub_warning_shown) {
             printf("\n[A2A3 Core STUB] ================================================\n");
             printf("[A2A3 Core STUB] InCore functions loaded as .o binaries (AICore code).\n");
@@ -5,6 +5,7 @@
  * Based on ref_runtime/src/platform/a2a3/host/binary_loader.cpp
  */
 
+#include "../../pto_runtime_common.h"
 #include "a2a3_binary_loader.h"
 #include "../a2a3_runtime_api.h"
 
@@ -12,6 +13,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <elf.h>
 
@@ -23,8 +27,27 @@
 
 static A2A3InCoreBinaryEntry g_incore_binaries[A2A3_MAX_INCORE_BINARIES];
 static int g_incore_binary_count = 0;
+
+// Name index over g_incore_binaries (pto_runtime_common.h), at most half full.
+#define A2A3_BINARY_INDEX_SIZE (2 * A2A3_MAX_INCORE_BINARIES)
+#define A2A3_BINARY_NAME_SIZE sizeof(g_incore_binaries[0].func_name)
+static PTONameIndexSlot g_binary_index_slots[A2A3_BINARY_INDEX_SIZE];
+static PTONameIndex g_binary_index = {
+    g_binary_index_slots, A2A3_BINARY_INDEX_SIZE,
+    g_incore_binaries[0].func_name, sizeof(A2A3InCoreBinaryEntry), A2A3_BINARY_NAME_SIZE - 1,
+};
 static bool g_binary_loader_initialized = false;
 
+// Alignment of each kernel inside a packed device image
+#define A2A3_INCORE_IMAGE_ALIGN 512
+
+#ifdef CANN_SDK_AVAILABLE
+// Device images allocated by a2a3_copy_incore_binaries_to_device(); each
+// holds every binary that was pending at the time of the call.
+static void* g_incore_device_images[A2A3_MAX_INCORE_BINARIES];
+static int g_incore_device_image_count = 0;
+#endif
+
 // =============================================================================
 // Helper Functions
 // =============================================================================
@@ -54,6 +77,24 @@ static void extract_func_name_from_path(const char* file_path, char* func_name,
     }
 }
 
+/**
+ * Probe the name index. Returns the g_incore_binaries index, or -1.
+ */
+static int binary_index_find(const char* func_name) {
+    uint32_t hash = pto_name_hash(func_name, g_binary_index.name_len);
+    return pto_name_index_find(&g_binary_index, func_name, hash, NULL);
+}
+
+static void binary_index_insert(int index) {
+    const char* func_name = g_incore_binaries[index].func_name;
+    uint32_t hash = pto_name_hash(func_name, g_binary_index.name_len);
+    uint32_t slot = A2A3_BINARY_INDEX_SIZE;
+    if (pto_name_index_find(&g_binary_index, func_name, hash, &slot) < 0 &&
+        slot < A2A3_BINARY_INDEX_SIZE) {
+        pto_name_index_publish(&g_binary_index, slot, hash, index);
+    }
+}
+
 /**
  * Check if a file has .o extension.
  */
@@ -89,43 +130,39 @@ int a2a3_load_elf_text_section(const char* bin_path, uint8_t** out_data, size_t*
     *out_data = NULL;
     *out_size = 0;
     
-    // Step 1: Read entire file
-    uint32_t file_size = a2a3_get_file_size(bin_path);
-    if (file_size == 0) {
-        fprintf(stderr, "[A2A3 Binary Loader] Error: File is empty or cannot be read: %s\n", bin_path);
+    // Step 1: Map the file; only the headers and .text pages are touched
+    int fd = open(bin_path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "[A2A3 Binary Loader] Error: Cannot open file: %s\n", bin_path);
         return A2A3_ERROR_BINARY_LOAD_FAILED;
     }
+    // FD_CLOEXEC rather than O_CLOEXEC, which needs POSIX.1-2008
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
     
-    uint8_t* buf = (uint8_t*)malloc(file_size);
-    if (!buf) {
-        fprintf(stderr, "[A2A3 Binary Loader] Error: Failed to allocate buffer for file\n");
-        return A2A3_ERROR_MEMORY_ALLOC;
-    }
-    
-    FILE* file = fopen(bin_path, "rb");
-    if (!file) {
-        fprintf(stderr, "[A2A3 Binary Loader] Error: Cannot open file: %s\n", bin_path);
-        free(buf);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        fprintf(stderr, "[A2A3 Binary Loader] Error: File is empty or cannot be read: %s\n", bin_path);
+        close(fd);
         return A2A3_ERROR_BINARY_LOAD_FAILED;
     }
+    size_t file_size = (size_t)st.st_size;
     
-    size_t bytes_read = fread(buf, 1, file_size, file);
-    fclose(file);
-    
-    if (bytes_read != file_size) {
-        fprintf(stderr, "[A2A3 Binary Loader] Error: Failed to read file: %s\n", bin_path);
-        free(buf);
+    void* map = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // the mapping keeps the file referenced
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "[A2A3 Binary Loader] Error: Cannot map file: %s\n", bin_path);
         return A2A3_ERROR_BINARY_LOAD_FAILED;
     }
+    const uint8_t* buf = (const uint8_t*)map;
+    int rc = A2A3_ERROR_BINARY_LOAD_FAILED;
     
     // Step 2: Parse ELF header
     if (file_size < sizeof(Elf64_Ehdr)) {
         fprintf(stderr, "[A2A3 Binary Loader] Error: File too small for ELF header: %s\n", bin_path);
-        free(buf);
-        return A2A3_ERROR_BINARY_LOAD_FAILED;
+        goto out;
     }
     
-    Elf64_Ehdr* elf_header = (Elf64_Ehdr*)buf;
+    const Elf64_Ehdr* elf_header = (const Elf64_Ehdr*)buf;
     
     // Verify ELF magic number (0x7F 'E' 'L' 'F')
     if (elf_header->e_ident[EI_MAG0] != ELFMAG0 ||
@@ -133,72 +170,69 @@ int a2a3_load_elf_text_section(const char* bin_path, uint8_t** out_data, size_t*
         elf_header->e_ident[EI_MAG2] != ELFMAG2 ||
         elf_header->e_ident[EI_MAG3] != ELFMAG3) {
         fprintf(stderr, "[A2A3 Binary Loader] Error: Not a valid ELF file: %s\n", bin_path);
-        free(buf);
-        return A2A3_ERROR_BINARY_LOAD_FAILED;
+        goto out;
     }
     
     // Verify 64-bit ELF
     if (elf_header->e_ident[EI_CLASS] != ELFCLASS64) {
         fprintf(stderr, "[A2A3 Binary Loader] Error: Not a 64-bit ELF file: %s\n", bin_path);
-        free(buf);
-        return A2A3_ERROR_BINARY_LOAD_FAILED;
+        goto out;
     }
     
-    // Step 3: Get section headers
-    if (elf_header->e_shoff == 0 || elf_header->e_shnum == 0) {
+    // Step 3: Get section headers (every offset is checked against the mapping)
+    if (elf_header->e_shoff == 0 || elf_header->e_shnum == 0 ||
+        elf_header->e_shoff + (uint64_t)elf_header->e_shnum * sizeof(Elf64_Shdr) > file_size) {
         fprintf(stderr, "[A2A3 Binary Loader] Error: No section headers in ELF file: %s\n", bin_path);
-        free(buf);
-        return A2A3_ERROR_BINARY_LOAD_FAILED;
+        goto out;
     }
     
-    Elf64_Shdr* section_headers = (Elf64_Shdr*)(buf + elf_header->e_shoff);
+    const Elf64_Shdr* section_headers = (const Elf64_Shdr*)(buf + elf_header->e_shoff);
     
     // Get string table for section names
     if (elf_header->e_shstrndx >= elf_header->e_shnum) {
         fprintf(stderr, "[A2A3 Binary Loader] Error: Invalid section string table index: %s\n", bin_path);
-        free(buf);
-        return A2A3_ERROR_BINARY_LOAD_FAILED;
+        goto out;
     }
     
-    Elf64_Shdr* shstr_header = &section_headers[elf_header->e_shstrndx];
-    char* strtbl = (char*)(buf + shstr_header->sh_offset);
-    
-    // Step 4: Find and extract .text section
-    uint8_t* text_data = NULL;
-    size_t text_size = 0;
+    const Elf64_Shdr* shstr_header = &section_headers[elf_header->e_shstrndx];
+    if (shstr_header->sh_offset + shstr_header->sh_size > file_size) {
+        fprintf(stderr, "[A2A3 Binary Loader] Error: Invalid section string table: %s\n", bin_path);
+        goto out;
+    }
+    const char* strtbl = (const char*)(buf + shstr_header->sh_offset);
     
+    // Step 4: Find .text and copy it straight out of the mapping
     for (int i = 0; i < elf_header->e_shnum; i++) {
-        Elf64_Shdr* section = &section_headers[i];
-        char* section_name = strtbl + section->sh_name;
-        
-        if (strcmp(section_name, ".text") == 0) {
-            // Extract .text section binary data
-            text_size = section->sh_size;
-            text_data = (uint8_t*)malloc(text_size);
-            if (!text_data) {
-                fprintf(stderr, "[A2A3 Binary Loader] Error: Failed to allocate text section buffer\n");
-                free(buf);
-                return A2A3_ERROR_MEMORY_ALLOC;
-            }
-            
-            memcpy(text_data, buf + section->sh_offset, text_size);
-            
-            printf("[A2A3 Binary Loader] Loaded .text section from %s (size: %zu bytes)\n",
-                   bin_path, text_size);
+        const Elf64_Shdr* section = &section_headers[i];
+        if (section->sh_name + sizeof(".text") > shstr_header->sh_size ||
+            strcmp(strtbl + section->sh_name, ".text") != 0) {
+            continue;
+        }
+        if (section->sh_size == 0 || section->sh_offset + section->sh_size > file_size) {
             break;
         }
+        
+        uint8_t* text_data = (uint8_t*)malloc(section->sh_size);
+        if (!text_data) {
+            fprintf(stderr, "[A2A3 Binary Loader] Error: Failed to allocate text section buffer\n");
+            rc = A2A3_ERROR_MEMORY_ALLOC;
+            goto out;
+        }
+        memcpy(text_data, buf + section->sh_offset, section->sh_size);
+        
+        *out_data = text_data;
+        *out_size = section->sh_size;
+        printf("[A2A3 Binary Loader] Loaded .text section from %s (size: %zu bytes)\n",
+               bin_path, *out_size);
+        rc = A2A3_SUCCESS;
+        goto out;
     }
     
-    free(buf);
+    fprintf(stderr, "[A2A3 Binary Loader] Error: .text section not found in: %s\n", bin_path);
     
-    if (!text_data || text_size == 0) {
-        fprintf(stderr, "[A2A3 Binary Loader] Error: .text section not found in: %s\n", bin_path);
-        return A2A3_ERROR_BINARY_LOAD_FAILED;
-    }
-    
-    *out_data = text_data;
-    *out_size = text_size;
-    return A2A3_SUCCESS;
+out:
+    munmap(map, file_size);
+    return rc;
 }
 
 // =============================================================================
@@ -267,19 +301,20 @@ int a2a3_load_incore_binary(const char* bin_path, const char* func_name, bool is
     }
     
     // Extract function name if not provided
-    char name_buf[128];
+    char name_buf[A2A3_BINARY_NAME_SIZE];
     if (!func_name) {
         extract_func_name_from_path(bin_path, name_buf, sizeof(name_buf));
         func_name = name_buf;
     }
+    if (strlen(func_name) >= A2A3_BINARY_NAME_SIZE) {
+        fprintf(stderr, "[A2A3 Binary Loader] Error: InCore function name too long: %s\n", func_name);
+        return A2A3_ERROR_INVALID_CONFIG;
+    }
     
     // Check if already loaded
-    for (int i = 0; i < g_incore_binary_count; i++) {
-        if (g_incore_binaries[i].is_loaded &&
-            strcmp(g_incore_binaries[i].func_name, func_name) == 0) {
-            printf("[A2A3 Binary Loader] Binary '%s' already loaded, skipping\n", func_name);
-            return 0;
-        }
+    if (binary_index_find(func_name) >= 0) {
+        printf("[A2A3 Binary Loader] Binary '%s' already loaded, skipping\n", func_name);
+        return 0;
     }
     
     // Load ELF .text section
@@ -293,13 +328,13 @@ int a2a3_load_incore_binary(const char* bin_path, const char* func_name, bool is
     
     // Register the binary
     A2A3InCoreBinaryEntry* entry = &g_incore_binaries[g_incore_binary_count];
-    strncpy(entry->func_name, func_name, sizeof(entry->func_name) - 1);
-    entry->func_name[sizeof(entry->func_name) - 1] = '\0';
+    snprintf(entry->func_name, sizeof(entry->func_name), "%s", func_name);  // Length checked above
     entry->binary_data = binary_data;
     entry->binary_size = binary_size;
     entry->device_addr = 0;  // Will be set when loaded to device
     entry->is_cube = is_cube;
     entry->is_loaded = true;
+    binary_index_insert(g_incore_binary_count);
     g_incore_binary_count++;
     
     printf("[A2A3 Binary Loader] Loaded InCore binary: %s -> %s (%zu bytes) [%s]\n",
@@ -311,14 +346,13 @@ int a2a3_load_incore_binary(const char* bin_path, const char* func_name, bool is
 A2A3InCoreBinaryEntry* a2a3_lookup_incore_binary(const char* func_name) {
     if (!func_name) return NULL;
     
-    for (int i = 0; i < g_incore_binary_count; i++) {
-        if (g_incore_binaries[i].is_loaded &&
-            strcmp(g_incore_binaries[i].func_name, func_name) == 0) {
-            return &g_incore_binaries[i];
-        }
-    }
-    
-    return NULL;
+    int index = binary_index_find(func_name);
+    return index >= 0 ? &g_incore_binaries[index] : NULL;
+}
+
+A2A3InCoreBinaryEntry* a2a3_get_incore_binary(int index) {
+    if (index < 0 || index >= g_incore_binary_count) return NULL;
+    return &g_incore_binaries[index];
 }
 
 int a2a3_get_incore_binary_count(void) {
@@ -330,18 +364,22 @@ void a2a3_unload_all_incore_binaries(void) {
         if (g_incore_binaries[i].is_loaded && g_incore_binaries[i].binary_data) {
             free(g_incore_binaries[i].binary_data);
         }
-#ifdef CANN_SDK_AVAILABLE
-        // Free device memory if allocated
-        if (g_incore_binaries[i].device_addr != 0) {
-            aclrtFree((void*)g_incore_binaries[i].device_addr);
-        }
-#endif
         g_incore_binaries[i].is_loaded = false;
         g_incore_binaries[i].binary_data = NULL;
         g_incore_binaries[i].binary_size = 0;
         g_incore_binaries[i].device_addr = 0;
     }
     g_incore_binary_count = 0;
+    memset(g_binary_index_slots, 0, sizeof(g_binary_index_slots));
+    
+#ifdef CANN_SDK_AVAILABLE
+    // Binaries share packed device images; free the images, not the entries
+    for (int i = 0; i < g_incore_device_image_count; i++) {
+        aclrtFree(g_incore_device_images[i]);
+        g_incore_device_images[i] = NULL;
+    }
+    g_incore_device_image_count = 0;
+#endif
 }
 
 // =============================================================================
@@ -371,51 +409,103 @@ static inline int aclrtMemcpy(void* dst, size_t dstMax, const void* src, size_t
 int a2a3_copy_incore_binaries_to_device(void) {
     int copied = 0;
     
+#ifdef CANN_SDK_AVAILABLE
+    // Pack every pending binary into one host staging buffer, then do a
+    // single device allocation and a single host->device copy.
+    size_t image_size = 0;
+    int pending = 0;
     for (int i = 0; i < g_incore_binary_count; i++) {
         A2A3InCoreBinaryEntry* entry = &g_incore_binaries[i];
-        
         if (!entry->is_loaded || !entry->binary_data || entry->binary_size == 0) {
             continue;
         }
-        
-        // Skip if already copied
         if (entry->device_addr != 0) {
-            copied++;
+            copied++;  // already on device
             continue;
         }
+        image_size = (image_size + A2A3_INCORE_IMAGE_ALIGN - 1) & ~(size_t)(A2A3_INCORE_IMAGE_ALIGN - 1);
+        image_size += entry->binary_size;
+        pending++;
+    }
+    
+    if (pending > 0) {
+        if (g_incore_device_image_count >= A2A3_MAX_INCORE_BINARIES) {
+            fprintf(stderr, "[A2A3 Binary Loader] Error: Too many device images\n");
+            return A2A3_ERROR_MEMORY_ALLOC;
+        }
+        
+        uint8_t* staging = (uint8_t*)calloc(1, image_size);
+        if (!staging) {
+            fprintf(stderr, "[A2A3 Binary Loader] Error: Failed to allocate %zu byte staging buffer\n",
+                    image_size);
+            return A2A3_ERROR_MEMORY_ALLOC;
+        }
+        size_t offsets[A2A3_MAX_INCORE_BINARIES];
+        size_t offset = 0;
+        for (int i = 0; i < g_incore_binary_count; i++) {
+            A2A3InCoreBinaryEntry* entry = &g_incore_binaries[i];
+            if (!entry->is_loaded || !entry->binary_data || entry->binary_size == 0 ||
+                entry->device_addr != 0) {
+                continue;
+            }
+            offset = (offset + A2A3_INCORE_IMAGE_ALIGN - 1) & ~(size_t)(A2A3_INCORE_IMAGE_ALIGN - 1);
+            memcpy(staging + offset, entry->binary_data, entry->binary_size);
+            offsets[i] = offset;
+            offset += entry->binary_size;
+        }
         
-#ifdef CANN_SDK_AVAILABLE
-        // Allocate device GM memory
         void* dev_ptr = NULL;
-        aclError rc = aclrtMalloc(&dev_ptr, entry->binary_size, ACL_MEM_MALLOC_HUGE_FIRST);
+        aclError rc = aclrtMalloc(&dev_ptr, image_size, ACL_MEM_MALLOC_HUGE_FIRST);
         if (rc != ACL_SUCCESS) {
-            fprintf(stderr, "[A2A3 Binary Loader] Error: Failed to allocate device memory for %s: %d\n",
-                    entry->func_name, rc);
-            continue;
+            fprintf(stderr, "[A2A3 Binary Loader] Error: Failed to allocate %zu bytes of device memory: %d\n",
+                    image_size, rc);
+            free(staging);
+            return A2A3_ERROR_MEMORY_ALLOC;
         }
-        
-        // Copy binary to device
-        rc = aclrtMemcpy(dev_ptr, entry->binary_size, entry->binary_data, 
-                         entry->binary_size, ACL_MEMCPY_HOST_TO_DEVICE);
+        rc = aclrtMemcpy(dev_ptr, image_size, staging, image_size, ACL_MEMCPY_HOST_TO_DEVICE);
+        free(staging);
         if (rc != ACL_SUCCESS) {
-            fprintf(stderr, "[A2A3 Binary Loader] Error: Failed to copy %s to device: %d\n",
-                    entry->func_name, rc);
+            fprintf(stderr, "[A2A3 Binary Loader] Error: Failed to copy binaries to device: %d\n", rc);
             aclrtFree(dev_ptr);
-            continue;
+            return A2A3_ERROR_MEMORY_ALLOC;
         }
+        g_incore_device_images[g_incore_device_image_count++] = dev_ptr;
         
-        entry->device_addr = (uint64_t)dev_ptr;
-        printf("[A2A3 Binary Loader] Copied %s to device: 0x%lx (%zu bytes)\n",
-               entry->func_name, entry->device_addr, entry->binary_size);
-        copied++;
+        for (int i = 0; i < g_incore_binary_count; i++) {
+            A2A3InCoreBinaryEntry* entry = &g_incore_binaries[i];
+            if (!entry->is_loaded || !entry->binary_data || entry->binary_size == 0 ||
+                entry->device_addr != 0) {
+                continue;
+            }
+            entry->device_addr = (uint64_t)dev_ptr + offsets[i];
+            printf("[A2A3 Binary Loader] Copied %s to device: 0x%lx (%zu bytes)\n",
+                   entry->func_name, entry->device_addr, entry->binary_size);
+            copied++;
+        }
+        printf("[A2A3 Binary Loader] Packed %d binaries into one %zu byte device image\n",
+               pending, image_size);
+    }
 #else
+    for (int i = 0; i < g_incore_binary_count; i++) {
+        A2A3InCoreBinaryEntry* entry = &g_incore_binaries[i];
+        
+        if (!entry->is_loaded || !entry->binary_data || entry->binary_size == 0) {
+            continue;
+        }
+        
+        // Skip if already copied
+        if (entry->device_addr != 0) {
+            copied++;
+            continue;
+        }
+        
         // Stub mode: use host address as device address (for testing)
         entry->device_addr = (uint64_t)entry->binary_data;
         printf("[A2A3 Binary Loader] Stub mode: %s -> 0x%lx (%zu bytes)\n",
                entry->func_name, entry->device_addr, entry->binary_size);
         copied++;
-#endif
     }
+#endif
     
     printf("[A2A3 Binary Loader] Copied %d binaries to device\n", copied);
     return copied;
@@ -437,6 +527,7 @@ void a2a3_binary_loader_init(void) {
     if (g_binary_loader_initialized) return;
     
     memset(g_incore_binaries, 0, sizeof(g_incore_binaries));
+    memset(g_binary_index_slots, 0, sizeof(g_binary_index_slots));
     g_incore_binary_count = 0;
     g_binary_loader_initialized = true;
     
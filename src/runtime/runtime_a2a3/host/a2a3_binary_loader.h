@@ -58,10 +58,10 @@ uint32_t a2a3_get_file_size(const char* file_path);
  * Load and extract .text section from ELF .o file.
  *
  * This function:
- * 1. Reads the entire .o file into memory
+ * 1. Maps the .o file read-only (mmap)
  * 2. Parses the ELF64 header
  * 3. Locates the .text section (executable code)
- * 4. Extracts and returns the .text section binary data
+ * 4. Copies the .text section out of the mapping and returns it
  *
  * @param bin_path     Path to the .o file (ELF format)
  * @param out_data     Output: pointer to allocated binary data (caller must free)
@@ -92,13 +92,21 @@ int a2a3_load_incore_binary_dir(const char* dir_path, bool is_cube);
 int a2a3_load_incore_binary(const char* bin_path, const char* func_name, bool is_cube);
 
 /**
- * Lookup InCore binary by name.
+ * Lookup InCore binary by name (hash index, no linear scan).
  * 
  * @param func_name  Function name
  * @return Pointer to binary entry, or NULL if not found
  */
 A2A3InCoreBinaryEntry* a2a3_lookup_incore_binary(const char* func_name);
 
+/**
+ * Get InCore binary by registration index.
+ * 
+ * @param index  0 .. a2a3_get_incore_binary_count() - 1
+ * @return Pointer to binary entry, or NULL if out of range
+ */
+A2A3InCoreBinaryEntry* a2a3_get_incore_binary(int index);
+
 /**
  * Get number of loaded InCore binaries.
  */
@@ -107,9 +115,10 @@ int a2a3_get_incore_binary_count(void);
 /**
  * Copy all loaded InCore binaries to device GM memory.
  * 
- * This function uses CANN API to allocate device memory and copy
- * the loaded binary data. After this call, device_addr in each
- * entry will contain the device GM address.
+ * Binaries not yet on the device are packed into one staging buffer
+ * (each aligned to 512 bytes) and transferred with a single CANN
+ * allocation and copy. After this call, device_addr in each entry
+ * will contain the device GM address.
  * 
  * @return Number of binaries copied, or negative on failure
  */
@@ -65,8 +65,13 @@ int runtime_entry_a2a3(PTOOrchFunc orch_func, void* user_data,
         return -1;
     }
     
-    // Initialize
+    // Initialize (capacities from PTO_RUNTIME_PRESET, default large)
     pto_runtime_init(rt);
+    if (!rt->table_mem) {
+        fprintf(stderr, "[A2A3 Host] ERROR: Failed to initialize runtime\n");
+        free(rt);
+        return -1;
+    }
     pto_runtime_enable_a2a3_sim(rt, num_vector_workers, num_cube_workers);
     rt->num_workers = total_workers;
     rt->shutdown_requested = false;
@@ -6,12 +6,14 @@
 
 #define _GNU_SOURCE  // For dlopen, dlsym, etc.
 
+#include "../../pto_runtime_common.h"
 #include "a2a3_so_loader.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <dlfcn.h>
 #include <dirent.h>
+#include <pthread.h>
 #include <sys/stat.h>
 
 // =============================================================================
@@ -27,6 +29,23 @@ static A2A3InCoreFuncEntry g_incore_registry[A2A3_MAX_INCORE_FUNCS];
 static int g_incore_count = 0;
 static bool g_so_loader_initialized = false;
 
+// InCore function ids. Every name (.so, registered or .o binary) gets a dense
+// id the first time it is registered; g_incore_dispatch[id] is what workers
+// read. The name index (pto_runtime_common.h) is at most half full; lookups
+// are lock-free, inserts take g_incore_id_mutex.
+#define A2A3_INCORE_INDEX_SIZE (2 * A2A3_MAX_INCORE_IDS)
+#define A2A3_INCORE_NAME_SIZE 128
+
+static PTONameIndexSlot g_incore_index_slots[A2A3_INCORE_INDEX_SIZE];
+static char g_incore_id_names[A2A3_MAX_INCORE_IDS][A2A3_INCORE_NAME_SIZE];
+static PTONameIndex g_incore_index = {
+    g_incore_index_slots, A2A3_INCORE_INDEX_SIZE,
+    g_incore_id_names[0], A2A3_INCORE_NAME_SIZE, A2A3_INCORE_NAME_SIZE - 1,
+};
+static A2A3InCoreDispatch g_incore_dispatch[A2A3_MAX_INCORE_IDS];
+static int32_t g_incore_id_count = 0;
+static pthread_mutex_t g_incore_id_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 // =============================================================================
 // Helper Functions
 // =============================================================================
@@ -61,6 +80,50 @@ static void extract_func_name(const char* so_path, char* func_name, size_t max_l
     }
 }
 
+/**
+ * Find the id of an InCore function name. Returns -1 if unknown.
+ */
+static int32_t incore_id_find(const char* func_name) {
+    uint32_t hash = pto_name_hash(func_name, g_incore_index.name_len);
+    return pto_name_index_find(&g_incore_index, func_name, hash, NULL);
+}
+
+/**
+ * Find or assign the id of an InCore function name. Returns -1 if the id
+ * space is exhausted.
+ */
+static int32_t incore_id_intern(const char* func_name) {
+    uint32_t hash = pto_name_hash(func_name, g_incore_index.name_len);
+    int32_t id = pto_name_index_find(&g_incore_index, func_name, hash, NULL);
+    if (id >= 0) return id;
+    
+    pthread_mutex_lock(&g_incore_id_mutex);
+    uint32_t slot = A2A3_INCORE_INDEX_SIZE;
+    id = pto_name_index_find(&g_incore_index, func_name, hash, &slot);  // Another thread may have won
+    if (id < 0 && slot < A2A3_INCORE_INDEX_SIZE && g_incore_id_count < A2A3_MAX_INCORE_IDS) {
+        id = g_incore_id_count++;
+        snprintf(g_incore_id_names[id], A2A3_INCORE_NAME_SIZE, "%.*s",
+                 A2A3_INCORE_NAME_SIZE - 1, func_name);
+        memset(&g_incore_dispatch[id], 0, sizeof(g_incore_dispatch[id]));
+        pto_name_index_publish(&g_incore_index, slot, hash, id);
+    }
+    pthread_mutex_unlock(&g_incore_id_mutex);
+    
+    if (id < 0) {
+        fprintf(stderr, "[A2A3 SO Loader] ERROR: Maximum InCore function ids reached (%d)\n",
+                A2A3_MAX_INCORE_IDS);
+    }
+    return id;
+}
+
+static void incore_id_reset(void) {
+    pthread_mutex_lock(&g_incore_id_mutex);
+    memset(g_incore_index_slots, 0, sizeof(g_incore_index_slots));
+    memset(g_incore_dispatch, 0, sizeof(g_incore_dispatch));
+    g_incore_id_count = 0;
+    pthread_mutex_unlock(&g_incore_id_mutex);
+}
+
 /**
  * Check if a file has .so extension.
  */
@@ -201,6 +264,7 @@ int a2a3_load_incore_dir(const char* dir_path, bool is_cube) {
     closedir(dir);
     
     if (load_o_files) {
+        a2a3_refresh_incore_dispatch();
         printf("[A2A3 SO Loader] Loaded %d %s binaries (.o) from %s\n",
                binary_count, is_cube ? "AIC" : "AIV", dir_path);
         return binary_count;
@@ -223,19 +287,26 @@ int a2a3_load_incore_so(const char* so_path, const char* func_name, bool is_cube
     }
     
     // Extract function name if not provided
-    char name_buf[128];
+    char name_buf[A2A3_INCORE_NAME_SIZE];
     if (!func_name) {
         extract_func_name(so_path, name_buf, sizeof(name_buf));
         func_name = name_buf;
     }
+    if (strlen(func_name) >= A2A3_INCORE_NAME_SIZE) {
+        fprintf(stderr, "[A2A3 SO Loader] ERROR: InCore function name too long: %s\n", func_name);
+        return A2A3_ERROR_INVALID_CONFIG;
+    }
     
     // Check if already loaded
-    for (int i = 0; i < g_incore_count; i++) {
-        if (g_incore_registry[i].is_loaded &&
-            strcmp(g_incore_registry[i].func_name, func_name) == 0) {
-            printf("[A2A3 SO Loader] Function '%s' already loaded, skipping\n", func_name);
-            return 0;
-        }
+    int32_t existing = incore_id_find(func_name);
+    if (existing >= 0 && g_incore_dispatch[existing].func_ptr) {
+        printf("[A2A3 SO Loader] Function '%s' already loaded, skipping\n", func_name);
+        return 0;
+    }
+    
+    int32_t id = incore_id_intern(func_name);
+    if (id < 0) {
+        return A2A3_ERROR_MEMORY_ALLOC;
     }
     
     // Load the .so file
@@ -256,16 +327,20 @@ int a2a3_load_incore_so(const char* so_path, const char* func_name, bool is_cube
     // If not found, try with common prefixes/suffixes
     if (error) {
         // Try with "kernel_" prefix
-        char alt_name[128];
-        snprintf(alt_name, sizeof(alt_name), "kernel_%s", func_name);
-        func = (A2A3InCoreFunc)dlsym(handle, alt_name);
-        error = dlerror();
+        char alt_name[A2A3_INCORE_NAME_SIZE + 8];
+        int len = snprintf(alt_name, sizeof(alt_name), "kernel_%.*s", A2A3_INCORE_NAME_SIZE - 1, func_name);
+        if (len > 0 && (size_t)len < sizeof(alt_name)) {
+            func = (A2A3InCoreFunc)dlsym(handle, alt_name);
+            error = dlerror();
+        }
         
         if (error) {
             // Try with "_entry" suffix
-            snprintf(alt_name, sizeof(alt_name), "%s_entry", func_name);
-            func = (A2A3InCoreFunc)dlsym(handle, alt_name);
-            error = dlerror();
+            len = snprintf(alt_name, sizeof(alt_name), "%.*s_entry", A2A3_INCORE_NAME_SIZE - 1, func_name);
+            if (len > 0 && (size_t)len < sizeof(alt_name)) {
+                func = (A2A3InCoreFunc)dlsym(handle, alt_name);
+                error = dlerror();
+            }
         }
     }
     
@@ -277,16 +352,18 @@ int a2a3_load_incore_so(const char* so_path, const char* func_name, bool is_cube
     
     // Register the function
     A2A3InCoreFuncEntry* entry = &g_incore_registry[g_incore_count];
-    strncpy(entry->func_name, func_name, sizeof(entry->func_name) - 1);
-    entry->func_name[sizeof(entry->func_name) - 1] = '\0';
+    snprintf(entry->func_name, sizeof(entry->func_name), "%s", func_name);  // Length checked above
     entry->func_ptr = func;
     entry->so_handle = handle;
     entry->is_cube = is_cube;
     entry->is_loaded = true;
     g_incore_count++;
     
-    printf("[A2A3 SO Loader] Loaded InCore: %s -> %s() [%s]\n",
-           so_path, func_name, is_cube ? "AIC" : "AIV");
+    g_incore_dispatch[id].func_ptr = func;
+    g_incore_dispatch[id].is_cube = is_cube;
+    
+    printf("[A2A3 SO Loader] Loaded InCore: %s -> %s() [%s, id %d]\n",
+           so_path, func_name, is_cube ? "AIC" : "AIV", id);
     
     return 0;
 }
@@ -294,59 +371,90 @@ int a2a3_load_incore_so(const char* so_path, const char* func_name, bool is_cube
 A2A3InCoreFunc a2a3_lookup_incore(const char* func_name) {
     if (!func_name) return NULL;
     
-    for (int i = 0; i < g_incore_count; i++) {
-        if (g_incore_registry[i].is_loaded &&
-            strcmp(g_incore_registry[i].func_name, func_name) == 0) {
-            return g_incore_registry[i].func_ptr;
-        }
-    }
-    
-    return NULL;
+    int32_t id = incore_id_find(func_name);
+    return id >= 0 ? g_incore_dispatch[id].func_ptr : NULL;
 }
 
 bool a2a3_is_cube_func(const char* func_name) {
     if (!func_name) return false;
     
-    for (int i = 0; i < g_incore_count; i++) {
-        if (g_incore_registry[i].is_loaded &&
-            strcmp(g_incore_registry[i].func_name, func_name) == 0) {
-            return g_incore_registry[i].is_cube;
+    int32_t id = incore_id_find(func_name);
+    return id >= 0 && g_incore_dispatch[id].is_cube;
+}
+
+int32_t a2a3_resolve_incore_id(const char* func_name) {
+    if (!func_name) return -1;
+    return incore_id_find(func_name);
+}
+
+const A2A3InCoreDispatch* a2a3_get_incore_dispatch_table(void) {
+    return g_incore_dispatch;
+}
+
+void a2a3_refresh_incore_dispatch(void) {
+    int count = a2a3_get_incore_binary_count();
+    for (int i = 0; i < count; i++) {
+        A2A3InCoreBinaryEntry* bin = a2a3_get_incore_binary(i);
+        if (!bin || !bin->is_loaded) continue;
+        
+        int32_t id = incore_id_intern(bin->func_name);
+        if (id < 0) return;
+        
+        A2A3InCoreDispatch* d = &g_incore_dispatch[id];
+        d->device_addr = bin->device_addr;
+        d->has_binary = true;
+        if (!d->func_ptr) {
+            d->is_cube = bin->is_cube;  // a host function's type takes precedence
         }
     }
-    
-    return false;
 }
 
 int a2a3_register_incore(const char* func_name, A2A3InCoreFunc func_ptr, bool is_cube) {
     if (!func_name || !func_ptr) {
         return A2A3_ERROR_INVALID_CONFIG;
     }
+    if (strlen(func_name) >= A2A3_INCORE_NAME_SIZE) {
+        fprintf(stderr, "[A2A3 SO Loader] ERROR: InCore function name too long: %s\n", func_name);
+        return A2A3_ERROR_INVALID_CONFIG;
+    }
+    
+    int32_t id = incore_id_find(func_name);
+    if (id >= 0 && g_incore_dispatch[id].func_ptr) {
+        // Update existing entry
+        for (int i = 0; i < g_incore_count; i++) {
+            if (g_incore_registry[i].is_loaded &&
+                strcmp(g_incore_registry[i].func_name, func_name) == 0) {
+                g_incore_registry[i].func_ptr = func_ptr;
+                g_incore_registry[i].is_cube = is_cube;
+                break;
+            }
+        }
+        g_incore_dispatch[id].func_ptr = func_ptr;
+        g_incore_dispatch[id].is_cube = is_cube;
+        return 0;
+    }
     
     if (g_incore_count >= A2A3_MAX_INCORE_FUNCS) {
         return A2A3_ERROR_MEMORY_ALLOC;
     }
     
-    // Check if already registered
-    for (int i = 0; i < g_incore_count; i++) {
-        if (g_incore_registry[i].is_loaded &&
-            strcmp(g_incore_registry[i].func_name, func_name) == 0) {
-            // Update existing entry
-            g_incore_registry[i].func_ptr = func_ptr;
-            g_incore_registry[i].is_cube = is_cube;
-            return 0;
-        }
+    id = incore_id_intern(func_name);
+    if (id < 0) {
+        return A2A3_ERROR_MEMORY_ALLOC;
     }
     
     // Add new entry
     A2A3InCoreFuncEntry* entry = &g_incore_registry[g_incore_count];
-    strncpy(entry->func_name, func_name, sizeof(entry->func_name) - 1);
-    entry->func_name[sizeof(entry->func_name) - 1] = '\0';
+    snprintf(entry->func_name, sizeof(entry->func_name), "%s", func_name);  // Length checked above
     entry->func_ptr = func_ptr;
     entry->so_handle = NULL;  // Not loaded from .so
     entry->is_cube = is_cube;
     entry->is_loaded = true;
     g_incore_count++;
     
+    g_incore_dispatch[id].func_ptr = func_ptr;
+    g_incore_dispatch[id].is_cube = is_cube;
+    
     return 0;
 }
 
@@ -365,6 +473,7 @@ void a2a3_unload_all_incore(void) {
         g_incore_registry[i].func_ptr = NULL;
     }
     g_incore_count = 0;
+    incore_id_reset();
 }
 
 // =============================================================================
@@ -377,6 +486,7 @@ void a2a3_so_loader_init(void) {
     // Clear registry
     memset(g_incore_registry, 0, sizeof(g_incore_registry));
     g_incore_count = 0;
+    incore_id_reset();
     g_orch_handle = NULL;
     g_orch_func = NULL;
     g_so_loader_initialized = true;
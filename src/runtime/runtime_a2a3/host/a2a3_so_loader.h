@@ -82,7 +82,7 @@ int a2a3_load_incore_dir(const char* dir_path, bool is_cube);
 int a2a3_load_incore_so(const char* so_path, const char* func_name, bool is_cube);
 
 /**
- * Lookup InCore function by name.
+ * Lookup InCore function by name (hash index, no linear scan).
  * 
  * @param func_name  Function name
  * @return Function pointer, or NULL if not found
@@ -97,6 +97,38 @@ A2A3InCoreFunc a2a3_lookup_incore(const char* func_name);
  */
 bool a2a3_is_cube_func(const char* func_name);
 
+// =============================================================================
+// InCore Function Ids
+// =============================================================================
+
+/**
+ * Maximum number of distinct InCore function ids (.so/registered + .o).
+ */
+#define A2A3_MAX_INCORE_IDS (2 * A2A3_MAX_INCORE_FUNCS)
+
+/**
+ * Resolve an InCore function name to its integer id.
+ * 
+ * Ids are assigned at load/registration time and stay valid until
+ * a2a3_unload_all_incore(). Call this once per task (at creation), then
+ * index a2a3_get_incore_dispatch_table() with the id.
+ * 
+ * @param func_name  Function name
+ * @return Function id, or -1 if no function of that name is loaded
+ */
+int32_t a2a3_resolve_incore_id(const char* func_name);
+
+/**
+ * Get the dense dispatch table, indexed by function id.
+ */
+const A2A3InCoreDispatch* a2a3_get_incore_dispatch_table(void);
+
+/**
+ * Update the dispatch table from the binary loader (.o functions and their
+ * device addresses). Call after a2a3_copy_incore_binaries_to_device().
+ */
+void a2a3_refresh_incore_dispatch(void);
+
 /**
  * Register an InCore function manually (without loading from .so).
  * 
@@ -12,19 +12,20 @@
 
 #include <time.h>  // Must be after _POSIX_C_SOURCE for clock_gettime
 #include "a2a3_orchestration.h"
+#include "../a2a3_runtime_api.h"
 
 // =============================================================================
 // Dual Ready Queue Implementation
 // =============================================================================
 
 static void vector_queue_push(PTORuntime* rt, int32_t task_id) {
-    if (rt->vector_ready_count >= PTO_MAX_READY_QUEUE) {
+    if (rt->vector_ready_count >= rt->ready_queue_size) {
         fprintf(stderr, "[A2A3 Orch] ERROR: Vector queue overflow\n");
         return;
     }
     
     rt->vector_ready_queue[rt->vector_ready_tail] = task_id;
-    rt->vector_ready_tail = (rt->vector_ready_tail + 1) % PTO_MAX_READY_QUEUE;
+    rt->vector_ready_tail = (rt->vector_ready_tail + 1) & rt->ready_queue_mask;
     rt->vector_ready_count++;
 }
 
@@ -34,19 +35,19 @@ static int32_t vector_queue_pop(PTORuntime* rt) {
     }
     
     int32_t task_id = rt->vector_ready_queue[rt->vector_ready_head];
-    rt->vector_ready_head = (rt->vector_ready_head + 1) % PTO_MAX_READY_QUEUE;
+    rt->vector_ready_head = (rt->vector_ready_head + 1) & rt->ready_queue_mask;
     rt->vector_ready_count--;
     return task_id;
 }
 
 static void cube_queue_push(PTORuntime* rt, int32_t task_id) {
-    if (rt->cube_ready_count >= PTO_MAX_READY_QUEUE) {
+    if (rt->cube_ready_count >= rt->ready_queue_size) {
         fprintf(stderr, "[A2A3 Orch] ERROR: Cube queue overflow\n");
         return;
     }
     
     rt->cube_ready_queue[rt->cube_ready_tail] = task_id;
-    rt->cube_ready_tail = (rt->cube_ready_tail + 1) % PTO_MAX_READY_QUEUE;
+    rt->cube_ready_tail = (rt->cube_ready_tail + 1) & rt->ready_queue_mask;
     rt->cube_ready_count++;
 }
 
@@ -56,7 +57,7 @@ static int32_t cube_queue_pop(PTORuntime* rt) {
     }
     
     int32_t task_id = rt->cube_ready_queue[rt->cube_ready_head];
-    rt->cube_ready_head = (rt->cube_ready_head + 1) % PTO_MAX_READY_QUEUE;
+    rt->cube_ready_head = (rt->cube_ready_head + 1) & rt->ready_queue_mask;
     rt->cube_ready_count--;
     return task_id;
 }
@@ -81,7 +82,7 @@ void a2a3_orch_init(PTORuntime* rt, int32_t num_vector_workers, int32_t num_cube
 }
 
 void a2a3_orch_route_to_queue(PTORuntime* rt, int32_t task_id) {
-    int32_t slot = PTO_TASK_SLOT(task_id);
+    int32_t slot = PTO_TASK_SLOT(rt, task_id);
     bool is_cube = rt->pend_task[slot].is_cube;
     
     if (is_cube) {
@@ -96,28 +97,28 @@ void a2a3_orch_route_to_queue(PTORuntime* rt, int32_t task_id) {
 void a2a3_orch_route_to_queue_threadsafe(PTORuntime* rt, int32_t task_id) {
     pthread_mutex_lock(&rt->queue_mutex);
     
-    int32_t slot = PTO_TASK_SLOT(task_id);
+    int32_t slot = PTO_TASK_SLOT(rt, task_id);
     bool is_cube = rt->pend_task[slot].is_cube;
     
     if (is_cube) {
-        if (rt->cube_ready_count >= PTO_MAX_READY_QUEUE) {
+        if (rt->cube_ready_count >= rt->ready_queue_size) {
             fprintf(stderr, "[A2A3 Orch] ERROR: Cube queue overflow\n");
             pthread_mutex_unlock(&rt->queue_mutex);
             return;
         }
         rt->cube_ready_queue[rt->cube_ready_tail] = task_id;
-        rt->cube_ready_tail = (rt->cube_ready_tail + 1) % PTO_MAX_READY_QUEUE;
+        rt->cube_ready_tail = (rt->cube_ready_tail + 1) & rt->ready_queue_mask;
         rt->cube_ready_count++;
         pthread_cond_broadcast(&rt->cube_queue_not_empty);
         DEBUG_PRINT("[A2A3 Orch] Task %d -> CUBE queue (count=%d)\n", task_id, rt->cube_ready_count);
     } else {
-        if (rt->vector_ready_count >= PTO_MAX_READY_QUEUE) {
+        if (rt->vector_ready_count >= rt->ready_queue_size) {
             fprintf(stderr, "[A2A3 Orch] ERROR: Vector queue overflow\n");
             pthread_mutex_unlock(&rt->queue_mutex);
             return;
         }
         rt->vector_ready_queue[rt->vector_ready_tail] = task_id;
-        rt->vector_ready_tail = (rt->vector_ready_tail + 1) % PTO_MAX_READY_QUEUE;
+        rt->vector_ready_tail = (rt->vector_ready_tail + 1) & rt->ready_queue_mask;
         rt->vector_ready_count++;
         pthread_cond_broadcast(&rt->vector_queue_not_empty);
         DEBUG_PRINT("[A2A3 Orch] Task %d -> VECTOR queue (count=%d)\n", task_id, rt->vector_ready_count);
@@ -126,16 +127,38 @@ void a2a3_orch_route_to_queue_threadsafe(PTORuntime* rt, int32_t task_id) {
     pthread_mutex_unlock(&rt->queue_mutex);
 }
 
+// InCore function registry (host/a2a3_so_loader.c). Weak, so the
+// orchestration layer also links without the host loaders.
+extern int32_t a2a3_resolve_incore_id(const char* func_name) __attribute__((weak));
+extern const A2A3InCoreDispatch* a2a3_get_incore_dispatch_table(void) __attribute__((weak));
+
+/**
+ * Resolve task->func_name to a registry id and fill in the host function
+ * pointer if the orchestrator did not pass one.
+ */
+static void a2a3_orch_resolve_func(PendingTask* task) {
+    if (task->func_id >= 0 || !task->func_name || !a2a3_resolve_incore_id) {
+        return;
+    }
+    task->func_id = a2a3_resolve_incore_id(task->func_name);
+    if (task->func_id >= 0 && !task->func_ptr && a2a3_get_incore_dispatch_table) {
+        task->func_ptr = (void*)a2a3_get_incore_dispatch_table()[task->func_id].func_ptr;
+    }
+}
+
 void a2a3_orch_submit_task(PTORuntime* rt, int32_t task_id) {
     if (task_id < 0 || task_id >= rt->next_task_id) {
         fprintf(stderr, "[A2A3 Orch] ERROR: Invalid task_id %d\n", task_id);
         return;
     }
     
-    PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(task_id)];
+    PendingTask* task = &rt->pend_task[PTO_TASK_SLOT(rt, task_id)];
+    
+    // Resolve the function name once here; workers index the dispatch table
+    a2a3_orch_resolve_func(task);
     
     bool ready = pto_task_prepare_submit(rt, task_id);
-    int32_t slot = PTO_TASK_SLOT(task_id);
+    int32_t slot = PTO_TASK_SLOT(rt, task_id);
     int32_t remaining = task->fanin_count - rt->fanin_refcount[slot];
     DEBUG_PRINT("[A2A3 Orch] Submit task %d: %s (fanin_rem=%d, is_cube=%d)\n",
                 task_id, task->func_name, remaining, task->is_cube);
@@ -157,7 +180,7 @@ void a2a3_orch_complete_task_threadsafe(PTORuntime* rt, int32_t task_id) {
     
     pthread_mutex_lock(&rt->task_mutex);
     
-    int32_t slot = PTO_TASK_SLOT(task_id);
+    int32_t slot = PTO_TASK_SLOT(rt, task_id);
     PendingTask* task = &rt->pend_task[slot];
 
     if (!task->is_active || task->task_id != task_id || task->is_complete) {
@@ -177,7 +200,7 @@ void a2a3_orch_complete_task_threadsafe(PTORuntime* rt, int32_t task_id) {
     int32_t seen = 0;
     while (off != 0 && seen < task->fanout_consumer_count) {
         int32_t consumer_id = rt->dep_list_pool[off].task_id;
-        int32_t cslot = PTO_TASK_SLOT(consumer_id);
+        int32_t cslot = PTO_TASK_SLOT(rt, consumer_id);
         PendingTask* consumer = &rt->pend_task[cslot];
 
         if (consumer->is_active && consumer->task_id == consumer_id) {
@@ -201,7 +224,7 @@ void a2a3_orch_complete_task_threadsafe(PTORuntime* rt, int32_t task_id) {
     off = task->fanin_head;
     while (off != 0) {
         int32_t producer_id = rt->dep_list_pool[off].task_id;
-        int32_t pslot = PTO_TASK_SLOT(producer_id);
+        int32_t pslot = PTO_TASK_SLOT(rt, producer_id);
         PendingTask* producer = &rt->pend_task[pslot];
         if (producer->is_active && producer->task_id == producer_id) {
             rt->fanout_refcount[pslot]++;
@@ -278,7 +301,7 @@ int32_t a2a3_orch_get_vector_task_blocking(PTORuntime* rt) {
     }
     
     int32_t task_id = rt->vector_ready_queue[rt->vector_ready_head];
-    rt->vector_ready_head = (rt->vector_ready_head + 1) % PTO_MAX_READY_QUEUE;
+    rt->vector_ready_head = (rt->vector_ready_head + 1) & rt->ready_queue_mask;
     rt->vector_ready_count--;
     
     pthread_mutex_unlock(&rt->queue_mutex);
@@ -318,7 +341,7 @@ int32_t a2a3_orch_get_cube_task_blocking(PTORuntime* rt) {
     }
     
     int32_t task_id = rt->cube_ready_queue[rt->cube_ready_head];
-    rt->cube_ready_head = (rt->cube_ready_head + 1) % PTO_MAX_READY_QUEUE;
+    rt->cube_ready_head = (rt->cube_ready_head + 1) & rt->ready_queue_mask;
     rt->cube_ready_count--;
     
     pthread_mutex_unlock(&rt->queue_mutex);
@@ -336,7 +359,7 @@ void a2a3_orch_get_stats(PTORuntime* rt, A2A3OrchStats* stats) {
     
     // Count completed tasks by type
     for (int i = 0; i < rt->next_task_id; i++) {
-        int32_t slot = PTO_TASK_SLOT(i);
+        int32_t slot = PTO_TASK_SLOT(rt, i);
         PendingTask* task = &rt->pend_task[slot];
         if (task->is_complete) {
             if (task->is_cube) {
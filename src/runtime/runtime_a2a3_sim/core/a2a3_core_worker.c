@@ -15,22 +15,15 @@
 // =============================================================================
 
 void a2a3_core_execute_task(PTORuntime* rt, int32_t task_id, int32_t worker_id) {
-    int32_t slot = PTO_TASK_SLOT(task_id);
+    int32_t slot = PTO_TASK_SLOT(rt, task_id);
     PendingTask* task = &rt->pend_task[slot];
     
     DEBUG_PRINT("[A2A3 Core] Worker %d executing task %d: %s\n", 
                 worker_id, task_id, task->func_name);
     
-    // Build argument array
-    void* args[PTO_MAX_ARGS * 2];
-    int arg_idx = 0;
-    
-    for (int i = 0; i < task->num_args; i++) {
-        TaskArg* arg = &task->args[i];
-        float* base_ptr = (float*)arg->region.raw_tensor;
-        int64_t offset = arg->region.row_offset * arg->region.cols + arg->region.col_offset;
-        args[arg_idx++] = (void*)(base_ptr + offset);
-    }
+    // Argument pointers were resolved at submit (pto_task_prepare_submit)
+    void* args[PTO_MAX_ARGS];
+    pto_task_load_args(task, args);
     
     // Simulation mode: use cycle cost function or heuristic for timing
     if (rt->simulation_mode) {
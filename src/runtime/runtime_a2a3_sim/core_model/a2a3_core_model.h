@@ -128,6 +128,9 @@ typedef enum {
 // Scalar instruction latency
 #define SCALAR_LATENCY          1       // Scalar arithmetic
 
+// Vector latencies above are for one tile of this size
+#define A2A3_DEFAULT_TILE_BYTES (32 * 128 * 4)
+
 // =============================================================================
 // Data Structures
 // =============================================================================
@@ -352,6 +355,7 @@ int a2a3_get_target_pipe(const char* instr_name, CoreType core_type);
 
 /**
  * Estimate latency for an instruction
+ * Vector latencies scale with data_size relative to A2A3_DEFAULT_TILE_BYTES
  */
 int64_t a2a3_estimate_latency(const char* instr_name, int64_t data_size);
 
@@ -551,20 +551,26 @@ int64_t a2a3_estimate_latency(const char* instr_name, int64_t data_size) {
         case INSTR_CAT_CUBE:
             return CUBE_MATMUL_LATENCY;
             
-        case INSTR_CAT_VECTOR:
+        case INSTR_CAT_VECTOR: {
             // Check for reduction or activation
+            int64_t base;
             if (strstr(instr_name, "Reduce") || strstr(instr_name, "ROWSUM") ||
                 strstr(instr_name, "ROWMAX")) {
-                return VEC_REDUCE_LATENCY;
+                base = VEC_REDUCE_LATENCY;
             } else if (strstr(instr_name, "Relu") || strstr(instr_name, "Sigmoid") ||
                        strstr(instr_name, "Tanh") || strstr(instr_name, "Gelu") ||
                        strstr(instr_name, "Swish") || strstr(instr_name, "Silu")) {
-                return VEC_ACTIVATION_LATENCY;
+                base = VEC_ACTIVATION_LATENCY;
             } else if (strstr(instr_name, "Exp") || strstr(instr_name, "Ln") ||
                        strstr(instr_name, "Sqrt") || strstr(instr_name, "Rsqrt")) {
-                return VEC_UNARY_LATENCY;
+                base = VEC_UNARY_LATENCY;
+            } else {
+                base = VEC_BINARY_LATENCY;
             }
-            return VEC_BINARY_LATENCY;
+            // Repeats scale with the amount of data
+            int64_t latency = base * data_size / A2A3_DEFAULT_TILE_BYTES;
+            return latency > 0 ? latency : 1;
+        }
     }
     
     return SCALAR_LATENCY;
@@ -37,6 +37,31 @@ static bool is_comment_or_empty(const char* line) {
     return (*p == '\0' || *p == '/' || *p == '#');
 }
 
+/**
+ * Element count of a vector instruction: its largest integer literal
+ * argument, e.g. 4096 in "Add(z, x, y, 4096);"
+ * @return Count, or 0 if no argument is an integer literal
+ */
+static int64_t element_count(const char* text) {
+    const char* p = strchr(text, '(');
+    if (!p) return 0;
+    int64_t count = 0;
+    while (*p && *p != ')') {
+        p++;  // skip '(' or ','
+        while (isspace((unsigned char)*p)) p++;
+        const char* digits = p;
+        while (isdigit((unsigned char)*p)) p++;
+        const char* end = p;
+        while (isspace((unsigned char)*p)) p++;
+        if (end > digits && (*p == ',' || *p == ')')) {
+            int64_t n = atoll(digits);
+            if (n > count) count = n;
+        }
+        while (*p && *p != ',' && *p != ')') p++;
+    }
+    return count;
+}
+
 // =============================================================================
 // Simulator Lifecycle
 // =============================================================================
@@ -401,8 +426,15 @@ bool a2a3_parse_instruction(const char* text, A2A3Instruction* out, CoreType cor
     out->category = a2a3_decode_instr_category(text, core_type);
     out->target_pipe = a2a3_get_target_pipe(text, core_type);
     
-    // Estimate latency
-    out->latency = a2a3_estimate_latency(text, 32 * 128 * 4);  // Default tile size
+    // Estimate latency; vector instructions may give their element count
+    int64_t data_size = A2A3_DEFAULT_TILE_BYTES;
+    if (out->category == INSTR_CAT_VECTOR) {
+        int64_t count = element_count(text);
+        if (count > 0) {
+            data_size = count * 4;  // Assume float32
+        }
+    }
+    out->latency = a2a3_estimate_latency(text, data_size);
     
     // Parse sync instructions
     if (strstr(text, "SET_FLAG") || strstr(text, "set_flag")) {
@@ -0,0 +1,170 @@
+"""
+Helpers for the compiler pass regression tests.
+
+- llama_module(): the llama 7B module from examples/llama, built once
+- HostKernel: a generated ARM64 InCore function (scalar or, on an ARM host,
+  NEON/SVE) built into a shared library and called through ctypes on numpy
+  buffers
+- orchestration_trace(): an orchestration function built against
+  stub/pto_runtime.h, which prints every task and argument it submits
+"""
+
+import contextlib
+import ctypes
+import io
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import warnings
+from typing import Callable, Dict, List, Optional, Sequence, Tuple
+
+import numpy as np
+
+TESTS_DIR = os.path.dirname(os.path.abspath(__file__))
+ROOT_DIR = os.path.dirname(os.path.dirname(TESTS_DIR))
+SRC_DIR = os.path.join(ROOT_DIR, "src")
+LLAMA_DIR = os.path.join(ROOT_DIR, "examples", "llama")
+STUB_DIR = os.path.join(TESTS_DIR, "stub")
+
+for _path in (SRC_DIR, LLAMA_DIR):
+    if _path not in sys.path:
+        sys.path.insert(0, _path)
+
+from compile.pto_compile import MultiBackendCodeGenerator, PTOModule  # noqa: E402
+
+CC = os.environ.get("CC", "cc")
+
+# Elements per GM buffer handed to a kernel; covers the largest llama tile
+# (256 x 128) and the 128 x 128 weight tiles.
+GM_ELEMENTS = 1 << 17
+
+FLOAT_SCALAR = 0.25
+
+_llama_module: Optional[PTOModule] = None
+
+
+def llama_module() -> PTOModule:
+    """create_llama7b_module(), built once per process without its progress output."""
+    global _llama_module
+    if _llama_module is None:
+        with contextlib.redirect_stdout(io.StringIO()):
+            import pto_llama7B_dynamic
+            _llama_module = pto_llama7B_dynamic.create_llama7b_module()
+    return _llama_module
+
+
+def generate(gen: MultiBackendCodeGenerator, backend: str, name: str, **kwargs) -> str:
+    """Code for one function of gen.module; over-budget arena warnings are not failures here."""
+    with warnings.catch_warnings():
+        warnings.simplefilter("ignore")
+        return getattr(gen, f"generate_{backend}")(gen.module.functions[name], **kwargs)
+
+
+def _compile(args: List[str]) -> None:
+    result = subprocess.run(args, capture_output=True, text=True)
+    if result.returncode != 0:
+        raise AssertionError(f"{' '.join(args)} failed:\n{result.stderr}")
+
+
+class HostKernel:
+    """A generated ARM64 InCore function built for and run on this host."""
+
+    _SIGNATURE = r"^void {name}\(([^)]*)\) \{{"
+
+    def __init__(self, code: str, name: str, work_dir: str, flags: Sequence[str] = (), tag: str = ""):
+        """tag tells apart the libraries of two builds of one function in work_dir."""
+        match = re.search(self._SIGNATURE.format(name=re.escape(name)), code, re.M)
+        if match is None:
+            raise AssertionError(f"no definition of {name} in the generated code")
+        self.name = name
+        # (C type, name); pointers are GM tensors, everything else a scalar
+        self.params: List[Tuple[str, str]] = []
+        for param in match.group(1).split(","):
+            ctype, _, pname = param.strip().rpartition(" ")
+            self.params.append((ctype.strip(), pname))
+
+        stem = os.path.join(work_dir, name + tag)
+        with open(stem + ".c", "w") as f:
+            f.write(code)
+        _compile([CC, "-std=c11", "-O1", "-fPIC", "-shared", *flags, stem + ".c", "-o", stem + ".so", "-lm"])
+        self._fn = getattr(ctypes.CDLL(stem + ".so"), name)
+        self._fn.restype = None
+
+    @property
+    def tensors(self) -> List[str]:
+        return [pname for ctype, pname in self.params if ctype.endswith("*")]
+
+    def __call__(self, buffers: Dict[str, np.ndarray],
+                 scalars: Optional[Dict[str, float]] = None) -> None:
+        """Run on buffers[tensor]; scalars default to FLOAT_SCALAR (float) or 0 (integer)."""
+        scalars = scalars or {}
+        args = []
+        for ctype, pname in self.params:
+            if ctype.endswith("*"):
+                buf = buffers[pname]
+                assert buf.dtype == np.float32 and buf.flags["C_CONTIGUOUS"]
+                args.append(buf.ctypes.data_as(ctypes.c_void_p))
+            elif ctype in ("float", "double"):
+                cls = ctypes.c_float if ctype == "float" else ctypes.c_double
+                args.append(cls(scalars.get(pname, FLOAT_SCALAR)))
+            else:
+                args.append(ctypes.c_int64(int(scalars.get(pname, 0))) if "64" in ctype
+                            else ctypes.c_int32(int(scalars.get(pname, 0))))
+        self._fn(*args)
+
+
+def random_buffers(names: Sequence[str], seed: int) -> Dict[str, np.ndarray]:
+    """One GM buffer per tensor, in [0.1, 1) so rsqrt/log/div stay finite."""
+    rng = np.random.default_rng(seed)
+    return {name: rng.uniform(0.1, 1.0, GM_ELEMENTS).astype(np.float32) for name in names}
+
+
+def copy_buffers(buffers: Dict[str, np.ndarray]) -> Dict[str, np.ndarray]:
+    return {name: buf.copy() for name, buf in buffers.items()}
+
+
+def assert_buffers_close(test, expected: Dict[str, np.ndarray], actual: Dict[str, np.ndarray],
+                         what: str, rtol: float = 1e-5, atol: float = 1e-6) -> None:
+    for name in expected:
+        if not np.allclose(expected[name], actual[name], rtol=rtol, atol=atol, equal_nan=True):
+            bad = np.flatnonzero(~np.isclose(expected[name], actual[name], rtol=rtol, atol=atol,
+                                             equal_nan=True))
+            test.fail(f"{what}: {name} differs at {bad.size} element(s), first [{bad[0]}] "
+                      f"{expected[name][bad[0]]!r} vs {actual[name][bad[0]]!r}")
+
+
+def orchestration_trace(code: str, work_dir: str, stem: str, argv: Sequence[str]) -> List[str]:
+    """Build an orchestration function against stub/pto_runtime.h and return the task trace."""
+    source = os.path.join(work_dir, stem + ".c")
+    exe = os.path.join(work_dir, stem)
+    if not os.path.exists(exe):
+        with open(source, "w") as f:
+            f.write(code)
+        _compile([CC, "-std=c11", "-O1", f"-I{STUB_DIR}", source, "-o", exe, "-lm"])
+    result = subprocess.run([exe, *argv], capture_output=True, text=True, timeout=120)
+    if result.returncode != 0:
+        raise AssertionError(f"{stem} {' '.join(argv)} exited with {result.returncode}:\n{result.stderr}")
+    return [line for line in result.stdout.splitlines() if line.startswith(("task ", "arg ", "submit ", "scope "))]
+
+
+def trace_tasks(trace: List[str]) -> int:
+    return sum(1 for line in trace if line.startswith("task "))
+
+
+def work_dir(test) -> str:
+    """A temporary directory removed when the test case finishes."""
+    tmp = tempfile.TemporaryDirectory(prefix="pto-pass-test-")
+    test.addCleanup(tmp.cleanup)
+    return tmp.name
+
+
+def in_core_names(module: PTOModule, keep: Callable = lambda prog: True) -> List[str]:
+    return [name for name, prog in module.functions.items() if prog.is_in_core and keep(prog)]
+
+
+def matmul_shapes_agree(program) -> bool:
+    """False when a TMATMUL reads past its tiles (a.cols != b.rows) under any lowering."""
+    return all(instr.a.tile_type.shape.cols == instr.b.tile_type.shape.rows
+               for instr in program.instructions if instr.opcode == "TMATMUL")
@@ -0,0 +1,90 @@
+/**
+ * Stand-in for src/runtime/pto_runtime.h in the compiler pass tests.
+ *
+ * Orchestration code built against this header runs no kernels: every task
+ * and argument it submits is printed, with tensors numbered in order of first
+ * use, so two lowerings of one orchestration function can be compared by
+ * their output.
+ */
+
+#ifndef PTO_RUNTIME_TRACE_STUB_H
+#define PTO_RUNTIME_TRACE_STUB_H
+
+// clock_gettime in the generated main(), as with the real header
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define PTO_TRACE_MAX_TENSORS 256
+
+typedef struct PTORuntime {
+    long long total_tasks_scheduled;
+    int32_t next_task;
+    int32_t num_tensors;
+    const void* tensors[PTO_TRACE_MAX_TENSORS];
+} PTORuntime;
+
+static inline void pto_runtime_init(PTORuntime* rt) { (void)rt; }
+static inline void pto_runtime_shutdown(PTORuntime* rt) { (void)rt; }
+static inline void pto_execute_all(PTORuntime* rt) { (void)rt; }
+static inline void pto_scope_begin(PTORuntime* rt) { printf("scope begin\n"); (void)rt; }
+static inline void pto_scope_end(PTORuntime* rt) { printf("scope end\n"); (void)rt; }
+
+static inline int32_t pto_trace_tensor(PTORuntime* rt, const void* tensor) {
+    for (int32_t i = 0; i < rt->num_tensors; i++) {
+        if (rt->tensors[i] == tensor) {
+            return i;
+        }
+    }
+    if (rt->num_tensors == PTO_TRACE_MAX_TENSORS) {
+        fprintf(stderr, "pto_runtime stub: too many tensors\n");
+        return -1;
+    }
+    rt->tensors[rt->num_tensors] = tensor;
+    return rt->num_tensors++;
+}
+
+static inline int32_t pto_task_alloc_6(PTORuntime* rt, const char* func_name, void* func_ptr,
+                                       int32_t buffer_bytes, int32_t reuse_bytes, bool is_cube) {
+    (void)func_ptr;
+    printf("task %s buffer=%d reuse=%d cube=%d\n", func_name, buffer_bytes, reuse_bytes, (int)is_cube);
+    return rt->next_task++;
+}
+
+static inline int32_t pto_task_alloc_5(PTORuntime* rt, const char* func_name, void* func_ptr,
+                                       int32_t buffer_bytes, int32_t reuse_bytes) {
+    return pto_task_alloc_6(rt, func_name, func_ptr, buffer_bytes, reuse_bytes, false);
+}
+
+#define _PTO_TASK_ALLOC_NARG(...) _PTO_TASK_ALLOC_NARG_(__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define _PTO_TASK_ALLOC_NARG_(_1, _2, _3, _4, _5, _6, N, ...) N
+#define _PTO_TASK_ALLOC_DISPATCH(N) _PTO_TASK_ALLOC_DISPATCH_(N)
+#define _PTO_TASK_ALLOC_DISPATCH_(N) pto_task_alloc_##N
+#define pto_task_alloc(...) _PTO_TASK_ALLOC_DISPATCH(_PTO_TASK_ALLOC_NARG(__VA_ARGS__))(__VA_ARGS__)
+
+static inline void pto_trace_arg(PTORuntime* rt, const char* kind, int32_t task_id, const void* tensor,
+                                 int64_t row_off, int64_t col_off, int64_t rows, int64_t cols) {
+    printf("arg %s task=%d tensor=%d [%lld, %lld] %lldx%lld\n", kind, task_id, pto_trace_tensor(rt, tensor),
+           (long long)row_off, (long long)col_off, (long long)rows, (long long)cols);
+}
+
+static inline void pto_task_add_input(PTORuntime* rt, int32_t task_id, void* tensor, int64_t row_off,
+                                      int64_t col_off, int64_t rows, int64_t cols) {
+    pto_trace_arg(rt, "in", task_id, tensor, row_off, col_off, rows, cols);
+}
+
+static inline void pto_task_add_output(PTORuntime* rt, int32_t task_id, void* tensor, int64_t row_off,
+                                       int64_t col_off, int64_t rows, int64_t cols) {
+    pto_trace_arg(rt, "out", task_id, tensor, row_off, col_off, rows, cols);
+}
+
+static inline void pto_task_submit(PTORuntime* rt, int32_t task_id) {
+    printf("submit task=%d\n", task_id);
+    rt->total_tasks_scheduled++;
+}
+
+#endif
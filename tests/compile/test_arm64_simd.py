@@ -0,0 +1,83 @@
+"""
+ARM64 NEON and SVE emission: every llama InCore kernel against the scalar
+(simd="scalar") code generator.
+
+On any host, the vectorizable kernels must use the intrinsics of the
+requested extension. On an aarch64 host (and, for SVE, a CPU that has it)
+the NEON/SVE kernels are also built and run against the scalar ones; the
+tolerance allows for reordered reductions and the polynomial exp.
+"""
+
+import platform
+import re
+import unittest
+
+import kernel_harness as h
+from compile.pto_compile import MultiBackendCodeGenerator
+
+_INTRINSICS = {
+    "neon": ("#include <arm_neon.h>", re.compile(r"\bv[a-z0-9]+_[a-z0-9_]+\(")),
+    "sve": ("#include <arm_sve.h>", re.compile(r"\bsv[a-z0-9]+_[a-z0-9_]+\(")),
+}
+_FLAGS = {"neon": (), "sve": ("-march=armv8-a+sve",)}
+
+ON_ARM64 = platform.machine() in ("aarch64", "arm64")
+
+
+def _has_sve() -> bool:
+    try:
+        with open("/proc/cpuinfo") as f:
+            return any(line.startswith("Features") and " sve" in line for line in f)
+    except OSError:
+        return False
+
+
+class Arm64SimdTest(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        cls.module = h.llama_module()
+        cls.gen = MultiBackendCodeGenerator(module=cls.module)
+
+    def vectorizable(self):
+        """Kernels with elementwise or row loops (the others only load and store)."""
+        return [name for name in h.in_core_names(self.module)
+                if re.search(r"// (Row-f|F)used loop",
+                             h.generate(self.gen, "arm64", name, simd="scalar"))]
+
+    def test_intrinsics(self):
+        names = self.vectorizable()
+        self.assertGreater(len(names), 0)
+        for simd, (include, intrinsic) in _INTRINSICS.items():
+            for name in names:
+                with self.subTest(simd=simd, kernel=name):
+                    code = h.generate(self.gen, "arm64", name, simd=simd)
+                    self.assertIn(include, code)
+                    self.assertRegex(code, intrinsic)
+
+    def compare_with_scalar(self, simd: str) -> None:
+        work_dir = h.work_dir(self)
+        for seed, name in enumerate(h.in_core_names(self.module, h.matmul_shapes_agree)):
+            with self.subTest(kernel=name):
+                reference = h.HostKernel(h.generate(self.gen, "arm64", name, simd="scalar"),
+                                         name, work_dir)
+                kernel = h.HostKernel(h.generate(self.gen, "arm64", name, simd=simd),
+                                      name, work_dir, flags=_FLAGS[simd], tag=f"_{simd}")
+                expected = h.random_buffers(reference.tensors, seed)
+                actual = h.copy_buffers(expected)
+                reference(expected)
+                kernel(actual)
+                h.assert_buffers_close(self, expected, actual, f"{name} ({simd})",
+                                       rtol=1e-4, atol=1e-5)
+
+    @unittest.skipUnless(ON_ARM64, "NEON code runs on aarch64 hosts only")
+    def test_neon_matches_scalar(self):
+        self.compare_with_scalar("neon")
+
+    @unittest.skipUnless(ON_ARM64 and _has_sve(), "SVE code needs an aarch64 CPU with SVE")
+    def test_sve_matches_scalar(self):
+        self.compare_with_scalar("sve")
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,82 @@
+"""
+Binary-expanded orchestration loops: the "dispatch" lowering (one loop over a
+table of levels) against the "cascade" lowering it replaces.
+
+Both are built against stub/pto_runtime.h and must submit the same tasks,
+with the same arguments in the same order, for every trip count.
+"""
+
+import copy
+import unittest
+
+import kernel_harness as h
+from compile.pto_compile import MultiBackendCodeGenerator, PTOFunctionBuilder
+from isa_definition.pto_isa_definition import ElementType, MemorySpace
+
+
+def phase1_module():
+    """The llama module plus its phase-1 loop alone, cheap enough to reach every level."""
+    import pto_llama7B_dynamic as llama
+    module = copy.copy(h.llama_module())
+    module.functions = dict(module.functions)
+    module.add_function(PTOFunctionBuilder("llama_phase1", module=module)
+        .not_in_core()
+        .memref("input", MemorySpace.GM, llama.DTYPE)
+        .memref("attn_norm_weights", MemorySpace.GM, llama.DTYPE)
+        .memref("wq", MemorySpace.GM, llama.DTYPE)
+        .memref("temp_norm", MemorySpace.GM, llama.DTYPE)
+        .memref("all_q_tiles", MemorySpace.GM, llama.DTYPE)
+        .scalar("num_tiles", ElementType.I32)
+        .for_loop("tile_i", 0, "num_tiles", 1,
+                  max_range=llama.MAX_NUM_TILES, min_range=llama.MIN_NUM_TILES,
+                  tile_levels=llama.TILE_ROWS_BY_LEVEL)
+            .call("rmsnorm_tile", {
+                "input": ("input", "tile_i", 0),
+                "weights": "attn_norm_weights",
+                "output": ("temp_norm", "tile_i", 0)
+            })
+            .call("tile_matmul", {
+                "input_a": ("temp_norm", "tile_i", 0),
+                "input_b": "wq",
+                "output": ("all_q_tiles", "tile_i", 0)
+            })
+        .end_for()
+        .build())
+    return module
+
+
+class BinaryExpansionTest(unittest.TestCase):
+
+    def compare(self, module, name, runs):
+        work_dir = h.work_dir(self)
+        code = {}
+        for mode in ("cascade", "dispatch"):
+            gen = MultiBackendCodeGenerator(module=module, binary_expansion=mode)
+            code[mode] = h.generate(gen, "arm64", name, simd="scalar")
+        self.assertIn("(dispatch)", code["dispatch"])
+        tasks = 0
+        for argv in runs:
+            with self.subTest(argv=" ".join(argv)):
+                cascade = h.orchestration_trace(code["cascade"], work_dir, "cascade", argv)
+                dispatch = h.orchestration_trace(code["dispatch"], work_dir, "dispatch", argv)
+                tasks += h.trace_tasks(cascade)
+                if cascade != dispatch:
+                    first = next((i for i, (a, b) in enumerate(zip(cascade, dispatch)) if a != b),
+                                 min(len(cascade), len(dispatch)))
+                    self.fail(f"traces differ at line {first} of {len(cascade)} / {len(dispatch)}: "
+                              f"{cascade[first:first + 1]} vs {dispatch[first:first + 1]}")
+        self.assertGreater(tasks, 0)
+
+    def test_llama_layer(self):
+        """The whole layer; flash attention is quadratic in num_tiles, so up to one level."""
+        runs = [[str(n), "32", str(n), "0"] for n in (1, 3, 16, 257)]
+        self.compare(h.llama_module(), "llama_layer_dynamic", runs)
+
+    def test_every_level(self):
+        """Trip counts hitting the specialized levels, the generic ones and the residual."""
+        runs = [[str(n)] for n in (0, 1, 255, 256, 300, 1024, 1500, 2048, 4095, 4096, 7000, 8193)]
+        self.compare(phase1_module(), "llama_phase1", runs)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,83 @@
+"""
+Double buffering (pto_double_buffer.double_buffer_loops): a tiled residual
+add loop rewritten to ping-pong tiles against the plain loop, at trip counts
+that hit the empty loop, the prologue/epilogue alone and both epilogue
+parities.
+
+The llama InCore kernels have no loops; they only check that the pass
+leaves loop-free code alone.
+"""
+
+import unittest
+
+import kernel_harness as h
+from compile.pto_compile import MultiBackendCodeGenerator, PTOFunctionBuilder, PTOModule
+from isa_definition.pto_isa_definition import ElementType
+
+TILE_ROWS = 32
+TILE_COLS = 128
+# Trip counts up to what fits in one GM buffer
+MAX_TILES = h.GM_ELEMENTS // (TILE_ROWS * TILE_COLS)
+
+
+def residual_loop_module(start: int) -> PTOModule:
+    """output[i] = (input[i] + residual[i]) * 0.5 for tiles i in [start, num_tiles)."""
+    module = PTOModule("double_buffer_test")
+    module.add_function(PTOFunctionBuilder("residual_loop", module=module)
+        .in_core()
+        .memref("input")
+        .memref("residual")
+        .memref("output")
+        .scalar("num_tiles", ElementType.I32)
+        .tile("x", TILE_ROWS, TILE_COLS)
+        .tile("r", TILE_ROWS, TILE_COLS)
+        .tile("s", TILE_ROWS, TILE_COLS)
+        .tile("y", TILE_ROWS, TILE_COLS)
+        .for_loop("i", start, "num_tiles", 1)
+            .load("x", "input", "i", 0)
+            .load("r", "residual", "i", 0)
+            .add("s", "x", "r")
+            .muls("y", "s", 0.5)
+            .store("y", "output", "i", 0)
+        .end_for()
+        .build())
+    return module
+
+
+class DoubleBufferTest(unittest.TestCase):
+
+    def test_tiled_loop(self):
+        work_dir = h.work_dir(self)
+        for start in (0, 1):
+            module = residual_loop_module(start)
+            plain = MultiBackendCodeGenerator(module=module)
+            pipelined = MultiBackendCodeGenerator(module=module, double_buffer=True)
+            reference = h.HostKernel(h.generate(plain, "arm64", "residual_loop", simd="scalar"),
+                                     "residual_loop", work_dir, tag=f"_{start}")
+            kernel = h.HostKernel(h.generate(pipelined, "arm64", "residual_loop", simd="scalar"),
+                                  "residual_loop", work_dir, tag=f"_{start}_pong")
+            result = pipelined.double_buffer_results["residual_loop"]
+            self.assertEqual(len(result.loops), 1, result.format())
+            self.assertEqual(sorted(result.loops[0].pong_tiles), ["r", "x", "y"])
+
+            for num_tiles in (0, 1, 2, 3, 4, 5, 8, MAX_TILES - 1, MAX_TILES):
+                with self.subTest(start=start, num_tiles=num_tiles):
+                    expected = h.random_buffers(reference.tensors, num_tiles)
+                    actual = h.copy_buffers(expected)
+                    reference(expected, {"num_tiles": num_tiles})
+                    kernel(actual, {"num_tiles": num_tiles})
+                    h.assert_buffers_close(self, expected, actual, "residual_loop", rtol=0, atol=0)
+
+    def test_llama_kernels_unchanged(self):
+        module = h.llama_module()
+        plain = MultiBackendCodeGenerator(module=module)
+        pipelined = MultiBackendCodeGenerator(module=module, double_buffer=True)
+        for name in h.in_core_names(module):
+            with self.subTest(kernel=name):
+                self.assertEqual(h.generate(pipelined, "arm64", name, simd="scalar"),
+                                 h.generate(plain, "arm64", name, simd="scalar"))
+                self.assertEqual(pipelined.double_buffer_results[name].loops, [])
+
+
+if __name__ == "__main__":
+    unittest.main()
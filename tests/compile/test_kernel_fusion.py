@@ -0,0 +1,102 @@
+"""
+InCore kernel fusion (pto_kernel_fusion.fuse_incore_calls) on the llama module.
+
+- Task counts of llama_layer_dynamic, from the cost model and from the
+  orchestration code generated with kernel_fusion on and off
+- Each fused kernel against its callees run one after the other on the same
+  GM buffers
+"""
+
+import unittest
+
+import kernel_harness as h
+from compile.pto_compile import MultiBackendCodeGenerator
+from compile.pto_kernel_fusion import fuse_incore_calls
+
+NUM_TILES = 16
+SCALARS = {"seq_len": NUM_TILES, "tile_rows": 32, "num_tiles": NUM_TILES, "zero": 0}
+
+# llama_layer_dynamic at num_tiles=16: 64 tasks per tile, 5 of them merged away
+TASKS_BEFORE = 1024
+TASKS_AFTER = 944
+
+
+def _tensor(arg) -> str:
+    return arg if isinstance(arg, str) else arg[0]
+
+
+def fused_calls(result, kernel):
+    """(fused CALL, [original CALLs]) of one fused kernel in its caller."""
+    original = result.original.functions[kernel.caller].instructions
+    rewritten = result.module.functions[kernel.caller].instructions
+    merged = {k.name: len(k.callees) for k in result.kernels}
+    i = 0
+    for instr in rewritten:
+        if instr.opcode == "CALL" and instr.callee == kernel.name:
+            return instr, original[i:i + len(kernel.callees)]
+        i += merged.get(instr.callee, 1) if instr.opcode == "CALL" else 1
+    raise AssertionError(f"{kernel.name} is not called by {kernel.caller}")
+
+
+class KernelFusionTest(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        cls.result = fuse_incore_calls(h.llama_module())
+
+    def test_llama_kernels(self):
+        self.assertEqual(
+            sorted(k.name for k in self.result.kernels),
+            sorted(["fused_tile_matmul_x3", "fused_rope_tile_x2",
+                    "fused_residual_add_tile_rmsnorm_tile", "fused_tile_matmul_x2"]))
+        for k in self.result.kernels:
+            self.assertEqual(k.caller, "llama_layer_dynamic")
+            self.assertLess(k.kernel_cycles_after + self.result.task_overhead,
+                            k.kernel_cycles_before + len(k.callees) * self.result.task_overhead)
+
+    def test_task_counts(self):
+        tasks_before, tasks_after, cycles_before, cycles_after = \
+            self.result.totals("llama_layer_dynamic", SCALARS)
+        self.assertEqual((tasks_before, tasks_after), (TASKS_BEFORE, TASKS_AFTER))
+        self.assertLess(cycles_after, cycles_before)
+
+        # The orchestration code generated with the pass submits as many tasks
+        work_dir = h.work_dir(self)
+        argv = [str(SCALARS[name]) for name in ("seq_len", "tile_rows", "num_tiles", "zero")]
+        for fusion, expected in ((False, TASKS_BEFORE), (True, TASKS_AFTER)):
+            with self.subTest(kernel_fusion=fusion):
+                gen = MultiBackendCodeGenerator(module=h.llama_module(), kernel_fusion=fusion)
+                code = h.generate(gen, "arm64", "llama_layer_dynamic", simd="scalar")
+                trace = h.orchestration_trace(code, work_dir, f"fusion_{fusion}", argv)
+                self.assertEqual(h.trace_tasks(trace), expected)
+
+    def test_fused_kernels_match_callees(self):
+        work_dir = h.work_dir(self)
+        unfused = MultiBackendCodeGenerator(module=h.llama_module())
+        fused = MultiBackendCodeGenerator(module=h.llama_module(), kernel_fusion=True)
+        callees = {}
+        for seed, kernel in enumerate(self.result.kernels):
+            with self.subTest(kernel=kernel.name):
+                call, calls = fused_calls(self.result, kernel)
+                for c in calls:
+                    if c.callee not in callees:
+                        callees[c.callee] = h.HostKernel(
+                            h.generate(unfused, "arm64", c.callee, simd="scalar"), c.callee, work_dir)
+                fused_kernel = h.HostKernel(
+                    h.generate(fused, "arm64", kernel.name, simd="scalar"), kernel.name, work_dir)
+
+                tensors = {_tensor(arg) for c in calls for arg in c.args.values()}
+                expected = h.random_buffers(sorted(tensors), seed)
+                actual = h.copy_buffers(expected)
+                for c in calls:
+                    callees[c.callee]({param: expected[_tensor(arg)] for param, arg in c.args.items()})
+                fused_kernel({param: actual[_tensor(arg)] for param, arg in call.args.items()})
+
+                # Intermediates whose stores were elided only hold data for the fused kernel
+                live = {_tensor(arg) for arg in call.args.values()}
+                h.assert_buffers_close(self, {t: expected[t] for t in live},
+                                       {t: actual[t] for t in live}, kernel.name)
+
+
+if __name__ == "__main__":
+    unittest.main()
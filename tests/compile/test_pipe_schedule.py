@@ -0,0 +1,163 @@
+"""
+A2/A3 InCore scheduling (pto_schedule.schedule_incore): every llama InCore
+kernel emitted with schedule=True against the program-order emission.
+
+The A2/A3 code needs the CANN toolchain to run, so the scheduled code is
+checked instead:
+- It issues the same instructions
+- Two instructions touching overlapping UB/L1/L0 bytes or the same GM
+  tensor, one of them writing, keep their order, and the later one's pipe
+  waits for the earlier one: same pipe, a set_flag/wait_flag pair, a
+  pipe_barrier or the scalar unit (which finishes an instruction, or a
+  wait_flag on PIPE_S, before issuing the next), possibly through other pipes
+- It does not simulate slower than program order
+"""
+
+import re
+import unittest
+from collections import defaultdict
+from typing import Dict, List, Set, Tuple
+
+import kernel_harness as h
+from compile.pto_compile import MultiBackendCodeGenerator
+from compile.pto_schedule import isa_pipe, target_pipe
+
+_TASSIGN = re.compile(r"^\s*TASSIGN\((\w+), 0x[0-9a-f]+\);\s*// (\w+) \[(\d+), (\d+)\)")
+_OP = re.compile(r"^\s*(T[A-Z0-9_]+)\((.*)\);$")
+_FLAG = re.compile(r"^\s*(set_flag|wait_flag)\((PIPE_\w+), (PIPE_\w+), (EVENT_ID\d+)\);$")
+_CYCLES = re.compile(r"Instruction schedule: (\d+) -> (\d+) simulated cycles")
+
+
+class Body:
+    """Instructions, flags and barriers of one generated A2/A3 InCore function."""
+
+    def __init__(self, code: str):
+        self.is_cube = "// Core Type: Cube" in code
+        self.buffers: Dict[str, Tuple[str, int, int]] = {}
+        # (kind, payload) in program order; kind is "op", "set", "wait" or "barrier"
+        self.items: List[Tuple[str, object]] = []
+        start = code.index("AICORE void")
+        for line in code[start:].splitlines()[1:]:
+            stripped = line.strip()
+            if not stripped or stripped.startswith("//") or stripped == "}":
+                continue
+            if stripped.startswith(("Tile<", "GlobalTensor<")):
+                continue
+            m = _TASSIGN.match(line)
+            if m:
+                self.buffers[m.group(1)] = (m.group(2), int(m.group(3)), int(m.group(4)))
+                continue
+            m = _OP.match(line)
+            if m:
+                self.items.append(("op", (m.group(1), [a.strip() for a in m.group(2).split(",")])))
+                continue
+            m = _FLAG.match(line)
+            if m:
+                kind = "set" if m.group(1) == "set_flag" else "wait"
+                self.items.append((kind, m.group(2, 3, 4)))
+                continue
+            # pipe_barrier, and anything the parser does not know, orders everything
+            self.items.append(("barrier", stripped))
+
+    @property
+    def ops(self) -> List[str]:
+        return [f"{opcode}({', '.join(args)})" for _, (opcode, args) in self._ops()]
+
+    def _ops(self):
+        return [(i, item[1]) for i, item in enumerate(self.items) if item[0] == "op"]
+
+    def pipe(self, opcode: str) -> str:
+        return isa_pipe(target_pipe(opcode, self.is_cube), self.is_cube)
+
+    def conflicts(self, a: List[str], b: List[str]) -> bool:
+        """Whether two instructions (operand lists, first one written) must stay ordered."""
+        def overlap(x: str, y: str) -> bool:
+            if x in self.buffers and y in self.buffers:
+                (sx, lx, hx), (sy, ly, hy) = self.buffers[x], self.buffers[y]
+                return sx == sy and lx < hy and ly < hx
+            return x == y and x.startswith("g_")
+        writes_a, writes_b = a[:1], b[:1]
+        return (any(overlap(w, y) for w in writes_a for y in b)
+                or any(overlap(x, w) for x in a for w in writes_b))
+
+    def happens_before(self) -> Dict[int, Set[int]]:
+        """For each op (index into items), the later ops that wait for it to finish."""
+        ops = self._ops()
+        pipe_of = {i: self.pipe(opcode) for i, (opcode, _) in ops}
+        edges: Dict[int, Set[int]] = defaultdict(set)
+        for x, _ in ops:
+            for y, _ in ops:
+                if y > x and pipe_of[x] in (pipe_of[y], "PIPE_S"):
+                    edges[x].add(y)
+        # k-th wait on a (src, dst, event) consumes the k-th set
+        sets: Dict[Tuple, List[int]] = defaultdict(list)
+        waits: Dict[Tuple, List[int]] = defaultdict(list)
+        for pos, (kind, payload) in enumerate(self.items):
+            if kind == "set":
+                sets[payload].append(pos)
+            elif kind == "wait":
+                waits[payload].append(pos)
+        for key, set_positions in sets.items():
+            src, dst, _ = key
+            for s, w in zip(set_positions, waits.get(key, [])):
+                for x, _ in ops:
+                    if x < s and pipe_of[x] == src:
+                        edges[x].update(y for y, _ in ops if y > w and dst in (pipe_of[y], "PIPE_S"))
+        for pos, (kind, _) in enumerate(self.items):
+            if kind == "barrier":
+                for x, _ in ops:
+                    if x < pos:
+                        edges[x].update(y for y, _ in ops if y > pos)
+
+        closure: Dict[int, Set[int]] = {}
+        for x, _ in reversed(ops):
+            reach = set(edges[x])
+            for y in edges[x]:
+                reach |= closure[y]
+            closure[x] = reach
+        return closure
+
+
+class PipeScheduleTest(unittest.TestCase):
+
+    def test_llama_kernels(self):
+        module = h.llama_module()
+        scheduled = MultiBackendCodeGenerator(module=module, schedule=True)
+        in_order = MultiBackendCodeGenerator(module=module, schedule=False)
+        reordered = 0
+        for name in h.in_core_names(module):
+            with self.subTest(kernel=name):
+                code = h.generate(scheduled, "ascend_a2a3_sim", name)
+                body = Body(code)
+                reference = Body(h.generate(in_order, "ascend_a2a3_sim", name))
+                self.assertEqual(sorted(body.ops), sorted(reference.ops))
+                if body.ops != reference.ops:
+                    reordered += 1
+                self.check_dependencies(name, reference, body)
+
+                m = _CYCLES.search(code)
+                self.assertIsNotNone(m, "no schedule summary")
+                self.assertLessEqual(int(m.group(2)), int(m.group(1)))
+        self.assertGreater(reordered, 0)
+
+    def check_dependencies(self, name: str, reference: Body, body: Body) -> None:
+        # Position of each reference op in the scheduled body; repeated
+        # instructions are matched in order
+        positions: Dict[str, List[int]] = defaultdict(list)
+        for pos, (opcode, args) in body._ops():
+            positions[f"{opcode}({', '.join(args)})"].append(pos)
+        placed = []
+        for text in reference.ops:
+            placed.append(positions[text].pop(0))
+        waits_for = body.happens_before()
+
+        ref_ops = [payload for _, payload in reference._ops()]
+        for i, (_, args_i) in enumerate(ref_ops):
+            for j in range(i + 1, len(ref_ops)):
+                if reference.conflicts(args_i, ref_ops[j][1]):
+                    self.assertIn(placed[j], waits_for[placed[i]],
+                                  f"{name}: {reference.ops[j]} does not wait for {reference.ops[i]}")
+
+
+if __name__ == "__main__":
+    unittest.main()
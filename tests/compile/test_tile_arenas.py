@@ -0,0 +1,40 @@
+"""
+Tile arenas (TileBufferAnalyzer liveness, analyze_buffers=True): every llama
+InCore kernel with tiles sharing arena slots against the same kernel with
+one array per tile.
+
+flash_attn_score_block multiplies q (64 x 128) by an untransposed k
+(64 x 128) and so reads past k_block; what it reads depends on the layout,
+so it is left out.
+"""
+
+import unittest
+
+import kernel_harness as h
+from compile.pto_compile import MultiBackendCodeGenerator
+
+
+class TileArenaTest(unittest.TestCase):
+
+    def test_llama_kernels(self):
+        module = h.llama_module()
+        work_dir = h.work_dir(self)
+        aliased = MultiBackendCodeGenerator(module=module, analyze_buffers=True)
+        separate = MultiBackendCodeGenerator(module=module, analyze_buffers=False)
+        for seed, name in enumerate(h.in_core_names(module, h.matmul_shapes_agree)):
+            with self.subTest(kernel=name):
+                code = h.generate(aliased, "arm64", name, simd="scalar")
+                self.assertIn("_tile_arena_", code)
+                kernel = h.HostKernel(code, name, work_dir, tag="_arena")
+                reference = h.HostKernel(h.generate(separate, "arm64", name, simd="scalar"),
+                                         name, work_dir)
+
+                expected = h.random_buffers(reference.tensors, seed)
+                actual = h.copy_buffers(expected)
+                reference(expected)
+                kernel(actual)
+                h.assert_buffers_close(self, expected, actual, name, rtol=0, atol=0)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,210 @@
+/**
+ * Host-side test for the CPU TLOAD/TSTORE copies (include/pto/cpu/TLoad.hpp,
+ * TStore.hpp, copy.hpp)
+ *
+ * Round-trips GM -> tile -> GM and checks, element by element:
+ * - ND and DN tensors with dense, padded-leading-dimension and strided
+ *   (non-unit inner stride) GM, i.e. the single memcpy, the memcpy-per-run and
+ *   the strided fallback
+ * - dynamic and static Stride, valid widths that are not a multiple of the
+ *   SIMD width, and a 3-D tensor folded into the tile rows
+ * - TLOAD pads the tail of each valid row/column and the rows/columns past the
+ *   valid region; TSTORE leaves GM outside the valid region untouched
+ *
+ * Built once more with a tiny PTO_CPU_STREAM_STORE_BYTES so the
+ * non-temporal TSTORE path runs the same cases.
+ */
+
+#ifndef __CPU_SIM
+#define __CPU_SIM
+#endif
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <pto/pto-inst.hpp>
+
+using namespace pto;
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "CHECK failed at %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+        }                                                                   \
+    } while (0)
+
+static constexpr int kRows = 16;
+static constexpr int kCols = 40;
+static constexpr float kUntouched = -7.5f;
+
+template <BLayout L>
+using PaddedTile = Tile<TileType::Vec, float, kRows, kCols, L, DYNAMIC, DYNAMIC, SLayout::NoneBox,
+    TileConfig::fractalABSize, PadValue::Max>;
+using RowTile = PaddedTile<BLayout::RowMajor>;
+using ColTile = PaddedTile<BLayout::ColMajor>;
+
+using DynShape2D = Shape<1, 1, 1, DYNAMIC, DYNAMIC>;
+using DynStride2D = Stride<1, 1, 1, DYNAMIC, DYNAMIC>;
+using NdGlobal = GlobalTensor<float, DynShape2D, DynStride2D>;
+using DnGlobal = GlobalTensor<float, DynShape2D, DynStride2D, Layout::DN>;
+// Leading dimension known at compile time: IsUnitStride folds to a constant.
+static constexpr int kStaticLd = kCols + 3;
+using NdStaticGlobal = GlobalTensor<float, DynShape2D, Stride<1, 1, 1, kStaticLd, 1>>;
+
+static float Value(int r, int c) {
+    return static_cast<float>(r * 1000 + c);
+}
+
+template <typename TileT>
+static std::size_t TileOffset(int r, int c) {
+    return TileT::isRowMajor ? static_cast<std::size_t>(r) * kCols + c : static_cast<std::size_t>(c) * kRows + r;
+}
+
+// GM holding Value(r, c) at r * s3 + c * s4 and kUntouched everywhere else.
+static std::vector<float> MakeGm(int rows, int cols, int s3, int s4) {
+    std::vector<float> gm(static_cast<std::size_t>((rows - 1) * s3 + (cols - 1) * s4 + 1) + 8, kUntouched);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            gm[static_cast<std::size_t>(r) * s3 + static_cast<std::size_t>(c) * s4] = Value(r, c);
+        }
+    }
+    return gm;
+}
+
+template <typename GlobalT>
+static GlobalT MakeGlobal(float *data, int rows, int cols, int s3, int s4) {
+    if constexpr (GlobalT::staticStride[GlobalTensorDim::DIM_3] == DYNAMIC) {
+        return GlobalT(data, DynShape2D(rows, cols), DynStride2D(s3, s4));
+    } else {
+        (void)s3;
+        (void)s4;
+        return GlobalT(data, DynShape2D(rows, cols));
+    }
+}
+
+// Returns the number of mismatching elements.
+template <typename TileT, typename GlobalT>
+static int RoundTrip(int rows, int cols, int s3, int s4) {
+    int mismatches = 0;
+    std::vector<float> src = MakeGm(rows, cols, s3, s4);
+    GlobalT srcGlobal = MakeGlobal<GlobalT>(src.data(), rows, cols, s3, s4);
+    TileT tile(rows, cols);
+    for (int i = 0; i < kRows * kCols; i++) {
+        tile.data()[i] = kUntouched;
+    }
+    TLOAD(tile, srcGlobal);
+    for (int r = 0; r < kRows; r++) {
+        for (int c = 0; c < kCols; c++) {
+            const float got = tile.data()[TileOffset<TileT>(r, c)];
+            const bool valid = r < rows && c < cols;
+            if (valid ? got != Value(r, c) : !(std::isinf(got) && got > 0)) {
+                mismatches++;
+            }
+        }
+    }
+
+    std::vector<float> dst(src.size(), kUntouched);
+    GlobalT dstGlobal = MakeGlobal<GlobalT>(dst.data(), rows, cols, s3, s4);
+    TSTORE(dstGlobal, tile);
+    for (std::size_t i = 0; i < dst.size(); i++) {
+        if (dst[i] != src[i]) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+struct Case {
+    int rows;
+    int cols;
+};
+
+// Full tile, SIMD tails, a single element, one row/column.
+static const Case kCases[] = {
+    {kRows, kCols}, {kRows, 1}, {1, kCols}, {5, 3}, {7, 17}, {kRows, 9}, {11, kCols - 1}, {1, 1},
+};
+
+template <typename TileT, typename GlobalT>
+static void TestLayout(const char *name, bool rowMajor) {
+    printf("test_load_store: %s dense, padded and strided GM\n", name);
+    for (const Case &tc : kCases) {
+        // Leading dimension: dense, padded; inner stride 1, then 3.
+        const int lead = rowMajor ? tc.cols : tc.rows;
+        const int ldPad = lead + 5;
+        int bad = 0;
+        if (rowMajor) {
+            bad += RoundTrip<TileT, GlobalT>(tc.rows, tc.cols, lead, 1);
+            bad += RoundTrip<TileT, GlobalT>(tc.rows, tc.cols, ldPad, 1);
+            bad += RoundTrip<TileT, GlobalT>(tc.rows, tc.cols, 3 * ldPad, 3);
+        } else {
+            bad += RoundTrip<TileT, GlobalT>(tc.rows, tc.cols, 1, lead);
+            bad += RoundTrip<TileT, GlobalT>(tc.rows, tc.cols, 1, ldPad);
+            bad += RoundTrip<TileT, GlobalT>(tc.rows, tc.cols, 3, 3 * ldPad);
+        }
+        if (bad != 0) {
+            fprintf(stderr, "  %d mismatches at %d x %d\n", bad, tc.rows, tc.cols);
+        }
+        CHECK(bad == 0);
+    }
+}
+
+static void TestStaticStride() {
+    printf("test_load_store: ND with a static leading dimension\n");
+    for (const Case &tc : kCases) {
+        CHECK((RoundTrip<RowTile, NdStaticGlobal>(tc.rows, tc.cols, kStaticLd, 1)) == 0);
+    }
+}
+
+static void TestFolded3D() {
+    printf("test_load_store: 3-D ND tensor folded into the tile rows\n");
+    using Shape3D = Shape<1, 1, DYNAMIC, DYNAMIC, DYNAMIC>;
+    using Stride3D = Stride<1, 1, DYNAMIC, DYNAMIC, 1>;
+    using Global3D = GlobalTensor<float, Shape3D, Stride3D>;
+    const int planes = 3;
+    const int rows = 5;
+    const int cols = 13;
+    const int ld = 21;
+    const int planeStride = rows * ld + 4;
+
+    std::vector<float> src(static_cast<std::size_t>(planes) * planeStride, kUntouched);
+    for (int p = 0; p < planes; p++) {
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                src[static_cast<std::size_t>(p) * planeStride + r * ld + c] = Value(p * rows + r, c);
+            }
+        }
+    }
+    Global3D srcGlobal(src.data(), Shape3D(planes, rows, cols), Stride3D(planeStride, ld));
+    RowTile tile(planes * rows, cols);
+    TLOAD(tile, srcGlobal);
+    int bad = 0;
+    for (int r = 0; r < planes * rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            bad += tile.data()[TileOffset<RowTile>(r, c)] != Value(r, c);
+        }
+    }
+    CHECK(bad == 0);
+
+    std::vector<float> dst(src.size(), kUntouched);
+    Global3D dstGlobal(dst.data(), Shape3D(planes, rows, cols), Stride3D(planeStride, ld));
+    TSTORE(dstGlobal, tile);
+    CHECK(dst == src);
+}
+
+int main() {
+    TestLayout<RowTile, NdGlobal>("ND -> row-major tile,", true);
+    TestLayout<ColTile, DnGlobal>("DN -> col-major tile,", false);
+    TestStaticStride();
+    TestFolded3D();
+    if (g_failures == 0) {
+        printf("PASSED\n");
+        return 0;
+    }
+    printf("FAILED (%d checks)\n", g_failures);
+    return 1;
+}
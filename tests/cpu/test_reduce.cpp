@@ -0,0 +1,182 @@
+/**
+ * Host-side test for the CPU row/column reductions (include/pto/cpu/reduce.hpp)
+ *
+ * Compares TROWSUM/TROWMAX/TROWMIN and TCOLSUM/TCOLMAX/TCOLMIN with a scalar
+ * reference for every valid width up to kCols, so each SIMD tail, the
+ * multi-accumulator remainder and the 256-column blocking are all hit. Inputs
+ * are multiples of 1/4 with small sums, so any summation order is exact and
+ * results are compared bit for bit. Elements outside the valid region hold a
+ * sentinel that would show up in the result if a fast path read past it.
+ */
+
+#ifndef __CPU_SIM
+#define __CPU_SIM
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <pto/pto-inst.hpp>
+
+using namespace pto;
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "CHECK failed at %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+        }                                                                   \
+    } while (0)
+
+static constexpr int kRows = 64;
+static constexpr int kCols = 608;  // > 2 column blocks, not a multiple of 8 vectors
+static constexpr float kSentinel = 1.0e30f;
+
+enum class Kind { Sum, Max, Min };
+
+template <typename T>
+using SrcTile = Tile<TileType::Vec, T, kRows, kCols, BLayout::RowMajor, DYNAMIC, DYNAMIC>;
+using RowDstTile = Tile<TileType::Vec, float, kRows, 8>;
+using ColDstTile = Tile<TileType::Vec, float, 1, kCols, BLayout::RowMajor, 1, DYNAMIC>;
+
+static float Value(int r, int c) {
+    // Multiples of 1/4 in [-4, 4]: exact in half, and every partial sum of at
+    // most kCols of them is exact in float.
+    const unsigned h = static_cast<unsigned>(r) * 2654435761u ^ static_cast<unsigned>(c) * 40503u;
+    return static_cast<float>(static_cast<int>(h % 33u) - 16) * 0.25f;
+}
+
+static float Combine(Kind kind, float a, float b) {
+    switch (kind) {
+        case Kind::Sum: return a + b;
+        case Kind::Max: return a > b ? a : b;
+        case Kind::Min: return a < b ? a : b;
+    }
+    return a;
+}
+
+// The sentinel wins every reduction it leaks into.
+static float Sentinel(Kind kind) {
+    return kind == Kind::Min ? -kSentinel : kSentinel;
+}
+
+template <typename T>
+static void Fill(SrcTile<T> &src, Kind kind, int rows, int cols) {
+    for (int r = 0; r < kRows; r++) {
+        for (int c = 0; c < kCols; c++) {
+            const bool valid = r < rows && c < cols;
+            src.data()[r * kCols + c] = static_cast<T>(valid ? Value(r, c) : Sentinel(kind));
+        }
+    }
+}
+
+static float RowReference(Kind kind, int r, int cols) {
+    float acc = Value(r, 0);
+    for (int c = 1; c < cols; c++) {
+        acc = Combine(kind, acc, Value(r, c));
+    }
+    return acc;
+}
+
+static float ColReference(Kind kind, int c, int rows) {
+    float acc = Value(0, c);
+    for (int r = 1; r < rows; r++) {
+        acc = Combine(kind, acc, Value(r, c));
+    }
+    return acc;
+}
+
+template <typename T>
+static void RowReduce(Kind kind, RowDstTile &dst, SrcTile<T> &src, SrcTile<T> &tmp) {
+    switch (kind) {
+        case Kind::Sum: TROWSUM(dst, src, tmp); break;
+        case Kind::Max: TROWMAX(dst, src, tmp); break;
+        case Kind::Min: TROWMIN(dst, src, tmp); break;
+    }
+}
+
+template <typename T>
+static void ColReduce(Kind kind, ColDstTile &dst, SrcTile<T> &src) {
+    switch (kind) {
+        case Kind::Sum: TCOLSUM(dst, src); break;
+        case Kind::Max: TCOLMAX(dst, src); break;
+        case Kind::Min: TCOLMIN(dst, src); break;
+    }
+}
+
+template <typename T>
+static void TestRows(const char *name, Kind kind) {
+    printf("test_reduce: %s, every width 1..%d\n", name, kCols);
+    static constexpr int kValidRows = 5;
+    SrcTile<T> tmp(kValidRows, kCols);
+    int mismatches = 0;
+    for (int cols = 1; cols <= kCols; cols++) {
+        SrcTile<T> src(kValidRows, cols);
+        RowDstTile dst;
+        Fill(src, kind, kValidRows, cols);
+        RowReduce(kind, dst, src, tmp);
+        for (int r = 0; r < kValidRows; r++) {
+            if (dst.data()[r * RowDstTile::Cols] != RowReference(kind, r, cols)) {
+                if (mismatches++ == 0) {
+                    fprintf(stderr, "  first mismatch: row %d, width %d\n", r, cols);
+                }
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+template <typename T>
+static void TestCols(const char *name, Kind kind) {
+    printf("test_reduce: %s, every width 1..%d\n", name, kCols);
+    static const int kValidRows[] = {1, 2, 7, kRows};
+    int mismatches = 0;
+    for (int rows : kValidRows) {
+        for (int cols = 1; cols <= kCols; cols++) {
+            SrcTile<T> src(rows, cols);
+            ColDstTile dst(cols);
+            Fill(src, kind, rows, cols);
+            for (int c = 0; c < kCols; c++) {
+                dst.data()[c] = kSentinel;
+            }
+            ColReduce(kind, dst, src);
+            for (int c = 0; c < cols; c++) {
+                if (dst.data()[c] != ColReference(kind, c, rows)) {
+                    if (mismatches++ == 0) {
+                        fprintf(stderr, "  first mismatch: col %d, %d x %d\n", c, rows, cols);
+                    }
+                }
+            }
+            // Columns past the valid width are not written.
+            for (int c = cols; c < kCols; c++) {
+                if (dst.data()[c] != kSentinel) {
+                    if (mismatches++ == 0) {
+                        fprintf(stderr, "  wrote col %d past width %d\n", c, cols);
+                    }
+                }
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+int main() {
+    TestRows<float>("TROWSUM f32", Kind::Sum);
+    TestRows<float>("TROWMAX f32", Kind::Max);
+    TestRows<float>("TROWMIN f32", Kind::Min);
+    TestRows<half>("TROWSUM f16 -> f32", Kind::Sum);
+    TestRows<half>("TROWMAX f16 -> f32", Kind::Max);
+    TestCols<float>("TCOLSUM f32", Kind::Sum);
+    TestCols<float>("TCOLMAX f32", Kind::Max);
+    TestCols<float>("TCOLMIN f32", Kind::Min);
+    TestCols<half>("TCOLSUM f16 -> f32", Kind::Sum);
+    TestCols<half>("TCOLMIN f16 -> f32", Kind::Min);
+    if (g_failures == 0) {
+        printf("PASSED\n");
+        return 0;
+    }
+    printf("FAILED (%d checks)\n", g_failures);
+    return 1;
+}
@@ -0,0 +1,219 @@
+/**
+ * Host-side test for the CPU TPUSH/TPOP model (include/pto/cpu/TPushPop.hpp)
+ *
+ * Built three times: with the default GM hand-over, with PTO_CPU_TPUSH_FIFO,
+ * and with PTO_CPU_TPUSH_FIFO plus PTO_CPU_TILE_FIFO_NO_WAIT. Checks:
+ * - default: TPUSH writes the tile to the GM tensor and TPOP reads it back
+ * - FIFO: tiles come out in push order; two blocks producing with the same
+ *   token get separate FIFOs, both when run one after another and when run
+ *   concurrently on two threads
+ * - FIFO: TPUSH waits while the FIFO is full and TPOP while it is empty, so
+ *   a producer and a consumer thread can stream more tiles than it holds
+ * - FIFO, no wait: pushing more than PTO_CPU_TILE_FIFO_DEPTH tiles, or
+ *   popping an empty FIFO, throws instead of hanging the sequential block loop
+ */
+
+#ifndef __CPU_SIM
+#define __CPU_SIM
+#endif
+
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <pto/pto-inst.hpp>
+
+using namespace pto;
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "CHECK failed at %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+        }                                                                   \
+    } while (0)
+
+static constexpr int kRows = 8;
+static constexpr int kCols = 16;
+using TileT = Tile<TileType::Vec, float, kRows, kCols>;
+using GlobalT = GlobalTensor<float, Shape<1, 1, 1, kRows, kCols>, Stride<1, 1, 1, kCols, 1>>;
+
+static void Fill(TileT &tile, float base) {
+    for (int i = 0; i < kRows * kCols; i++) {
+        tile.data()[i] = base + static_cast<float>(i);
+    }
+}
+
+static bool Holds(const TileT &tile, float base) {
+    for (int i = 0; i < kRows * kCols; i++) {
+        if (tile.data()[i] != base + static_cast<float>(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifndef PTO_CPU_TPUSH_FIFO
+
+static void TestGmHandOver() {
+    printf("test_tile_push_pop: GM hand-over\n");
+    std::vector<float> gm(kRows * kCols, 0.0f);
+    GlobalT global(gm.data());
+    TileT src;
+    TileT dst;
+    Fill(src, 100.0f);
+    Fill(dst, 0.0f);
+    TPUSH(global, src, 1);
+    CHECK(gm[0] == 100.0f);
+    CHECK(gm[kRows * kCols - 1] == 100.0f + kRows * kCols - 1);
+    TPOP(dst, global, 1);
+    CHECK(Holds(dst, 100.0f));
+}
+
+#else
+
+#ifdef PTO_CPU_TILE_FIFO_NO_WAIT
+
+static void TestDepth() {
+    printf("test_tile_push_pop: FIFO depth %zu, no wait\n", static_cast<size_t>(PTO_CPU_TILE_FIFO_DEPTH));
+    std::vector<float> gm(kRows * kCols, -1.0f);
+    GlobalT global(gm.data());
+    TileT tile;
+    pto_cpu_block_idx = 0;
+    for (unsigned i = 0; i < PTO_CPU_TILE_FIFO_DEPTH; i++) {
+        Fill(tile, 1000.0f * i);
+        TPUSH(global, tile, 2);
+    }
+    bool threw = false;
+    try {
+        TPUSH(global, tile, 2);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(gm[0] == -1.0f);  // GM is not used in FIFO mode
+
+    for (unsigned i = 0; i < PTO_CPU_TILE_FIFO_DEPTH; i++) {
+        TPOP(tile, global, 2);
+        CHECK(Holds(tile, 1000.0f * i));
+    }
+    threw = false;
+    try {
+        TPOP(tile, global, 2);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+#else
+
+static void TestBlockingStream() {
+    printf("test_tile_push_pop: TPUSH/TPOP wait on a full/empty FIFO\n");
+    constexpr int kTiles = 4 * PTO_CPU_TILE_FIFO_DEPTH + 3;
+    std::vector<float> gm(kRows * kCols, -1.0f);
+    int bad = 0;
+    pto_cpu_block_idx = 0;
+    std::thread consumer([&] {
+        GlobalT global(gm.data());
+        TileT tile;
+        for (int i = 0; i < kTiles; i++) {
+            TPOP(tile, global, 2);
+            if (!Holds(tile, 1000.0f * i)) {
+                bad++;
+            }
+        }
+    });
+    std::thread producer([&] {
+        GlobalT global(gm.data());
+        TileT tile;
+        for (int i = 0; i < kTiles; i++) {
+            Fill(tile, 1000.0f * i);
+            TPUSH(global, tile, 2);
+        }
+    });
+    producer.join();
+    consumer.join();
+    CHECK(bad == 0);
+    CHECK(gm[0] == -1.0f);  // GM is not used in FIFO mode
+}
+
+#endif
+
+static void TestBlocksSequential() {
+    printf("test_tile_push_pop: two producers on one token, sequential blocks\n");
+    std::vector<float> gm(kRows * kCols);
+    GlobalT global(gm.data());
+    TileT tile;
+    for (uint32_t block = 0; block < 2; block++) {
+        pto_cpu_block_idx = block;
+        Fill(tile, 10.0f + block);
+        TPUSH(global, tile, 3);
+    }
+    for (uint32_t block = 0; block < 2; block++) {
+        pto_cpu_block_idx = block;
+        TPOP(tile, global, 3);
+        CHECK(Holds(tile, 10.0f + block));
+    }
+    pto_cpu_block_idx = 0;
+}
+
+static void TestBlocksThreaded() {
+    printf("test_tile_push_pop: two producers on one token, concurrent blocks\n");
+    constexpr int kTiles = 2000;
+    constexpr uint16_t kToken = 4;
+    std::vector<std::thread> threads;
+    std::vector<int> bad(2, 0);
+    for (uint32_t block = 0; block < 2; block++) {
+        threads.emplace_back([block] {
+            TileT tile;
+            for (int i = 0; i < kTiles; i++) {
+                Fill(tile, static_cast<float>(block * kTiles + i));
+                while (!cpu::TryPushTile(tile, block, kToken)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([block, &bad] {
+            TileT tile;
+            for (int i = 0; i < kTiles; i++) {
+                while (!cpu::TryPopTile(tile, block, kToken)) {
+                    std::this_thread::yield();
+                }
+                if (!Holds(tile, static_cast<float>(block * kTiles + i))) {
+                    bad[block]++;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    CHECK(bad[0] == 0);
+    CHECK(bad[1] == 0);
+}
+
+#endif
+
+int main() {
+#ifndef PTO_CPU_TPUSH_FIFO
+    TestGmHandOver();
+#else
+#ifdef PTO_CPU_TILE_FIFO_NO_WAIT
+    TestDepth();
+#else
+    TestBlockingStream();
+#endif
+    TestBlocksSequential();
+    TestBlocksThreaded();
+#endif
+    if (g_failures == 0) {
+        printf("PASSED\n");
+        return 0;
+    }
+    printf("FAILED (%d checks)\n", g_failures);
+    return 1;
+}